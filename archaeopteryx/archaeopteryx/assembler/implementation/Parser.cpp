@@ -0,0 +1,1093 @@
+/*! \file   Parser.cpp
+	\author Gregory Diamos <gregory.diamos@gatech.edu>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the Parser class.
+*/
+
+// Archaeopteryx Includes
+#include <archaeopteryx/assembler/interface/Parser.h>
+
+// Vanaheimr Includes
+#include <vanaheimr/parser/interface/Lexer.h>
+#include <vanaheimr/parser/interface/TypeParser.h>
+#include <vanaheimr/parser/interface/TypeAliasSet.h>
+#include <vanaheimr/parser/interface/ConstantValueParser.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/Type.h>
+#include <vanaheimr/ir/interface/Constant.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <cstdlib>
+
+namespace archaeopteryx
+{
+
+namespace assembler
+{
+
+typedef vanaheimr::parser::Lexer Lexer;
+typedef vanaheimr::parser::Token Token;
+
+namespace ir = vanaheimr::ir;
+
+class ParserEngine
+{
+public:
+	typedef vanaheimr::compiler::Compiler Compiler;
+
+public:
+	ParserEngine(Compiler* compiler, const std::string& moduleName);
+
+public:
+	ir::Module* parse();
+
+public:
+	Lexer lexer;
+
+private:
+	class FunctionBody
+	{
+	public:
+		FunctionBody(ir::Function* f, size_t p);
+
+	public:
+		ir::Function* function;
+		size_t        position;
+	};
+
+	typedef std::vector<FunctionBody> FunctionBodyVector;
+
+	typedef std::unordered_map<std::string, ir::BasicBlock*> BasicBlockMap;
+	typedef std::unordered_map<std::string, ir::VirtualRegister*> RegisterMap;
+
+	typedef std::vector<ir::Operand*> OperandVector;
+
+private:
+	void _parseDeclaration();
+	void _parseGlobal();
+	void _parseFunction();
+	void _skipFunctionBody();
+
+private:
+	void _parseFunctionBody(const FunctionBody& body);
+	void _recordLabels();
+	void _parseStatement();
+
+	void _setOperands(ir::Instruction* instruction, const ir::Type* type);
+	void _setCallOperands(ir::Call* call, const ir::Type* type);
+
+private:
+	ir::PredicateOperand* _parseGuard(ir::Instruction* instruction);
+	ir::Operand* _parseOperand(ir::Instruction* instruction,
+		const ir::Type* type);
+	ir::Operand* _parseIndirectOperand(ir::Instruction* instruction,
+		const ir::Type* type);
+	ir::Operand* _parseImmediateOperand(ir::Instruction* instruction,
+		const ir::Type* type);
+	ir::Operand* _parseNamedOperand(ir::Instruction* instruction,
+		const ir::Type* type);
+	OperandVector _parseOperands(ir::Instruction* instruction,
+		const ir::Type* type);
+
+private:
+	const ir::Type* _parseType();
+	std::string     _parseName();
+	bool            _scan(const std::string& token);
+	bool            _isType(const Token& token) const;
+
+	void _skipLineEnds();
+	void _scanLineEnd();
+
+private:
+	ir::VirtualRegister* _getRegister(const Token& name, const ir::Type* type);
+	ir::Variable*        _getSymbol(const std::string& name);
+	ir::Argument*        _getArgument(const std::string& name);
+	ir::Variable*        _getIntrinsic(const std::string& name,
+		const ir::Call& call);
+	ir::VirtualRegister* _getSpecialValue(const std::string& name,
+		const ir::Type* type);
+
+private:
+	std::string _location() const;
+
+private:
+	Compiler*   _compiler;
+	std::string _moduleName;
+	ir::Module* _module;
+
+	vanaheimr::parser::TypeAliasSet _types;
+
+	FunctionBodyVector _functionBodies;
+
+private:
+	ir::Function*   _function;
+	ir::BasicBlock* _block;
+	BasicBlockMap   _blocks;
+	RegisterMap     _registers;
+
+};
+
+Parser::Parser(Compiler* compiler)
+: _compiler(compiler)
+{
+
+}
+
+Parser::Module* Parser::parse(const std::string& filename)
+{
+	ParserEngine engine(_compiler, filename);
+
+	engine.lexer.setFile(filename);
+
+	return engine.parse();
+}
+
+Parser::Module* Parser::parse(std::istream& stream,
+	const std::string& moduleName)
+{
+	ParserEngine engine(_compiler, moduleName);
+
+	engine.lexer.setStream(&stream);
+
+	return engine.parse();
+}
+
+ParserEngine::FunctionBody::FunctionBody(ir::Function* f, size_t p)
+: function(f), position(p)
+{
+
+}
+
+ParserEngine::ParserEngine(Compiler* compiler, const std::string& name)
+: _compiler(compiler), _moduleName(name), _module(nullptr),
+  _function(nullptr), _block(nullptr)
+{
+	/// symbols
+	lexer.addTokens({"(", ")", "{", "}", "[", "]", ",", "=", "\\*", "+",
+		"!", "@"});
+
+	/// names, types and registers
+	lexer.addTokens({"[a-zA-Z_$.%][a-zA-Z_$.0-9]*"});
+	lexer.addTokens({"[a-zA-Z_$.][a-zA-Z_$.0-9]*:"}); // labels
+
+	/// numbers
+	lexer.addTokens({"[:digit:][:digit:]*", "-[:digit:][:digit:]*"});
+	lexer.addTokens({"-*[:digit:][:digit:]*\\.[:digit:]*"});
+	lexer.addTokens({"-*[:digit:][:digit:]*\\.[:digit:]*e[-+][:digit:]*"});
+	lexer.addTokens({"0x[0-9a-fA-F][0-9a-fA-F]*"});
+
+	/// string initializers
+	lexer.addTokens({"\"[^\n\"]*\"", "c\"[^\n\"]*\""});
+
+	/// statements end with the line, comments run to the end of it
+	lexer.addTokens({"\n", ";[^\n]*"});
+
+	lexer.addWhitespaceRules(" \t\r");
+}
+
+ir::Module* ParserEngine::parse()
+{
+	hydrazine::log("Assembler::Parser") << "Parsing VIR module '"
+		<< _moduleName << "'\n";
+
+	_module = &*_compiler->newModule(_moduleName);
+
+	// Declare every symbol first, bodies may refer to later ones
+	_skipLineEnds();
+
+	while(!lexer.hitEndOfStream())
+	{
+		_parseDeclaration();
+		_skipLineEnds();
+	}
+
+	for(auto& body : _functionBodies)
+	{
+		_parseFunctionBody(body);
+	}
+
+	return _module;
+}
+
+void ParserEngine::_parseDeclaration()
+{
+	if(_scan("global"))
+	{
+		_parseGlobal();
+	}
+	else
+	{
+		_parseFunction();
+	}
+}
+
+void ParserEngine::_parseGlobal()
+{
+	auto type = _parseType();
+	auto name = _parseName();
+
+	if(_module->getGlobal(name) != _module->global_end() ||
+		_module->getFunction(name) != _module->end())
+	{
+		throw std::runtime_error("At " + _location() +
+			": redefinition of '" + name + "'.");
+	}
+
+	auto global = _module->newGlobal(name, type,
+		ir::Variable::ExternalLinkage, ir::Global::Shared);
+
+	if(_scan("="))
+	{
+		vanaheimr::parser::ConstantValueParser parser(&lexer);
+
+		parser.parse(type);
+
+		global->setInitializer(parser.releaseParsedConstant());
+	}
+
+	hydrazine::log("Assembler::Parser") << " Parsed global '" << name << "'\n";
+
+	_scanLineEnd();
+}
+
+void ParserEngine::_parseFunction()
+{
+	std::vector<std::string> attributes;
+
+	while(lexer.peekToken().startsWith('.'))
+	{
+		auto attribute = lexer.consumeToken();
+
+		attributes.push_back(std::string(attribute.begin() + 1,
+			attribute.end()));
+	}
+
+	auto returnType = _parseType();
+	auto name       = _parseName();
+
+	if(_module->getGlobal(name) != _module->global_end() ||
+		_module->getFunction(name) != _module->end())
+	{
+		throw std::runtime_error("At " + _location() +
+			": redefinition of '" + name + "'.");
+	}
+
+	auto function = _module->newFunction(name, ir::Variable::ExternalLinkage,
+		ir::Variable::VisibleVisibility);
+
+	if(!returnType->isVoid())
+	{
+		function->newReturnValue(returnType, "returnValue");
+	}
+
+	lexer.scanThrow("(");
+
+	if(!lexer.scanPeek(")"))
+	{
+		do
+		{
+			auto type = _parseType();
+
+			function->newArgument(type, _parseName());
+		}
+		while(_scan(","));
+	}
+
+	lexer.scanThrow(")");
+
+	for(auto& attribute : attributes)
+	{
+		function->addAttribute(attribute);
+	}
+
+	function->interpretType();
+
+	hydrazine::log("Assembler::Parser") << " Parsed function '" << name
+		<< "'\n";
+
+	_skipLineEnds();
+
+	if(!_scan("{"))
+	{
+		function->addAttribute("prototype");
+		return;
+	}
+
+	// Bodies are parsed once every symbol has been declared
+	_functionBodies.push_back(FunctionBody(&*function, lexer.position()));
+
+	_skipFunctionBody();
+
+	lexer.scanThrow("}");
+}
+
+void ParserEngine::_skipFunctionBody()
+{
+	unsigned int depth = 0;
+
+	while(true)
+	{
+		if(lexer.hitEndOfStream())
+		{
+			throw std::runtime_error("At " + _location() +
+				": hit the end of the file in a function body.");
+		}
+
+		auto token = lexer.peekToken();
+
+		if(token == "{")
+		{
+			++depth;
+		}
+		else if(token == "}")
+		{
+			if(depth == 0) break;
+
+			--depth;
+		}
+
+		lexer.consumeToken();
+	}
+}
+
+void ParserEngine::_parseFunctionBody(const FunctionBody& body)
+{
+	_function = body.function;
+	_block    = nullptr;
+
+	hydrazine::log("Assembler::Parser") << " Parsing the body of '"
+		<< _function->name() << "'\n";
+
+	lexer.seek(body.position);
+
+	_recordLabels();
+
+	lexer.seek(body.position);
+
+	while(true)
+	{
+		_skipLineEnds();
+
+		auto token = lexer.peekToken();
+
+		if(token == "}") break;
+
+		if(token.back() == ':')
+		{
+			_block = _blocks[std::string(token.begin(), token.end() - 1)];
+
+			lexer.consumeToken();
+			continue;
+		}
+
+		if(_block == nullptr)
+		{
+			throw std::runtime_error("At " + _location() +
+				": expecting a label before the first statement.");
+		}
+
+		_parseStatement();
+	}
+
+	_blocks.clear();
+	_registers.clear();
+
+	_function = nullptr;
+	_block    = nullptr;
+}
+
+void ParserEngine::_recordLabels()
+{
+	// Branches may refer to labels further down the function
+	for(auto token = lexer.consumeToken(); token != "}";
+		token = lexer.consumeToken())
+	{
+		if(token.empty() || token.back() != ':') continue;
+
+		auto name = std::string(token.begin(), token.end() - 1);
+
+		if(_blocks.count(name) != 0)
+		{
+			throw std::runtime_error("At " + _location() +
+				": duplicate label '" + name + "'.");
+		}
+
+		auto block = _function->newBasicBlock(_function->exit_block(), name);
+
+		_blocks.insert(std::make_pair(name, &*block));
+	}
+}
+
+static ir::Instruction::Opcode parseOpcode(const Token& token)
+{
+	// Spellings of hand-written code, exit and the pointer casts are
+	//  translated the way the PTX translator does
+	if(token == "exit")     return ir::Instruction::Ret;
+	if(token == "inttoptr") return ir::Instruction::Bitcast;
+	if(token == "ptrtoint") return ir::Instruction::Bitcast;
+
+	return ir::Instruction::parseOpcode(token.str());
+}
+
+static bool isSupported(ir::Instruction::Opcode opcode)
+{
+	switch(opcode)
+	{
+	case ir::Instruction::Atom:          // fall through
+	case ir::Instruction::Getelementptr: // fall through
+	case ir::Instruction::Launch:        // fall through
+	case ir::Instruction::Membar:        // fall through
+	case ir::Instruction::Phi:           // fall through
+	case ir::Instruction::Psi:           // fall through
+	case ir::Instruction::Machine:       // fall through
+	case ir::Instruction::InvalidOpcode:
+	{
+		return false;
+	}
+	default: break;
+	}
+
+	return true;
+}
+
+static ir::ComparisonInstruction::Comparison parseComparison(
+	const Token& token)
+{
+	for(int c = 0; c != ir::ComparisonInstruction::InvalidComparison; ++c)
+	{
+		auto comparison = (ir::ComparisonInstruction::Comparison)c;
+
+		if(token == ir::ComparisonInstruction::toString(comparison))
+		{
+			return comparison;
+		}
+	}
+
+	return ir::ComparisonInstruction::InvalidComparison;
+}
+
+void ParserEngine::_parseStatement()
+{
+	// The guard comes first, it needs an instruction to belong to
+	lexer.checkpoint();
+
+	_scan("!");
+
+	if(_scan("@")) lexer.consumeToken();
+
+	auto opcodeToken = lexer.consumeToken();
+
+	lexer.restoreCheckpoint();
+
+	auto opcode = parseOpcode(opcodeToken);
+
+	if(!isSupported(opcode))
+	{
+		throw std::runtime_error("At " + _location() +
+			": '" + opcodeToken.str() + "' is not a supported opcode.");
+	}
+
+	std::unique_ptr<ir::Instruction> instruction(
+		ir::Instruction::create(opcode, _block));
+
+	instruction->setGuard(_parseGuard(instruction.get()));
+
+	lexer.consumeToken();
+
+	if(opcode == ir::Instruction::Setp)
+	{
+		auto comparisonToken = lexer.consumeToken();
+
+		auto comparison = parseComparison(comparisonToken);
+
+		if(comparison == ir::ComparisonInstruction::InvalidComparison)
+		{
+			throw std::runtime_error("At " + _location() +
+				": invalid comparison '" + comparisonToken.str() + "'.");
+		}
+
+		static_cast<ir::Setp*>(instruction.get())->comparison = comparison;
+	}
+	else if(opcode == ir::Instruction::Bra)
+	{
+		static_cast<ir::Bra*>(instruction.get())->modifier =
+			_scan("uni") ? ir::Bra::UniformBranch :
+			ir::Bra::MultitargetBranch;
+	}
+
+	const ir::Type* type = nullptr;
+
+	if(_isType(lexer.peekToken())) type = _parseType();
+
+	// Binaries have no pointer data types, addresses are 64-bit integers
+	if(dynamic_cast<const ir::PointerType*>(type) != nullptr)
+	{
+		type = _compiler->getType("i64");
+	}
+
+	_setOperands(instruction.get(), type);
+
+	hydrazine::log("Assembler::Parser") << "  Parsed '"
+		<< instruction->toString() << "'\n";
+
+	_block->push_back(instruction.release());
+
+	_scanLineEnd();
+}
+
+static void checkOperandCount(const std::vector<ir::Operand*>& operands,
+	size_t expected, const ir::Instruction& instruction,
+	const std::string& location)
+{
+	if(operands.size() == expected) return;
+
+	for(auto operand : operands) delete operand;
+
+	std::stringstream message;
+
+	message << "At " << location << ": '" << instruction.opcodeString()
+		<< "' takes " << expected << " operands, found "
+		<< operands.size() << ".";
+
+	throw std::runtime_error(message.str());
+}
+
+void ParserEngine::_setOperands(ir::Instruction* instruction,
+	const ir::Type* type)
+{
+	if(instruction->isCall())
+	{
+		_setCallOperands(static_cast<ir::Call*>(instruction), type);
+
+		return;
+	}
+
+	OperandVector operands;
+
+	// A comparison writes a predicate, the type is that of its sources
+	if(instruction->opcode == ir::Instruction::Setp)
+	{
+		operands.push_back(_parseOperand(instruction,
+			_compiler->getType("i1")));
+
+		lexer.scanThrow(",");
+	}
+
+	auto sources = _parseOperands(instruction, type);
+
+	operands.insert(operands.end(), sources.begin(), sources.end());
+
+	if(auto unary = dynamic_cast<ir::UnaryInstruction*>(instruction))
+	{
+		checkOperandCount(operands, 2, *instruction, _location());
+
+		unary->setD(operands[0]);
+		unary->setA(operands[1]);
+	}
+	else if(auto binary = dynamic_cast<ir::BinaryInstruction*>(instruction))
+	{
+		checkOperandCount(operands, 3, *instruction, _location());
+
+		binary->setD(operands[0]);
+		binary->setA(operands[1]);
+		binary->setB(operands[2]);
+	}
+	else if(auto st = dynamic_cast<ir::St*>(instruction))
+	{
+		checkOperandCount(operands, 2, *instruction, _location());
+
+		st->setD(operands[0]);
+		st->setA(operands[1]);
+	}
+	else if(auto bra = dynamic_cast<ir::Bra*>(instruction))
+	{
+		checkOperandCount(operands, 1, *instruction, _location());
+
+		bra->setTarget(operands[0]);
+	}
+	else
+	{
+		// ret and bar
+		checkOperandCount(operands, 0, *instruction, _location());
+	}
+}
+
+void ParserEngine::_setCallOperands(ir::Call* call, const ir::Type* type)
+{
+	if(type != nullptr)
+	{
+		call->addReturn(_parseOperand(call, type));
+
+		lexer.scanThrow(",");
+	}
+
+	auto target = lexer.peekToken();
+
+	if(target.startsWith("_Zintrinsic_") &&
+		_module->getFunction(target.str()) == _module->end())
+	{
+		// The prototype is declared from the call, after its operands
+		lexer.consumeToken();
+
+		auto arguments = _scan(",") ?
+			_parseOperands(call, type) : OperandVector();
+
+		for(auto argument : arguments) call->addArgument(argument);
+
+		call->setTarget(new ir::AddressOperand(
+			_getIntrinsic(target.str(), *call), call));
+
+		return;
+	}
+
+	call->setTarget(_parseOperand(call, type));
+
+	if(!_scan(",")) return;
+
+	auto arguments = _parseOperands(call, type);
+
+	for(auto argument : arguments) call->addArgument(argument);
+}
+
+ir::PredicateOperand* ParserEngine::_parseGuard(ir::Instruction* instruction)
+{
+	bool isInverted = _scan("!");
+
+	if(!_scan("@"))
+	{
+		if(isInverted)
+		{
+			throw std::runtime_error("At " + _location() +
+				": expecting '@' after '!'.");
+		}
+
+		return new ir::PredicateOperand(ir::PredicateOperand::PredicateTrue,
+			instruction);
+	}
+
+	if(_scan("pt"))
+	{
+		return new ir::PredicateOperand(isInverted ?
+			ir::PredicateOperand::PredicateFalse :
+			ir::PredicateOperand::PredicateTrue, instruction);
+	}
+
+	auto predicate = _getRegister(lexer.consumeToken(),
+		_compiler->getType("i1"));
+
+	return new ir::PredicateOperand(predicate, isInverted ?
+		ir::PredicateOperand::InversePredicate :
+		ir::PredicateOperand::StraightPredicate, instruction);
+}
+
+static bool isRegister(const Token& token)
+{
+	if(token.size() < 2) return false;
+
+	if(token.startsWith('%')) return true;
+
+	if(!token.startsWith('r')) return false;
+
+	for(size_t i = 1; i < token.size(); ++i)
+	{
+		if(token[i] < '0' || token[i] > '9') return false;
+	}
+
+	return true;
+}
+
+static bool isNumber(const Token& token)
+{
+	if(token.startsWith('-')) return token.size() > 1;
+
+	return !token.empty() && token[0] >= '0' && token[0] <= '9';
+}
+
+ir::Operand* ParserEngine::_parseOperand(ir::Instruction* instruction,
+	const ir::Type* type)
+{
+	auto token = lexer.peekToken();
+
+	if(token == "[") return _parseIndirectOperand(instruction, type);
+
+	if(isNumber(token)) return _parseImmediateOperand(instruction, type);
+
+	if(isRegister(token))
+	{
+		return new ir::RegisterOperand(_getRegister(lexer.consumeToken(),
+			type), instruction);
+	}
+
+	return _parseNamedOperand(instruction, type);
+}
+
+ir::Operand* ParserEngine::_parseIndirectOperand(ir::Instruction* instruction,
+	const ir::Type* type)
+{
+	lexer.scanThrow("[");
+
+	auto token = lexer.consumeToken();
+
+	if(!isRegister(token))
+	{
+		throw std::runtime_error("At " + _location() +
+			": expecting a register, found '" + token.str() + "'.");
+	}
+
+	auto base = _getRegister(token, type);
+
+	int64_t offset = 0;
+
+	if(_scan("+") || lexer.peekToken().startsWith('-'))
+	{
+		auto offsetToken = lexer.consumeToken().str();
+
+		char* end = nullptr;
+
+		offset = std::strtoll(offsetToken.c_str(), &end, 0);
+
+		if(*end != '\0')
+		{
+			throw std::runtime_error("At " + _location() +
+				": invalid offset '" + offsetToken + "'.");
+		}
+	}
+
+	lexer.scanThrow("]");
+
+	return new ir::IndirectOperand(base, offset, instruction);
+}
+
+ir::Operand* ParserEngine::_parseImmediateOperand(ir::Instruction* instruction,
+	const ir::Type* type)
+{
+	auto token = lexer.consumeToken().str();
+
+	if(type == nullptr)
+	{
+		throw std::runtime_error("At " + _location() +
+			": immediate '" + token + "' needs an instruction type.");
+	}
+
+	char* end = nullptr;
+
+	if(type->isFloatingPoint())
+	{
+		double value = std::strtod(token.c_str(), &end);
+
+		if(*end == '\0')
+		{
+			return new ir::ImmediateOperand(value, instruction, type);
+		}
+	}
+	else if(token[0] == '-')
+	{
+		int64_t value = std::strtoll(token.c_str(), &end, 0);
+
+		if(*end == '\0')
+		{
+			return new ir::ImmediateOperand((uint64_t)value, instruction,
+				type);
+		}
+	}
+	else
+	{
+		uint64_t value = std::strtoull(token.c_str(), &end, 0);
+
+		if(*end == '\0')
+		{
+			return new ir::ImmediateOperand(value, instruction, type);
+		}
+	}
+
+	throw std::runtime_error("At " + _location() +
+		": invalid immediate '" + token + "'.");
+}
+
+ir::Operand* ParserEngine::_parseNamedOperand(ir::Instruction* instruction,
+	const ir::Type* type)
+{
+	auto name = _parseName();
+
+	auto argument = _getArgument(name);
+
+	if(argument != nullptr) return new ir::ArgumentOperand(argument,
+		instruction);
+
+	auto symbol = _getSymbol(name);
+
+	if(symbol != nullptr) return new ir::AddressOperand(symbol, instruction);
+
+	if(instruction->isCall() || instruction->isBranch())
+	{
+		throw std::runtime_error("At " + _location() +
+			": unknown target '" + name + "'.");
+	}
+
+	if(type == nullptr)
+	{
+		throw std::runtime_error("At " + _location() +
+			": special value '" + name + "' needs an instruction type.");
+	}
+
+	return new ir::RegisterOperand(_getSpecialValue(name, type), instruction);
+}
+
+ParserEngine::OperandVector ParserEngine::_parseOperands(
+	ir::Instruction* instruction, const ir::Type* type)
+{
+	OperandVector operands;
+
+	auto next = lexer.peekToken();
+
+	if(next.empty() || next == "\n" || next.startsWith(';') || next == "}")
+	{
+		return operands;
+	}
+
+	try
+	{
+		do
+		{
+			operands.push_back(_parseOperand(instruction, type));
+		}
+		while(_scan(","));
+	}
+	catch(...)
+	{
+		for(auto operand : operands) delete operand;
+
+		throw;
+	}
+
+	return operands;
+}
+
+const ir::Type* ParserEngine::_parseType()
+{
+	vanaheimr::parser::TypeParser parser(_compiler, &_types);
+
+	try
+	{
+		parser.parse(&lexer);
+	}
+	catch(const std::exception& e)
+	{
+		throw std::runtime_error("At " + _location() + ": " + e.what());
+	}
+
+	return parser.parsedType();
+}
+
+std::string ParserEngine::_parseName()
+{
+	auto token = lexer.consumeToken();
+
+	if(token.empty() || token == "\n" || token.startsWith(';') ||
+		!(isalpha(token[0]) || token[0] == '_' || token[0] == '$' ||
+		token[0] == '.' || token[0] == '%'))
+	{
+		throw std::runtime_error("At " + _location() +
+			": expecting a name, found '" + token.str() + "'.");
+	}
+
+	return token.str();
+}
+
+bool ParserEngine::_scan(const std::string& token)
+{
+	// Lexer::scan always consumes, statements have optional tokens
+	if(lexer.hitEndOfStream() || !lexer.scanPeek(token)) return false;
+
+	lexer.consumeToken();
+
+	return true;
+}
+
+bool ParserEngine::_isType(const Token& token) const
+{
+	if(token.empty() || isRegister(token)) return false;
+
+	auto type = _compiler->getType(token.str());
+
+	return type != nullptr && type->isPrimitive();
+}
+
+void ParserEngine::_skipLineEnds()
+{
+	while(!lexer.hitEndOfStream())
+	{
+		auto token = lexer.peekToken();
+
+		if(token != "\n" && !token.startsWith(';')) break;
+
+		lexer.consumeToken();
+	}
+}
+
+void ParserEngine::_scanLineEnd()
+{
+	if(lexer.hitEndOfStream()) return;
+
+	auto token = lexer.peekToken();
+
+	if(token == "}") return;
+
+	if(token != "\n" && !token.startsWith(';'))
+	{
+		throw std::runtime_error("At " + _location() +
+			": expecting the end of the line, found '" + token.str() + "'.");
+	}
+
+	_skipLineEnds();
+}
+
+ir::VirtualRegister* ParserEngine::_getRegister(const Token& token,
+	const ir::Type* type)
+{
+	auto name = token.str();
+
+	auto reg = _registers.find(name);
+
+	if(reg != _registers.end()) return reg->second;
+
+	if(type == nullptr)
+	{
+		throw std::runtime_error("At " + _location() +
+			": register '" + name + "' needs an instruction type.");
+	}
+
+	auto newRegister = _function->newVirtualRegister(type, name);
+
+	_registers.insert(std::make_pair(name, &*newRegister));
+
+	return &*newRegister;
+}
+
+ir::Variable* ParserEngine::_getSymbol(const std::string& name)
+{
+	auto block = _blocks.find(name);
+
+	if(block != _blocks.end()) return block->second;
+
+	auto function = _module->getFunction(name);
+
+	if(function != _module->end()) return &*function;
+
+	auto global = _module->getGlobal(name);
+
+	if(global != _module->global_end()) return &*global;
+
+	return nullptr;
+}
+
+ir::Argument* ParserEngine::_getArgument(const std::string& name)
+{
+	for(auto argument = _function->argument_begin();
+		argument != _function->argument_end(); ++argument)
+	{
+		if(argument->name() == name) return &*argument;
+	}
+
+	for(auto argument = _function->returned_begin();
+		argument != _function->returned_end(); ++argument)
+	{
+		if(argument->name() == name) return &*argument;
+	}
+
+	return nullptr;
+}
+
+ir::Variable* ParserEngine::_getIntrinsic(const std::string& name,
+	const ir::Call& call)
+{
+	auto function = _module->newFunction(name, ir::Variable::ExternalLinkage,
+		ir::Variable::HiddenVisibility);
+
+	function->addAttribute("prototype");
+	function->addAttribute("intrinsic");
+
+	unsigned int index = 0;
+
+	for(auto returned : call.returned())
+	{
+		std::stringstream stream;
+
+		stream << "returnValue_" << index++;
+
+		function->newReturnValue(returned->type(), stream.str());
+	}
+
+	index = 0;
+
+	for(auto argument : call.arguments())
+	{
+		std::stringstream stream;
+
+		stream << "argument_" << index++;
+
+		function->newArgument(argument->type(), stream.str());
+	}
+
+	function->interpretType();
+
+	return &*function;
+}
+
+ir::VirtualRegister* ParserEngine::_getSpecialValue(const std::string& name,
+	const ir::Type* type)
+{
+	auto intrinsicName = "_Zintrinsic_getspecial_" + name;
+
+	auto function = _module->getFunction(intrinsicName);
+
+	if(function == _module->end())
+	{
+		function = _module->newFunction(intrinsicName,
+			ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility);
+
+		function->newReturnValue(type, "returnedValue");
+
+		function->addAttribute("intrinsic");
+		function->addAttribute("prototype");
+
+		function->interpretType();
+	}
+
+	// Read the value into a new register ahead of the instruction
+	auto call = new ir::Call(_block);
+
+	call->setGuard(new ir::PredicateOperand(
+		ir::PredicateOperand::PredicateTrue, call));
+
+	auto value = &*_function->newVirtualRegister(type);
+
+	call->addReturn(new ir::RegisterOperand(value, call));
+	call->setTarget(new ir::AddressOperand(&*function, call));
+
+	_block->push_back(call);
+
+	return value;
+}
+
+std::string ParserEngine::_location() const
+{
+	return _moduleName + ":" + lexer.location();
+}
+
+}
+
+}
+
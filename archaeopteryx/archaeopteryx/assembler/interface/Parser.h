@@ -0,0 +1,71 @@
+/*! \file   Parser.h
+	\author Gregory Diamos <gregory.diamos@gatech.edu>
+	\date   Sunday October 18, 2026
+	\brief  The header file for the Parser class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <string>
+#include <istream>
+
+// Forward Declarations
+namespace vanaheimr { namespace compiler { class Compiler; } }
+namespace vanaheimr { namespace ir       { class Module;   } }
+
+namespace archaeopteryx
+{
+
+namespace assembler
+{
+
+/*! \brief Parses textual VIR into a Vanaheimr module on the host
+
+	The module can be written out directly with vanaheimr::as::BinaryWriter,
+	so hand-written kernels (e.g. test/saxpy.vir) skip the compiler.
+
+	module    := { global | function }
+	global    := 'global' type name [ '=' constant ]
+	function  := { '.' attribute } type name '(' [ type name { ',' type name } ]
+	             ')' [ '{' { label ':' | statement } '}' ]
+	statement := [ guard ] opcode [ modifier ] [ type ] [ operand { ',' operand } ]
+	guard     := [ '!' ] '@' ( register | 'pt' )
+	operand   := register | '[' register [ ( '+' | '-' ) integer ] ']' |
+	             number | name
+
+	Statements end with the line, ';' starts a comment.  Registers are 'r'
+	followed by digits or start with '%', they take the type of the first
+	instruction that names them, except that 'setp' writes an i1 and pointer
+	types become i64 (binaries have no pointer data types).  A call names
+	its return first when it has a type, then the target and the arguments.
+
+	Names are resolved to labels, arguments, functions and then globals,
+	which may be declared anywhere in the file.  A call to an undeclared
+	'_Zintrinsic_' function declares the intrinsic, and any other unknown
+	name reads a special value through '_Zintrinsic_getspecial_<name>'.
+*/
+class Parser
+{
+public:
+	typedef vanaheimr::compiler::Compiler Compiler;
+	typedef vanaheimr::ir::Module         Module;
+
+public:
+	Parser(Compiler* compiler);
+
+public:
+	/*! \brief Parse a file into a new module named after the file */
+	Module* parse(const std::string& filename);
+	/*! \brief Parse a stream into a new module */
+	Module* parse(std::istream& stream, const std::string& moduleName);
+
+private:
+	Compiler* _compiler;
+
+};
+
+}
+
+}
+
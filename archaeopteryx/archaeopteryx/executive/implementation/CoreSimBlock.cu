@@ -31,17 +31,32 @@ namespace executive
 {
 
 __device__ void CoreSimBlock::setupCoreSimBlock(unsigned int blockId,
-	unsigned int registers, const CoreSimKernel* kernel)
+	unsigned int registers, uint64_t localMemoryAddress,
+	unsigned int localMemory, const CoreSimKernel* kernel)
 {
+	// r32 and r33 are always written by initializeSpecialRegisters
+	const unsigned int specialRegisters = 34;
+
 	m_blockState.blockId = blockId;
-	m_blockState.registersPerThread = registers;
+	m_blockState.registersPerThread = registers < specialRegisters ?
+		specialRegisters : registers;
+	m_blockState.localMemoryAddress = localMemoryAddress;
+	m_blockState.localMemoryWindow  = localMemory;
 	m_kernel = kernel;
 	
-	device_report("Setting up core sim block %p, %d threads, %d registers\n",
-		this, m_blockState.threadsPerBlock, m_blockState.registersPerThread);
+	if(m_blockState.localMemoryPerThread < localMemory)
+	{
+		m_blockState.localMemoryPerThread = localMemory;
+	}
+	
+	device_report("Setting up core sim block %p, %d threads, %d registers, "
+		"%d bytes of local memory\n", this, m_blockState.threadsPerBlock,
+		m_blockState.registersPerThread, m_blockState.localMemoryPerThread);
 
 	m_registerFiles = new Register[m_blockState.registersPerThread *
 		m_blockState.threadsPerBlock];
+	m_localMemory = new LocalMemory[m_blockState.localMemoryPerThread *
+		m_blockState.threadsPerBlock];
 		
 	m_threads = new CoreSimThread[m_blockState.threadsPerBlock];
 	m_warp    = m_threads + (threadIdx.x - getThreadIdInWarp());
@@ -303,8 +318,21 @@ __device__ void CoreSimBlock::setRegister(unsigned int threadId,
 }
 
 __device__ CoreSimThread::Value CoreSimBlock::translateVirtualToPhysical(
-	const CoreSimThread::Value v)
+	unsigned int threadId, const CoreSimThread::Value v)
 {
+	// Every thread uses the same addresses for its spill slots, each one
+	//  gets a private copy of the window
+	CoreSimThread::Value offset = v - m_blockState.localMemoryAddress;
+	
+	if(v >= m_blockState.localMemoryAddress &&
+		offset < m_blockState.localMemoryWindow)
+	{
+		LocalMemory* local = m_localMemory +
+			m_blockState.localMemoryPerThread * threadId + offset;
+		
+		return reinterpret_cast<CoreSimThread::Value>(local);
+	}
+	
 	return m_kernel->translateVirtualToPhysicalAddress(v);
 }
 
@@ -18,11 +18,34 @@ namespace archaeopteryx
 namespace executive
 {
 
+__device__ static uint64_t getIntegerSymbol(ir::Binary* binary,
+	const char* name, uint64_t defaultValue)
+{
+	if(binary->findSymbol(name) == 0) return defaultValue;
+	
+	if(binary->getSymbolSize(name) > sizeof(uint64_t)) return defaultValue;
+	
+	uint64_t value = 0;
+	
+	binary->copySymbolDataToAddress(&value, name);
+	
+	return value;
+}
+
 __device__ void CoreSimKernel::launchKernel(CoreSimBlock* blocks,
 	ir::Binary* binary)
 {
-	unsigned int registerCount = util::KnobDatabase::getKnob<unsigned int>(
-			"simulator-registers-per-thread");
+	// Binaries from the register budgeted compiler record their register
+	//  and spill memory usage, older ones fall back to the simulator default
+	unsigned int registerCount = getIntegerSymbol(binary,
+		"simulated-registers-per-thread",
+		util::KnobDatabase::getKnob<unsigned int>(
+			"simulator-registers-per-thread"));
+	
+	uint64_t localMemoryAddress = getIntegerSymbol(binary,
+		"simulated-local-memory-address", 0);
+	unsigned int localMemory = getIntegerSymbol(binary,
+		"simulated-local-memory-per-thread", 0);
 
 	for (unsigned int simulatedBlock = blockIdx.x;
 		simulatedBlock < simulatedBlocks; simulatedBlock += gridDim.x)
@@ -31,7 +54,7 @@ __device__ void CoreSimKernel::launchKernel(CoreSimBlock* blocks,
 		{
 			blocks[blockIdx.x].setupBinary(binary);
 			blocks[blockIdx.x].setupCoreSimBlock(simulatedBlock,
-				registerCount, this);
+				registerCount, localMemoryAddress, localMemory, this);
 		}
 
 		__syncthreads();
@@ -151,7 +151,7 @@ static __device__ ir::Binary::PC executeAtom(Instruction* instruction,
 	Value a = getOperand(atom->a, parentBlock, threadId);
 	Value b = getOperand(atom->b, parentBlock, threadId);
 
-	Value physical = parentBlock->translateVirtualToPhysical(a);
+	Value physical = parentBlock->translateVirtualToPhysical(threadId, a);
 
 	//TO DO
 	device_assert_m(false, "Atomic operations not supported yet.");
@@ -351,7 +351,7 @@ static __device__ ir::Binary::PC executeLd(Instruction* instruction,
 
 	Value a = getOperand(ld->a, parentBlock, threadId);
 
-	Value physical = parentBlock->translateVirtualToPhysical(a);
+	Value physical = parentBlock->translateVirtualToPhysical(threadId, a);
 
 	device_report(" Thread %d, loading from (%p virtual) (%p physical)\n",
 		threadId, a, physical);
@@ -556,7 +556,7 @@ static __device__ ir::Binary::PC executeSt(Instruction* instruction,
 	St* st = static_cast<St*>(instruction);
 
 	Value d = getOperand(st->d, parentBlock, threadId);
-	Value physical = parentBlock->translateVirtualToPhysical(d);
+	Value physical = parentBlock->translateVirtualToPhysical(threadId, d);
 
 	Value a = getOperand(st->a, parentBlock, threadId);
 
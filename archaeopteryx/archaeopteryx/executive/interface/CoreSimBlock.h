@@ -39,6 +39,8 @@ class CoreSimBlock
 				unsigned int blockId;
 				unsigned int registersPerThread;
 				unsigned int localMemoryPerThread;
+				uint64_t     localMemoryAddress;
+				unsigned int localMemoryWindow;
 				unsigned int threadsPerBlock;
 				unsigned int sharedMemoryPerBlock;
 				ir::Binary*  binary;
@@ -48,6 +50,7 @@ class CoreSimBlock
 		//FetchUnit m_fetchUnit;
 		typedef unsigned long long Register;
 		Register* m_registerFiles;
+		LocalMemory* m_localMemory;
 		BlockState m_blockState;
 		CoreSimThread* m_threads;
 		typedef CoreSimThread* Warp;
@@ -73,7 +76,8 @@ class CoreSimBlock
 		//  3) local memory for each thread
 		//  4) thread contexts
 		__device__ void setupCoreSimBlock(unsigned int blockId,
-			unsigned int registers, const CoreSimKernel* kernel);
+			unsigned int registers, uint64_t localMemoryAddress,
+			unsigned int localMemory, const CoreSimKernel* kernel);
 		__device__ void setupBinary(ir::Binary* binary);
 		__device__ ir::Binary* binary();   
  
@@ -85,7 +89,8 @@ class CoreSimBlock
 		// Interfaces to CoreSimThread
 		__device__ CoreSimThread::Value getRegister(unsigned int, unsigned int);
 		__device__ void setRegister(unsigned int, unsigned int, const CoreSimThread::Value&);
-		__device__ CoreSimThread::Value translateVirtualToPhysical(const CoreSimThread::Value);
+		__device__ CoreSimThread::Value translateVirtualToPhysical(unsigned int,
+			const CoreSimThread::Value);
 		__device__ void barrier(unsigned int);
 		__device__ unsigned int returned(unsigned int, unsigned int);
 		__device__ unsigned int getLinkRegister() const;
@@ -14,6 +14,9 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/asm/interface/Instruction.h>
+#include <vanaheimr/asm/interface/InstructionCodec.h>
+
+#include <vanaheimr/util/interface/LZCodec.h>
 
 
 #ifdef REPORT_BASE
@@ -68,6 +71,9 @@ __device__ Binary::~Binary()
 	device_report(" deleting symbol tables...\n");
 
 	delete[] _symbolTable;
+	delete[] _symbolBuckets;
+	delete[] _symbolChains;
+	delete[] _pageDirectory;
 	delete[] _codeSection;
 	delete[] _dataSection;
 	delete[] _stringSection;
@@ -81,6 +87,32 @@ __device__ Binary::SymbolTableEntry* Binary::findSymbol(const char* name)
 {
 	_loadSymbolTable();
 	
+	if(_loadSymbolIndex())
+	{
+		unsigned int hash = SymbolIndex::hash(name);
+		unsigned int next = _symbolBuckets[SymbolIndex::bucket(hash,
+			_header.symbolIndexBuckets)];
+		
+		for(unsigned int steps = 0; next < _header.symbols &&
+			steps < _header.symbols; ++steps)
+		{
+			SymbolTableEntry* symbol = _symbolTable + next;
+			
+			// Only compare names (which may fault in string pages)
+			//  when the hashes match
+			if(_symbolChains[next].hash == hash && _strcmp(
+				_header.stringsOffset + symbol->stringOffset, name) == 0)
+			{
+				return symbol;
+			}
+			
+			next = _symbolChains[next].next;
+		}
+		
+		return 0;
+	}
+	
+	// Binaries without an index fall back to a linear search
 	for(unsigned int i = 0; i < _header.symbols; ++i)
 	{
 		SymbolTableEntry* symbol = _symbolTable + i;
@@ -105,6 +137,13 @@ __device__ void Binary::copyCode(InstructionContainer* code, PC pc,
 	
 	device_report("Copying %d instructions at PC %d\n", instructions, pc);
 
+	if(_header.encoding == Header::CompactEncoding)
+	{
+		_decodeCode(code, pc, instructions);
+		
+		return;
+	}
+
 	while(instructions > 0)
 	{
 		size_t instructionsInThisPage =
@@ -154,6 +193,16 @@ __device__ void Binary::findFunction(page_iterator& page, unsigned int& offset,
 	
 	device_assert(symbol->type == SymbolTableEntry::FunctionType);
 	
+	if(_header.encoding == Header::CompactEncoding)
+	{
+		PC pc = _getPC(symbol->offset);
+		
+		page   = code_begin() + pc / _header.instructionsPerPage;
+		offset = pc % _header.instructionsPerPage;
+		
+		return;
+	}
+	
 	page   = code_begin() + _getCodePageId(symbol->offset);
 	offset = _getCodePageOffset(symbol->offset);
 }
@@ -270,15 +319,13 @@ __device__ void Binary::copyDataToAddress(void* address, uint64_t offset,
 
 __device__ Binary::PC Binary::findFunctionsPC(const char* name)
 {
-	page_iterator page  = 0;
-	unsigned int offset = 0;
-
-	findFunction(page, offset, name);
+	SymbolTableEntry* symbol = findSymbol(name);
 	
-	const size_t instructionsPerPage = sizeof(PageDataType) /
-		sizeof(InstructionContainer);
+	if(symbol == 0) return 0;
+	
+	device_assert(symbol->type == SymbolTableEntry::FunctionType);
 	
-	return instructionsPerPage * (page - code_begin()) + offset;
+	return _getPC(symbol->offset);
 }
 
 __device__ Binary::page_iterator Binary::code_begin()
@@ -322,9 +369,7 @@ __device__ Binary::PageDataType* Binary::getCodePage(page_iterator page)
 		device_report("Loading code page (%p) at offset (%p) now...\n",
 			page, offset);
 	
-		_file->seekg(offset);
-		*page = (PageDataType*)new PageDataType;
-		_file->read(*page, sizeof(PageDataType));
+		*page = _readPage(offset, page - code_begin());
 
 		_unlock(page);
 	
@@ -345,9 +390,7 @@ __device__ Binary::PageDataType* Binary::getDataPage(page_iterator page)
 		device_report("Loading data page (%p) at offset (%p) now...\n",
 			page, offset);
 
-		_file->seekg(offset);
-		*page = (PageDataType*)new PageDataType;
-		_file->read(*page, sizeof(PageDataType));
+		*page = _readPage(offset, _header.codePages + (page - data_begin()));
 		
 		_unlock(page);
 
@@ -390,12 +433,19 @@ __device__ void Binary::_loadHeader()
 	device_report("Loading header (%p magic)\n", _header.magic);
 	
 	device_assert(_header.magic == Header::MagicNumber);
+	device_assert(_header.version <= Header::CurrentVersion);
+	device_assert(_header.encoding == Header::FixedEncoding ||
+		(_header.encoding == Header::CompactEncoding &&
+		_header.instructionsPerPage != 0));
 	
 	_dataSection   = new PagePointer[_header.dataPages];
 	_codeSection   = new PagePointer[_header.codePages];
 	_stringSection = new PagePointer[_header.stringPages];
 
-	_symbolTable = 0;
+	_symbolTable   = 0;
+	_symbolBuckets = 0;
+	_symbolChains  = 0;
+	_pageDirectory = 0;
 
 	util::memset(_dataSection,   0, _header.dataPages   * sizeof(PagePointer));
 	util::memset(_codeSection,   0, _header.codePages   * sizeof(PagePointer));
@@ -416,6 +466,8 @@ __device__ void Binary::_loadHeader()
 		_locks.insert(util::make_pair(page, Lock()));
 	}
 	
+	_loadPageDirectory();
+	
 	device_report("Loaded binary (%d data pages, %d code pages, "
 		"%d symbols, %d string pages)\n", _header.dataPages, _header.codePages,
 		_header.symbols, _header.stringPages);
@@ -442,6 +494,92 @@ __device__ void Binary::_loadSymbolTable()
 	device_report("   loaded %d symbols...\n", _header.symbols);
 }
 
+__device__ bool Binary::_loadSymbolIndex()
+{
+	if(_header.version < 1 || _header.symbolIndexBuckets == 0) return false;
+	if(_symbolBuckets != 0) return true;
+
+	device_report(" Loading symbol index now (%d buckets).\n",
+		_header.symbolIndexBuckets);
+
+	_symbolBuckets = new uint32_t[_header.symbolIndexBuckets];
+	_symbolChains  = new SymbolIndexEntry[_header.symbols];
+
+	_file->seekg(_header.symbolIndexOffset);
+
+	_file->read(_symbolBuckets,
+		_header.symbolIndexBuckets * sizeof(uint32_t));
+	_file->read(_symbolChains, _header.symbols * sizeof(SymbolIndexEntry));
+
+	return true;
+}
+
+__device__ void Binary::_loadPageDirectory()
+{
+	if(_header.version < 2) return;
+	if(_header.compression == Header::NoCompression) return;
+
+	device_assert(_header.compression == Header::PageCompression);
+	device_assert(_header.directoryEntries ==
+		_header.codePages + _header.dataPages);
+
+	device_report(" Loading page directory now (%d entries).\n",
+		_header.directoryEntries);
+
+	_pageDirectory = new PageDirectoryEntry[_header.directoryEntries];
+
+	_file->seekg(_header.pageDirectoryOffset);
+	_file->read(_pageDirectory,
+		_header.directoryEntries * sizeof(PageDirectoryEntry));
+}
+
+__device__ Binary::PagePointer Binary::_readPage(size_t offset,
+	unsigned int directoryIndex)
+{
+	PagePointer page = (PageDataType*)new PageDataType;
+
+	if(_pageDirectory == 0)
+	{
+		_file->seekg(offset);
+		_file->read(page, sizeof(PageDataType));
+
+		return page;
+	}
+
+	device_assert(directoryIndex < _header.directoryEntries);
+
+	const PageDirectoryEntry& entry = _pageDirectory[directoryIndex];
+
+	_file->seekg(entry.offset);
+
+	if(entry.method == PageDirectoryEntry::Stored)
+	{
+		device_assert(entry.size == sizeof(PageDataType));
+
+		_file->read(page, sizeof(PageDataType));
+
+		return page;
+	}
+
+	device_assert(entry.method == PageDirectoryEntry::LZ);
+
+	device_report("  expanding page from %d compressed bytes\n",
+		(int)entry.size);
+
+	char* compressed = new char[entry.size];
+
+	_file->read(compressed, entry.size);
+
+	bool success = vanaheimr::util::LZCodec::decompress(compressed,
+		entry.size, page, sizeof(PageDataType));
+
+	delete[] compressed;
+
+	device_assert(success);
+
+	return page;
+}
+
 __device__ size_t Binary::_getCodePageOffset(page_iterator page)
 {
 	return _header.codeOffset +	(page - code_begin()) * sizeof(PageDataType);
@@ -565,6 +703,35 @@ __device__ int Binary::_strlen(unsigned int stringTableOffset)
 	return length;
 }
 
+__device__ Binary::PC Binary::_getPC(size_t offset)
+{
+	device_assert(offset >= _header.codeOffset);
+	
+	// Code symbols are laid out as fixed size instructions in any encoding
+	return (offset - _header.codeOffset) / sizeof(InstructionContainer);
+}
+
+__device__ void Binary::_decodeCode(InstructionContainer* code, PC pc,
+	unsigned int instructions)
+{
+	const unsigned int instructionsPerPage = _header.instructionsPerPage;
+	
+	for(unsigned int i = 0; i < instructions; ++i, ++pc)
+	{
+		page_iterator page = code_begin() + pc / instructionsPerPage;
+		
+		device_assert(page < code_end());
+		
+		PageDataType* pageData = getCodePage(page);
+		device_assert(pageData != 0);
+		
+		bool success = vanaheimr::as::InstructionCodec::decode(pageData,
+			pc % instructionsPerPage, instructionsPerPage, code[i]);
+		
+		device_assert(success);
+	}
+}
+
 __device__ unsigned int Binary::_getCodePageId(size_t offset)
 {
 	device_assert(offset >= _header.codeOffset);
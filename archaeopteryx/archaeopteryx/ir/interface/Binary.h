@@ -14,6 +14,8 @@
 // Vanaheimr Includes
 #include <vanaheimr/asm/interface/BinaryHeader.h>
 #include <vanaheimr/asm/interface/SymbolTableEntry.h>
+#include <vanaheimr/asm/interface/SymbolIndex.h>
+#include <vanaheimr/asm/interface/PageDirectory.h>
 
 #include <vanaheimr/util/interface/IntTypes.h>
 
@@ -45,6 +47,9 @@ public:
 	/*! \brief A binary header */
 	typedef vanaheimr::as::BinaryHeader     Header;
 	typedef vanaheimr::as::SymbolTableEntry SymbolTableEntry;
+	typedef vanaheimr::as::SymbolIndex      SymbolIndex;
+	typedef vanaheimr::as::SymbolIndexEntry SymbolIndexEntry;
+	typedef vanaheimr::as::PageDirectoryEntry PageDirectoryEntry;
 
 	/*! \brief A 32-KB page */
 	static const unsigned int PageSize = Header::PageSize / sizeof(uint32_t);
@@ -78,7 +83,8 @@ public:
 public:	
 	/*! \brief Find a symbol by name */
 	__device__ SymbolTableEntry* findSymbol(const char* name);
-	/*! \brief Find a function by name */
+	/*! \brief Find a function by name, the offset is in bytes for fixed
+		size instructions and in instructions for compact code pages */
 	__device__ void findFunction(page_iterator& page, unsigned int& offset,
 		const char* name);
 	/*! \brief Find a variable by name */
@@ -137,6 +143,14 @@ private:
 
 	/*! \brief Load the symbol table */
 	__device__ void _loadSymbolTable();
+	/*! \brief Load the symbol index, if the binary has one */
+	__device__ bool _loadSymbolIndex();
+	/*! \brief Load the page directory of a compressed binary */
+	__device__ void _loadPageDirectory();
+
+	/*! \brief Read a code or data page, expanding it if it is compressed */
+	__device__ PagePointer _readPage(size_t offset,
+		unsigned int directoryIndex);
 
 	/*! \brief Get an offset in the file for a specific code page */
 	__device__ size_t _getCodePageOffset(page_iterator page);
@@ -154,6 +168,12 @@ private:
 		unsigned int size);
 
 private:
+	/*! \brief Get the PC of a code symbol offset */
+	__device__ PC _getPC(size_t offset);
+	/*! \brief Copy instructions from compact code pages */
+	__device__ void _decodeCode(InstructionContainer* code, PC pc,
+		unsigned int instructions);
+
 	/*! \brief Get the page number for a specific offset in the file */
 	__device__ unsigned int _getCodePageId(size_t offset);
 	/*! \brief Get the page offset for a specific offset in the file */
@@ -195,6 +215,14 @@ private:
 	/*! \brief The actual symbol table */
 	SymbolTableEntry* _symbolTable;
 
+	/*! \brief The heads of the symbol index hash chains */
+	uint32_t*         _symbolBuckets;
+	/*! \brief The symbol index hash chains, one entry per symbol */
+	SymbolIndexEntry* _symbolChains;
+
+	/*! \brief Where compressed code and data pages are in the file */
+	PageDirectoryEntry* _pageDirectory;
+
 private:
 	class Lock
 	{
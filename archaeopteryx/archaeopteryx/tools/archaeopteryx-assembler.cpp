@@ -0,0 +1,114 @@
+/*! \file   archaeopteryx-assembler.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the archaeopteryx-assembler tool.
+*/
+
+// Archaeopteryx Includes
+#include <archaeopteryx/assembler/interface/Parser.h>
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/BinaryWriter.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace archaeopteryx
+{
+
+static void assemble(const std::string& inputFileName,
+	const std::string& outputFileName, bool compress, unsigned int threads)
+{
+	typedef vanaheimr::compiler::Compiler Compiler;
+
+	vanaheimr::ir::Module* module = nullptr;
+
+	try
+	{
+		assembler::Parser parser(Compiler::getSingleton());
+
+		module = parser.parse(inputFileName);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "Assembler Failed: parsing failed.\n";
+		std::cerr << "  Message: " << e.what() << "\n";
+		return;
+	}
+
+	std::ios_base::openmode oMode = std::ios_base::out | std::ios_base::binary;
+
+	std::ofstream outputVirFile(outputFileName.c_str(), oMode);
+
+	if(!outputVirFile.is_open())
+	{
+		std::cerr << "Assembler Failed: could not open VIR file '"
+			<< outputFileName << "' for writing.\n";
+
+		return;
+	}
+
+	try
+	{
+		vanaheimr::as::BinaryWriter writer(compress ?
+			vanaheimr::as::BinaryHeader::PageCompression :
+			vanaheimr::as::BinaryHeader::NoCompression, threads);
+
+		writer.write(outputVirFile, *module);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "Assembler Failed: binary writing failed.\n";
+		std::cerr << "  Message: " << e.what() << "\n";
+		return;
+	}
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	std::string inputFileName;
+	std::string outputFileName;
+
+	bool verbose  = false;
+	bool compress = false;
+
+	unsigned int threads = 1;
+
+	parser.description("This program assembles a textual VIR file into a "
+		"VIR binary that can be loaded by the simulator.");
+
+	parser.parse("-i", "--input" ,  inputFileName,
+		"", "The input textual VIR file path.");
+	parser.parse("-o", "--output",  outputFileName,
+		"", "The output VIR binary path.");
+	parser.parse("-v", "--verbose", verbose, false,
+		"Print out log messages during execution");
+	parser.parse("-c", "--compress", compress, false,
+		"Compress the code and data pages of the output binary.");
+	parser.parse("-t", "--threads", threads, 1,
+		"Threads used to write the output binary (0 for all cores).");
+	parser.parse();
+
+	if(verbose)
+	{
+		hydrazine::enableAllLogs();
+	}
+
+	archaeopteryx::assemble(inputFileName, outputFileName, compress, threads);
+
+	return 0;
+}
+
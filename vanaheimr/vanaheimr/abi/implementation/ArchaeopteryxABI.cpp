@@ -25,6 +25,8 @@ ApplicationBinaryInterface* getArchaeopteryxABI()
 	// Memory Regions
 	archaeopteryxABI->insert(new FixedAddressRegion(
 		"parameter", 1024, 8, ir::Global::Shared, 4096));
+	archaeopteryxABI->insert(new FixedAddressRegion(
+		"spill", 1024, 8, ir::Global::Thread, 8192));
 
 	// Bound Variables
 	archaeopteryxABI->insert(new RegisterBoundVariable(
@@ -82,8 +82,8 @@ const ir::Function* ControlFlowGraph::function() const
 void ControlFlowGraph::analyze(Function& function)
 {
 	// perform the analysis sequentially
-	  _successors.resize(function.size());
-	_predecessors.resize(function.size());
+	  _successors.resize(function.block_capacity());
+	_predecessors.resize(function.block_capacity());
 		
 	_function = &function;
 		
@@ -62,7 +62,7 @@ DataflowAnalysis::InstructionSet
 		auto writeOperand = static_cast<ir::RegisterOperand*>(write);
 	
 		auto localDefinitions = getReachingDefinitions(
-			*writeOperand->virtualRegister);
+			*writeOperand->virtualRegister());
 	
 		definitions.insert(localDefinitions.begin(), localDefinitions.end());
 	}
@@ -81,7 +81,7 @@ DataflowAnalysis::InstructionSet
 	
 		auto readOperand = static_cast<ir::RegisterOperand*>(read);
 	
-		auto localUses = getReachedUses(*readOperand->virtualRegister);
+		auto localUses = getReachedUses(*readOperand->virtualRegister());
 	
 		uses.insert(localUses.begin(), localUses.end());
 	}
@@ -127,8 +127,8 @@ void DataflowAnalysis::analyze(Function& function)
 
 void DataflowAnalysis::_analyzeLiveInsAndOuts(Function& function)
 {
-	 _liveins.resize(function.size());
-	_liveouts.resize(function.size());
+	 _liveins.resize(function.block_capacity());
+	_liveouts.resize(function.block_capacity());
 	
 	BasicBlockSet worklist;
 	
@@ -146,54 +146,39 @@ void DataflowAnalysis::_analyzeLiveInsAndOuts(Function& function)
 
 void DataflowAnalysis::_analyzeReachingDefinitions(Function& function)
 {
-	// For each instruction, create a writer set and a reader set
-	//  gather them together 
+	// Each register already knows the operands that refer to it,
+	//  so just gather the instructions that own them
 	
 	_reachingDefinitions.clear();
 	        _reachedUses.clear();
 	
-	_reachingDefinitions.resize(function.register_size());
-	        _reachedUses.resize(function.register_size());
-	
+	_reachingDefinitions.resize(function.register_capacity());
+	        _reachedUses.resize(function.register_capacity());
 	
 	// parallel for-all
-	for(auto block = function.begin(); block != function.end(); ++block)
+	for(auto value = function.register_begin();
+		value != function.register_end(); ++value)
 	{
-		for(auto instruction : *block)
-		{
-			VirtualRegisterSet localDefinitions;
-			VirtualRegisterSet localUses;
+		auto& definitions = _reachingDefinitions[value->id];
+		auto& uses        =         _reachedUses[value->id];
 		
-			// find values that are written to
-			for(auto write : instruction->writes)
-			{
-				if(!write->isRegister()) continue;
-			
-				auto registerWrite = static_cast<ir::RegisterOperand*>(write);
+		for(auto operand = value->operand_begin();
+			operand != value->operand_end(); ++operand)
+		{
+			if(!(*operand)->isRegister()) continue;
 			
-				localDefinitions.insert(registerWrite->virtualRegister);
-			}
-
-			// find values that are read from
-			for(auto read : instruction->reads)
-			{
-				if(!read->isRegister()) continue;
+			auto instruction = (*operand)->instruction;
 			
-				auto registerRead = static_cast<ir::RegisterOperand*>(read);
+			// skip operands of instructions that are not in a block
+			if(instruction == nullptr || !instruction->isLinked()) continue;
 			
-				localUses.insert(registerRead->virtualRegister);
-			}
-		
-			// insert the instruction into the read value's user set
-			for(auto readValue : localUses)
+			if((*operand)->isDefinition())
 			{
-				_reachedUses[readValue->id].insert(instruction);
+				definitions.insert(instruction);
 			}
-		
-			// insert the instruction into the written value's def set
-			for(auto writtenValue : localDefinitions)
+			else if((*operand)->isUse())
 			{
-				_reachingDefinitions[writtenValue->id].insert(instruction);
+				uses.insert(instruction);
 			}
 		}
 	}
@@ -250,7 +235,7 @@ bool DataflowAnalysis::_recomputeLiveInsAndOutsForBlock(BasicBlock* block)
 		
 			auto reg = static_cast<ir::RegisterOperand*>(read);
 
-			livein.insert(reg->virtualRegister);
+			livein.insert(reg->virtualRegister());
 		}
 
 		// kill on defs
@@ -260,7 +245,7 @@ bool DataflowAnalysis::_recomputeLiveInsAndOutsForBlock(BasicBlock* block)
 		
 			auto reg = static_cast<ir::RegisterOperand*>(write);
 
-			livein.erase(reg->virtualRegister);
+			livein.erase(reg->virtualRegister());
 		}
 	}
 
@@ -143,7 +143,7 @@ static bool hasDataflowDependence(const ir::Instruction& predecessor,
 	
 		auto registerOperand = static_cast<ir::RegisterOperand*>(write);
 	
-		writes.insert(registerOperand->virtualRegister);
+		writes.insert(registerOperand->virtualRegister());
 	}
 	
 	for(auto read : successor.reads)
@@ -152,7 +152,7 @@ static bool hasDataflowDependence(const ir::Instruction& predecessor,
 	
 		auto registerOperand = static_cast<ir::RegisterOperand*>(read);
 	
-		if(writes.count(registerOperand->virtualRegister) != 0) return true;
+		if(writes.count(registerOperand->virtualRegister()) != 0) return true;
 	}
 	
 	return false;
@@ -43,9 +43,22 @@ DominatorAnalysis::DominatorAnalysis()
 bool DominatorAnalysis::dominates(const BasicBlock& b,
 	const BasicBlock& potentialDominator)
 {
-	auto dominatedBlocks = getDominatedBlocks(potentialDominator);
+	// Walk up the tree, the dominated sets only hold the immediate children
+	auto block = const_cast<BasicBlock*>(&b);
 
-	return dominatedBlocks.count(const_cast<BasicBlock*>(&b)) != 0;
+	while(block != nullptr)
+	{
+		if(block == &potentialDominator) return true;
+
+		auto dominator = getDominator(*block);
+
+		// The entry is its own immediate dominator
+		if(dominator == block) break;
+
+		block = dominator;
+	}
+
+	return false;
 }
 
 DominatorAnalysis::BasicBlock* DominatorAnalysis::getDominator(
@@ -113,7 +126,7 @@ void DominatorAnalysis::_determineImmediateDominators(Function& function)
 		getAnalysis("ReversePostOrderTraversal"));
 	
 	// Determine post order numbers
-	IntVector postOrderNumbers(function.size());
+	IntVector postOrderNumbers(function.block_capacity());
 	
 	report(" creating post order sequence...");
 	for(auto block = reversePostOrder->order.begin();
@@ -126,7 +139,7 @@ void DominatorAnalysis::_determineImmediateDominators(Function& function)
 	}
 	
 	// All blocks start being uninitialized
-	_immediateDominators.assign(function.size(), nullptr);
+	_immediateDominators.assign(function.block_capacity(), nullptr);
 	
 	// The entry starts dominating itself
 	_immediateDominators[function.entry_block()->id()] =
@@ -185,7 +198,7 @@ void DominatorAnalysis::_determineImmediateDominators(Function& function)
 		}
 	}
 
-	_dominatedBlocks.resize(function.size());
+	_dominatedBlocks.resize(function.block_capacity());
 }
 
 void DominatorAnalysis::_determineDominatedSets(Function& function)
@@ -201,7 +214,7 @@ void DominatorAnalysis::_determineDominatedSets(Function& function)
 
 void DominatorAnalysis::_determineDominanceFrontiers(Function& function)
 {
-	_dominanceFrontiers.resize(function.size());
+	_dominanceFrontiers.resize(function.block_capacity());
 
 	auto cfg = static_cast<ControlFlowGraph*>(getAnalysis("ControlFlowGraph"));
 	
@@ -74,7 +74,7 @@ void InterferenceAnalysis::analyze(Function& function)
 		getAnalysis("LiveRangeAnalysis"));
 	assert(ranges != nullptr);
 
-	_interferences.resize(function.register_size());
+	_interferences.resize(function.register_capacity());
 
 	// map live ranges into partiions that are alive in the same blocks
 	auto blocksToRanges = mapBlocksToLiveRanges(ranges);
@@ -37,7 +37,8 @@ public:
 	DominatorAnalysis();
 
 public:
-	/*! \brief Is a block dominated by another? */
+	/*! \brief Is a block dominated by another?  Every block dominates
+		itself. */
 	bool dominates(const BasicBlock& b, const BasicBlock& potentialDominator);
 
 	/*! \brief Find the immediate dominator of a given block */
@@ -0,0 +1,220 @@
+/*! \file   test-dominator-analysis.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the test-dominator-analysis test.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/analysis/interface/DominatorAnalysis.h>
+
+#include <vanaheimr/transforms/interface/Pass.h>
+#include <vanaheimr/transforms/interface/PassManager.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/Function.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <iostream>
+#include <vector>
+#include <string>
+
+namespace test
+{
+
+namespace ir       = vanaheimr::ir;
+namespace analysis = vanaheimr::analysis;
+
+typedef std::vector<ir::BasicBlock*> BasicBlockVector;
+
+/*! \brief Compare the analysis against the expected dominator relation */
+class DominatorCheckPass : public vanaheimr::transforms::FunctionPass
+{
+public:
+	/*! \brief A block and a block that should or should not dominate it */
+	class Query
+	{
+	public:
+		Query(const std::string& b, const std::string& d, bool e)
+		: block(b), dominator(d), expected(e) {}
+
+	public:
+		std::string block;
+		std::string dominator;
+		bool        expected;
+	};
+
+	typedef std::vector<Query> QueryVector;
+
+public:
+	DominatorCheckPass(const QueryVector& q)
+	: FunctionPass(StringVector({"ControlFlowGraph", "DominatorAnalysis"}),
+		"DominatorCheckPass"), queries(q), passed(true)
+	{
+
+	}
+
+public:
+	virtual void runOnFunction(Function& function)
+	{
+		auto dominators = static_cast<analysis::DominatorAnalysis*>(
+			getAnalysis("DominatorAnalysis"));
+
+		for(auto& query : queries)
+		{
+			auto block     = findBlock(function, query.block);
+			auto dominator = findBlock(function, query.dominator);
+
+			bool dominates = dominators->dominates(*block, *dominator);
+
+			std::cout << " " << query.dominator
+				<< (dominates ? " dominates " : " does not dominate ")
+				<< query.block << "\n";
+
+			if(dominates != query.expected)
+			{
+				std::cout << "  expected the opposite.\n";
+				passed = false;
+			}
+		}
+	}
+
+	virtual Pass* clone() const
+	{
+		return new DominatorCheckPass(queries);
+	}
+
+public:
+	QueryVector queries;
+	bool        passed;
+
+private:
+	static ir::BasicBlock* findBlock(Function& function,
+		const std::string& name)
+	{
+		for(auto& block : function)
+		{
+			if(block.name() == name) return &block;
+		}
+
+		return nullptr;
+	}
+
+};
+
+/*! \brief Build the loop
+
+	entry -> header -> body -> side -> latch -> done -> exit
+	                   body --------->  latch
+	                          header <- latch
+
+	so that the latch is dominated by the header through the body,
+	but is not an immediate child of the header.
+*/
+static void buildLoop(ir::Module& module)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto predicateType = compiler->getType("i1");
+
+	auto function = module.newFunction("loop",
+		ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility);
+
+	BasicBlockVector blocks;
+
+	for(auto name : {"header", "body", "side", "latch", "done"})
+	{
+		blocks.push_back(&*function->newBasicBlock(function->exit_block(),
+			name));
+	}
+
+	auto header = blocks[0];
+	auto body   = blocks[1];
+	auto latch  = blocks[3];
+
+	auto condition = &*function->newVirtualRegister(predicateType);
+
+	// body skips over side
+	auto skip = new ir::Bra(ir::Bra::UniformBranch, body);
+
+	skip->setGuard(new ir::PredicateOperand(condition,
+		ir::PredicateOperand::StraightPredicate, skip));
+	skip->setTarget(new ir::AddressOperand(latch, skip));
+
+	body->push_back(skip);
+
+	// latch branches back to the header or falls through to done
+	auto back = new ir::Bra(ir::Bra::UniformBranch, latch);
+
+	back->setGuard(new ir::PredicateOperand(condition,
+		ir::PredicateOperand::StraightPredicate, back));
+	back->setTarget(new ir::AddressOperand(header, back));
+
+	latch->push_back(back);
+}
+
+static bool testLoopDominators()
+{
+	typedef DominatorCheckPass::Query       Query;
+	typedef DominatorCheckPass::QueryVector QueryVector;
+
+	QueryVector queries =
+	{
+		// The back edge, the header is two levels above the latch
+		Query("latch",  "header", true),
+		Query("side",   "header", true),
+		Query("done",   "header", true),
+		Query("done",   "body",   true),
+		Query("latch",  "latch",  true),
+		Query("latch",  "side",   false),
+		Query("header", "latch",  false),
+		Query("header", "body",   false),
+		Query("body",   "done",   false)
+	};
+
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	ir::Module module("test-dominator-analysis", compiler);
+
+	buildLoop(module);
+
+	auto check = new DominatorCheckPass(queries);
+
+	vanaheimr::transforms::PassManager manager(&module);
+
+	manager.addPass(check);
+
+	manager.runOnFunction("loop");
+
+	return check->passed;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	parser.description("This program checks the dominator analysis on a "
+		"loop with a multi-block body.");
+	parser.parse();
+
+	if(!test::testLoopDominators())
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	std::cout << "Test Passed\n";
+
+	return 0;
+}
+
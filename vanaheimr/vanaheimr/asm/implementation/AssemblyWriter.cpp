@@ -40,6 +40,8 @@ void AssemblyWriter::write(std::ostream& stream, const ir::Module& module)
 
 	for(auto function = module.begin(); function != module.end(); ++function)
 	{
+		module.materialize(function);
+
 		writeFunction(stream, *function);
 	}
 	
@@ -50,6 +52,11 @@ void AssemblyWriter::write(std::ostream& stream, const ir::Module& module)
 	}
 }
 
+void AssemblyWriter::write(std::ostream& stream, const ir::Function& function)
+{
+	writeFunction(stream, function);
+}
+
 void AssemblyWriter::writeFunction(std::ostream& stream,
 	const ir::Function& function)
 {
@@ -276,7 +283,7 @@ void AssemblyWriter::writeOperand(std::ostream& stream, const ir::Operand& o)
 		const ir::RegisterOperand& operand =
 			static_cast<const ir::RegisterOperand&>(o);
 		
-		writeVirtualRegister(stream, *operand.virtualRegister);
+		writeVirtualRegister(stream, *operand.virtualRegister());
 		
 		break;
 	}
@@ -308,7 +315,7 @@ void AssemblyWriter::writeOperand(std::ostream& stream, const ir::Operand& o)
 		{
 			stream << "@";
 			
-			writeVirtualRegister(stream, *operand.virtualRegister);
+			writeVirtualRegister(stream, *operand.virtualRegister());
 
 			break;
 		}
@@ -332,7 +339,7 @@ void AssemblyWriter::writeOperand(std::ostream& stream, const ir::Operand& o)
 			static_cast<const ir::IndirectOperand&>(o);
 		
 		stream << "[ ";
-		writeVirtualRegister(stream, *operand.virtualRegister);
+		writeVirtualRegister(stream, *operand.virtualRegister());
 	
 		stream << " + " << std::hex << operand.offset << std::dec << " ]";
 		
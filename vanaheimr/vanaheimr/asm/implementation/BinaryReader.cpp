@@ -6,11 +6,15 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/asm/interface/BinaryReader.h>
+#include <vanaheimr/asm/interface/InstructionCodec.h>
 
 #include <vanaheimr/compiler/interface/Compiler.h>
 
 #include <vanaheimr/ir/interface/Module.h>
 
+#include <vanaheimr/util/interface/MappedFile.h>
+#include <vanaheimr/util/interface/LZCodec.h>
+
 // Hydrazine Includes
 #include <hydrazine/interface/string.h>
 #include <hydrazine/interface/debug.h>
@@ -18,6 +22,8 @@
 // Standard Library Includes
 #include <stdexcept>
 #include <unordered_set>
+#include <mutex>
+#include <cstring>
 
 // Preprocessor Macros
 #ifdef REPORT_BASE
@@ -32,13 +38,87 @@ namespace vanaheimr
 namespace as
 {
 
+/*! \brief Decodes the function bodies of a mapped binary on demand */
+class BinaryFunctionMaterializer : public ir::FunctionMaterializer
+{
+private:
+	typedef BinaryReader::symbol_iterator symbol_iterator;
+	typedef std::unordered_map<const ir::Function*, symbol_iterator>
+		FunctionToSymbolMap;
+
+public:
+	BinaryFunctionMaterializer(BinaryReader* reader)
+	: _reader(reader)
+	{
+
+	}
+
+public:
+	void addFunction(const ir::Function& function, symbol_iterator symbol)
+	{
+		_pending.insert(std::make_pair(&function, symbol));
+	}
+
+public:
+	bool isMaterialized(const ir::Function& function) const
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		return _pending.count(&function) == 0;
+	}
+
+	void materialize(ir::Function& function)
+	{
+		// The reader keeps per-function state, load one body at a time
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		auto pending = _pending.find(&function);
+
+		if(pending == _pending.end()) return;
+
+		report("Materializing function '" << function.name() << "'");
+
+		auto symbol = pending->second;
+
+		_pending.erase(pending);
+
+		_reader->_loadFunctionBody(function, *symbol);
+	}
+
+	void discard(const ir::Function& function)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_pending.erase(&function);
+	}
+
+private:
+	std::unique_ptr<BinaryReader> _reader;
+	FunctionToSymbolMap           _pending;
+	mutable std::mutex            _mutex;
+};
+
+BinaryReader::PagedSection::PagedSection()
+: directory(nullptr)
+{
+
+}
+
+BinaryReader::BinaryReader()
+: _file(nullptr), _fileSize(0), _firstDecodedPC(0), _function(nullptr)
+{
+
+}
+
+BinaryReader::~BinaryReader()
+{
+
+}
+
 ir::Module* BinaryReader::read(std::istream& stream, const std::string& name)
 {
-	      _readHeader(stream);
-	 _readDataSection(stream);
-	 _readStringTable(stream);
-	 _readSymbolTable(stream);
-	_readInstructions(stream);
+	_readFile(stream);
+	_readSections();
 
 	ir::Module* module = new ir::Module(name,
 		compiler::Compiler::getSingleton());
@@ -51,23 +131,118 @@ ir::Module* BinaryReader::read(std::istream& stream, const std::string& name)
 	return module;
 }
 
-void BinaryReader::_readHeader(std::istream& stream)
+ir::Module* BinaryReader::map(const std::string& path, const std::string& name)
+{
+	// The materializer outlives this reader, it gets a reader of its own
+	std::unique_ptr<BinaryReader> reader(new BinaryReader);
+
+	reader->_mapping.reset(new util::MappedFile(path));
+
+	reader->_file     = reader->_mapping->data();
+	reader->_fileSize = reader->_mapping->size();
+
+	reader->_readSections();
+	reader->_loadTypes();
+
+	std::unique_ptr<ir::Module> module(new ir::Module(name,
+		compiler::Compiler::getSingleton()));
+
+	reader->_loadGlobals(*module);
+	reader->_loadArguments(*module);
+
+	auto materializer = new BinaryFunctionMaterializer(reader.get());
+
+	BinaryReader* lazyReader = reader.release();
+
+	module->setMaterializer(materializer);
+
+	for(auto symbol = lazyReader->_symbolTable.begin();
+		symbol != lazyReader->_symbolTable.end(); ++symbol)
+	{
+		if(symbol->type != SymbolTableEntry::FunctionType) continue;
+
+		auto variable = lazyReader->_getVariableAtSymbolOffset(
+			lazyReader->_getSymbolOffset(symbol));
+
+		materializer->addFunction(*static_cast<ir::Function*>(variable),
+			symbol);
+	}
+
+	report("Mapped binary, " << module->size()
+		<< " functions will be loaded on demand...");
+
+	return module.release();
+}
+
+void BinaryReader::_readFile(std::istream& stream)
+{
+	stream.seekg(0, std::ios::end);
+
+	std::streamoff size = stream.tellg();
+
+	if(size < 0)
+	{
+		throw std::runtime_error("Failed to read binary, the stream is "
+			"not seekable.");
+	}
+
+	stream.seekg(0, std::ios::beg);
+
+	_buffer.resize(size);
+
+	stream.read(_buffer.data(), size);
+
+	if(stream.gcount() != size)
+	{
+		throw std::runtime_error("Failed to read binary, hit EOF.");
+	}
+
+	_file     = _buffer.data();
+	_fileSize = _buffer.size();
+}
+
+void BinaryReader::_readSections()
+{
+	      _readHeader();
+	_readPageDirectory();
+	 _readDataSection();
+	 _readStringTable();
+	 _readSymbolTable();
+	_readInstructions();
+	 _readSymbolIndex();
+}
+
+void BinaryReader::_readHeader()
 {
 	report("Reading header...");
-	stream.read((char*)&_header, sizeof(BinaryHeader));
 
-	if(stream.gcount() != sizeof(BinaryHeader))
+	if(_fileSize < sizeof(BinaryHeader))
 	{
 		throw std::runtime_error("Failed to read binary "
 			"header, hit EOF.");
 	}
 
+	std::memcpy(&_header, _file, sizeof(BinaryHeader));
+
 	if(_header.magic != BinaryHeader::MagicNumber)
 	{
 		throw std::runtime_error("Failed to read binary "
 			"header, invalid magic number.");
 	}
 
+	if(_header.version > BinaryHeader::CurrentVersion)
+	{
+		std::stringstream message;
+
+		message << "Failed to read binary header, format version "
+			<< _header.version << " is newer than the supported version "
+			<< BinaryHeader::CurrentVersion << ".";
+
+		throw std::runtime_error(message.str());
+	}
+
+	report(" version:       " << _header.version);
+
 	report(" data pages:    " << _header.dataPages);
 	report(" code pages:    " << _header.codePages);
 	report(" symbols:       " << _header.symbols);
@@ -77,92 +252,263 @@ void BinaryReader::_readHeader(std::istream& stream)
 	report(" symbol offset: " << _header.symbolOffset);
 	report(" string offset: " << _header.stringsOffset);
 	report(" name offset:   " << _header.nameOffset);
+	report(" index buckets: " << _header.symbolIndexBuckets);
+	report(" index offset:  " << _header.symbolIndexOffset);
+	report(" compression:   " << _header.compression);
+	report(" encoding:      " << _header.encoding);
+
+	if(_header.encoding == BinaryHeader::CompactEncoding)
+	{
+		report(" instructions per page: " << _header.instructionsPerPage);
+
+		if(_header.instructionsPerPage == 0 || _header.instructionsPerPage
+			* sizeof(uint16_t) >= BinaryHeader::PageSize)
+		{
+			throw std::runtime_error("Failed to read binary header, invalid "
+				"number of instructions per code page.");
+		}
+	}
+	else if(_header.encoding != BinaryHeader::FixedEncoding)
+	{
+		std::stringstream message;
+
+		message << "Failed to read binary header, unknown instruction "
+			"encoding " << _header.encoding << ".";
+
+		throw std::runtime_error(message.str());
+	}
 }
 
-void BinaryReader::_readDataSection(std::istream& stream)
+void BinaryReader::_readDataSection()
 {
-	size_t dataSize = BinaryHeader::PageSize * _header.dataPages;
+	size_t dataSize = BinaryHeader::PageSize * (size_t)_header.dataPages;
 
-	stream.seekg(_header.dataOffset, std::ios::beg);
+	if(_header.compression != BinaryHeader::NoCompression)
+	{
+		_dataSection = DataView(_readPagedSection(_dataPages,
+			_header.dataPages, "data section"), dataSize);
+
+		return;
+	}
+
+	_dataSection = DataView(_getSection(_header.dataOffset, dataSize,
+		"data section"), dataSize);
+}
+
+void BinaryReader::_readStringTable()
+{
+	size_t stringTableSize =
+		BinaryHeader::PageSize * (size_t)_header.stringPages;
+
+	_stringTable = DataView(_getSection(_header.stringsOffset,
+		stringTableSize, "string table"), stringTableSize);
+}
 
-	_dataSection.resize(dataSize);
+void BinaryReader::_readSymbolTable()
+{
+	size_t symbolTableSize = sizeof(SymbolTableEntry) * _header.symbols;
 
-	stream.read((char*) _dataSection.data(), dataSize);
+	_symbolTable = SymbolView::fromBytes(_getSection(_header.symbolOffset,
+		symbolTableSize, "symbol table"), symbolTableSize);
+}
+
+void BinaryReader::_readInstructions()
+{
+	size_t dataSize = BinaryHeader::PageSize * (size_t)_header.codePages;
 
-	if((size_t)stream.gcount() != dataSize)
+	if(_header.compression != BinaryHeader::NoCompression)
 	{
-		throw std::runtime_error("Failed to read binary data section, hit"
-			" EOF."); 
+		_codeSection = DataView(_readPagedSection(_codePages,
+			_header.codePages, "code section"), dataSize);
+	}
+	else
+	{
+		_codeSection = DataView(_getSection(_header.codeOffset,
+			dataSize, "code section"), dataSize);
+	}
+
+	// Compact code pages are decoded a function at a time
+	if(_header.encoding == BinaryHeader::FixedEncoding)
+	{
+		_instructions = InstructionView::fromBytes(_codeSection.data(),
+			_codeSection.size());
 	}
 }
 
-void BinaryReader::_readStringTable(std::istream& stream)
+void BinaryReader::_readSymbolIndex()
 {
-	size_t stringTableSize = BinaryHeader::PageSize * _header.stringPages;
+	uint32_t buckets = _header.symbolIndexBuckets;
 
-	stream.seekg(_header.stringsOffset, std::ios::beg);
+	// Binaries written before the index existed get one built here
+	if(_header.version < 1 || buckets == 0)
+	{
+		report(" building symbol index for " << _symbolTable.size()
+			<< " symbols");
 
-	_stringTable.resize(stringTableSize);
+		_builtSymbolIndex.build(_symbolTable.data(), _symbolTable.size(),
+			_stringTable.data(), _stringTable.size());
 
-	stream.read((char*) _stringTable.data(), stringTableSize);
+		_symbolBuckets = BucketView(_builtSymbolIndex.buckets.data(),
+			_builtSymbolIndex.buckets.size());
+		_symbolChains  = SymbolIndexView(_builtSymbolIndex.entries.data(),
+			_builtSymbolIndex.entries.size());
 
-	if((size_t)stream.gcount() != stringTableSize)
+		return;
+	}
+
+	if((buckets & (buckets - 1)) != 0)
 	{
-		throw std::runtime_error("Failed to read string table, hit EOF");
+		throw std::runtime_error("Failed to read binary symbol index, the "
+			"bucket count is not a power of two.");
 	}
+
+	const char* section = _getSection(_header.symbolIndexOffset,
+		SymbolIndex::size(buckets, _header.symbols), "symbol index");
+
+	_symbolBuckets = BucketView(
+		reinterpret_cast<const uint32_t*>(section), buckets);
+	_symbolChains  = SymbolIndexView(
+		reinterpret_cast<const SymbolIndexEntry*>(
+		section + buckets * sizeof(uint32_t)), _header.symbols);
 }
 
-void BinaryReader::_readSymbolTable(std::istream& stream)
+void BinaryReader::_readPageDirectory()
 {
-	size_t symbolTableSize = sizeof(SymbolTableEntry) * _header.symbols;
+	if(_header.compression == BinaryHeader::NoCompression) return;
 
-	stream.seekg(_header.symbolOffset, std::ios::beg);
+	if(_header.compression != BinaryHeader::PageCompression)
+	{
+		std::stringstream message;
 
-	_symbolTable.resize(_header.symbols);
+		message << "Failed to read binary, unknown compression method "
+			<< _header.compression << ".";
 
-	stream.read((char*) _symbolTable.data(), symbolTableSize);
+		throw std::runtime_error(message.str());
+	}
 
-	if((size_t)stream.gcount() != symbolTableSize)
+	if(_header.directoryEntries !=
+		(uint64_t)_header.codePages + _header.dataPages)
 	{
-		throw std::runtime_error("Failed to read symbol table, hit EOF");
+		throw std::runtime_error("Failed to read binary page directory, "
+			"it does not cover the code and data sections.");
 	}
+
+	report(" reading page directory with " << _header.directoryEntries
+		<< " entries");
+
+	auto directory = reinterpret_cast<const PageDirectoryEntry*>(
+		_getSection(_header.pageDirectoryOffset,
+		_header.directoryEntries * sizeof(PageDirectoryEntry),
+		"page directory"));
+
+	_codePages.directory = directory;
+	_dataPages.directory = directory + _header.codePages;
 }
 
-void BinaryReader::_readInstructions(std::istream& stream)
+const char* BinaryReader::_readPagedSection(PagedSection& section,
+	uint64_t pages, const std::string& name)
 {
-	size_t dataSize = BinaryHeader::PageSize * _header.codePages;
-	size_t sizeInInstructions = (dataSize + sizeof(InstructionContainer) - 1) /
-		sizeof(InstructionContainer);
+	report(" " << name << " is compressed, " << pages
+		<< " pages will be expanded on demand");
 
-	_instructions.resize(sizeInInstructions);
+	section.pages.reset(new char[pages * BinaryHeader::PageSize]);
+	section.resident.assign(pages, false);
 
-	// TODO obey page alignment
-	stream.seekg(_header.codeOffset, std::ios::beg);
+	return section.pages.get();
+}
 
-	stream.read((char*) _instructions.data(), dataSize);
+void BinaryReader::_makeResident(PagedSection& section, uint64_t offset,
+	uint64_t size)
+{
+	if(section.directory == nullptr || size == 0) return;
+
+	uint64_t firstPage = offset / BinaryHeader::PageSize;
+	uint64_t lastPage  = (offset + size - 1) / BinaryHeader::PageSize;
+
+	if(lastPage >= section.resident.size())
+	{
+		throw std::runtime_error("Failed to read compressed binary, "
+			"access past the end of a section.");
+	}
 
-	if((size_t)stream.gcount() != dataSize)
+	for(uint64_t page = firstPage; page <= lastPage; ++page)
 	{
-		throw std::runtime_error("Failed to read code section, hit EOF.");
+		if(section.resident[page]) continue;
+
+		const PageDirectoryEntry& entry = section.directory[page];
+
+		const char* stored = _getSection(entry.offset, entry.size,
+			"compressed page");
+
+		char* expanded = section.pages.get() + page * BinaryHeader::PageSize;
+
+		bool success = false;
+
+		if(entry.method == PageDirectoryEntry::Stored)
+		{
+			success = entry.size == BinaryHeader::PageSize;
+
+			if(success) std::memcpy(expanded, stored, entry.size);
+		}
+		else if(entry.method == PageDirectoryEntry::LZ)
+		{
+			success = util::LZCodec::decompress(stored, entry.size,
+				expanded, BinaryHeader::PageSize);
+		}
+
+		if(!success)
+		{
+			std::stringstream message;
+
+			message << "Failed to read compressed binary, page at offset "
+				<< entry.offset << " is corrupt.";
+
+			throw std::runtime_error(message.str());
+		}
+
+		report("  expanded page " << page << " from " << entry.size
+			<< " bytes");
+
+		section.resident[page] = true;
 	}
 }
 
+const char* BinaryReader::_getSection(uint64_t offset, uint64_t size,
+	const std::string& name) const
+{
+	if(offset > _fileSize || size > _fileSize - offset)
+	{
+		throw std::runtime_error("Failed to read binary " + name +
+			", hit EOF.");
+	}
+
+	return _file + offset;
+}
+
 void BinaryReader::_loadTypes()
 {
+	auto compiler = compiler::Compiler::getSingleton();
+
 	for(auto symbol = _symbolTable.begin();
 		symbol != _symbolTable.end(); ++symbol)
 	{
-		compiler::Compiler::getSingleton()->getOrInsertType(
-			_getSymbolTypeName(*symbol));
+		// Most symbols share a handful of types, only parse new ones
+		auto name = _getSymbolTypeName(*symbol);
+
+		if(compiler->getType(name) != nullptr) continue;
+
+		compiler->getOrInsertType(name);
 	}
 }
 
 void BinaryReader::_initializeModule(ir::Module& m)
 {
 	_loadGlobals(m);
+	_loadArguments(m);
 	_loadFunctions(m);
 
 	_variables.clear();
+	_arguments.clear();
 	_locals.clear();
 }
 
@@ -176,9 +522,7 @@ void BinaryReader::_loadGlobals(ir::Module& m)
 		if(symbol->type != SymbolTableEntry::VariableType &&
 			symbol->type != SymbolTableEntry::FunctionType) continue;
 
-		uint64_t symbolTableOffset = _header.symbolOffset +
-			sizeof(SymbolTableEntry) *
-			std::distance(_symbolTable.begin(), symbol);
+		uint64_t symbolTableOffset = _getSymbolOffset(symbol);
 		
 		report("  loaded " << _getSymbolName(*symbol)
 			<< " at offset " << symbol->offset
@@ -223,7 +567,7 @@ void BinaryReader::_loadGlobals(ir::Module& m)
 				}
 				
 				// Don't update the variable set
-				return;
+				continue;
 			}
 			else
 			{
@@ -254,132 +598,155 @@ void BinaryReader::_loadGlobals(ir::Module& m)
 	}
 }
 
-void BinaryReader::_loadFunctions(ir::Module& m)
+void BinaryReader::_loadArguments(ir::Module& m)
 {
-	typedef std::unordered_map<uint64_t, ir::BasicBlock*> PCToBasicBlockMap;
-
-	report(" Loading functions from symbol table...");
+	report(" Loading arguments from symbol table...");
 
+	// A single pass, argument symbols are named _Z<function>_<argument>,
+	//  names with underscores are resolved to the longest function name
 	for(auto symbol = _symbolTable.begin();
 		symbol != _symbolTable.end(); ++symbol)
 	{
-		if(symbol->type != SymbolTableEntry::FunctionType) continue;
+		if(symbol->type != SymbolTableEntry::ArgumentType) continue;
 
-		report("  loaded function " << _getSymbolName(*symbol));
+		std::string mangledName = _getSymbolName(*symbol);
 
-		uint64_t symbolTableOffset = _header.symbolOffset +
-			sizeof(SymbolTableEntry) *
-			std::distance(_symbolTable.begin(), symbol);
-	
-		ir::Variable* variable = _getVariableAtSymbolOffset(symbolTableOffset);
-		ir::Function* function = static_cast<ir::Function*>(variable);
-		
-		_function = function;
-		
-		report("   loading arguments...");
+		ir::Function* function = nullptr;
+		std::string   name;
 
-		for(auto argumentSymbol = _symbolTable.begin();
-			argumentSymbol != _symbolTable.end(); ++argumentSymbol)
+		for(auto separator = mangledName.find('_', 2);
+			separator != std::string::npos;
+			separator = mangledName.find('_', separator + 1))
 		{
-			if(argumentSymbol->type != SymbolTableEntry::ArgumentType)
-			{
-				continue;
-			}
-			
-			std::string functionName =
-				_getSymbolName(*argumentSymbol).substr(2,
-				function->name().size());
-		
-			if(functionName != function->name()) continue;
+			auto candidate = _findSymbol(mangledName.substr(2, separator - 2));
 
-			uint64_t symbolTableOffset = _header.symbolOffset +
-				sizeof(SymbolTableEntry) *
-				std::distance(_symbolTable.begin(), argumentSymbol);
+			if(candidate == _symbolTable.end()) continue;
+			if(candidate->type != SymbolTableEntry::FunctionType) continue;
 
-			std::string name = _getSymbolName(*argumentSymbol).substr(
-				2 + function->name().size());
+			function = static_cast<ir::Function*>(
+				_getVariableAtSymbolOffset(_getSymbolOffset(candidate)));
+			name     = mangledName.substr(separator + 1);
+		}
 
-			report("    loaded argument " << name
-				<< " at offset " << argumentSymbol->offset
-				<< ", symbol offset is " << symbolTableOffset);
+		if(function == nullptr)
+		{
+			throw std::runtime_error("Could not find the function for "
+				"argument '" + mangledName + "'");
+		}
 
-			auto type = _getSymbolType(*argumentSymbol);
+		uint64_t symbolTableOffset = _getSymbolOffset(symbol);
 
-			if(type == nullptr)
-			{
-				throw std::runtime_error("Could not find type with name '" +
-					_getSymbolTypeName(*argumentSymbol) + "' for symbol '" +
-					name + "'");
-			}
-	
-			auto argument = function->newArgument(type, name);
+		report("  loaded argument " << name << " of " << function->name()
+			<< " at offset " << symbol->offset
+			<< ", symbol offset is " << symbolTableOffset);
 
-			_arguments.insert(std::make_pair(symbolTableOffset,
-				&*argument));
+		auto type = _getSymbolType(*symbol);
+
+		if(type == nullptr)
+		{
+			throw std::runtime_error("Could not find type with name '" +
+				_getSymbolTypeName(*symbol) + "' for symbol '" +
+				name + "'");
 		}
 
-		BasicBlockDescriptorVector blocks = _getBasicBlocksInFunction(*symbol);
-	
-		PCToBasicBlockMap blockPCs;
+		auto argument = function->newArgument(type, name);
 
-		for(auto blockOffset : blocks)
-		{
-			ir::Function::iterator block = function->newBasicBlock(
-				function->end(), blockOffset.name);
+		_arguments.insert(std::make_pair(symbolTableOffset, &*argument));
+	}
+}
+
+void BinaryReader::_loadFunctions(ir::Module& m)
+{
+	report(" Loading functions from symbol table...");
 
-			blockPCs.insert(std::make_pair(blockOffset.begin, &*block));
+	for(auto symbol = _symbolTable.begin();
+		symbol != _symbolTable.end(); ++symbol)
+	{
+		if(symbol->type != SymbolTableEntry::FunctionType) continue;
 
-			report("   adding basic block " << blockOffset.name
-				<< " using instructions [" 
-				<< blockOffset.begin << ", " << blockOffset.end << "]");
+		ir::Variable* variable = _getVariableAtSymbolOffset(
+			_getSymbolOffset(symbol));
 		
-			for(unsigned int i = blockOffset.begin; i != blockOffset.end; ++i)
-			{
-				assert(i < _instructions.size());
-				_addInstruction(block, _instructions[i]);
-				report("    added instruction '" 
-					<< block->back()->toString() << "'");
-			}
-		}
+		_loadFunctionBody(*static_cast<ir::Function*>(variable), *symbol);
+	}
+}
 
-		report("  resolving branch targets...");
+void BinaryReader::_loadFunctionBody(ir::Function& function,
+	const SymbolTableEntry& symbol)
+{
+	typedef std::unordered_map<uint64_t, ir::BasicBlock*> PCToBasicBlockMap;
 
-		for(auto unresolved : _unresolvedTargets)
-		{
-			// find the symbol with the specified offset
-			const SymbolTableEntry& targetSymbol =
-				_getSymbolEntryAtOffset(unresolved.first);
+	report("  loaded function " << _getSymbolName(symbol));
 
-			uint64_t pc = (targetSymbol.offset - _header.codeOffset) /
-				sizeof(InstructionContainer);
-		
-			report("   for branch to pc " << pc);
+	_function = &function;
 
-			auto block = blockPCs.find(pc);
+	uint64_t firstPC = (symbol.offset - _header.codeOffset) /
+		sizeof(InstructionContainer);
 
-			if(block == blockPCs.end())
-			{
-				std::stringstream message;
+	_fetchInstructions(firstPC,
+		firstPC + symbol.size / sizeof(InstructionContainer));
 
-				message << "Could not find basic block starting at pc " << pc;
+	BasicBlockDescriptorVector blocks = _getBasicBlocksInFunction(symbol);
 
-				throw std::runtime_error(message.str());
-			}
-			
-			report("    setting target to " << block->second->name());
+	PCToBasicBlockMap blockPCs;
+
+	for(auto blockOffset : blocks)
+	{
+		ir::Function::iterator block = function.newBasicBlock(
+			function.end(), blockOffset.name);
 
-			static_cast<ir::AddressOperand*>(unresolved.second)->globalValue =
-				block->second;
+		blockPCs.insert(std::make_pair(blockOffset.begin, &*block));
+
+		report("   adding basic block " << blockOffset.name
+			<< " using instructions [" 
+			<< blockOffset.begin << ", " << blockOffset.end << "]");
+	
+		for(unsigned int i = blockOffset.begin; i != blockOffset.end; ++i)
+		{
+			_addInstruction(block, _getInstruction(i));
+			report("    added instruction '" 
+				<< block->back()->toString() << "'");
 		}
+	}
 
-		_unresolvedTargets.clear();
-		_virtualRegisters.clear();
-		_arguments.clear();
-		
-		for(auto local = _locals.begin(); local != _locals.end(); ++local)
+	report("  resolving branch targets...");
+
+	for(auto unresolved : _unresolvedTargets)
+	{
+		// find the symbol with the specified offset
+		const SymbolTableEntry& targetSymbol =
+			_getSymbolEntryAtOffset(unresolved.first);
+
+		uint64_t pc = (targetSymbol.offset - _header.codeOffset) /
+			sizeof(InstructionContainer);
+	
+		report("   for branch to pc " << pc);
+
+		auto block = blockPCs.find(pc);
+
+		if(block == blockPCs.end())
 		{
-			local->second = nullptr;
+			std::stringstream message;
+
+			message << "Could not find basic block starting at pc " << pc;
+
+			throw std::runtime_error(message.str());
 		}
+		
+		report("    setting target to " << block->second->name());
+
+		static_cast<ir::AddressOperand*>(unresolved.second)->globalValue =
+			block->second;
+	}
+
+	_unresolvedTargets.clear();
+	_virtualRegisters.clear();
+	_decodedInstructions.clear();
+	_function = nullptr;
+	
+	for(auto local = _locals.begin(); local != _locals.end(); ++local)
+	{
+		local->second = nullptr;
 	}
 }
 
@@ -459,7 +826,7 @@ BinaryReader::BasicBlockDescriptorVector
 
 	for(uint64_t i = begin; i != end; ++i)
 	{
-		const InstructionContainer& instruction = _instructions[i];
+		const InstructionContainer& instruction = _getInstruction(i);
 
 		if(instruction.asInstruction.opcode == Instruction::Bra)
 		{
@@ -500,7 +867,7 @@ BinaryReader::BasicBlockDescriptorVector
 		uint64_t blockEnd = i;
 
 		const InstructionContainer&
-			instruction = _instructions[i];
+			instruction = _getInstruction(i);
 
 		if(targets.count(i) != 0)
 		{
@@ -534,6 +901,125 @@ BinaryReader::BasicBlockDescriptorVector
 	return blocks;
 }
 
+void BinaryReader::_fetchInstructions(uint64_t begin, uint64_t end)
+{
+	if(begin == end) return;
+
+	if(_header.encoding == BinaryHeader::FixedEncoding)
+	{
+		_makeResident(_codePages, begin * sizeof(InstructionContainer),
+			(end - begin) * sizeof(InstructionContainer));
+
+		return;
+	}
+
+	uint64_t perPage   = _header.instructionsPerPage;
+	uint64_t firstPage = begin / perPage;
+	uint64_t lastPage  = (end - 1) / perPage;
+
+	if(lastPage >= _header.codePages)
+	{
+		throw std::runtime_error("Failed to read binary code section, "
+			"instructions past the last code page.");
+	}
+
+	_makeResident(_codePages, firstPage * BinaryHeader::PageSize,
+		(lastPage - firstPage + 1) * BinaryHeader::PageSize);
+
+	_firstDecodedPC = begin;
+	_decodedInstructions.resize(end - begin);
+
+	for(uint64_t pc = begin; pc != end; ++pc)
+	{
+		const char* page = _codeSection.data() +
+			(pc / perPage) * BinaryHeader::PageSize;
+
+		if(!InstructionCodec::decode(page, pc % perPage, perPage,
+			_decodedInstructions[pc - begin]))
+		{
+			std::stringstream message;
+
+			message << "Failed to read binary code section, instruction at "
+				"pc " << pc << " is corrupt.";
+
+			throw std::runtime_error(message.str());
+		}
+	}
+}
+
+const InstructionContainer& BinaryReader::_getInstruction(uint64_t pc) const
+{
+	if(_header.encoding == BinaryHeader::FixedEncoding)
+	{
+		assert(pc < _instructions.size());
+
+		return _instructions[pc];
+	}
+
+	assert(pc >= _firstDecodedPC &&
+		pc - _firstDecodedPC < _decodedInstructions.size());
+
+	return _decodedInstructions[pc - _firstDecodedPC];
+}
+
+const OperandContainer& BinaryReader::_getDataOperand(uint64_t offset)
+{
+	_makeResident(_dataPages, offset, sizeof(OperandContainer));
+
+	assert(offset + sizeof(OperandContainer) <= _dataSection.size());
+
+	return *reinterpret_cast<const OperandContainer*>(&_dataSection[offset]);
+}
+
+static ir::Instruction::Opcode convertOpcode(Instruction::Opcode opcode)
+{
+	// The IR has opcodes that are never encoded, the values do not line up
+	switch(opcode)
+	{
+	case Instruction::Add:           return ir::Instruction::Add;
+	case Instruction::And:           return ir::Instruction::And;
+	case Instruction::Ashr:          return ir::Instruction::Ashr;
+	case Instruction::Atom:          return ir::Instruction::Atom;
+	case Instruction::Bar:           return ir::Instruction::Bar;
+	case Instruction::Bitcast:       return ir::Instruction::Bitcast;
+	case Instruction::Bra:           return ir::Instruction::Bra;
+	case Instruction::Call:          return ir::Instruction::Call;
+	case Instruction::Fdiv:          return ir::Instruction::Fdiv;
+	case Instruction::Fmul:          return ir::Instruction::Fmul;
+	case Instruction::Fpext:         return ir::Instruction::Fpext;
+	case Instruction::Fptosi:        return ir::Instruction::Fptosi;
+	case Instruction::Fptoui:        return ir::Instruction::Fptoui;
+	case Instruction::Fptrunc:       return ir::Instruction::Fptrunc;
+	case Instruction::Frem:          return ir::Instruction::Frem;
+	case Instruction::Launch:        return ir::Instruction::Launch;
+	case Instruction::Ld:            return ir::Instruction::Ld;
+	case Instruction::Lshr:          return ir::Instruction::Lshr;
+	case Instruction::Membar:        return ir::Instruction::Membar;
+	case Instruction::Mul:           return ir::Instruction::Mul;
+	case Instruction::Phi:           return ir::Instruction::Phi;
+	case Instruction::Psi:           return ir::Instruction::Psi;
+	case Instruction::Or:            return ir::Instruction::Or;
+	case Instruction::Ret:           return ir::Instruction::Ret;
+	case Instruction::Setp:          return ir::Instruction::Setp;
+	case Instruction::Sext:          return ir::Instruction::Sext;
+	case Instruction::Sdiv:          return ir::Instruction::Sdiv;
+	case Instruction::Shl:           return ir::Instruction::Shl;
+	case Instruction::Sitofp:        return ir::Instruction::Sitofp;
+	case Instruction::Srem:          return ir::Instruction::Srem;
+	case Instruction::St:            return ir::Instruction::St;
+	case Instruction::Sub:           return ir::Instruction::Sub;
+	case Instruction::Trunc:         return ir::Instruction::Trunc;
+	case Instruction::Udiv:          return ir::Instruction::Udiv;
+	case Instruction::Uitofp:        return ir::Instruction::Uitofp;
+	case Instruction::Urem:          return ir::Instruction::Urem;
+	case Instruction::Xor:           return ir::Instruction::Xor;
+	case Instruction::Zext:          return ir::Instruction::Zext;
+	default: break;
+	}
+
+	return ir::Instruction::InvalidOpcode;
+}
+
 void BinaryReader::_addInstruction(ir::Function::iterator block,
 	const InstructionContainer& container)
 {
@@ -542,8 +1028,8 @@ void BinaryReader::_addInstruction(ir::Function::iterator block,
 	if(_addComplexInstruction(block, container))      return;
 
 	assertM(false, "Translation for instruction '" <<
-		ir::Instruction::toString((ir::Instruction::Opcode)
-		container.asInstruction.opcode) << "' not implemented.");
+		ir::Instruction::toString(
+		convertOpcode(container.asInstruction.opcode)) << "' not implemented.");
 }
 
 bool BinaryReader::_addSimpleBinaryInstruction(ir::Function::iterator block,
@@ -569,8 +1055,8 @@ bool BinaryReader::_addSimpleBinaryInstruction(ir::Function::iterator block,
 	case Instruction::Xor:
 	{
 		auto instruction = static_cast<ir::BinaryInstruction*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asBinaryInstruction.guard, instruction));
@@ -610,8 +1096,8 @@ bool BinaryReader::_addSimpleUnaryInstruction(ir::Function::iterator block,
 	case Instruction::Zext:
 	{
 		auto instruction = static_cast<ir::UnaryInstruction*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asUnaryInstruction.guard, instruction));
@@ -637,8 +1123,8 @@ bool BinaryReader::_addComplexInstruction(ir::Function::iterator block,
 	if(container.asInstruction.opcode == Instruction::St)
 	{
 		auto instruction = static_cast<ir::St*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asSt.guard, instruction));
@@ -656,8 +1142,8 @@ bool BinaryReader::_addComplexInstruction(ir::Function::iterator block,
 	else if(container.asInstruction.opcode == Instruction::Setp)
 	{
 		auto instruction = static_cast<ir::Setp*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asSetp.guard, instruction));
@@ -681,8 +1167,8 @@ bool BinaryReader::_addComplexInstruction(ir::Function::iterator block,
 	else if(container.asInstruction.opcode == Instruction::Bra)
 	{
 		auto instruction = static_cast<ir::Bra*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asBra.guard, instruction));
@@ -706,8 +1192,8 @@ bool BinaryReader::_addComplexInstruction(ir::Function::iterator block,
 	else if(container.asInstruction.opcode == Instruction::Ret)
 	{
 		auto instruction = static_cast<ir::Ret*>(
-			ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+			ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 		instruction->setGuard(_translateOperand(
 			container.asRet.guard, instruction));
@@ -730,8 +1216,8 @@ void BinaryReader::_addCallInstruction(ir::Function::iterator block,
 	const InstructionContainer& container)
 {
 	auto instruction = static_cast<ir::Call*>(
-		ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+		ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 	instruction->setGuard(_translateOperand(
 		container.asCall.guard, instruction));
@@ -744,10 +1230,9 @@ void BinaryReader::_addCallInstruction(ir::Function::iterator block,
 	{
 		uint64_t offset = returned * sizeof(OperandContainer) +
 			container.asCall.returnArgumentOffset;
-		const OperandContainer* operand =
-			reinterpret_cast<OperandContainer*>(&_dataSection[offset]);
 	
-		instruction->addReturn(_translateOperand(*operand, instruction));
+		instruction->addReturn(_translateOperand(_getDataOperand(offset),
+			instruction));
 	}
 
 	for(unsigned int argument = 0;
@@ -755,10 +1240,9 @@ void BinaryReader::_addCallInstruction(ir::Function::iterator block,
 	{
 		uint64_t offset = argument * sizeof(OperandContainer) +
 			container.asCall.argumentOffset;
-		const OperandContainer* operand =
-			reinterpret_cast<OperandContainer*>(&_dataSection[offset]);
 	
-		instruction->addArgument(_translateOperand(*operand, instruction));
+		instruction->addArgument(_translateOperand(_getDataOperand(offset),
+			instruction));
 	}
 	
 	block->push_back(instruction);
@@ -768,8 +1252,8 @@ void BinaryReader::_addPhiInstruction(ir::Function::iterator block,
 	const InstructionContainer& container)
 {
 	auto instruction = static_cast<ir::Phi*>(
-		ir::Instruction::create((ir::Instruction::Opcode)
-			container.asInstruction.opcode, &*block));
+		ir::Instruction::create(
+			convertOpcode(container.asInstruction.opcode), &*block));
 
 	instruction->setGuard(_translateOperand(
 		container.asCall.guard, instruction));
@@ -787,15 +1271,10 @@ void BinaryReader::_addPhiInstruction(ir::Function::iterator block,
 		uint64_t blockOffset = sourceBlock * sizeof(OperandContainer) +
 			container.asPhi.sourcesOffset;
 		
-		const OperandContainer* operandSource =
-			reinterpret_cast<OperandContainer*>(&_dataSection[offset]);
-		const OperandContainer* operandBlock =
-			reinterpret_cast<OperandContainer*>(&_dataSection[blockOffset]);
-			
 		auto registerSource = static_cast<ir::RegisterOperand*>(
-			_translateOperand(*operandSource, instruction));
+			_translateOperand(_getDataOperand(offset), instruction));
 		auto addressBlock   = static_cast<ir::AddressOperand*>(
-			_translateOperand(*operandBlock, instruction));
+			_translateOperand(_getDataOperand(blockOffset), instruction));
 			
 		instruction->addSource(registerSource, addressBlock);
 	}
@@ -1018,6 +1497,38 @@ const SymbolTableEntry& BinaryReader::_getSymbolEntryAtOffset(
 	return _symbolTable[symbolOffset];
 }
 
+uint64_t BinaryReader::_getSymbolOffset(symbol_iterator symbol) const
+{
+	return _header.symbolOffset + sizeof(SymbolTableEntry) *
+		std::distance(_symbolTable.begin(), symbol);
+}
+
+BinaryReader::symbol_iterator BinaryReader::_findSymbol(
+	const std::string& name) const
+{
+	uint32_t hash = SymbolIndex::hash(name.c_str());
+
+	uint32_t next = _symbolBuckets[SymbolIndex::bucket(hash,
+		_symbolBuckets.size())];
+
+	// Chains come from the file, stop at corrupt links or cycles
+	for(size_t steps = 0; next < _symbolTable.size() &&
+		steps < _symbolTable.size(); ++steps)
+	{
+		const SymbolIndexEntry& entry = _symbolChains[next];
+
+		if(entry.hash == hash && std::strcmp(name.c_str(),
+			_stringTable.data() + _symbolTable[next].stringOffset) == 0)
+		{
+			return _symbolTable.begin() + next;
+		}
+
+		next = entry.next;
+	}
+
+	return _symbolTable.end();
+}
+
 BinaryReader::BasicBlockDescriptor::BasicBlockDescriptor(
 	const std::string& n, uint64_t b, uint64_t e)
 : name(n), begin(b), end(e)
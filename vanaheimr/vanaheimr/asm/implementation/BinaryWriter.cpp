@@ -7,13 +7,27 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/asm/interface/BinaryWriter.h>
+#include <vanaheimr/asm/interface/InstructionCodec.h>
 
 #include <vanaheimr/ir/interface/Module.h>
 #include <vanaheimr/ir/interface/Type.h>
+#include <vanaheimr/ir/interface/Constant.h>
+
+#include <vanaheimr/machine/interface/PhysicalRegisterOperand.h>
+#include <vanaheimr/machine/interface/PhysicalIndirectOperand.h>
+#include <vanaheimr/machine/interface/PhysicalRegister.h>
+
+#include <vanaheimr/util/interface/LZCodec.h>
+#include <vanaheimr/util/interface/ThreadPool.h>
 
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
+// Standard Library Includes
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
 // Preprocessor Macros
 #ifdef REPORT_BASE
 #undef REPORT_BASE
@@ -29,8 +43,9 @@ namespace vanaheimr
 namespace as
 {
 
-BinaryWriter::BinaryWriter()
-: m_module(0)
+BinaryWriter::BinaryWriter(Compression compression, unsigned int threads)
+: m_module(0), m_compression(compression), m_threads(threads), m_codeSize(0),
+  m_instructionsPerPage(0), m_compressedSize(0)
 {
 
 }
@@ -39,25 +54,46 @@ void BinaryWriter::write(std::ostream& binary, const ir::Module& m)
 {
 	m_module = &m;
 
+	m.materializeAll();
+
 	report("Serializing module " << m.name << " to binary bytecode...");
 
+	util::ThreadPool pool(m_threads);
+
 	populateData();
-	populateInstructions();
+	populateFunctions();
+	layoutStreamedData();
+	sizeInstructions(pool);
 	linkSymbols();
+	populateSymbolIndex();
 	
-	populateHeader();
+	// The header is rewritten once the size of every section is known
+	std::memset(&m_header, 0, sizeof(BinaryHeader));
 
-	report(" writing header");
+	report(" writing header placeholder");
 	writePage(binary, (const char*)&m_header, sizeof(BinaryHeader));
 	report(" writing symbols");
 	writePage(binary, (const char*)m_symbolTable.data(), getSymbolTableSize());
+	
 	report(" writing instructions");
-	writePage(binary, (const char*)m_instructions.data(),
-		getInstructionStreamSize());
+	writeInstructions(binary, pool);
 	report(" writing data");
-	writePage(binary, (const char*)m_data.data(), getDataSize());
+	writeData(binary);
+	
 	report(" writing string table");
 	writePage(binary, (const char*)m_stringTable.data(), getStringTableSize());
+	report(" writing symbol index");
+	writePage(binary, (const char*)m_symbolIndex.data(), getSymbolIndexSize());
+	
+	if(m_compression != BinaryHeader::NoCompression)
+	{
+		report(" writing page directory");
+		writePage(binary, (const char*)m_pageDirectory.data(),
+			getPageDirectorySize());
+	}
+
+	report(" writing header");
+	writeHeader(binary);
 }
 
 void BinaryWriter::writePage(std::ostream& binary, const void* data,
@@ -88,8 +124,186 @@ void BinaryWriter::writePage(std::ostream& binary, const void* data,
 	}
 }
 
+void BinaryWriter::writeHeader(std::ostream& binary)
+{
+	populateHeader();
+
+	std::ostream::pos_type end = binary.tellp();
+
+	binary.seekp(getHeaderOffset());
+	binary.write((const char*)&m_header, sizeof(BinaryHeader));
+	binary.seekp(end);
+
+	if(!binary.good())
+	{
+		throw std::runtime_error("Failed to write binary header, the "
+			"output stream is not seekable.");
+	}
+}
+
+void BinaryWriter::writeInstructions(std::ostream& binary,
+	util::ThreadPool& pool)
+{
+	report("  " << m_instructionsPerPage << " instructions per page in "
+		<< (m_codeSize / PageSize) << " pages");
+
+	DataVector page(PageSize, 0);
+
+	size_t slot   = 0;
+	size_t offset = m_instructionsPerPage * sizeof(uint16_t);
+
+	std::vector<DataVector> records;
+
+	for(size_t begin = 0; begin < m_functions.size(); )
+	{
+		// Convert a batch of functions at a time, append them in order
+		size_t   end          = begin;
+		uint64_t instructions = 0;
+
+		while(end < m_functions.size() && instructions < InstructionsPerBatch)
+		{
+			instructions += m_functions[end++].instructions;
+		}
+
+		records.assign(end - begin, DataVector());
+
+		pool.parallelFor(end - begin, [&](size_t i)
+		{
+			encodeFunction(m_functions[begin + i], &records[i], nullptr);
+		});
+
+		for(size_t i = 0; i < records.size(); ++i)
+		{
+			const FunctionLayout& layout = m_functions[begin + i];
+
+			const char* record = records[i].data();
+
+			for(uint64_t pc = layout.firstInstruction;
+				pc != layout.firstInstruction + layout.instructions; ++pc)
+			{
+				if(slot == m_instructionsPerPage)
+				{
+					writeSectionPage(binary, page.data());
+
+					std::fill(page.begin(), page.end(), 0);
+
+					slot   = 0;
+					offset = m_instructionsPerPage * sizeof(uint16_t);
+				}
+
+				size_t size = m_instructionSizes[pc];
+
+				// The offset table, then the instructions
+				page[2 * slot]     = offset & 0xff;
+				page[2 * slot + 1] = offset >> 8;
+
+				assert(offset + size <= PageSize);
+
+				std::memcpy(page.data() + offset, record, size);
+
+				offset += size;
+				record += size;
+
+				++slot;
+			}
+
+			assert(record == records[i].data() + records[i].size());
+		}
+
+		begin = end;
+	}
+
+	if(slot > 0) writeSectionPage(binary, page.data());
+}
+
+void BinaryWriter::writeData(std::ostream& binary)
+{
+	DataVector page(PageSize);
+
+	uint64_t size = getDataSize();
+
+	auto streamed = m_streamedData.begin();
+
+	for(uint64_t begin = 0; begin < size; begin += PageSize)
+	{
+		uint64_t end = std::min<uint64_t>(begin + PageSize, size);
+
+		// The tail of the last page is zero
+		std::fill(page.begin(), page.end(), 0);
+
+		if(begin < m_data.size())
+		{
+			uint64_t bytes = std::min<uint64_t>(end, m_data.size()) - begin;
+
+			std::memcpy(page.data(), m_data.data() + begin, bytes);
+		}
+
+		// Streamed images follow the data held in memory
+		for(; streamed != m_streamedData.end(); ++streamed)
+		{
+			uint64_t imageEnd = streamed->offset + streamed->constant->bytes();
+
+			if(streamed->offset >= end) break;
+
+			uint64_t first = std::max(begin, streamed->offset);
+			uint64_t last  = std::min(end,   imageEnd);
+
+			streamed->constant->read(first - streamed->offset,
+				page.data() + (first - begin), last - first);
+
+			// The rest of the image goes on the next page
+			if(imageEnd > end) break;
+		}
+
+		writeSectionPage(binary, page.data());
+	}
+}
+
+void BinaryWriter::writeSectionPage(std::ostream& binary, const char* page)
+{
+	if(m_compression == BinaryHeader::NoCompression)
+	{
+		binary.write(page, PageSize);
+
+		return;
+	}
+
+	m_compressedPage.resize(PageSize);
+
+	PageDirectoryEntry entry;
+
+	entry.offset = getCompressedPagesOffset() + m_compressedSize;
+
+	// Only keep the compressed page if it is smaller
+	size_t compressedSize = util::LZCodec::compress(page, PageSize,
+		m_compressedPage.data(), PageSize - 1);
+
+	if(compressedSize == 0)
+	{
+		entry.method = PageDirectoryEntry::Stored;
+		entry.size   = PageSize;
+
+		binary.write(page, PageSize);
+	}
+	else
+	{
+		entry.method = PageDirectoryEntry::LZ;
+		entry.size   = compressedSize;
+
+		binary.write(m_compressedPage.data(), compressedSize);
+	}
+
+	m_compressedSize += entry.size;
+
+	m_pageDirectory.push_back(entry);
+}
+
 void BinaryWriter::populateData()
 {
+	report(" Reserving space for variables with ABI assigned addresses...");
+
+	m_data.resize(getAddressedDataSize());
+
 	report(" Adding global variables...");
 
 	for(ir::Module::const_global_iterator i = m_module->global_begin();
@@ -116,7 +330,7 @@ static std::string flattenAttributes(const ir::Function& function)
 	return list.str();
 }
 
-void BinaryWriter::populateInstructions()
+void BinaryWriter::populateFunctions()
 {
 	report(" Adding function symbols.");
 	for(ir::Module::const_iterator function = m_module->begin();
@@ -128,7 +342,9 @@ void BinaryWriter::populateInstructions()
 			0, 0, function->type().name, flattenAttributes(*function));
 	}
 	
-	report(" Adding functions.");
+	report(" Laying out functions.");
+	uint64_t instructionOffset = 0;
+
 	for(ir::Module::const_iterator function = m_module->begin();
 		function != m_module->end(); ++function)
 	{
@@ -152,35 +368,154 @@ void BinaryWriter::populateInstructions()
 		}
 		
 		// Instructions
-		unsigned int instructionsBegin =
-			m_instructions.size() * sizeof(InstructionContainer);
-		unsigned int instructionOffset = m_instructions.size();	
+		FunctionLayout layout;
+
+		layout.function         = &*function;
+		layout.firstInstruction = instructionOffset;
+
+		VariableToOffsetMap blockOffsets;
+
 		for(auto bb = function->begin(); bb != function->end(); ++bb)
 		{
-			m_basicBlockOffsets.insert(std::make_pair(bb->name(),
+			blockOffsets.insert(std::make_pair(&*bb,
 				instructionOffset * sizeof(InstructionContainer)));
 
 			instructionOffset += bb->size();
 		}
 
-		unsigned int instructionsSize =
-			instructionOffset * sizeof(InstructionContainer)
-			- instructionsBegin;
-	
+		layout.instructions = instructionOffset - layout.firstInstruction;
+
+		// Referenced blocks get symbols, call and phi operand lists get data,
+		//  so that functions can later be converted independently
+		OffsetToSymbolMap blockSymbols;
+
+		layout.dataOffset = m_data.size();
+
 		for(auto bb = function->begin(); bb != function->end(); ++bb)
 		{
-			report("   Basic Block " << bb->name());
 			for(auto inst = bb->begin(); inst != bb->end(); ++inst)
 			{
-				m_instructions.push_back(convertToContainer(**inst));
+				for(auto read : (*inst)->reads)
+				{
+					addBasicBlockSymbol(*read, blockOffsets, blockSymbols);
+				}
+
+				for(auto write : (*inst)->writes)
+				{
+					addBasicBlockSymbol(*write, blockOffsets, blockSymbols);
+				}
+
+				reserveOperandData(**inst);
+			}
+		}
+
+		layout.dataSize = m_data.size() - layout.dataOffset;
+
+		patchSymbol(function->name(),
+			layout.firstInstruction * sizeof(InstructionContainer),
+			layout.instructions     * sizeof(InstructionContainer));
+
+		m_functions.push_back(layout);
+	}
+}
+
+void BinaryWriter::sizeInstructions(util::ThreadPool& pool)
+{
+	report(" Sizing " << getInstructionCount() << " instructions with "
+		<< pool.size() << " threads.");
+
+	// The page layout depends on the encoded size of every instruction
+	m_instructionSizes.assign(getInstructionCount(), 0);
+
+	pool.parallelFor(m_functions.size(), [&](size_t i)
+	{
+		const FunctionLayout& layout = m_functions[i];
+
+		encodeFunction(layout, nullptr,
+			m_instructionSizes.data() + layout.firstInstruction);
+	});
+
+	m_instructionsPerPage = getInstructionsPerPage(m_instructionSizes);
+
+	uint64_t pages = (m_instructionSizes.size() + m_instructionsPerPage - 1) /
+		m_instructionsPerPage;
+
+	m_codeSize = pages * PageSize;
+}
+
+void BinaryWriter::encodeFunction(const FunctionLayout& layout,
+	DataVector* records, uint8_t* sizes)
+{
+	char record[InstructionCodec::MaximumInstructionSize];
+
+	// Both passes write the same operand lists to the same place
+	uint64_t dataOffset = layout.dataOffset;
+	uint64_t index      = 0;
+
+	for(auto bb = layout.function->begin();
+		bb != layout.function->end(); ++bb)
+	{
+		report("   Basic Block " << bb->name());
+		for(auto inst = bb->begin(); inst != bb->end(); ++inst, ++index)
+		{
+			size_t size = InstructionCodec::encode(
+				convertToContainer(**inst, dataOffset), record);
+
+			if(sizes != nullptr) sizes[index] = size;
+
+			if(records != nullptr)
+			{
+				records->insert(records->end(), record, record + size);
 			}
 		}
+	}
+
+	assert(index == layout.instructions);
+	assert(dataOffset == layout.dataOffset + layout.dataSize);
+}
+
+unsigned int BinaryWriter::getInstructionsPerPage(
+	const InstructionSizeVector& sizes)
+{
+	size_t instructions = sizes.size();
+
+	auto fits = [&](size_t perPage)
+	{
+		size_t bytes = 0;
+
+		for(size_t i = 0; i < instructions; ++i)
+		{
+			if(i % perPage == 0) bytes = perPage * sizeof(uint16_t);
+
+			bytes += sizes[i];
+
+			if(bytes > PageSize) return false;
+		}
 
-		patchSymbol(function->name(), instructionsBegin, instructionsSize);
+		return true;
+	};
+	// Any page of maximum size instructions fits, a page of only offsets
+	//  never does, and a single page needs no more slots than instructions
+	size_t low  = PageSize /
+		(sizeof(uint16_t) + InstructionCodec::MaximumInstructionSize);
+	size_t high = std::min<size_t>(PageSize / sizeof(uint16_t),
+		std::max(instructions, low) + 1);
+
+	while(high - low > 1)
+	{
+		size_t middle = (low + high) / 2;
 
-		m_basicBlockOffsets.clear();
-		m_basicBlockSymbols.clear();
+		if(fits(middle))
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
 	}
+
+	return low;
 }
 
 void BinaryWriter::linkSymbols()
@@ -201,19 +536,53 @@ void BinaryWriter::linkSymbols()
 	}
 }
 
+void BinaryWriter::populateSymbolIndex()
+{
+	SymbolIndexBuilder builder;
+
+	builder.build(m_symbolTable.data(), m_symbolTable.size(),
+		m_stringTable.data(), m_stringTable.size());
+
+	size_t bucketBytes = builder.buckets.size() * sizeof(uint32_t);
+	size_t entryBytes  = builder.entries.size() * sizeof(SymbolIndexEntry);
+
+	m_symbolIndex.resize(bucketBytes + entryBytes);
+
+	std::memcpy(m_symbolIndex.data(), builder.buckets.data(), bucketBytes);
+	std::memcpy(m_symbolIndex.data() + bucketBytes, builder.entries.data(),
+		entryBytes);
+}
+
 void BinaryWriter::populateHeader()
 {
+	std::memset(&m_header, 0, sizeof(BinaryHeader));
+
 	m_header.magic         = BinaryHeader::MagicNumber;
-	m_header.dataPages     = (m_data.size() + PageSize - 1) / PageSize; 
+	m_header.dataPages     = (getDataSize() + PageSize - 1) / PageSize; 
 	m_header.codePages     =
-		((m_instructions.size() * sizeof(InstructionContainer)) + PageSize - 1)
-		/ PageSize;
+		(getInstructionStreamSize() + PageSize - 1) / PageSize;
 	m_header.symbols       = m_symbolTable.size(); 
 	m_header.stringPages   = (m_stringTable.size() + PageSize - 1) / PageSize;
 	m_header.dataOffset    = getDataOffset();
 	m_header.codeOffset    = getInstructionOffset();
 	m_header.symbolOffset  = getSymbolTableOffset();
 	m_header.stringsOffset = getStringTableOffset();
+
+	m_header.version            = BinaryHeader::CurrentVersion;
+	m_header.symbolIndexBuckets =
+		SymbolIndex::bucketCount(m_symbolTable.size());
+	m_header.symbolIndexOffset  = getSymbolIndexOffset();
+
+	m_header.compression = m_compression;
+
+	m_header.encoding            = BinaryHeader::CompactEncoding;
+	m_header.instructionsPerPage = m_instructionsPerPage;
+
+	if(m_compression != BinaryHeader::NoCompression)
+	{
+		m_header.directoryEntries    = m_pageDirectory.size();
+		m_header.pageDirectoryOffset = getPageDirectoryOffset();
+	}
 }
 
 size_t BinaryWriter::getHeaderOffset() const
@@ -238,9 +607,30 @@ size_t BinaryWriter::getSymbolTableOffset() const
 
 size_t BinaryWriter::getStringTableOffset() const
 {
+	if(m_compression != BinaryHeader::NoCompression)
+	{
+		return pageAlign(getCompressedPagesOffset() + m_compressedSize);
+	}
+
 	return pageAlign(getDataSize() + getDataOffset());
 }
 
+size_t BinaryWriter::getCompressedPagesOffset() const
+{
+	// Compressed pages are stored where the code section would start
+	return getInstructionOffset();
+}
+
+size_t BinaryWriter::getPageDirectoryOffset() const
+{
+	return pageAlign(getSymbolIndexSize() + getSymbolIndexOffset());
+}
+
+size_t BinaryWriter::getSymbolIndexOffset() const
+{
+	return pageAlign(getStringTableSize() + getStringTableOffset());
+}
+
 size_t BinaryWriter::getSymbolTableSize() const
 {
 	return m_symbolTable.size() * sizeof(SymbolTableEntry);
@@ -248,12 +638,16 @@ size_t BinaryWriter::getSymbolTableSize() const
 
 size_t BinaryWriter::getInstructionStreamSize() const
 {
-	return m_instructions.size() * sizeof(InstructionContainer);
+	return m_codeSize;
 }
 
 size_t BinaryWriter::getDataSize() const
 {
-	return m_data.size();
+	if(m_streamedData.empty()) return m_data.size();
+	
+	auto& last = m_streamedData.back();
+	
+	return last.offset + last.constant->bytes();
 }
 
 size_t BinaryWriter::getStringTableSize() const
@@ -261,6 +655,24 @@ size_t BinaryWriter::getStringTableSize() const
 	return m_stringTable.size();
 }
 
+size_t BinaryWriter::getSymbolIndexSize() const
+{
+	return m_symbolIndex.size();
+}
+
+size_t BinaryWriter::getPageDirectorySize() const
+{
+	return m_pageDirectory.size() * sizeof(PageDirectoryEntry);
+}
+
+uint64_t BinaryWriter::getInstructionCount() const
+{
+	if(m_functions.empty()) return 0;
+
+	return m_functions.back().firstInstruction +
+		m_functions.back().instructions;
+}
+
 static Instruction::Opcode convertOpcode(
 	ir::Instruction::Opcode opcode)
 {
@@ -390,11 +802,44 @@ static PredicateOperand::PredicateModifier convertPredicate(
 	return PredicateOperand::InvalidPredicate;
 }
 
+unsigned int BinaryWriter::getEncodedRegister(
+	const ir::RegisterOperand& operand)
+{
+	auto physical =
+		dynamic_cast<const machine::PhysicalRegisterOperand*>(&operand);
+
+	if(physical == nullptr) return operand.virtualRegister()->id;
+
+	if(physical->physicalRegister == nullptr)
+	{
+		throw std::runtime_error("Register operand '" + operand.toString() +
+			"' was never assigned a physical register.");
+	}
+
+	// Allocation colors are unique ids, ids only count within a file
+	return physical->physicalRegister->uniqueId();
+}
+
+static int64_t getIndirectOffset(const ir::Operand& operand)
+{
+	// Register allocation replaces indirect operands with physical ones,
+	//  which are not IndirectOperands
+	auto physical =
+		dynamic_cast<const machine::PhysicalIndirectOperand*>(&operand);
+
+	if(physical != nullptr) return physical->offset;
+
+	return static_cast<const ir::IndirectOperand&>(operand).offset;
+}
+
 OperandContainer BinaryWriter::convertOperand(
 	const ir::Operand& operand)
 {
 	OperandContainer result;
 
+	// Unused bytes are zero so that binaries are deterministic and compress
+	std::memset(&result, 0, sizeof(OperandContainer));
+
 	switch(operand.mode())
 	{
 	case ir::Operand::Register:
@@ -402,11 +847,11 @@ OperandContainer BinaryWriter::convertOperand(
 		const ir::RegisterOperand& reg =
 			static_cast<const ir::RegisterOperand&>(operand);
 
-		report("     converting virtual register " << reg.virtualRegister->id
-			<< " (" << reg.virtualRegister->type->name << ")");
+		report("     converting virtual register " << reg.virtualRegister()->id
+			<< " (" << reg.virtualRegister()->type->name << ")");
 		
-		result.asRegister.reg  = reg.virtualRegister->id;
-		result.asRegister.type = convertType(reg.virtualRegister->type);
+		result.asRegister.reg  = getEncodedRegister(reg);
+		result.asRegister.type = convertType(reg.virtualRegister()->type);
 		
 		result.asOperand.mode = as::Operand::Register;
 		break;
@@ -433,9 +878,9 @@ OperandContainer BinaryWriter::convertOperand(
 			predicate.modifier == ir::PredicateOperand::InversePredicate)
 		{
 			report("     converting non-trivial predicate with virtual "
-				"register " << predicate.virtualRegister->id
-				<< " (" << predicate.virtualRegister->type->name << ")");
-			result.asPredicate.reg = predicate.virtualRegister->id;
+				"register " << predicate.virtualRegister()->id
+				<< " (" << predicate.virtualRegister()->type->name << ")");
+			result.asPredicate.reg = getEncodedRegister(predicate);
 		}
 		else
 		{
@@ -448,12 +893,12 @@ OperandContainer BinaryWriter::convertOperand(
 	}
 	case ir::Operand::Indirect:
 	{
-		const ir::IndirectOperand& indirect =
-			static_cast<const ir::IndirectOperand&>(operand);
+		const ir::RegisterOperand& indirect =
+			static_cast<const ir::RegisterOperand&>(operand);
 
-		result.asIndirect.reg    = indirect.virtualRegister->id;
-		result.asIndirect.type   = convertType(indirect.virtualRegister->type);
-		result.asIndirect.offset = indirect.offset;
+		result.asIndirect.reg    = getEncodedRegister(indirect);
+		result.asIndirect.type   = convertType(indirect.virtualRegister()->type);
+		result.asIndirect.offset = getIndirectOffset(operand);
 		
 		result.asOperand.mode = as::Operand::Indirect;
 
@@ -516,7 +961,7 @@ static bool isComplexInstruction(const ir::Instruction& instruction)
 
 void BinaryWriter::convertComplexInstruction(
 	InstructionContainer& container,
-	const ir::Instruction& instruction)
+	const ir::Instruction& instruction, uint64_t& dataOffset)
 {
 	switch(instruction.opcode)
 	{
@@ -527,7 +972,7 @@ void BinaryWriter::convertComplexInstruction(
 	}
 	case ir::Instruction::Call:
 	{
-		convertCallInstruction(container, instruction);
+		convertCallInstruction(container, instruction, dataOffset);
 		break;
 	}
 	case ir::Instruction::St:
@@ -542,7 +987,7 @@ void BinaryWriter::convertComplexInstruction(
 	}
 	case ir::Instruction::Phi:
 	{
-		convertPhiInstruction(container, instruction);
+		convertPhiInstruction(container, instruction, dataOffset);
 		break;
 	}
 	default: assertM(false, "Translation for "
@@ -659,19 +1104,21 @@ void BinaryWriter::convertComparisonInstruction(
 }
 
 InstructionContainer BinaryWriter::convertToContainer(
-	const Instruction& instruction)
+	const Instruction& instruction, uint64_t& dataOffset)
 {
 	report("    " << instruction.toString());
 
 	InstructionContainer container;
 
+	std::memset(&container, 0, sizeof(InstructionContainer));
+
 	container.asInstruction.opcode = convertOpcode(instruction.opcode);
 	container.asInstruction.guard  =
 		convertOperand(*instruction.guard()).asPredicate;
 
 	if(isComplexInstruction(instruction))
 	{
-		convertComplexInstruction(container, instruction);
+		convertComplexInstruction(container, instruction, dataOffset);
 	}
 	else if(instruction.isComparison())
 	{
@@ -706,25 +1153,50 @@ size_t BinaryWriter::getSymbolTableOffset(const ir::Variable* g)
 
 size_t BinaryWriter::getBasicBlockSymbolTableOffset(const ir::Variable* g)
 {
-	auto offset = m_basicBlockOffsets.find(g->name());
-	assert(offset != m_basicBlockOffsets.end());
+	auto symbol = m_basicBlockSymbols.find(g);
+
+	assertM(symbol != m_basicBlockSymbols.end(),
+		"No symbol for basic block " << g->name() << "");
+
+	return symbol->second;
+}
+
+void BinaryWriter::addBasicBlockSymbol(const ir::Operand& operand,
+	const VariableToOffsetMap& blockOffsets, OffsetToSymbolMap& blockSymbols)
+{
+	if(operand.mode() != ir::Operand::Address) return;
+
+	const ir::AddressOperand& address =
+		static_cast<const ir::AddressOperand&>(operand);
+
+	const ir::Variable* block = address.globalValue;
+
+	if(!block->type().isBasicBlock()) return;
+
+	if(m_basicBlockSymbols.count(block) != 0) return;
 
-	auto symbol = m_basicBlockSymbols.find(offset->second);
+	auto offset = blockOffsets.find(block);
+
+	assertM(offset != blockOffsets.end(), "Basic block " << block->name()
+		<< " is not in the referencing function.");
+
+	// Blocks at the same offset share a symbol
+	auto symbol = blockSymbols.find(offset->second);
 	
-	if(symbol == m_basicBlockSymbols.end())
+	if(symbol == blockSymbols.end())
 	{
 		uint64_t symbolOffset = m_symbolTable.size() *
 			sizeof(SymbolTableEntry) + getSymbolTableOffset();
 
-		symbol = m_basicBlockSymbols.insert(std::make_pair(
+		symbol = blockSymbols.insert(std::make_pair(
 			offset->second, symbolOffset)).first;
 
 		addSymbol(SymbolTableEntry::BasicBlockType, 0x0, 0x0,
-			ir::Global::InvalidLevel, g->name(), offset->second, 0,
-			g->type().name);
+			ir::Global::InvalidLevel, block->name(), offset->second, 0,
+			block->type().name);
 	}
 
-	return symbol->second;
+	m_basicBlockSymbols.insert(std::make_pair(block, symbol->second));
 }
 
 size_t BinaryWriter::getSymbolTableOffset(const std::string& name)
@@ -742,18 +1214,11 @@ size_t BinaryWriter::getSymbolTableOffset(const std::string& name)
 BinaryWriter::SymbolTableEntryVector::iterator
 	BinaryWriter::getSymbol(const std::string& name)
 {
-	for(SymbolVector::iterator symbol = m_symbolTable.begin();
-		symbol != m_symbolTable.end(); ++symbol)
-	{
-		std::string symbolName(&m_stringTable[symbol->stringOffset]);
+	auto symbol = m_symbolNames.find(name);
 
-		if(symbolName == name)
-		{
-			return symbol;
-		}
-	}
+	if(symbol == m_symbolNames.end()) return m_symbolTable.end();
 
-	return m_symbolTable.end();
+	return m_symbolTable.begin() + symbol->second;
 }
 
 void BinaryWriter::addSymbol(unsigned int type, unsigned int linkage,
@@ -767,6 +1232,9 @@ void BinaryWriter::addSymbol(unsigned int type, unsigned int linkage,
 	
 	SymbolTableEntry symbol;
 
+	// Unused attribute bits are zero so that binaries are deterministic
+	std::memset(&symbol, 0, sizeof(SymbolTableEntry));
+
 	symbol.type                  = type;
 	symbol.attributes.linkage    = linkage;
 	symbol.attributes.visibility = visibility;
@@ -792,31 +1260,126 @@ void BinaryWriter::addSymbol(unsigned int type, unsigned int linkage,
 		std::back_inserter(m_stringTable));
 	m_stringTable.push_back('\0');
 
-	// Add the symbol
+	// Add the symbol, lookups by name find the first one to use it
+	m_symbolNames.insert(std::make_pair(name, m_symbolTable.size()));
 	m_symbolTable.push_back(symbol);
 }
 
 void BinaryWriter::addGlobal(const ir::Global& global)
 {
 	ir::Constant::DataVector blob;
+	
+	const uint8_t* begin = nullptr;
+	const uint8_t* end   = nullptr;
 		
 	report("  " << global.name());
 
-	if(global.hasInitializer())
+	auto streamed = dynamic_cast<const ir::StreamedArrayConstant*>(
+		global.initializer());
+
+	// Streamed images are placed after the rest of the data and read while
+	//  the data section is written, a fixed address reads them up front
+	if(streamed != nullptr && !global.hasAddress())
 	{
-		const ir::Constant* initializer = global.initializer();
-		blob = initializer->data();
+		addSymbol(SymbolTableEntry::VariableType, global.linkage(),
+			global.visibility(), global.level(), global.name(), 0,
+			global.bytes(), global.type().name);
+
+		StreamedData data;
+
+		data.name     = global.name();
+		data.constant = streamed;
+		data.offset   = 0;
+
+		m_streamedData.push_back(data);
+
+		return;
+	}
+
+	auto array = dynamic_cast<const ir::ArrayConstant*>(
+		global.initializer());
+
+	if(array != nullptr)
+	{
+		// Array images can be large, copy them without a temporary
+		begin = (const uint8_t*)array->storage();
+		end   = begin + array->storageBytes();
 	}
 	else
 	{
-		blob.resize(global.bytes());
+		if(global.hasInitializer())
+		{
+			blob = global.initializer()->data();
+		}
+		else
+		{
+			blob.resize(global.bytes());
+		}
+		
+		begin = blob.data();
+		end   = blob.data() + blob.size();
+	}
+
+	// Honor the offset chosen by the ABI lowering pass if there is one
+	if(global.hasAddress())
+	{
+		assert(global.address() + (end - begin) <= m_data.size());
+		
+		addSymbol(SymbolTableEntry::VariableType, global.linkage(),
+			global.visibility(), global.level(), global.name(),
+			global.address(), global.bytes(), global.type().name);
+	
+		std::copy(begin, end, m_data.begin() + global.address());
+		
+		return;
 	}
 
 	addSymbol(SymbolTableEntry::VariableType, global.linkage(),
 		global.visibility(), global.level(), global.name(), m_data.size(),
 		global.bytes(), global.type().name);
 	
-	std::copy(blob.begin(), blob.end(), std::back_inserter(m_data));
+	m_data.insert(m_data.end(), begin, end);
+}
+
+void BinaryWriter::layoutStreamedData()
+{
+	uint64_t offset = m_data.size();
+
+	for(auto& data : m_streamedData)
+	{
+		data.offset = offset;
+
+		patchSymbol(data.name, offset, data.constant->bytes());
+
+		offset += data.constant->bytes();
+	}
+}
+
+uint64_t BinaryWriter::getAddressedDataSize() const
+{
+	uint64_t size = 0;
+
+	for(auto global = m_module->global_begin();
+		global != m_module->global_end(); ++global)
+	{
+		if(!global->hasAddress()) continue;
+		
+		size = std::max(size, global->address() + global->bytes());
+	}
+	
+	for(auto function = m_module->begin();
+		function != m_module->end(); ++function)
+	{
+		for(auto local = function->local_begin();
+			local != function->local_end(); ++local)
+		{
+			if(!local->hasAddress()) continue;
+		
+			size = std::max(size, local->address() + local->bytes());
+		}
+	}
+	
+	return size;
 }
 
 void BinaryWriter::patchSymbol(const std::string& name,
@@ -879,32 +1442,32 @@ void BinaryWriter::convertBraInstruction(
 
 void BinaryWriter::convertCallInstruction(
 	InstructionContainer& container,
-	const ir::Instruction& instruction)
+	const ir::Instruction& instruction, uint64_t& dataOffset)
 {
 	const ir::Call& call = static_cast<const ir::Call&>(instruction);
 
 	container.asCall.target = convertOperand(*call.target());
 	
-	alignData(sizeof(OperandContainer));
+	dataOffset = align(dataOffset, sizeof(OperandContainer));
 	
 	auto returnArguments = call.returned();
 	
 	container.asCall.returnArguments      = returnArguments.size();
-	container.asCall.returnArgumentOffset = m_data.size();
+	container.asCall.returnArgumentOffset = dataOffset;
 	
 	for(auto operand : returnArguments)
 	{
-		addOperandToDataSection(convertOperand(*operand));
+		addOperandToDataSection(convertOperand(*operand), dataOffset);
 	}
 	
 	auto arguments = call.arguments();
 	
 	container.asCall.arguments      = arguments.size();
-	container.asCall.argumentOffset = m_data.size();
+	container.asCall.argumentOffset = dataOffset;
 	
 	for(auto operand : arguments)
 	{
-		addOperandToDataSection(convertOperand(*operand));
+		addOperandToDataSection(convertOperand(*operand), dataOffset);
 	}
 }
 
@@ -917,38 +1480,69 @@ void BinaryWriter::convertRetInstruction(
 
 void BinaryWriter::convertPhiInstruction(
 	InstructionContainer& container,
-	const ir::Instruction& instruction)
+	const ir::Instruction& instruction, uint64_t& dataOffset)
 {
 	const ir::Phi& phi = static_cast<const ir::Phi&>(instruction);
 
 	container.asPhi.destination = convertOperand(*phi.d());
 	
-	alignData(sizeof(OperandContainer));
+	dataOffset = align(dataOffset, sizeof(OperandContainer));
 	
 	auto sources = phi.sources();
 	auto blocks  = phi.blocks();
 	
 	container.asPhi.sources       = sources.size();
-	container.asPhi.sourcesOffset = m_data.size();
+	container.asPhi.sourcesOffset = dataOffset;
 	
 	for(auto source : sources)
 	{
-		addOperandToDataSection(convertOperand(*source));
+		addOperandToDataSection(convertOperand(*source), dataOffset);
 	}
 	
 	for(auto block : blocks)
 	{
 		addOperandToDataSection(convertOperand(
-			ir::AddressOperand(const_cast<ir::BasicBlock*>(block), nullptr)));
+			ir::AddressOperand(const_cast<ir::BasicBlock*>(block), nullptr)),
+			dataOffset);
 	}
 }
 
-void BinaryWriter::addOperandToDataSection(const OperandContainer& operand)
+void BinaryWriter::addOperandToDataSection(const OperandContainer& operand,
+	uint64_t& dataOffset)
 {
-	const char* begin = reinterpret_cast<const char*>(&operand);
-	const char* end   = begin + sizeof(OperandContainer);
-	
-	std::copy(begin, end, std::back_inserter(m_data));
+	// The space was reserved when the function was laid out
+	assert(dataOffset + sizeof(OperandContainer) <= m_data.size());
+
+	std::memcpy(m_data.data() + dataOffset, &operand,
+		sizeof(OperandContainer));
+
+	dataOffset += sizeof(OperandContainer);
+}
+
+void BinaryWriter::reserveOperandData(const ir::Instruction& instruction)
+{
+	size_t operands = 0;
+
+	if(instruction.opcode == ir::Instruction::Call)
+	{
+		const ir::Call& call = static_cast<const ir::Call&>(instruction);
+
+		operands = call.returned().size() + call.arguments().size();
+	}
+	else if(instruction.opcode == ir::Instruction::Phi)
+	{
+		const ir::Phi& phi = static_cast<const ir::Phi&>(instruction);
+
+		operands = phi.sources().size() + phi.blocks().size();
+	}
+	else
+	{
+		return;
+	}
+
+	alignData(sizeof(OperandContainer));
+
+	m_data.resize(m_data.size() + operands * sizeof(OperandContainer));
 }
 
 uint64_t BinaryWriter::align(uint64_t address, uint64_t alignment)
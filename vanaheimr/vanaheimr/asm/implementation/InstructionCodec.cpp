@@ -0,0 +1,241 @@
+/*! \file   InstructionCodec.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the InstructionCodec class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/InstructionCodec.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <cstring>
+
+namespace vanaheimr
+{
+
+namespace as
+{
+
+/*! \brief Appends bytes and varints to an encoded instruction */
+class InstructionEncoder
+{
+public:
+	InstructionEncoder(void* output)
+	: begin(static_cast<uint8_t*>(output)), position(begin) {}
+
+public:
+	void byte(unsigned int value)
+	{
+		assert(value < 256);
+
+		*position++ = value;
+	}
+
+	void varint(uint64_t value)
+	{
+		while(value >= 0x80)
+		{
+			*position++ = (value & 0x7f) | 0x80;
+			value >>= 7;
+		}
+
+		*position++ = value;
+	}
+
+	void raw64(uint64_t value)
+	{
+		for(unsigned int i = 0; i < 8; ++i, value >>= 8)
+		{
+			*position++ = value & 0xff;
+		}
+	}
+
+	void operand(const OperandContainer& operand)
+	{
+		unsigned int mode = operand.asOperand.mode;
+
+		switch(mode)
+		{
+		case Operand::Register:
+		{
+			byte(mode | (operand.asRegister.type << 4));
+			varint(operand.asRegister.reg);
+			break;
+		}
+		case Operand::Immediate:
+		{
+			unsigned int type = operand.asImmediate.type;
+
+			byte(mode | (type << 4));
+
+			if(type == f32 || type == f64)
+			{
+				raw64(operand.asImmediate.uint);
+			}
+			else
+			{
+				varint(operand.asImmediate.uint);
+			}
+			break;
+		}
+		case Operand::Predicate:
+		{
+			byte(mode | (operand.asPredicate.modifier << 4));
+			varint(operand.asPredicate.reg);
+			break;
+		}
+		case Operand::Indirect:
+		{
+			byte(mode | (operand.asIndirect.type << 4));
+			varint(operand.asIndirect.reg);
+			varint(operand.asIndirect.offset);
+			break;
+		}
+		case Operand::Symbol:
+		{
+			byte(mode);
+			varint(operand.asSymbol.symbolTableOffset);
+			break;
+		}
+		case Operand::InvalidOperand:
+		{
+			byte(mode);
+			break;
+		}
+		default: assertM(false, "Invalid operand mode " << mode << ".");
+		}
+	}
+
+	size_t size() const
+	{
+		return position - begin;
+	}
+
+public:
+	uint8_t* begin;
+	uint8_t* position;
+};
+
+size_t InstructionCodec::encode(const InstructionContainer& instruction,
+	void* output)
+{
+	InstructionEncoder encoder(output);
+
+	encoder.byte(instruction.asInstruction.opcode);
+
+	OperandContainer guard;
+
+	std::memset(&guard, 0, sizeof(OperandContainer));
+
+	guard.asPredicate = instruction.asInstruction.guard;
+
+	encoder.operand(guard);
+
+	switch(instruction.asInstruction.opcode)
+	{
+	case Instruction::Add:  // fall through
+	case Instruction::And:  // fall through
+	case Instruction::Ashr: // fall through
+	case Instruction::Fdiv: // fall through
+	case Instruction::Fmul: // fall through
+	case Instruction::Frem: // fall through
+	case Instruction::Lshr: // fall through
+	case Instruction::Mul:  // fall through
+	case Instruction::Or:   // fall through
+	case Instruction::Sdiv: // fall through
+	case Instruction::Shl:  // fall through
+	case Instruction::Srem: // fall through
+	case Instruction::Sub:  // fall through
+	case Instruction::Udiv: // fall through
+	case Instruction::Urem: // fall through
+	case Instruction::Xor:
+	{
+		encoder.operand(instruction.asBinaryInstruction.d);
+		encoder.operand(instruction.asBinaryInstruction.a);
+		encoder.operand(instruction.asBinaryInstruction.b);
+		break;
+	}
+	case Instruction::Setp:
+	{
+		encoder.operand(instruction.asSetp.d);
+		encoder.operand(instruction.asSetp.a);
+		encoder.operand(instruction.asSetp.b);
+		encoder.byte(instruction.asSetp.comparison);
+		break;
+	}
+	case Instruction::Atom:
+	{
+		encoder.operand(instruction.asAtom.d);
+		encoder.operand(instruction.asAtom.a);
+		encoder.operand(instruction.asAtom.b);
+		encoder.byte(instruction.asAtom.operation);
+		encoder.operand(instruction.asAtom.c);
+		break;
+	}
+	case Instruction::Bitcast: // fall through
+	case Instruction::Fpext:   // fall through
+	case Instruction::Fptosi:  // fall through
+	case Instruction::Fptoui:  // fall through
+	case Instruction::Fptrunc: // fall through
+	case Instruction::Ld:      // fall through
+	case Instruction::Ret:     // fall through
+	case Instruction::Sext:    // fall through
+	case Instruction::Sitofp:  // fall through
+	case Instruction::St:      // fall through
+	case Instruction::Trunc:   // fall through
+	case Instruction::Uitofp:  // fall through
+	case Instruction::Zext:
+	{
+		encoder.operand(instruction.asUnaryInstruction.d);
+		encoder.operand(instruction.asUnaryInstruction.a);
+		break;
+	}
+	case Instruction::Bra:
+	{
+		encoder.operand(instruction.asBra.target);
+		encoder.byte(instruction.asBra.modifier);
+		break;
+	}
+	case Instruction::Call:
+	{
+		encoder.operand(instruction.asCall.target);
+		encoder.varint(instruction.asCall.returnArguments);
+		encoder.varint(instruction.asCall.arguments);
+		encoder.varint(instruction.asCall.returnArgumentOffset);
+		encoder.varint(instruction.asCall.argumentOffset);
+		break;
+	}
+	case Instruction::Membar:
+	{
+		encoder.byte(instruction.asMembar.level);
+		break;
+	}
+	case Instruction::Phi:
+	{
+		encoder.operand(instruction.asPhi.destination);
+		encoder.varint(instruction.asPhi.sources);
+		encoder.varint(instruction.asPhi.sourcesOffset);
+		break;
+	}
+	case Instruction::Bar:    // fall through
+	case Instruction::Launch: // fall through
+	case Instruction::Psi:
+	{
+		break;
+	}
+	default: assertM(false, "Invalid opcode "
+		<< instruction.asInstruction.opcode << ".");
+	}
+
+	assert(encoder.size() <= MaximumInstructionSize);
+
+	return encoder.size();
+}
+
+}
+
+}
+
@@ -0,0 +1,54 @@
+/*! \file   SymbolIndexBuilder.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the SymbolIndexBuilder class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/SymbolIndexBuilder.h>
+
+// Standard Library Includes
+#include <stdexcept>
+#include <cstring>
+
+namespace vanaheimr
+{
+
+namespace as
+{
+
+void SymbolIndexBuilder::build(const SymbolTableEntry* symbols,
+	uint32_t symbolCount, const char* strings, size_t stringTableSize)
+{
+	uint32_t emptyBucket = SymbolIndex::InvalidSymbol;
+
+	buckets.assign(SymbolIndex::bucketCount(symbolCount), emptyBucket);
+	entries.resize(symbolCount);
+
+	// Push in reverse so that every chain ends up in symbol order
+	for(uint32_t i = symbolCount; i != 0; --i)
+	{
+		const SymbolTableEntry& symbol = symbols[i - 1];
+
+		if(symbol.stringOffset >= stringTableSize ||
+			std::memchr(strings + symbol.stringOffset, '\0',
+			stringTableSize - symbol.stringOffset) == nullptr)
+		{
+			throw std::runtime_error("Symbol name is outside of the "
+				"string table.");
+		}
+
+		uint32_t hash   = SymbolIndex::hash(strings + symbol.stringOffset);
+		uint32_t bucket = SymbolIndex::bucket(hash, buckets.size());
+
+		entries[i - 1].hash = hash;
+		entries[i - 1].next = buckets[bucket];
+
+		buckets[bucket] = i - 1;
+	}
+}
+
+}
+
+}
+
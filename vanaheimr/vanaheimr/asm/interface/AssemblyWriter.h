@@ -35,6 +35,7 @@ public:
 
 public:
 	void write(std::ostream& stream, const ir::Module& m);
+	void write(std::ostream& stream, const ir::Function& f);
 
 private:
 	void writeFunction(std::ostream& stream, const ir::Function& f);
@@ -4,6 +4,8 @@
 	\brief  The header file for the specification of the header of the binary
 */
 
+#pragma once
+
 // Vanaheimr Includes
 #include <vanaheimr/util/interface/IntTypes.h>
 
@@ -21,6 +23,29 @@ public:
 	static const unsigned int PageSize    = (1 << 15); // 32 KB
 	static const uint64_t     MagicNumber = 0x2E5649527F454C46ULL;
 
+	/*! \brief The newest format revision, binaries written before the
+		header carried a version read back as version 0
+
+		1 - adds the optional symbol index section
+		2 - adds optional per-page compression of code and data
+		3 - adds the compact instruction encoding
+	*/
+	static const uint32_t CurrentVersion = 3;
+
+	/*! \brief How code and data pages are stored */
+	enum Compression
+	{
+		NoCompression   = 0x0, // pages are stored in place
+		PageCompression = 0x1  // pages are found through the page directory
+	};
+
+	/*! \brief How instructions are stored in code pages */
+	enum Encoding
+	{
+		FixedEncoding   = 0x0, // an array of InstructionContainers
+		CompactEncoding = 0x1  // see InstructionCodec
+	};
+
 public:
 	uint64_t magic          : 64;
 	uint32_t dataPages      : 32;
@@ -32,6 +57,22 @@ public:
 	uint64_t symbolOffset   : 64;
 	uint64_t stringsOffset  : 64;
 	uint64_t nameOffset     : 64;
+
+	// Version 1 fields, zero in older binaries (the header page is padded)
+	uint32_t version            : 32;
+	uint32_t symbolIndexBuckets : 32; // 0 if there is no symbol index
+	uint64_t symbolIndexOffset  : 64;
+
+	// Version 2 fields, with compression codeOffset and dataOffset are
+	//  the addresses that symbols refer to rather than file offsets
+	uint32_t compression         : 32;
+	uint32_t directoryEntries    : 32; // code pages, then data pages
+	uint64_t pageDirectoryOffset : 64;
+
+	// Version 3 fields, with either encoding the offsets of code symbols
+	//  are codeOffset + PC * sizeof(InstructionContainer)
+	uint32_t encoding            : 32;
+	uint32_t instructionsPerPage : 32; // compact encoding only
 };
 
 }
@@ -9,18 +9,25 @@
 // Vanaheimr Includes
 #include <vanaheimr/asm/interface/BinaryHeader.h>
 #include <vanaheimr/asm/interface/SymbolTableEntry.h>
+#include <vanaheimr/asm/interface/SymbolIndexBuilder.h>
+#include <vanaheimr/asm/interface/PageDirectory.h>
 
 #include <vanaheimr/asm/interface/Instruction.h>
 
 #include <vanaheimr/ir/interface/Function.h>
 #include <vanaheimr/ir/interface/Global.h>
 
+#include <vanaheimr/util/interface/ArrayView.h>
+
 // Standard Library Includes
 #include <istream>
 #include <vector>
 #include <unordered_map>
+#include <memory>
 
-namespace vanaheimr { namespace ir { class Constant; } }
+// Forward Declarations
+namespace vanaheimr { namespace ir   { class Constant;   } }
+namespace vanaheimr { namespace util { class MappedFile; } }
 
 namespace vanaheimr
 {
@@ -31,16 +38,33 @@ namespace as
 /*! \brief Reads in a vanaheimr bytecode file yielding a module. */
 class BinaryReader
 {
+public:
+	BinaryReader();
+	~BinaryReader();
+
 public:
 	/*! \brief Attempts to read from a binary stream, returns a module */
 	ir::Module* read(std::istream& stream, const std::string& name);
 
+	/*! \brief Maps a binary file into memory, returns a module
+
+		Globals and function signatures are declared immediately, the
+		sections are used in place and each function body is only
+		decoded the first time the module materializes it.
+	*/
+	ir::Module* map(const std::string& path, const std::string& name);
+
 private:
-	typedef std::vector<InstructionContainer>       InstructionVector;
-	typedef std::vector<char>                       DataVector;
-	typedef std::vector<SymbolTableEntry>           SymbolVector;
+	typedef util::ArrayView<InstructionContainer> InstructionView;
+	typedef util::ArrayView<char>                 DataView;
+	typedef util::ArrayView<SymbolTableEntry>     SymbolView;
+	typedef util::ArrayView<uint32_t>             BucketView;
+	typedef util::ArrayView<SymbolIndexEntry>     SymbolIndexView;
+
+	typedef std::vector<char>                 DataVector;
+	typedef std::vector<InstructionContainer> InstructionVector;
 
-	typedef SymbolVector::iterator symbol_iterator;
+	typedef SymbolView::const_iterator symbol_iterator;
 
 	class BasicBlockDescriptor
 	{
@@ -56,18 +80,49 @@ private:
 
 	typedef std::vector<BasicBlockDescriptor> BasicBlockDescriptorVector;
 
+	/*! \brief A compressed section, pages are expanded on first use */
+	class PagedSection
+	{
+	public:
+		PagedSection();
+
+	public:
+		const PageDirectoryEntry* directory; // the section's first page
+		std::unique_ptr<char[]>   pages;
+		std::vector<bool>         resident;
+	};
+
 private:
-	void _readHeader(std::istream& stream);
-	void _readDataSection(std::istream& stream);
-	void _readStringTable(std::istream& stream);
-	void _readSymbolTable(std::istream& stream);
-	void _readInstructions(std::istream& stream);
+	void _readFile(std::istream& stream);
+	void _readSections();
+
+	void _readHeader();
+	void _readDataSection();
+	void _readStringTable();
+	void _readSymbolTable();
+	void _readInstructions();
+	void _readSymbolIndex();
+	void _readPageDirectory();
+
+	const char* _readPagedSection(PagedSection& section, uint64_t pages,
+		const std::string& name);
+	void _makeResident(PagedSection& section, uint64_t offset,
+		uint64_t size);
+
+	void _fetchInstructions(uint64_t begin, uint64_t end);
+	const InstructionContainer& _getInstruction(uint64_t pc) const;
+
+	const char* _getSection(uint64_t offset, uint64_t size,
+		const std::string& name) const;
 
 private:
 	void _loadTypes();
 	void _initializeModule(ir::Module& m);
 	void _loadGlobals(ir::Module& m);
+	void _loadArguments(ir::Module& m);
 	void _loadFunctions(ir::Module& m);
+	void _loadFunctionBody(ir::Function& function,
+		const SymbolTableEntry& symbol);
 	
 private:
 	std::string              _getSymbolName(
@@ -91,6 +146,8 @@ private:
 	BasicBlockDescriptorVector _getBasicBlocksInFunction(
 		const SymbolTableEntry& name) const;
 
+	const OperandContainer& _getDataOperand(uint64_t offset);
+
 	void _addInstruction(ir::Function::iterator block,
 		const InstructionContainer& container);
 
@@ -117,14 +174,39 @@ private:
 	ir::Variable* _getVariableAtSymbolOffset(uint64_t offset);
 	ir::Argument* _getArgumentAtSymbolOffset(uint64_t offset) const;
 	const SymbolTableEntry& _getSymbolEntryAtOffset(uint64_t offset) const; 
+	uint64_t _getSymbolOffset(symbol_iterator symbol) const;
+	symbol_iterator _findSymbol(const std::string& name) const;
+
+private:
+	/*! \brief The whole file, either copied from a stream or mapped */
+	const char* _file;
+	size_t      _fileSize;
+
+	DataVector                        _buffer;
+	std::unique_ptr<util::MappedFile> _mapping;
 
 private:
 	BinaryHeader _header;
 
-	InstructionVector _instructions;
-	DataVector        _dataSection;
-	DataVector        _stringTable;
-	SymbolVector      _symbolTable;
+	InstructionView _instructions;
+	DataView        _codeSection;
+	DataView        _dataSection;
+	DataView        _stringTable;
+	SymbolView      _symbolTable;
+
+	/*! \brief The symbol index, built on load for binaries without one */
+	BucketView         _symbolBuckets;
+	SymbolIndexView    _symbolChains;
+	SymbolIndexBuilder _builtSymbolIndex;
+
+	/*! \brief Code and data pages of compressed binaries */
+	PagedSection _codePages;
+	PagedSection _dataPages;
+
+	/*! \brief The decoded instructions of the function being loaded from
+		a binary with compact encoding */
+	InstructionVector _decodedInstructions;
+	uint64_t          _firstDecodedPC;
 
 private:
 	typedef std::unordered_map<RegisterType,
@@ -143,6 +225,9 @@ private:
 	SymbolToVariableMap      _locals;
 	TargetToBranchOperandMap _unresolvedTargets;
 	ir::Function*            _function;
+
+private:
+	friend class BinaryFunctionMaterializer;
 };
 
 }
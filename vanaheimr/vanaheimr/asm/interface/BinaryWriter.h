@@ -10,12 +10,15 @@
 #include <vanaheimr/asm/interface/BinaryHeader.h>
 
 #include <vanaheimr/asm/interface/SymbolTableEntry.h>
+#include <vanaheimr/asm/interface/SymbolIndexBuilder.h>
+#include <vanaheimr/asm/interface/PageDirectory.h>
 
 #include <vanaheimr/asm/interface/Instruction.h>
 
 // Standard Library Includes
 #include <vector>
 #include <unordered_map>
+#include <string>
 #include <ostream>
 
 // Forward Declarations
@@ -23,8 +26,13 @@ namespace vanaheimr { namespace ir { class Module;      } }
 namespace vanaheimr { namespace ir { class Global;      } }
 namespace vanaheimr { namespace ir { class Instruction; } }
 namespace vanaheimr { namespace ir { class Operand;     } }
+namespace vanaheimr { namespace ir { class RegisterOperand; } }
 namespace vanaheimr { namespace ir { class Argument;    } }
 namespace vanaheimr { namespace ir { class Variable;    } }
+namespace vanaheimr { namespace ir { class Function;    } }
+namespace vanaheimr { namespace ir { class StreamedArrayConstant; } }
+
+namespace vanaheimr { namespace util { class ThreadPool; } }
 
 /*! \brief The wrapper namespace for Vanaheimr */
 namespace vanaheimr
@@ -33,7 +41,21 @@ namespace vanaheimr
 namespace as
 {
 
-/*! \brief Represents a single compilation unit. */
+/*! \brief Represents a single compilation unit.
+
+	The binary is streamed out.  A serial pass lays out symbols and data,
+	a second pass sizes the encoded instructions to fix the code page
+	layout, and a third pass converts batches of functions again and
+	writes their code pages as they fill.  Only one encoded byte per
+	instruction is kept for the whole module, so memory is bounded by the
+	data section and a batch of functions rather than the code size.
+	Streamed initializers are not part of that, they are read one page at
+	a time while the data section is written.
+
+	Both conversion passes may run on several threads, functions are
+	always appended in module order so the output does not depend on the
+	thread count.  The header is written last, the stream must be seekable.
+*/
 class BinaryWriter
 {
 public:
@@ -46,17 +68,39 @@ public:
 	static const unsigned int PageSize = BinaryHeader::PageSize;
 
 public:
-	BinaryWriter();
+	typedef BinaryHeader::Compression Compression;
+
+public:
+	/*! \brief Create a writer, functions are converted on 'threads'
+		threads, 0 uses the hardware concurrency and 1 is serial */
+	BinaryWriter(Compression compression = BinaryHeader::NoCompression,
+		unsigned int threads = 1);
 	void write(std::ostream& binary, const ir::Module& inputModule);
 
+public:
+	/*! \brief The register number encoded for an operand, the physical
+		register after allocation, otherwise the virtual register id */
+	static unsigned int getEncodedRegister(const ir::RegisterOperand& operand);
+
+private:
+	/*! \brief The instructions converted together in the streaming pass */
+	static const uint64_t InstructionsPerBatch = 1 << 16;
+
 private:
 	void writePage(std::ostream& binary, const void* data,
 		uint64_t size);
+	void writeHeader(std::ostream& binary);
+	void writeInstructions(std::ostream& binary, util::ThreadPool& pool);
+	void writeData(std::ostream& binary);
+	void writeSectionPage(std::ostream& binary, const char* page);
 
 	void populateHeader();
-	void populateInstructions();
+	void populateFunctions();
+	void sizeInstructions(util::ThreadPool& pool);
 	void populateData();
+	void layoutStreamedData();
 	void linkSymbols();
+	void populateSymbolIndex();
 
 private:
 	size_t getHeaderOffset() const;
@@ -64,14 +108,27 @@ private:
 	size_t getDataOffset() const;
 	size_t getSymbolTableOffset() const;
 	size_t getStringTableOffset() const;
+	size_t getSymbolIndexOffset() const;
+	size_t getCompressedPagesOffset() const;
+	size_t getPageDirectoryOffset() const;
 
 	size_t getSymbolTableSize() const;
 	size_t getInstructionStreamSize() const;
 	size_t getDataSize() const;
 	size_t getStringTableSize() const;
+	size_t getSymbolIndexSize() const;
+	size_t getPageDirectorySize() const;
+
+	uint64_t getAddressedDataSize() const;
+
+	typedef std::vector<uint8_t> InstructionSizeVector;
+
+	static unsigned int getInstructionsPerPage(
+		const InstructionSizeVector& sizes);
+	uint64_t getInstructionCount() const;
 	
 	void convertComplexInstruction(InstructionContainer& container,
-		const Instruction& instruction);
+		const Instruction& instruction, uint64_t& dataOffset);
 	void convertUnaryInstruction(InstructionContainer& container,
 		const Instruction& instruction);
 	void convertBinaryInstruction(InstructionContainer& container,
@@ -80,7 +137,8 @@ private:
 		const Instruction& instruction);
 	
 	OperandContainer     convertOperand(const Operand&);
-	InstructionContainer convertToContainer(const Instruction&); 
+	InstructionContainer convertToContainer(const Instruction&,
+		uint64_t& dataOffset);
 
 	size_t getSymbolTableOffset(const ir::Argument* a);
 	size_t getSymbolTableOffset(const ir::Variable* g);
@@ -103,38 +161,86 @@ private:
 	void convertBraInstruction(InstructionContainer& container,
 		const Instruction& instruction);
 	void convertCallInstruction(InstructionContainer& container,
-		const Instruction& instruction);
+		const Instruction& instruction, uint64_t& dataOffset);
 	void convertRetInstruction(InstructionContainer& container,
 		const Instruction& instruction);
 	void convertPhiInstruction(InstructionContainer& container,
-		const Instruction& instruction);
+		const Instruction& instruction, uint64_t& dataOffset);
 
 private:
-	void addOperandToDataSection(const OperandContainer& operand);
+	void addOperandToDataSection(const OperandContainer& operand,
+		uint64_t& dataOffset);
+	void reserveOperandData(const Instruction& instruction);
 
 private:
 	static uint64_t align(uint64_t address, uint64_t alignment);
 	static uint64_t pageAlign(uint64_t address);
 
 private:
-	typedef std::vector<InstructionContainer>         InstructionVector;
 	typedef std::vector<char>                         DataVector;
 	typedef std::vector<SymbolTableEntry>             SymbolVector;
-	typedef std::unordered_map<std::string, uint64_t> OffsetMap;
 	typedef std::unordered_map<uint64_t, uint64_t>    OffsetToSymbolMap;
+	typedef std::unordered_map<std::string, size_t>   NameToSymbolMap;
+	typedef std::vector<PageDirectoryEntry>           PageDirectory;
+
+	typedef std::unordered_map<const ir::Variable*, uint64_t>
+		VariableToOffsetMap;
+
+	/*! \brief The place of a function's instructions and operand lists */
+	class FunctionLayout
+	{
+	public:
+		const ir::Function* function;
+		uint64_t            firstInstruction;
+		uint64_t            instructions;
+		uint64_t            dataOffset;
+		uint64_t            dataSize;
+	};
+
+	typedef std::vector<FunctionLayout> FunctionLayoutVector;
+
+	/*! \brief A global whose initializer is read as it is written */
+	class StreamedData
+	{
+	public:
+		std::string                      name;
+		const ir::StreamedArrayConstant* constant;
+		uint64_t                         offset;
+	};
+
+	typedef std::vector<StreamedData> StreamedDataVector;
+
+private:
+	void addBasicBlockSymbol(const Operand& operand,
+		const VariableToOffsetMap& blockOffsets,
+		OffsetToSymbolMap& blockSymbols);
+	void encodeFunction(const FunctionLayout& layout, DataVector* records,
+		uint8_t* sizes);
 
 private:
-	const ir::Module*  m_module;
+	const ir::Module*     m_module;
+	Compression           m_compression;
+	unsigned int          m_threads;
 	
-	BinaryHeader      m_header;
-	InstructionVector m_instructions;
-	DataVector        m_data;
-	SymbolVector      m_symbolTable;
-	DataVector        m_stringTable;
+	BinaryHeader          m_header;
+	FunctionLayoutVector  m_functions;
+	InstructionSizeVector m_instructionSizes;
+	uint64_t              m_codeSize;
+	unsigned int          m_instructionsPerPage;
+	DataVector            m_data;
+	StreamedDataVector    m_streamedData;
+	SymbolVector          m_symbolTable;
+	DataVector            m_stringTable;
+	DataVector            m_symbolIndex;
+
+private:
+	uint64_t          m_compressedSize;
+	DataVector        m_compressedPage;
+	PageDirectory     m_pageDirectory;
 
 private:
-	OffsetMap         m_basicBlockOffsets;
-	OffsetToSymbolMap m_basicBlockSymbols;
+	VariableToOffsetMap m_basicBlockSymbols;
+	NameToSymbolMap     m_symbolNames;
 };
 
 }
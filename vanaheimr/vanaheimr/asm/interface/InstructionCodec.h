@@ -0,0 +1,350 @@
+/*! \file   InstructionCodec.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the InstructionCodec class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/Instruction.h>
+#include <vanaheimr/asm/interface/BinaryHeader.h>
+
+#include <vanaheimr/util/interface/IntTypes.h>
+#include <vanaheimr/util/interface/HostDevice.h>
+
+// Standard Library Includes
+#include <cstddef>
+
+namespace vanaheimr
+{
+
+namespace as
+{
+
+/*! \brief The compact, variable length encoding of instructions
+
+	An instruction is its opcode byte, its guard, then only the fields
+	that its opcode uses, so an add takes a fraction of the space of an
+	InstructionContainer.  An operand starts with a byte holding its
+	mode in the low nibble and its data type (or predicate modifier) in
+	the high nibble.  Registers, offsets, counts and integer immediates
+	are LEB128 varints, floating point immediates are stored as is.
+
+	A compact code page holds BinaryHeader::instructionsPerPage
+	instructions (fewer in the last page).  It starts with a table of
+	16-bit page offsets, one per instruction, followed by the encoded
+	instructions, so a PC is found with a division, a table lookup and
+	a decode.
+
+	Decoding produces exactly the container that was encoded, provided
+	that its unused bytes were zero.  It is also compiled for the device
+	so that the simulator can decode code pages itself.
+*/
+class InstructionCodec
+{
+public:
+	static const unsigned int PageSize               = BinaryHeader::PageSize;
+	static const unsigned int MaximumInstructionSize = 96;
+
+public:
+	/*! \brief Encode an instruction, returns the encoded size, at most
+		MaximumInstructionSize bytes */
+	static size_t encode(const InstructionContainer& instruction,
+		void* output);
+
+public:
+	/*! \brief Decode the instruction in a slot of a compact code page,
+		returns false if the page is malformed */
+	VANAHEIMR_HOST_DEVICE static bool decode(const void* page,
+		unsigned int slot, unsigned int instructionsPerPage,
+		InstructionContainer& instruction)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(page);
+
+		if(slot >= instructionsPerPage) return false;
+
+		unsigned int tableSize = instructionsPerPage * sizeof(uint16_t);
+
+		if(tableSize >= PageSize) return false;
+
+		unsigned int begin = _readOffset(bytes, slot);
+		unsigned int end   = PageSize;
+
+		// Unused slots of the last page have an offset of zero
+		if(slot + 1 < instructionsPerPage)
+		{
+			unsigned int next = _readOffset(bytes, slot + 1);
+
+			if(next != 0) end = next;
+		}
+
+		if(begin < tableSize || begin >= end) return false;
+
+		return decode(bytes + begin, end - begin, instruction);
+	}
+
+	/*! \brief Decode one instruction from at most inputSize bytes */
+	VANAHEIMR_HOST_DEVICE static bool decode(const void* input,
+		size_t inputSize, InstructionContainer& instruction)
+	{
+		Stream stream(static_cast<const uint8_t*>(input), inputSize);
+
+		_clear(&instruction, sizeof(InstructionContainer));
+
+		instruction.asInstruction.opcode = (Instruction::Opcode)stream.byte();
+
+		OperandContainer guard;
+
+		_clear(&guard, sizeof(OperandContainer));
+		_decodeOperand(stream, guard);
+
+		instruction.asInstruction.guard = guard.asPredicate;
+
+		switch(instruction.asInstruction.opcode)
+		{
+		case Instruction::Add:  // fall through
+		case Instruction::And:  // fall through
+		case Instruction::Ashr: // fall through
+		case Instruction::Fdiv: // fall through
+		case Instruction::Fmul: // fall through
+		case Instruction::Frem: // fall through
+		case Instruction::Lshr: // fall through
+		case Instruction::Mul:  // fall through
+		case Instruction::Or:   // fall through
+		case Instruction::Sdiv: // fall through
+		case Instruction::Shl:  // fall through
+		case Instruction::Srem: // fall through
+		case Instruction::Sub:  // fall through
+		case Instruction::Udiv: // fall through
+		case Instruction::Urem: // fall through
+		case Instruction::Xor:
+		{
+			_decodeOperand(stream, instruction.asBinaryInstruction.d);
+			_decodeOperand(stream, instruction.asBinaryInstruction.a);
+			_decodeOperand(stream, instruction.asBinaryInstruction.b);
+			break;
+		}
+		case Instruction::Setp:
+		{
+			_decodeOperand(stream, instruction.asSetp.d);
+			_decodeOperand(stream, instruction.asSetp.a);
+			_decodeOperand(stream, instruction.asSetp.b);
+
+			instruction.asSetp.comparison =
+				(ComparisonInstruction::Comparison)stream.byte();
+			break;
+		}
+		case Instruction::Atom:
+		{
+			_decodeOperand(stream, instruction.asAtom.d);
+			_decodeOperand(stream, instruction.asAtom.a);
+			_decodeOperand(stream, instruction.asAtom.b);
+
+			instruction.asAtom.operation = (Atom::Operation)stream.byte();
+
+			_decodeOperand(stream, instruction.asAtom.c);
+			break;
+		}
+		case Instruction::Bitcast: // fall through
+		case Instruction::Fpext:   // fall through
+		case Instruction::Fptosi:  // fall through
+		case Instruction::Fptoui:  // fall through
+		case Instruction::Fptrunc: // fall through
+		case Instruction::Ld:      // fall through
+		case Instruction::Ret:     // fall through
+		case Instruction::Sext:    // fall through
+		case Instruction::Sitofp:  // fall through
+		case Instruction::St:      // fall through
+		case Instruction::Trunc:   // fall through
+		case Instruction::Uitofp:  // fall through
+		case Instruction::Zext:
+		{
+			_decodeOperand(stream, instruction.asUnaryInstruction.d);
+			_decodeOperand(stream, instruction.asUnaryInstruction.a);
+			break;
+		}
+		case Instruction::Bra:
+		{
+			_decodeOperand(stream, instruction.asBra.target);
+
+			instruction.asBra.modifier = (Bra::BranchModifier)stream.byte();
+			break;
+		}
+		case Instruction::Call:
+		{
+			_decodeOperand(stream, instruction.asCall.target);
+
+			instruction.asCall.returnArguments      = stream.varint();
+			instruction.asCall.arguments            = stream.varint();
+			instruction.asCall.returnArgumentOffset = stream.varint();
+			instruction.asCall.argumentOffset       = stream.varint();
+			break;
+		}
+		case Instruction::Membar:
+		{
+			instruction.asMembar.level = (Membar::Level)stream.byte();
+			break;
+		}
+		case Instruction::Phi:
+		{
+			_decodeOperand(stream, instruction.asPhi.destination);
+
+			instruction.asPhi.sources       = stream.varint();
+			instruction.asPhi.sourcesOffset = stream.varint();
+			break;
+		}
+		case Instruction::Bar:    // fall through
+		case Instruction::Launch: // fall through
+		case Instruction::Psi:
+		{
+			break;
+		}
+		default: return false;
+		}
+
+		return stream.valid();
+	}
+
+private:
+	/*! \brief Reads bytes and varints, remembering if it ran out */
+	class Stream
+	{
+	public:
+		VANAHEIMR_HOST_DEVICE Stream(const uint8_t* begin, size_t size)
+		: _position(begin), _end(begin + size), _valid(true) {}
+
+	public:
+		VANAHEIMR_HOST_DEVICE unsigned int byte()
+		{
+			if(_position == _end)
+			{
+				_valid = false;
+				return 0;
+			}
+
+			return *_position++;
+		}
+
+		VANAHEIMR_HOST_DEVICE uint64_t varint()
+		{
+			uint64_t value = 0;
+
+			for(unsigned int shift = 0; shift < 64; shift += 7)
+			{
+				unsigned int next = byte();
+
+				value |= (uint64_t)(next & 0x7f) << shift;
+
+				if((next & 0x80) == 0) return value;
+			}
+
+			_valid = false;
+
+			return value;
+		}
+
+		VANAHEIMR_HOST_DEVICE uint64_t raw64()
+		{
+			uint64_t value = 0;
+
+			for(unsigned int shift = 0; shift < 64; shift += 8)
+			{
+				value |= (uint64_t)byte() << shift;
+			}
+
+			return value;
+		}
+
+		VANAHEIMR_HOST_DEVICE void invalidate()
+		{
+			_valid = false;
+		}
+
+		VANAHEIMR_HOST_DEVICE bool valid() const
+		{
+			return _valid;
+		}
+
+	private:
+		const uint8_t* _position;
+		const uint8_t* _end;
+		bool           _valid;
+	};
+
+private:
+	VANAHEIMR_HOST_DEVICE static void _clear(void* data, size_t size)
+	{
+		uint8_t* bytes = static_cast<uint8_t*>(data);
+
+		for(size_t i = 0; i < size; ++i) bytes[i] = 0;
+	}
+
+	VANAHEIMR_HOST_DEVICE static unsigned int _readOffset(
+		const uint8_t* page, unsigned int slot)
+	{
+		return page[2 * slot] | (page[2 * slot + 1] << 8);
+	}
+
+	VANAHEIMR_HOST_DEVICE static bool _isFloatingPoint(unsigned int type)
+	{
+		return type == f32 || type == f64;
+	}
+
+	VANAHEIMR_HOST_DEVICE static void _decodeOperand(Stream& stream,
+		OperandContainer& operand)
+	{
+		unsigned int header = stream.byte();
+		unsigned int mode   = header & 0xf;
+		unsigned int extra  = header >> 4;
+
+		operand.asOperand.mode = (Operand::OperandMode)mode;
+
+		switch(mode)
+		{
+		case Operand::Register:
+		{
+			operand.asRegister.type = (DataType)extra;
+			operand.asRegister.reg  = stream.varint();
+			break;
+		}
+		case Operand::Immediate:
+		{
+			operand.asImmediate.type = (DataType)extra;
+			operand.asImmediate.uint = _isFloatingPoint(extra) ?
+				stream.raw64() : stream.varint();
+			break;
+		}
+		case Operand::Predicate:
+		{
+			operand.asPredicate.modifier =
+				(PredicateOperand::PredicateModifier)extra;
+			operand.asPredicate.reg = stream.varint();
+			break;
+		}
+		case Operand::Indirect:
+		{
+			operand.asIndirect.type   = (DataType)extra;
+			operand.asIndirect.reg    = stream.varint();
+			operand.asIndirect.offset = stream.varint();
+			break;
+		}
+		case Operand::Symbol:
+		{
+			operand.asSymbol.symbolTableOffset = stream.varint();
+			break;
+		}
+		case Operand::InvalidOperand:
+		{
+			break;
+		}
+		default: stream.invalidate();
+		}
+	}
+
+};
+
+}
+
+}
+
@@ -0,0 +1,44 @@
+/*!	\file   PageDirectory.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the specification of the page directory
+	        of compressed binaries
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntTypes.h>
+
+/*! \brief The wrapper namespace for Vanaheimr */
+namespace vanaheimr
+{
+
+/*! \brief A namespace for the internal representation */
+namespace as
+{
+
+/*! \brief Locates one compressed code or data page in the file
+
+	Every page expands to exactly BinaryHeader::PageSize bytes, so any
+	page can be loaded on its own.
+*/
+class PageDirectoryEntry
+{
+public:
+	enum Method
+	{
+		Stored = 0x0, // the page did not compress, it is stored as is
+		LZ     = 0x1  // the page is a util::LZCodec block
+	};
+
+public:
+	uint64_t offset : 64; // the file offset of the stored page
+	uint32_t size   : 32; // the bytes stored in the file
+	uint32_t method : 32;
+};
+
+}
+
+}
+
@@ -0,0 +1,87 @@
+/*!	\file   SymbolIndex.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the specification of the symbol index
+	        section of the binary
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntTypes.h>
+#include <vanaheimr/util/interface/HostDevice.h>
+
+/*! \brief The wrapper namespace for Vanaheimr */
+namespace vanaheimr
+{
+
+/*! \brief A namespace for the internal representation */
+namespace as
+{
+
+/*! \brief A link in a hash chain, stored at the position of its symbol */
+class SymbolIndexEntry
+{
+public:
+	uint32_t hash : 32; // the hash of the symbol name
+	uint32_t next : 32; // the next symbol in the same bucket
+};
+
+/*! \brief The layout of the optional symbol index section
+
+	The section holds symbolIndexBuckets 32-bit chain heads followed by
+	one SymbolIndexEntry per symbol table entry.  Chains are sorted by
+	symbol position, so a lookup finds the same symbol as a linear scan
+	of the table would when names repeat (e.g. basic block labels).
+*/
+class SymbolIndex
+{
+public:
+	/*! \brief Ends a chain or marks an empty bucket */
+	static const uint32_t InvalidSymbol = 0xffffffff;
+
+public:
+	/*! \brief The 32-bit FNV-1a hash of a null terminated name */
+	VANAHEIMR_HOST_DEVICE static uint32_t hash(const char* name)
+	{
+		uint32_t value = 2166136261u;
+
+		for(; *name != '\0'; ++name)
+		{
+			value ^= (unsigned char)*name;
+			value *= 16777619u;
+		}
+
+		return value;
+	}
+
+	/*! \brief The bucket holding a hash, the bucket count is a power of 2 */
+	VANAHEIMR_HOST_DEVICE static uint32_t bucket(uint32_t hash,
+		uint32_t buckets)
+	{
+		return hash & (buckets - 1);
+	}
+
+	/*! \brief The number of buckets used for a symbol table */
+	VANAHEIMR_HOST_DEVICE static uint32_t bucketCount(uint32_t symbols)
+	{
+		uint32_t buckets = 1;
+
+		while(buckets < symbols && buckets < 0x80000000u) buckets <<= 1;
+
+		return buckets;
+	}
+
+	/*! \brief The size of the section in bytes */
+	VANAHEIMR_HOST_DEVICE static uint64_t size(uint32_t buckets,
+		uint32_t symbols)
+	{
+		return buckets * (uint64_t)sizeof(uint32_t) +
+			symbols * (uint64_t)sizeof(SymbolIndexEntry);
+	}
+};
+
+}
+
+}
+
@@ -0,0 +1,44 @@
+/*! \file   SymbolIndexBuilder.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the SymbolIndexBuilder class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/SymbolIndex.h>
+#include <vanaheimr/asm/interface/SymbolTableEntry.h>
+
+// Standard Library Includes
+#include <vector>
+#include <cstddef>
+
+namespace vanaheimr
+{
+
+namespace as
+{
+
+/*! \brief Builds the hash chains of a symbol index over a symbol table */
+class SymbolIndexBuilder
+{
+public:
+	typedef std::vector<uint32_t>         BucketVector;
+	typedef std::vector<SymbolIndexEntry> EntryVector;
+
+public:
+	/*! \brief Index the symbols, names are offsets into the string table */
+	void build(const SymbolTableEntry* symbols, uint32_t symbolCount,
+		const char* strings, size_t stringTableSize);
+
+public:
+	BucketVector buckets;
+	EntryVector  entries;
+
+};
+
+}
+
+}
+
@@ -5,6 +5,11 @@
 	        the binary
 */
 
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntTypes.h>
+
 /*! \brief The wrapper namespace for Vanaheimr */
 namespace vanaheimr
 {
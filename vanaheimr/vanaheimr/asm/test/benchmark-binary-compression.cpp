@@ -0,0 +1,246 @@
+/*! \file   benchmark-binary-compression.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the binary page compression benchmark.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/BinaryWriter.h>
+#include <vanaheimr/asm/interface/BinaryReader.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <memory>
+
+namespace benchmark
+{
+
+static double seconds(std::chrono::steady_clock::time_point begin,
+	std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+/*! \brief Fill a function with a chain of three operand adds */
+static void buildFunction(vanaheimr::ir::Function& function,
+	const vanaheimr::ir::Type* type, unsigned int blocks,
+	unsigned int instructions)
+{
+	namespace ir = vanaheimr::ir;
+
+	auto previous = &*function.newVirtualRegister(type);
+
+	for(unsigned int b = 0; b < blocks; ++b)
+	{
+		std::stringstream name;
+
+		name << "block" << b;
+
+		auto block = function.newBasicBlock(function.exit_block(),
+			name.str());
+
+		for(unsigned int i = 0; i < instructions; ++i)
+		{
+			auto next = &*function.newVirtualRegister(type);
+
+			auto add = new ir::Add(&*block);
+
+			add->setGuard(new ir::PredicateOperand(
+				ir::PredicateOperand::PredicateTrue, add));
+			add->setD(new ir::RegisterOperand(next,     add));
+			add->setA(new ir::RegisterOperand(previous, add));
+			add->setB(new ir::ImmediateOperand((uint64_t)i, add, type));
+
+			block->push_back(add);
+
+			previous = next;
+		}
+	}
+}
+
+static size_t writeModule(const vanaheimr::ir::Module& module,
+	const std::string& path, vanaheimr::as::BinaryHeader::Compression method,
+	unsigned int threads, double& writeTime)
+{
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+
+	if(!file.is_open())
+	{
+		throw std::runtime_error("Could not open '" + path + "' for writing.");
+	}
+
+	vanaheimr::as::BinaryWriter writer(method, threads);
+
+	auto begin = std::chrono::steady_clock::now();
+
+	writer.write(file, module);
+
+	writeTime = seconds(begin, std::chrono::steady_clock::now());
+
+	return file.tellp();
+}
+
+/*! \brief Time reading a whole binary and mapping then materializing it */
+static void benchmarkLoad(const std::string& path, unsigned int iterations,
+	double& readTime, double& mapTime)
+{
+	namespace as = vanaheimr::as;
+
+	readTime = 0.0;
+	mapTime  = 0.0;
+
+	for(unsigned int iteration = 0; iteration < iterations; ++iteration)
+	{
+		auto begin = std::chrono::steady_clock::now();
+
+		{
+			std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+
+			as::BinaryReader reader;
+
+			std::unique_ptr<vanaheimr::ir::Module> module(
+				reader.read(file, path));
+		}
+
+		auto read = std::chrono::steady_clock::now();
+
+		{
+			as::BinaryReader reader;
+
+			std::unique_ptr<vanaheimr::ir::Module> module(
+				reader.map(path, path));
+
+			module->materializeAll();
+		}
+
+		auto mapped = std::chrono::steady_clock::now();
+
+		readTime += seconds(begin, read);
+		mapTime  += seconds(read,  mapped);
+	}
+}
+
+static void benchmarkCompression(const std::string& path,
+	unsigned int functions, unsigned int blocks, unsigned int instructions,
+	unsigned int iterations, unsigned int threads)
+{
+	namespace ir = vanaheimr::ir;
+	namespace as = vanaheimr::as;
+
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto type = compiler->getType("i32");
+
+	if(type == nullptr) throw std::runtime_error("No i32 type.");
+
+	ir::Module module("benchmark", compiler);
+
+	for(unsigned int f = 0; f < functions; ++f)
+	{
+		std::stringstream name;
+
+		name << "function" << f;
+
+		auto function = module.newFunction(name.str(),
+			ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility,
+			type);
+
+		buildFunction(*function, type, blocks, instructions);
+	}
+
+	std::string compressedPath = path + ".compressed";
+
+	double plainWrite      = 0.0;
+	double compressedWrite = 0.0;
+
+	size_t plainSize      = writeModule(module, path,
+		as::BinaryHeader::NoCompression, threads, plainWrite);
+	size_t compressedSize = writeModule(module, compressedPath,
+		as::BinaryHeader::PageCompression, threads, compressedWrite);
+
+	std::cout << "  uncompressed: " << plainSize      << " bytes\n";
+	std::cout << "  compressed:   " << compressedSize << " bytes ("
+		<< ((double)plainSize / compressedSize) << "x)\n";
+	std::cout << "  write:        " << (plainWrite * 1000.0)
+		<< " ms uncompressed, " << (compressedWrite * 1000.0)
+		<< " ms compressed\n";
+
+	if(iterations == 0) return;
+
+	double plainRead      = 0.0;
+	double plainMap       = 0.0;
+	double compressedRead = 0.0;
+	double compressedMap  = 0.0;
+
+	benchmarkLoad(path,           iterations, plainRead,      plainMap);
+	benchmarkLoad(compressedPath, iterations, compressedRead, compressedMap);
+
+	std::cout << "  read:         " << (plainRead * 1000.0 / iterations)
+		<< " ms uncompressed, " << (compressedRead * 1000.0 / iterations)
+		<< " ms compressed\n";
+	std::cout << "  map:          " << (plainMap * 1000.0 / iterations)
+		<< " ms uncompressed, " << (compressedMap * 1000.0 / iterations)
+		<< " ms compressed\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	std::string  path;
+	unsigned int functions    = 0;
+	unsigned int blocks       = 0;
+	unsigned int instructions = 0;
+	unsigned int iterations   = 0;
+	unsigned int threads      = 0;
+
+	parser.description("This program writes a synthetic module as a plain "
+		"and as a page compressed VIR binary, and compares their sizes and "
+		"load times.");
+
+	parser.parse("-o", "--output",       path,         "benchmark.vir",
+		"The path of the uncompressed binary.");
+	parser.parse("-f", "--functions",    functions,    16,
+		"The number of functions in the module.");
+	parser.parse("-b", "--blocks",       blocks,       64,
+		"The number of basic blocks in each function.");
+	parser.parse("-n", "--instructions", instructions, 64,
+		"The number of instructions in each basic block.");
+	parser.parse("-i", "--iterations",   iterations,   10,
+		"The number of times to load each binary.");
+	parser.parse("-t", "--threads",      threads,      1,
+		"The number of threads used to write each binary.");
+	parser.parse();
+
+	try
+	{
+		benchmark::benchmarkCompression(path, functions, blocks, instructions,
+			iterations, threads);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "benchmark-binary-compression FAILED: " << e.what()
+			<< "\n";
+
+		return -1;
+	}
+
+	return 0;
+}
+
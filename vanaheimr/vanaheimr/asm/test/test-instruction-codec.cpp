@@ -0,0 +1,265 @@
+/*! \file   test-instruction-codec.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the test-instruction-codec test.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/asm/interface/InstructionCodec.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <iostream>
+#include <random>
+#include <cstring>
+
+namespace test
+{
+
+typedef vanaheimr::as::InstructionContainer InstructionContainer;
+typedef vanaheimr::as::OperandContainer     OperandContainer;
+typedef vanaheimr::as::InstructionCodec     InstructionCodec;
+
+typedef std::mt19937_64 Generator;
+
+static uint64_t randomValue(Generator& generator)
+{
+	// Favor small values, they take the short varint forms
+	unsigned int bits = generator() % 65;
+
+	if(bits == 64) return generator();
+
+	return generator() & ((1ULL << bits) - 1);
+}
+
+static OperandContainer randomOperand(Generator& generator)
+{
+	namespace as = vanaheimr::as;
+
+	OperandContainer operand;
+
+	std::memset(&operand, 0, sizeof(OperandContainer));
+
+	operand.asOperand.mode = (as::Operand::OperandMode)(generator() %
+		(as::Operand::InvalidOperand + 1));
+
+	switch(operand.asOperand.mode)
+	{
+	case as::Operand::Register:
+	{
+		operand.asRegister.reg  = randomValue(generator);
+		operand.asRegister.type = (as::DataType)(generator() % as::f64);
+		break;
+	}
+	case as::Operand::Immediate:
+	{
+		operand.asImmediate.uint = randomValue(generator);
+		operand.asImmediate.type = (as::DataType)(generator() %
+			as::InvalidDataType);
+		break;
+	}
+	case as::Operand::Predicate:
+	{
+		operand.asPredicate.reg      = randomValue(generator);
+		operand.asPredicate.modifier =
+			(as::PredicateOperand::PredicateModifier)(generator() %
+			as::PredicateOperand::InvalidPredicate);
+		break;
+	}
+	case as::Operand::Indirect:
+	{
+		operand.asIndirect.reg    = randomValue(generator);
+		operand.asIndirect.offset = randomValue(generator);
+		operand.asIndirect.type   = (as::DataType)(generator() % as::f64);
+		break;
+	}
+	case as::Operand::Symbol:
+	{
+		operand.asSymbol.symbolTableOffset = randomValue(generator);
+		break;
+	}
+	default: break;
+	}
+
+	return operand;
+}
+
+static InstructionContainer randomInstruction(Generator& generator)
+{
+	namespace as = vanaheimr::as;
+
+	InstructionContainer instruction;
+
+	std::memset(&instruction, 0, sizeof(InstructionContainer));
+
+	auto opcode = (as::Instruction::Opcode)(generator() %
+		as::Instruction::InvalidOpcode);
+
+	instruction.asInstruction.opcode = opcode;
+
+	instruction.asInstruction.guard.mode     = as::Operand::Predicate;
+	instruction.asInstruction.guard.reg      = randomValue(generator);
+	instruction.asInstruction.guard.modifier =
+		(as::PredicateOperand::PredicateModifier)(generator() %
+		as::PredicateOperand::InvalidPredicate);
+
+	switch(opcode)
+	{
+	case as::Instruction::Setp:
+	{
+		instruction.asSetp.comparison =
+			(as::ComparisonInstruction::Comparison)(generator() %
+			as::ComparisonInstruction::InvalidComparison);
+	}
+	// fall through
+	case as::Instruction::Add:
+	case as::Instruction::Xor:
+	{
+		instruction.asBinaryInstruction.d = randomOperand(generator);
+		instruction.asBinaryInstruction.a = randomOperand(generator);
+		instruction.asBinaryInstruction.b = randomOperand(generator);
+		break;
+	}
+	case as::Instruction::Atom:
+	{
+		instruction.asAtom.d = randomOperand(generator);
+		instruction.asAtom.a = randomOperand(generator);
+		instruction.asAtom.b = randomOperand(generator);
+		instruction.asAtom.c = randomOperand(generator);
+
+		instruction.asAtom.operation = (as::Atom::Operation)(generator() %
+			as::Atom::InvalidOperation);
+		break;
+	}
+	case as::Instruction::Ld:
+	case as::Instruction::St:
+	case as::Instruction::Ret:
+	{
+		instruction.asUnaryInstruction.d = randomOperand(generator);
+		instruction.asUnaryInstruction.a = randomOperand(generator);
+		break;
+	}
+	case as::Instruction::Bra:
+	{
+		instruction.asBra.target   = randomOperand(generator);
+		instruction.asBra.modifier = (as::Bra::BranchModifier)(generator() %
+			as::Bra::InvalidModifier);
+		break;
+	}
+	case as::Instruction::Call:
+	{
+		instruction.asCall.target               = randomOperand(generator);
+		instruction.asCall.returnArguments      = generator() % 1000;
+		instruction.asCall.arguments            = generator() % 1000;
+		instruction.asCall.returnArgumentOffset = randomValue(generator);
+		instruction.asCall.argumentOffset       = randomValue(generator);
+		break;
+	}
+	case as::Instruction::Membar:
+	{
+		instruction.asMembar.level = (as::Membar::Level)(generator() %
+			as::Membar::InvalidLevel);
+		break;
+	}
+	case as::Instruction::Phi:
+	{
+		instruction.asPhi.destination   = randomOperand(generator);
+		instruction.asPhi.sources       = generator() % 1000;
+		instruction.asPhi.sourcesOffset = randomValue(generator);
+		break;
+	}
+	default:
+	{
+		// Only opcodes with operands of their own are interesting
+		instruction.asInstruction.opcode = as::Instruction::Bar;
+		break;
+	}
+	}
+
+	return instruction;
+}
+
+static bool testInstructionCodec(unsigned int instructions,
+	unsigned int seed)
+{
+	Generator generator(seed);
+
+	size_t encodedBytes = 0;
+
+	for(unsigned int i = 0; i < instructions; ++i)
+	{
+		InstructionContainer instruction = randomInstruction(generator);
+
+		char encoded[InstructionCodec::MaximumInstructionSize];
+
+		size_t size = InstructionCodec::encode(instruction, encoded);
+
+		encodedBytes += size;
+
+		InstructionContainer decoded;
+
+		if(!InstructionCodec::decode(encoded, size, decoded))
+		{
+			std::cout << "Instruction " << i << " failed to decode.\n";
+			return false;
+		}
+
+		if(std::memcmp(&decoded, &instruction,
+			sizeof(InstructionContainer)) != 0)
+		{
+			std::cout << "Instruction " << i << " (opcode "
+				<< instruction.asInstruction.opcode
+				<< ") changed in a round trip.\n";
+			return false;
+		}
+
+		// A truncated instruction must be rejected, not misread
+		if(size > 1 && InstructionCodec::decode(encoded, size - 1, decoded))
+		{
+			std::cout << "Truncated instruction " << i << " was accepted.\n";
+			return false;
+		}
+	}
+
+	if(instructions > 0)
+	{
+		std::cout << " " << (double)encodedBytes / instructions
+			<< " bytes per instruction instead of "
+			<< sizeof(InstructionContainer) << "\n";
+	}
+
+	return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	unsigned int instructions = 0;
+	unsigned int seed         = 0;
+
+	parser.description("This program encodes and decodes random "
+		"instructions with the compact instruction encoding.");
+
+	parser.parse("-n", "--instructions", instructions, 100000,
+		"The number of instructions to test.");
+	parser.parse("-s", "--seed",         seed,         0,
+		"The random number generator seed.");
+	parser.parse();
+
+	if(!test::testInstructionCodec(instructions, seed))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	std::cout << "Test Passed\n";
+
+	return 0;
+}
+
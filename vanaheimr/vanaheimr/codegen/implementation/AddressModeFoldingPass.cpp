@@ -0,0 +1,299 @@
+/*! \file   AddressModeFoldingPass.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the AddressModeFoldingPass class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/codegen/interface/AddressModeFoldingPass.h>
+
+#include <vanaheimr/ir/interface/Function.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+#include <vanaheimr/util/interface/LargeMap.h>
+#include <vanaheimr/util/interface/LargeSet.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <vector>
+#include <utility>
+#include <cassert>
+
+// Preprocessor Macros
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
+namespace vanaheimr
+{
+
+namespace codegen
+{
+
+AddressModeFoldingPass::AddressModeFoldingPass()
+: FunctionPass({}, "AddressModeFoldingPass"), _foldedOperands(0),
+	_deletedInstructions(0)
+{
+
+}
+
+typedef std::vector<ir::Instruction*> InstructionVector;
+typedef util::LargeSet<ir::Instruction*> InstructionSet;
+typedef util::LargeMap<ir::VirtualRegister*, unsigned int> RegisterToIndexMap;
+typedef util::LargeMap<ir::VirtualRegister*, unsigned int> RegisterUseCountMap;
+
+static unsigned int foldBlock(ir::BasicBlock& block, InstructionSet& folded);
+static unsigned int deleteDeadArithmetic(ir::Function& function,
+	InstructionSet& folded);
+
+void AddressModeFoldingPass::runOnFunction(Function& f)
+{
+	report("Folding address arithmetic in function '" << f.name() << "'");
+
+	_foldedOperands      = 0;
+	_deletedInstructions = 0;
+
+	InstructionSet folded;
+
+	for(auto block = f.begin(); block != f.end(); ++block)
+	{
+		_foldedOperands += foldBlock(*block, folded);
+	}
+
+	_deletedInstructions = deleteDeadArithmetic(f, folded);
+
+	hydrazine::log("AddressModeFoldingPass") << " folded " << _foldedOperands
+		<< " memory operands, deleted " << _deletedInstructions
+		<< " instructions in function '" << f.name() << "'\n";
+}
+
+transforms::Pass* AddressModeFoldingPass::clone() const
+{
+	return new AddressModeFoldingPass;
+}
+
+unsigned int AddressModeFoldingPass::foldedOperands() const
+{
+	return _foldedOperands;
+}
+
+unsigned int AddressModeFoldingPass::deletedInstructions() const
+{
+	return _deletedInstructions;
+}
+
+static ir::VirtualRegister* getRegister(ir::Operand* operand)
+{
+	if(operand->mode() != ir::Operand::Register &&
+		operand->mode() != ir::Operand::Indirect &&
+		operand->mode() != ir::Operand::Predicate)
+	{
+		return nullptr;
+	}
+
+	return static_cast<ir::RegisterOperand*>(operand)->virtualRegister();
+}
+
+static bool isIntegerImmediate(const ir::Operand* operand)
+{
+	if(!operand->isImmediate()) return false;
+
+	auto immediate = static_cast<const ir::ImmediateOperand*>(operand);
+
+	return !immediate->dataType->isFloatingPoint();
+}
+
+/*! \brief Is the instruction 'rX = rSource +/- imm' with no guard? */
+static bool isFoldableArithmetic(const ir::Instruction* instruction,
+	ir::VirtualRegister*& source, int64_t& offset)
+{
+	if(instruction->opcode != ir::Instruction::Add &&
+		instruction->opcode != ir::Instruction::Sub)
+	{
+		return false;
+	}
+
+	if(instruction->reads.size() != 3 || instruction->writes.size() != 1)
+	{
+		return false;
+	}
+
+	if(!instruction->guard()->isAlwaysTrue()) return false;
+
+	if(instruction->writes[0]->mode() != ir::Operand::Register) return false;
+
+	auto a = instruction->reads[1];
+	auto b = instruction->reads[2];
+
+	// Canonicalize 'imm + reg' to 'reg + imm', subtraction does not commute
+	if(instruction->opcode == ir::Instruction::Add && isIntegerImmediate(a))
+	{
+		std::swap(a, b);
+	}
+
+	if(a->mode() != ir::Operand::Register || !isIntegerImmediate(b))
+	{
+		return false;
+	}
+
+	source = static_cast<ir::RegisterOperand*>(a)->virtualRegister();
+	offset = static_cast<int64_t>(static_cast<ir::ImmediateOperand*>(b)->uint);
+
+	if(instruction->opcode == ir::Instruction::Sub) offset = -offset;
+
+	return true;
+}
+
+static bool foldOperand(ir::IndirectOperand* indirect,
+	const InstructionVector& instructions,
+	const RegisterToIndexMap& lastDefinition, InstructionSet& folded)
+{
+	bool changed = false;
+
+	while(true)
+	{
+		auto definition = lastDefinition.find(indirect->virtualRegister());
+
+		if(definition == lastDefinition.end()) break;
+
+		auto arithmetic = instructions[definition->second];
+
+		ir::VirtualRegister* source = nullptr;
+		int64_t offset = 0;
+
+		if(!isFoldableArithmetic(arithmetic, source, offset)) break;
+
+		// The source must hold the same value here as it did at the add
+		auto sourceDefinition = lastDefinition.find(source);
+
+		if(sourceDefinition != lastDefinition.end() &&
+			sourceDefinition->second >= definition->second)
+		{
+			break;
+		}
+
+		report("  folding '" << arithmetic->toString() << "' into '"
+			<< indirect->instruction->toString() << "'");
+
+		indirect->setVirtualRegister(source);
+		indirect->offset += offset;
+
+		folded.insert(arithmetic);
+
+		changed = true;
+	}
+
+	return changed;
+}
+
+static unsigned int foldBlock(ir::BasicBlock& block, InstructionSet& folded)
+{
+	InstructionVector instructions(block.begin(), block.end());
+
+	RegisterToIndexMap lastDefinition;
+
+	unsigned int foldedOperands = 0;
+
+	for(unsigned int index = 0; index < instructions.size(); ++index)
+	{
+		auto instruction = instructions[index];
+
+		if(instruction->isLoad() || instruction->isStore())
+		{
+			for(auto read : instruction->reads)
+			{
+				if(!read->isIndirect()) continue;
+
+				if(foldOperand(static_cast<ir::IndirectOperand*>(read),
+					instructions, lastDefinition, folded))
+				{
+					++foldedOperands;
+				}
+			}
+		}
+
+		for(auto write : instruction->writes)
+		{
+			auto reg = getRegister(write);
+
+			if(reg == nullptr) continue;
+
+			lastDefinition[reg] = index;
+		}
+	}
+
+	return foldedOperands;
+}
+
+static unsigned int deleteDeadArithmetic(ir::Function& function,
+	InstructionSet& folded)
+{
+	RegisterUseCountMap uses;
+
+	for(auto& block : function)
+	{
+		for(auto instruction : block)
+		{
+			for(auto read : instruction->reads)
+			{
+				auto reg = getRegister(read);
+
+				if(reg == nullptr) continue;
+
+				uses[reg] += 1;
+			}
+		}
+	}
+
+	unsigned int deleted = 0;
+	bool changed = true;
+
+	// Deleting the tail of a chain can expose the next link as dead
+	while(changed)
+	{
+		changed = false;
+
+		for(auto instruction = folded.begin(); instruction != folded.end(); )
+		{
+			auto arithmetic = *instruction;
+			auto destination = getRegister(arithmetic->writes[0]);
+
+			if(uses[destination] != 0)
+			{
+				++instruction;
+				continue;
+			}
+
+			for(auto read : arithmetic->reads)
+			{
+				auto reg = getRegister(read);
+
+				if(reg == nullptr) continue;
+
+				assert(uses[reg] > 0);
+				uses[reg] -= 1;
+			}
+
+			report("  deleting dead '" << arithmetic->toString() << "'");
+
+			instruction = folded.erase(instruction);
+
+			arithmetic->eraseFromBlock();
+
+			++deleted;
+			changed = true;
+		}
+	}
+
+	return deleted;
+}
+
+}
+
+}
+
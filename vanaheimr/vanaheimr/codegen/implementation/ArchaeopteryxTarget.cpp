@@ -7,13 +7,35 @@
 // Vanaheimr Includes
 #include <vanaheimr/codegen/interface/ArchaeopteryxTarget.h>
 
+#include <vanaheimr/codegen/interface/RegisterAllocator.h>
+
 #include <vanaheimr/transforms/interface/PassManager.h>
 #include <vanaheimr/transforms/interface/PassFactory.h>
 
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/asm/interface/BinaryWriter.h>
+
+#include <vanaheimr/abi/interface/ApplicationBinaryInterface.h>
+
 #include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/Type.h>
+#include <vanaheimr/ir/interface/Constant.h>
+#include <vanaheimr/ir/interface/Operand.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+
+#include <vanaheimr/util/interface/ThreadPool.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
 
 // Standard Library Includes
 #include <stdexcept>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <chrono>
 
 namespace vanaheimr
 {
@@ -24,78 +46,204 @@ namespace codegen
 ArchaeopteryxTarget::ArchaeopteryxTarget()
 : Target("ArchaeopteryxSimulatorTarget"),
 	instructionSelectorName("translation-table"),
-	registerAllocatorName("chaitin-briggs"), instructionSchedulerName("list")
+	registerAllocatorName("chaitin-briggs"), instructionSchedulerName("list"),
+	requestedOccupancy(0), registerFileSize(32768), threads(0)
 {
 
 }
 
+typedef transforms::Pass::StringVector StringVector;
+typedef std::vector<ir::Function*>      FunctionVector;
+typedef std::vector<unsigned int>       RegisterCountVector;
+typedef GenericSpillCodePass::SpillFrame SpillFrame;
+typedef std::vector<SpillFrame>         SpillFrameVector;
+typedef ArchaeopteryxTarget::CallGraph  CallGraph;
+
+static transforms::Pass* createPass(const std::string& name,
+	const StringVector& options, const std::string& description);
+static void buildCallGraph(CallGraph& calls, const ir::Module& module);
+static uint64_t layoutSpillFrames(SpillFrameVector& frames,
+	const FunctionVector& functions, const CallGraph& calls);
+static unsigned int getEncodedRegisterCount(const ir::Module& module);
+static void addRegisterCountGlobal(ir::Module& module, unsigned int count);
+static void addLocalMemoryGlobals(ir::Module& module, uint64_t bytes);
+
 void ArchaeopteryxTarget::lower()
 {
+	auto start = std::chrono::steady_clock::now();
+	
+	// Calls are only recognizable before instruction selection
+	CallGraph calls;
+	
+	buildCallGraph(calls, *_module);
+	
+	_lowerModule();
+	
+	auto middle = std::chrono::steady_clock::now();
+	
+	uint64_t localMemory = 0;
+	
+	unsigned int registers = _lowerFunctions(calls, localMemory);
+	
+	auto finish = std::chrono::steady_clock::now();
+	
+	hydrazine::log("ArchaeopteryxTarget") << "Lowering " << _module->name
+		<< " took " << std::chrono::duration<double>(middle - start).count()
+		<< "s for module passes and "
+		<< std::chrono::duration<double>(finish - middle).count()
+		<< "s for function passes.\n";
+	
+	// The simulator indexes its register file with the encoded registers,
+	//  it must cover every one of them, not just the allocated colors
+	registers = std::max(registers, getEncodedRegisterCount(*_module));
+	
+	// Tell the simulator how large the register file needs to be
+	addRegisterCountGlobal(*_module, registers);
+	
+	// Spill slots are per thread, the simulator has to back them with
+	//  memory that only one thread can see
+	addLocalMemoryGlobals(*_module, localMemory);
+}
+
+void ArchaeopteryxTarget::_lowerModule()
+{
+	// Instruction selection adds operations to the shared machine model,
+	//  so it runs serially along with the module-wide ABI lowering
 	transforms::PassManager manager(_module);
 
+	// Block Placement, branches are only visible before selection
+	auto placement = createPass("BasicBlockPlacementPass",
+		blockPlacementOptions, "block placement pass");
+
+	manager.addPass(placement);
+
+	// Address Mode Folding, arithmetic is only visible before selection
+	auto addressFolding = createPass("AddressModeFoldingPass",
+		StringVector(), "address mode folding pass");
+
+	manager.addPass(addressFolding);
+
 	// Instruction Selection
-	auto selector = transforms::PassFactory::createPass(
-		instructionSelectorName);
-	
-	if(selector == nullptr)
-	{
-		throw std::runtime_error("Failed to create archaeopteryx"
-			" instruction selection pass '" + instructionSelectorName + "'.");
-	}
+	auto selector = createPass(instructionSelectorName, StringVector(),
+		"instruction selection pass");
 
 	manager.addPass(selector);
 
 	// ABI Lowering	
-	auto abiLowering = transforms::PassFactory::createPass(
-		"EnforceArchaeopteryxABIPass");
-
-	if(abiLowering == nullptr)
-	{
-		throw std::runtime_error("Failed to create archaeopteryx"
-			" ABI lowering pass.");
-	}
+	auto abiLowering = createPass("EnforceArchaeopteryxABIPass",
+		StringVector(), "ABI lowering pass");
 
 	manager.addPass(abiLowering);
 
-	// Instruction Scheduler
-	auto scheduler = transforms::PassFactory::createPass(
-		instructionSchedulerName);
+	manager.addDependence(addressFolding->name, placement->name);
+	manager.addDependence(selector->name,       addressFolding->name);
+	manager.addDependence(abiLowering->name,    selector->name);
+	
+	manager.runOnModule();
+}
+
+unsigned int ArchaeopteryxTarget::_lowerFunctions(const CallGraph& calls,
+	uint64_t& localMemory)
+{
+	// Every function is rewritten, load deferred bodies and take private
+	//  copies of functions shared with cloned modules now rather than
+	//  racing to do it below
+	_module->materializeAll();
+	_module->detachAll();
+	
+	FunctionVector functions;
+	
+	for(auto function = _module->begin();
+		function != _module->end(); ++function)
+	{
+		functions.push_back(&*function);
+	}
+	
+	RegisterCountVector registers(functions.size(), 0);
+	SpillFrameVector    frames(functions.size());
+	
+	util::ThreadPool pool(threads);
 	
-	if(scheduler == nullptr)
+	hydrazine::log("ArchaeopteryxTarget") << "Lowering " << functions.size()
+		<< " functions with " << pool.size() << " threads.\n";
+	
+	// Every function gets its own passes, they only touch their function
+	pool.parallelFor(functions.size(), [&](size_t index)
+	{
+		registers[index] = _lowerFunction(*functions[index], frames[index]);
+	});
+	
+	// Frames are placed in module order so that the layout does not
+	//  depend on the thread count
+	localMemory = layoutSpillFrames(frames, functions, calls);
+	
+	unsigned int maximum = 0;
+	
+	for(auto count : registers)
 	{
-		throw std::runtime_error("Failed to get instruction scheduler '" +
-			instructionSchedulerName +"'");
+		maximum = std::max(maximum, count);
 	}
+	
+	return maximum;
+}
+
+unsigned int ArchaeopteryxTarget::_lowerFunction(ir::Function& function,
+	SpillFrame& frame)
+{
+	transforms::PassManager manager(_module);
+
+	// Instruction Scheduler
+	auto scheduler = createPass(instructionSchedulerName, StringVector(),
+		"instruction scheduler");
 
 	manager.addPass(scheduler);
 	
 	// Register Allocator
-	auto allocator = transforms::PassFactory::createPass(registerAllocatorName);	
+	StringVector allocatorOptions;
 	
-	if(allocator == nullptr)
+	if(registerBudget() != 0)
 	{
-		throw std::runtime_error("Failed to get register allocator '" +
-			registerAllocatorName +"'");
+		std::stringstream budget;
+		
+		budget << "registers=" << registerBudget();
+		
+		allocatorOptions.push_back(budget.str());
 	}
+	
+	auto allocator = createPass(registerAllocatorName, allocatorOptions,
+		"register allocator");
 
 	manager.addPass(allocator);
 	
 	// Register Spiller
-	auto spiller = transforms::PassFactory::createPass("GenericSpillCodePass");
-
-	if(spiller == nullptr)
-	{
-		throw std::runtime_error("Failed to create spill code pass.");
-	}
+	auto spiller = createPass("GenericSpillCodePass", StringVector(),
+		"spill code pass");
 	
 	manager.addPass(spiller);
 
-	manager.addDependence(abiLowering->name, selector->name);
-	manager.addDependence(scheduler->name,   abiLowering->name);
-	manager.addDependence(allocator->name,   scheduler->name);
-	manager.addDependence(spiller->name,     allocator->name);
+	manager.addDependence(allocator->name, scheduler->name);
+	manager.addDependence(spiller->name,   allocator->name);
 	
-	manager.runOnModule();
+	manager.runOnFunction(function);
+	
+	frame = static_cast<GenericSpillCodePass*>(spiller)->frame();
+	
+	return static_cast<RegisterAllocator*>(allocator)->usedRegisterCount();
+}
+
+unsigned int ArchaeopteryxTarget::registerBudget() const
+{
+	if(requestedOccupancy == 0) return 0;
+	
+	unsigned int budget = registerFileSize / requestedOccupancy;
+	
+	if(budget == 0)
+	{
+		throw std::runtime_error("Requested occupancy exceeds the number "
+			"of registers in the register file.");
+	}
+	
+	return budget;
 }
 
 ir::ModuleBase* ArchaeopteryxTarget::getLoweredModule()
@@ -105,7 +253,228 @@ ir::ModuleBase* ArchaeopteryxTarget::getLoweredModule()
 
 Target* ArchaeopteryxTarget::clone() const
 {
-	return new ArchaeopteryxTarget;
+	return new ArchaeopteryxTarget(*this);
+}
+
+static transforms::Pass* createPass(const std::string& name,
+	const StringVector& options, const std::string& description)
+{
+	auto pass = transforms::PassFactory::createPass(name, options);
+	
+	if(pass == nullptr)
+	{
+		throw std::runtime_error("Failed to create archaeopteryx " +
+			description + " '" + name + "'.");
+	}
+	
+	return pass;
+}
+
+static void buildCallGraph(CallGraph& calls, const ir::Module& module)
+{
+	module.materializeAll();
+	
+	for(auto function = module.begin(); function != module.end(); ++function)
+	{
+		auto& callees = calls[function->name()];
+		
+		for(auto& block : *function)
+		{
+			for(auto instruction : block)
+			{
+				if(!instruction->isCall() || instruction->isIntrinsic())
+				{
+					continue;
+				}
+				
+				auto target = static_cast<const ir::Call*>(
+					instruction)->target();
+				
+				std::string name;
+				
+				if(target->isAddress())
+				{
+					auto address = static_cast<const ir::AddressOperand*>(
+						target);
+					
+					if(module.getFunction(address->globalValue->name()) !=
+						module.end())
+					{
+						name = address->globalValue->name();
+					}
+				}
+				
+				callees.push_back(name);
+			}
+		}
+	}
+}
+
+/*! \brief Can the function be called again while it is active? */
+static bool isReentrant(const std::string& function,
+	const CallGraph& calls)
+{
+	std::set<std::string> visited;
+	StringVector          frontier(1, function);
+	
+	while(!frontier.empty())
+	{
+		auto caller = calls.find(frontier.back());
+		
+		frontier.pop_back();
+		
+		if(caller == calls.end()) continue;
+		
+		for(auto& callee : caller->second)
+		{
+			// An indirect call could reach anything
+			if(callee.empty() || callee == function) return true;
+			
+			if(visited.insert(callee).second) frontier.push_back(callee);
+		}
+	}
+	
+	return false;
+}
+
+static uint64_t align(uint64_t offset, uint64_t alignment)
+{
+	uint64_t remainder = offset % alignment;
+	
+	return remainder == 0 ? offset : offset + alignment - remainder;
+}
+
+static uint64_t layoutSpillFrames(SpillFrameVector& frames,
+	const FunctionVector& functions, const CallGraph& calls)
+{
+	// Kernels are never called, a thread only runs one, so their
+	//  frames share the start of the spill region
+	uint64_t offset = 0;
+	
+	for(unsigned int index = 0; index < functions.size(); ++index)
+	{
+		if(!functions[index]->hasAttribute("kernel")) continue;
+		
+		offset = std::max(offset, frames[index].bytes);
+	}
+	
+	// Every other function gets its own frame, so a callee never
+	//  overwrites the spilled values of any of its callers
+	for(unsigned int index = 0; index < functions.size(); ++index)
+	{
+		auto& frame    = frames[index];
+		auto  function = functions[index];
+		
+		if(function->hasAttribute("kernel") || frame.bytes == 0) continue;
+		
+		if(isReentrant(function->name(), calls))
+		{
+			throw std::runtime_error("Function '" + function->name() +
+				"' spills registers but can be re-entered through calls, "
+				"spill frames are not stack allocated.");
+		}
+		
+		offset = align(offset, frame.alignment);
+		
+		hydrazine::log("ArchaeopteryxTarget") << "Placing the " << frame.bytes
+			<< " byte spill frame of " << function->name() << " at offset "
+			<< offset << ".\n";
+		
+		frame.relocate(offset);
+		
+		offset += frame.bytes;
+	}
+	
+	return offset;
+}
+
+static unsigned int getEncodedRegisterCount(const ir::Operand* operand)
+{
+	if(operand == nullptr || !operand->isRegister()) return 0;
+	
+	return as::BinaryWriter::getEncodedRegister(
+		*static_cast<const ir::RegisterOperand*>(operand)) + 1;
+}
+
+static unsigned int getEncodedRegisterCount(const ir::Module& module)
+{
+	unsigned int count = 0;
+	
+	for(auto function = module.begin();
+		function != module.end(); ++function)
+	{
+		for(auto& block : *function)
+		{
+			for(auto instruction : block)
+			{
+				for(auto read : instruction->reads)
+				{
+					count = std::max(count, getEncodedRegisterCount(read));
+				}
+
+				for(auto write : instruction->writes)
+				{
+					count = std::max(count, getEncodedRegisterCount(write));
+				}
+			}
+		}
+	}
+	
+	return count;
+}
+
+static void addIntegerGlobal(ir::Module& module, const std::string& name,
+	uint64_t value, unsigned int bits)
+{
+	auto compiler = compiler::Compiler::getSingleton();
+	
+	auto existing = module.getGlobal(name);
+	
+	if(existing != module.global_end()) module.removeGlobal(existing);
+	
+	auto type = compiler->getType("i" + std::to_string(bits));
+	
+	auto global = module.newGlobal(name, type,
+		ir::Global::ExternalLinkage, ir::Global::Shared);
+	
+	global->setInitializer(new ir::IntegerConstant(value, bits));
+}
+
+static void addRegisterCountGlobal(ir::Module& module, unsigned int count)
+{
+	addIntegerGlobal(module, "simulated-registers-per-thread", count, 32);
+	
+	hydrazine::log("ArchaeopteryxTarget") << "Kernels in " << module.name
+		<< " need " << count << " registers per thread.\n";
+}
+
+static void addLocalMemoryGlobals(ir::Module& module, uint64_t bytes)
+{
+	if(bytes == 0) return;
+	
+	auto abi = abi::ApplicationBinaryInterface::getABI("archaeopteryx");
+	assert(abi != nullptr);
+	
+	auto region = abi->findRegion("spill");
+	assert(region != nullptr && region->isFixed());
+	
+	auto spill = static_cast<const abi::FixedAddressRegion*>(region);
+	
+	if(bytes > spill->bytes)
+	{
+		throw std::runtime_error("Spill frames of module '" + module.name +
+			"' need " + std::to_string(bytes) + " bytes, the ABI only "
+			"reserves " + std::to_string(spill->bytes) + ".");
+	}
+	
+	addIntegerGlobal(module, "simulated-local-memory-address",
+		spill->address, 64);
+	addIntegerGlobal(module, "simulated-local-memory-per-thread",
+		bytes, 64);
+	
+	hydrazine::log("ArchaeopteryxTarget") << "Kernels in " << module.name
+		<< " need " << bytes << " bytes of thread local memory at "
+		<< spill->address << ".\n";
 }
 
 }
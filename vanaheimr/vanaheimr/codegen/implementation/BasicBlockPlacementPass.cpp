@@ -0,0 +1,746 @@
+/*! \file   BasicBlockPlacementPass.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the BasicBlockPlacementPass class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/codegen/interface/BasicBlockPlacementPass.h>
+
+#include <vanaheimr/analysis/interface/ControlFlowGraph.h>
+#include <vanaheimr/analysis/interface/DominatorAnalysis.h>
+
+#include <vanaheimr/ir/interface/Function.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+#include <vanaheimr/util/interface/LargeMap.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+// Preprocessor Macros
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
+namespace vanaheimr
+{
+
+namespace codegen
+{
+
+BasicBlockPlacementPass::BasicBlockPlacementPass()
+: FunctionPass(StringVector({"ControlFlowGraph", "DominatorAnalysis"}),
+	"BasicBlockPlacementPass"), _insertedBranches(0), _removedBranches(0)
+{
+
+}
+
+typedef analysis::ControlFlowGraph  ControlFlowGraph;
+typedef analysis::DominatorAnalysis DominatorAnalysis;
+
+typedef BasicBlockPlacementPass::BlockCountMap BlockCountMap;
+
+typedef std::vector<ir::BasicBlock*> BasicBlockVector;
+typedef std::vector<unsigned int>    PositionVector;
+typedef std::vector<PositionVector>  ChainVector;
+typedef std::vector<double>          FrequencyVector;
+typedef std::vector<bool>            BitVector;
+
+typedef util::LargeMap<const ir::BasicBlock*, unsigned int> PositionMap;
+typedef util::LargeMap<const ir::BasicBlock*,
+	ir::BasicBlock*> FallthroughMap;
+
+class Edge
+{
+public:
+	Edge(unsigned int h, unsigned int t, double w)
+	: head(h), tail(t), weight(w) {}
+
+public:
+	unsigned int head;
+	unsigned int tail;
+	double       weight;
+};
+
+typedef std::vector<Edge> EdgeVector;
+
+/*! \brief The blocks of a function indexed by their original position */
+class BlockLayout
+{
+public:
+	typedef std::vector<ir::Function::iterator> IteratorVector;
+
+public:
+	BasicBlockVector blocks;
+	IteratorVector   iterators;
+	PositionMap      positions;
+
+public:
+	unsigned int entry;
+	unsigned int exit;
+};
+
+static void estimateFrequencies(FrequencyVector& frequencies,
+	const BlockLayout& layout, ControlFlowGraph& cfg,
+	DominatorAnalysis& dominators, const BlockCountMap* counts);
+static void findColdBlocks(BitVector& cold, const BlockLayout& layout,
+	ControlFlowGraph& cfg, const BlockCountMap* counts);
+static void weighEdges(EdgeVector& edges, const BlockLayout& layout,
+	const FrequencyVector& frequencies, const BitVector& cold,
+	ControlFlowGraph& cfg, DominatorAnalysis& dominators,
+	const BlockCountMap* counts);
+static void findFallthroughs(FallthroughMap& fallthroughs,
+	const BlockLayout& layout);
+static void buildChains(ChainVector& chains, const EdgeVector& edges,
+	const BlockLayout& layout);
+static void orderChains(PositionVector& order, const ChainVector& chains,
+	const EdgeVector& edges, const BitVector& cold, const BlockLayout& layout);
+static void repairBranches(ir::Function& function,
+	const FallthroughMap& fallthroughs, unsigned int& inserted,
+	unsigned int& removed);
+
+void BasicBlockPlacementPass::runOnFunction(Function& f)
+{
+	_insertedBranches = 0;
+	_removedBranches  = 0;
+
+	// Nothing to reorder with only the entry, exit, and a single block
+	if(f.size() <= 3) return;
+
+	report("Placing basic blocks in function '" << f.name() << "'");
+
+	auto cfg = static_cast<ControlFlowGraph*>(getAnalysis("ControlFlowGraph"));
+	auto dominators = static_cast<DominatorAnalysis*>(
+		getAnalysis("DominatorAnalysis"));
+
+	BlockLayout layout;
+
+	for(auto block = f.begin(); block != f.end(); ++block)
+	{
+		layout.positions.insert(std::make_pair(&*block, layout.blocks.size()));
+		layout.blocks.push_back(&*block);
+		layout.iterators.push_back(block);
+	}
+
+	layout.entry = layout.positions.find(&*f.entry_block())->second;
+	layout.exit  = layout.positions.find(&*f.exit_block())->second;
+
+	const BlockCountMap* counts = nullptr;
+
+	auto functionProfile = profile.find(f.name());
+
+	if(functionProfile != profile.end()) counts = &functionProfile->second;
+
+	FrequencyVector frequencies;
+	BitVector       cold;
+	EdgeVector      edges;
+
+	estimateFrequencies(frequencies, layout, *cfg, *dominators, counts);
+	findColdBlocks(cold, layout, *cfg, counts);
+	weighEdges(edges, layout, frequencies, cold, *cfg, *dominators, counts);
+
+	// Remember where each block falls through to before moving anything
+	FallthroughMap fallthroughs;
+
+	findFallthroughs(fallthroughs, layout);
+
+	ChainVector    chains;
+	PositionVector order;
+
+	buildChains(chains, edges, layout);
+	orderChains(order, chains, edges, cold, layout);
+
+	for(auto position : order)
+	{
+		report(" placing " << layout.blocks[position]->name());
+
+		f.moveBasicBlock(f.exit_block(), layout.iterators[position]);
+	}
+
+	repairBranches(f, fallthroughs, _insertedBranches, _removedBranches);
+
+	hydrazine::log("BasicBlockPlacementPass") << " formed " << chains.size()
+		<< " chains, inserted " << _insertedBranches << " and removed "
+		<< _removedBranches << " branches in function '" << f.name() << "'\n";
+}
+
+void BasicBlockPlacementPass::configure(const StringVector& options)
+{
+	for(auto& option : options)
+	{
+		if(option.find("profile=") == 0)
+		{
+			loadProfile(option.substr(8));
+		}
+		else
+		{
+			throw std::runtime_error("Invalid option '" + option +
+				"' for BasicBlockPlacementPass.");
+		}
+	}
+}
+
+transforms::Pass* BasicBlockPlacementPass::clone() const
+{
+	auto pass = new BasicBlockPlacementPass;
+
+	pass->profile = profile;
+
+	return pass;
+}
+
+void BasicBlockPlacementPass::loadProfile(const std::string& path)
+{
+	std::ifstream file(path.c_str());
+
+	if(!file.is_open())
+	{
+		throw std::runtime_error("Failed to open block profile '" +
+			path + "'.");
+	}
+
+	std::string line;
+
+	while(std::getline(file, line))
+	{
+		if(line.empty() || line[0] == '#') continue;
+
+		std::stringstream stream(line);
+
+		std::string function;
+		std::string block;
+		uint64_t    count = 0;
+
+		if(!(stream >> function >> block >> count))
+		{
+			throw std::runtime_error("Malformed block profile entry '" +
+				line + "' in '" + path + "'.");
+		}
+
+		profile[function][block] += count;
+	}
+}
+
+unsigned int BasicBlockPlacementPass::insertedBranches() const
+{
+	return _insertedBranches;
+}
+
+unsigned int BasicBlockPlacementPass::removedBranches() const
+{
+	return _removedBranches;
+}
+
+static unsigned int getPosition(const BlockLayout& layout,
+	const ir::BasicBlock* block)
+{
+	auto position = layout.positions.find(block);
+
+	assert(position != layout.positions.end());
+
+	return position->second;
+}
+
+static uint64_t getCount(const BlockCountMap& counts,
+	const ir::BasicBlock* block)
+{
+	// Blocks missing from the profile of a function never executed
+	auto count = counts.find(block->name());
+
+	if(count == counts.end()) return 0;
+
+	return count->second;
+}
+
+static bool isBackEdge(const ir::BasicBlock& head, const ir::BasicBlock& tail,
+	DominatorAnalysis& dominators)
+{
+	return dominators.dominates(head, tail);
+}
+
+static void estimateFrequencies(FrequencyVector& frequencies,
+	const BlockLayout& layout, ControlFlowGraph& cfg,
+	DominatorAnalysis& dominators, const BlockCountMap* counts)
+{
+	frequencies.assign(layout.blocks.size(), 0.0);
+
+	if(counts != nullptr)
+	{
+		for(unsigned int i = 0; i < layout.blocks.size(); ++i)
+		{
+			frequencies[i] = getCount(*counts, layout.blocks[i]);
+		}
+
+		return;
+	}
+
+	// Each natural loop is assumed to iterate eight times
+	PositionVector depths(layout.blocks.size(), 0);
+
+	for(unsigned int header = 0; header < layout.blocks.size(); ++header)
+	{
+		auto headerBlock = layout.blocks[header];
+
+		BitVector body(layout.blocks.size(), false);
+		PositionVector worklist;
+
+		for(auto predecessor : cfg.getPredecessors(*headerBlock))
+		{
+			if(!isBackEdge(*predecessor, *headerBlock, dominators)) continue;
+
+			worklist.push_back(getPosition(layout, predecessor));
+		}
+
+		if(worklist.empty()) continue;
+
+		body[header] = true;
+
+		while(!worklist.empty())
+		{
+			unsigned int position = worklist.back();
+			worklist.pop_back();
+
+			if(body[position]) continue;
+
+			body[position] = true;
+
+			for(auto predecessor : cfg.getPredecessors(
+				*layout.blocks[position]))
+			{
+				worklist.push_back(getPosition(layout, predecessor));
+			}
+		}
+
+		for(unsigned int i = 0; i < body.size(); ++i)
+		{
+			if(body[i]) depths[i] += 1;
+		}
+	}
+
+	for(unsigned int i = 0; i < layout.blocks.size(); ++i)
+	{
+		frequencies[i] = 1.0;
+
+		for(unsigned int d = 0; d < std::min(depths[i], 6U); ++d)
+		{
+			frequencies[i] *= 8.0;
+		}
+	}
+}
+
+static bool callsColdFunction(const ir::BasicBlock& block)
+{
+	for(auto instruction : block)
+	{
+		if(!instruction->isCall()) continue;
+
+		auto call = static_cast<const ir::Call*>(instruction);
+
+		if(!call->target()->isAddress()) continue;
+
+		auto address = static_cast<const ir::AddressOperand*>(call->target());
+
+		if(!address->globalValue->type().isFunction()) continue;
+
+		auto callee = static_cast<const ir::Function*>(address->globalValue);
+
+		if(callee->hasAttribute("cold") || callee->hasAttribute("noreturn"))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void findColdBlocks(BitVector& cold, const BlockLayout& layout,
+	ControlFlowGraph& cfg, const BlockCountMap* counts)
+{
+	BitVector reached(layout.blocks.size(), false);
+
+	PositionVector worklist(1, layout.entry);
+
+	while(!worklist.empty())
+	{
+		unsigned int position = worklist.back();
+		worklist.pop_back();
+
+		if(reached[position]) continue;
+
+		reached[position] = true;
+
+		for(auto successor : cfg.getSuccessors(*layout.blocks[position]))
+		{
+			worklist.push_back(getPosition(layout, successor));
+		}
+	}
+
+	cold.assign(layout.blocks.size(), false);
+
+	for(unsigned int i = 0; i < layout.blocks.size(); ++i)
+	{
+		if(i == layout.entry || i == layout.exit) continue;
+
+		auto block = layout.blocks[i];
+
+		cold[i] = !reached[i] || callsColdFunction(*block) ||
+			(counts != nullptr && getCount(*counts, block) == 0);
+	}
+}
+
+static double getEdgeProbability(const ir::BasicBlock& head,
+	const ir::BasicBlock& tail, const BlockLayout& layout,
+	const FrequencyVector& frequencies, const BitVector& cold,
+	ControlFlowGraph& cfg, DominatorAnalysis& dominators,
+	const BlockCountMap* counts)
+{
+	auto successors = cfg.getSuccessors(head);
+
+	if(successors.size() == 1) return 1.0;
+
+	unsigned int tailPosition = getPosition(layout, &tail);
+
+	if(cold[tailPosition]) return 0.0;
+
+	if(counts != nullptr)
+	{
+		double total = 0.0;
+
+		for(auto successor : successors)
+		{
+			total += getCount(*counts, successor);
+		}
+
+		if(total == 0.0) return 0.0;
+
+		return getCount(*counts, &tail) / total;
+	}
+
+	// Prefer the back edge, then staying in the loop, then the hotter side
+	for(auto successor : successors)
+	{
+		if(successor == &tail) continue;
+
+		unsigned int otherPosition = getPosition(layout, successor);
+
+		if(cold[otherPosition]) return 1.0;
+
+		bool tailIsBackEdge  = isBackEdge(head, tail, dominators);
+		bool otherIsBackEdge = isBackEdge(head, *successor, dominators);
+
+		if(tailIsBackEdge != otherIsBackEdge)
+		{
+			return tailIsBackEdge ? 0.875 : 0.125;
+		}
+
+		double tailFrequency  = frequencies[tailPosition];
+		double otherFrequency = frequencies[otherPosition];
+
+		if(tailFrequency != otherFrequency)
+		{
+			return tailFrequency > otherFrequency ? 0.875 : 0.125;
+		}
+	}
+
+	return 1.0 / successors.size();
+}
+
+static bool compareEdges(const Edge& left, const Edge& right)
+{
+	if(left.weight != right.weight) return left.weight > right.weight;
+	if(left.head   != right.head)   return left.head   < right.head;
+
+	return left.tail < right.tail;
+}
+
+static void weighEdges(EdgeVector& edges, const BlockLayout& layout,
+	const FrequencyVector& frequencies, const BitVector& cold,
+	ControlFlowGraph& cfg, DominatorAnalysis& dominators,
+	const BlockCountMap* counts)
+{
+	for(unsigned int head = 0; head < layout.blocks.size(); ++head)
+	{
+		auto headBlock = layout.blocks[head];
+
+		for(auto successor : cfg.getSuccessors(*headBlock))
+		{
+			double probability = getEdgeProbability(*headBlock, *successor,
+				layout, frequencies, cold, cfg, dominators, counts);
+
+			edges.push_back(Edge(head, getPosition(layout, successor),
+				frequencies[head] * probability));
+		}
+	}
+
+	std::sort(edges.begin(), edges.end(), compareEdges);
+}
+
+static bool fallsThrough(const ir::BasicBlock& block)
+{
+	auto terminator = block.terminator();
+
+	if(terminator == nullptr) return true;
+	if(terminator->isCall())  return true;
+
+	return !terminator->guard()->isAlwaysTrue();
+}
+
+static void findFallthroughs(FallthroughMap& fallthroughs,
+	const BlockLayout& layout)
+{
+	for(unsigned int i = 0; i + 1 < layout.blocks.size(); ++i)
+	{
+		if(!fallsThrough(*layout.blocks[i])) continue;
+
+		fallthroughs.insert(std::make_pair(layout.blocks[i],
+			layout.blocks[i + 1]));
+	}
+}
+
+static void buildChains(ChainVector& chains, const EdgeVector& edges,
+	const BlockLayout& layout)
+{
+	// Every block but the exit starts in its own chain
+	PositionVector chainOf(layout.blocks.size(), 0);
+
+	ChainVector allChains(layout.blocks.size());
+
+	for(unsigned int i = 0; i < layout.blocks.size(); ++i)
+	{
+		allChains[i].push_back(i);
+		chainOf[i] = i;
+	}
+
+	for(auto& edge : edges)
+	{
+		if(edge.weight <= 0.0) break;
+
+		if(edge.head == layout.exit || edge.tail == layout.exit) continue;
+		if(edge.tail == layout.entry) continue;
+
+		unsigned int headChain = chainOf[edge.head];
+		unsigned int tailChain = chainOf[edge.tail];
+
+		if(headChain == tailChain) continue;
+
+		// Only join the end of one chain to the start of another
+		if(allChains[headChain].back()  != edge.head) continue;
+		if(allChains[tailChain].front() != edge.tail) continue;
+
+		for(auto position : allChains[tailChain])
+		{
+			allChains[headChain].push_back(position);
+			chainOf[position] = headChain;
+		}
+
+		allChains[tailChain].clear();
+	}
+
+	for(auto& chain : allChains)
+	{
+		if(chain.empty()) continue;
+		if(chain.front() == layout.exit) continue;
+
+		chains.push_back(chain);
+	}
+}
+
+static void orderChains(PositionVector& order, const ChainVector& chains,
+	const EdgeVector& edges, const BitVector& cold, const BlockLayout& layout)
+{
+	PositionVector chainOf(layout.blocks.size(), chains.size());
+
+	for(unsigned int c = 0; c < chains.size(); ++c)
+	{
+		for(auto position : chains[c]) chainOf[position] = c;
+	}
+
+	BitVector placed(chains.size(), false);
+	BitVector coldChain(chains.size(), true);
+
+	for(unsigned int c = 0; c < chains.size(); ++c)
+	{
+		for(auto position : chains[c])
+		{
+			if(!cold[position]) coldChain[c] = false;
+		}
+	}
+
+	auto place = [&](unsigned int c)
+	{
+		placed[c] = true;
+		order.insert(order.end(), chains[c].begin(), chains[c].end());
+	};
+
+	place(chainOf[layout.entry]);
+
+	// Greedily follow the heaviest edge out of the placed blocks, chains
+	//  are numbered in original block order, which breaks ties
+	while(true)
+	{
+		FrequencyVector connections(chains.size(), 0.0);
+
+		for(auto& edge : edges)
+		{
+			unsigned int headChain = chainOf[edge.head];
+			unsigned int tailChain = chainOf[edge.tail];
+
+			if(headChain == chains.size() || tailChain == chains.size())
+			{
+				continue;
+			}
+
+			if(placed[headChain] && !placed[tailChain])
+			{
+				connections[tailChain] += edge.weight;
+			}
+		}
+
+		unsigned int next = chains.size();
+
+		for(unsigned int c = 0; c < chains.size(); ++c)
+		{
+			if(placed[c] || coldChain[c]) continue;
+
+			if(next == chains.size() || connections[c] > connections[next])
+			{
+				next = c;
+			}
+		}
+
+		if(next == chains.size()) break;
+
+		place(next);
+	}
+
+	for(unsigned int c = 0; c < chains.size(); ++c)
+	{
+		if(!placed[c]) place(c);
+	}
+}
+
+static void insertBranch(ir::BasicBlock& block, ir::BasicBlock* target)
+{
+	// Falling into the exit block returns, so a return is equivalent
+	if(&*block.function()->exit_block() == target)
+	{
+		auto ret = new ir::Ret(&block);
+
+		ret->setGuard(new ir::PredicateOperand(
+			ir::PredicateOperand::PredicateTrue, ret));
+
+		block.push_back(ret);
+
+		return;
+	}
+
+	auto branch = new ir::Bra(ir::Bra::UniformBranch, &block);
+
+	branch->setGuard(new ir::PredicateOperand(
+		ir::PredicateOperand::PredicateTrue, branch));
+	branch->setTarget(new ir::AddressOperand(target, branch));
+
+	block.push_back(branch);
+}
+
+static bool invertBranch(ir::Bra& branch, ir::BasicBlock* target)
+{
+	auto guard = branch.guard();
+
+	if(guard->modifier == ir::PredicateOperand::StraightPredicate)
+	{
+		guard->modifier = ir::PredicateOperand::InversePredicate;
+	}
+	else if(guard->modifier == ir::PredicateOperand::InversePredicate)
+	{
+		guard->modifier = ir::PredicateOperand::StraightPredicate;
+	}
+	else
+	{
+		return false;
+	}
+
+	branch.setTarget(new ir::AddressOperand(target, &branch));
+
+	return true;
+}
+
+static bool isBranch(const ir::Instruction* instruction)
+{
+	if(instruction == nullptr) return false;
+
+	return instruction->isBranch() && !instruction->isCall();
+}
+
+static void repairBranches(ir::Function& function,
+	const FallthroughMap& fallthroughs, unsigned int& inserted,
+	unsigned int& removed)
+{
+	for(auto block = function.begin(); block != function.end(); ++block)
+	{
+		ir::BasicBlock* next = nullptr;
+
+		auto nextBlock = block; ++nextBlock;
+
+		if(nextBlock != function.end()) next = &*nextBlock;
+
+		auto terminator = block->terminator();
+
+		auto fallthrough = fallthroughs.find(&*block);
+
+		ir::BasicBlock* target = fallthrough == fallthroughs.end() ?
+			nullptr : fallthrough->second;
+
+		if(isBranch(terminator))
+		{
+			auto branch = static_cast<ir::Bra*>(terminator);
+
+			// A branch to the next block is now a fallthrough
+			if(branch->isUnconditional() && branch->targetBasicBlock() == next)
+			{
+				report(" removing " << branch->toString());
+
+				block->erase(branch);
+				++removed;
+
+				continue;
+			}
+
+			// Branch on the opposite condition to the old fallthrough
+			if(target != nullptr && target != next &&
+				branch->targetBasicBlock() == next)
+			{
+				if(invertBranch(*branch, target))
+				{
+					report(" inverted " << branch->toString());
+
+					continue;
+				}
+			}
+		}
+
+		if(target == nullptr || target == next) continue;
+
+		insertBranch(*block, target);
+		++inserted;
+
+		report(" inserted " << block->back()->toString());
+	}
+}
+
+}
+
+}
+
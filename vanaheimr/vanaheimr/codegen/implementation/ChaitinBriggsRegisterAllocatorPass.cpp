@@ -26,6 +26,9 @@
 
 // Standard Library Includes
 #include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <sstream>
 
 // Preprocessor Macros
 #ifdef REPORT_BASE
@@ -67,12 +70,21 @@ void ChaitinBriggsRegisterAllocatorPass::runOnFunction(Function& f)
 	
 	_machine = compiler::Compiler::getSingleton()->getMachineModel();
 	
+	_allocated.clear();
+	
 	// attempt to color the interferences
 	color(_spilled, _allocated, f, *interferenceAnalysis,
 		_machine->totalRegisterCount());
 	
-	// TODO: spill if allocation fails
-	assertM(_spilled.empty(), "No support for spills yet.");
+	unsigned int colors = _machine->totalRegisterCount();
+	
+	if(_registerBudget != 0)
+	{
+		colors = std::min(colors, _registerBudget);
+	}
+	
+	// spill if the allocation does not fit in the budget
+	_spillToMeetBudget(f, colors);
 	
 	// TODO: Map colors to registers
 	
@@ -82,7 +94,11 @@ void ChaitinBriggsRegisterAllocatorPass::runOnFunction(Function& f)
 
 transforms::Pass* ChaitinBriggsRegisterAllocatorPass::clone() const
 {
-	return new ChaitinBriggsRegisterAllocatorPass;
+	auto pass = new ChaitinBriggsRegisterAllocatorPass;
+	
+	pass->setRegisterBudget(registerBudget());
+	
+	return pass;
 }
 
 RegisterAllocator::VirtualRegisterSet
@@ -102,6 +118,69 @@ const machine::PhysicalRegister*
 	return _machine->getPhysicalRegister(allocatedRegister->second);
 }
 
+RegisterAllocator::PhysicalRegisterVector
+	ChaitinBriggsRegisterAllocatorPass::getSpillTemporaries() const
+{
+	return _spillTemporaries;
+}
+
+void ChaitinBriggsRegisterAllocatorPass::_spillToMeetBudget(Function& f,
+	unsigned int colors)
+{
+	unsigned int usedColors = 0;
+	
+	for(auto& allocation : _allocated)
+	{
+		usedColors = std::max(usedColors, allocation.second + 1);
+	}
+	
+	if(usedColors <= colors)
+	{
+		_usedRegisterCount = std::max(_usedRegisterCount, usedColors);
+		return;
+	}
+	
+	if(colors <= SpillTemporaryCount)
+	{
+		std::stringstream message;
+		
+		message << "Register budget of " << colors << " is too small to "
+			"allocate function '" << f.name() << "', at least "
+			<< (SpillTemporaryCount + 1) << " registers are needed for spills.";
+		
+		throw std::runtime_error(message.str());
+	}
+	
+	unsigned int allocatableColors = colors - SpillTemporaryCount;
+	
+	report(" Allocation needs " << usedColors << " registers, spilling "
+		"everything colored above " << allocatableColors);
+
+	// Values colored above the budget go to memory
+	for(auto reg = f.register_begin(); reg != f.register_end(); ++reg)
+	{
+		auto allocation = _allocated.find(reg->id);
+		
+		if(allocation == _allocated.end())       continue;
+		if(allocation->second < allocatableColors) continue;
+		
+		report("  spilling vr" << reg->id);
+		
+		_spilled.insert(&*reg);
+		_allocated.erase(allocation);
+	}
+	
+	// The top of the budget is reserved for reloading spilled values
+	_spillTemporaries.clear();
+	
+	for(unsigned int color = allocatableColors; color < colors; ++color)
+	{
+		_spillTemporaries.push_back(_machine->getPhysicalRegister(color));
+	}
+	
+	_usedRegisterCount = std::max(_usedRegisterCount, colors);
+}
+
 class RegisterInfo
 {
 public:
@@ -123,12 +202,16 @@ public:
 };
 
 typedef std::vector<RegisterInfo> RegisterInfoVector;
+
+/*! \brief Each function gets its own deterministic generator so that
+	functions can be allocated concurrently */
+typedef std::minstd_rand RandomGenerator;
 	
 typedef util::SmallSet<unsigned int> ColorSet;
 typedef std::vector<unsigned int> ColorVector;
 
 static unsigned int randomColorThatDoesntCollide(ColorSet& usedColors,
-	unsigned int maxColor)
+	unsigned int maxColor, RandomGenerator& generator)
 {
 	ColorSet unusedColors;
 	
@@ -141,12 +224,12 @@ static unsigned int randomColorThatDoesntCollide(ColorSet& usedColors,
 	
 	ColorVector availableColors(unusedColors.begin(), unusedColors.end());
 	
-	return availableColors[std::rand() % availableColors.size()];
+	return availableColors[generator() % availableColors.size()];
 }
 
 static unsigned int computeColor(bool& finished, const RegisterInfo& reg,
 	const RegisterInfoVector& registerInfo,
-	const InterferenceAnalysis& interferences)
+	const InterferenceAnalysis& interferences, RandomGenerator& generator)
 {
 	ColorSet usedColors;
 
@@ -180,7 +263,7 @@ static unsigned int computeColor(bool& finished, const RegisterInfo& reg,
 	// Define the range of possible colors [0 to usedRegisterCount]
 	if(finished && (usedColors.count(reg.color) != 0 || reg.color >= spread))
 	{
-		return randomColorThatDoesntCollide(usedColors, spread);
+		return randomColorThatDoesntCollide(usedColors, spread, generator);
 	}
 	
 	// keep the original color if it doesn't collide
@@ -192,11 +275,12 @@ static unsigned int computeColor(bool& finished, const RegisterInfo& reg,
 	// Otherwise, assign a new register randomly in the possible window
 	unsigned int maxColor = predecessorCount + 1;
 	
-	return randomColorThatDoesntCollide(usedColors, maxColor);
+	return randomColorThatDoesntCollide(usedColors, maxColor, generator);
 }
 
 static bool propagateColorsInParallel(RegisterInfoVector& registers,
-	unsigned int iteration, const InterferenceAnalysis& interferences)
+	unsigned int iteration, const InterferenceAnalysis& interferences,
+	RandomGenerator& generator)
 {
 	report("  -------------------- Iteration "
 		<< iteration << " ------------------");
@@ -210,7 +294,7 @@ static bool propagateColorsInParallel(RegisterInfoVector& registers,
 	{
 		bool predecessorsFinished = true;
 		unsigned int newColor = computeColor(predecessorsFinished, *reg,
-			registers, interferences);
+			registers, interferences, generator);
 
 		newRegisters.push_back(RegisterInfo(reg->virtualRegister,
 			reg->nodeDegree, newColor, reg->schedulingOrder,
@@ -231,7 +315,7 @@ static bool propagateColorsInParallel(RegisterInfoVector& registers,
 }
 
 static void initializeColors(RegisterInfoVector& registers,
-	const InterferenceAnalysis& interferences)
+	const InterferenceAnalysis& interferences, RandomGenerator& generator)
 {
 	// initialize the register randomly in the possible range
 	for(auto& reg : registers)
@@ -254,7 +338,7 @@ static void initializeColors(RegisterInfoVector& registers,
 		
 		unsigned int maxColor = predecessorCount + 1;
 	
-		reg.color = std::rand() % maxColor;
+		reg.color = generator() % maxColor;
 	}
 }
 
@@ -291,8 +375,7 @@ static void color(RegisterAllocator::VirtualRegisterSet& spilled,
 	RegisterMap& allocated, const ir::Function& function,
 	const InterferenceAnalysis& interferences, unsigned int colors)
 {
-	//std::srand(std::time(0));
-	std::srand(0);
+	RandomGenerator generator(0);
 	
 	// Create a map from node degree to virtual register
 	RegisterInfoVector registers;
@@ -310,7 +393,7 @@ static void color(RegisterAllocator::VirtualRegisterSet& spilled,
 	initializeSchedulingOrder(registers);
 	
 	// Initialize the colors
-	initializeColors(registers, interferences);
+	initializeColors(registers, interferences, generator);
 	
 	// Propagate colors until converged
 	report(" Propating colors until converged.");
@@ -321,7 +404,7 @@ static void color(RegisterAllocator::VirtualRegisterSet& spilled,
 	while(changed)
 	{
 		changed = propagateColorsInParallel(registers,
-			iteration++, interferences);
+			iteration++, interferences, generator);
 		
 		// Check iteration count
 		assertM(iteration <= colors, "Too many iterations: " << iteration);
@@ -361,8 +444,8 @@ static void replaceVirtualRegisterWithPhysical(ir::Operand*& operand,
 		auto indirectOperand = static_cast<ir::IndirectOperand*>(operand);
 		
 		newOperand = new machine::PhysicalIndirectOperand(
-			allocator.getPhysicalRegister(*indirectOperand->virtualRegister),
-			indirectOperand->virtualRegister, indirectOperand->offset,
+			allocator.getPhysicalRegister(*indirectOperand->virtualRegister()),
+			indirectOperand->virtualRegister(), indirectOperand->offset,
 			indirectOperand->instruction);
 	}
 	else
@@ -370,8 +453,8 @@ static void replaceVirtualRegisterWithPhysical(ir::Operand*& operand,
 		auto registerOperand = static_cast<ir::RegisterOperand*>(operand);
 	
 		newOperand = new machine::PhysicalRegisterOperand(
-			allocator.getPhysicalRegister(*registerOperand->virtualRegister),
-			registerOperand->virtualRegister, registerOperand->instruction);
+			allocator.getPhysicalRegister(*registerOperand->virtualRegister()),
+			registerOperand->virtualRegister(), registerOperand->instruction);
 	}
 
 	delete operand;
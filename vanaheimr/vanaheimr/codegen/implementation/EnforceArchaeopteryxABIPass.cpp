@@ -19,6 +19,10 @@
 #include <hydrazine/interface/debug.h>
 
 // Standard Library Includes
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <list>
 #include <cstring>
 
 // Preprocessor Macros
@@ -35,7 +39,8 @@ namespace codegen
 {
 
 EnforceArchaeopteryxABIPass::EnforceArchaeopteryxABIPass()
-: ModulePass({}, "EnforceArchaeopteryxABIPass")
+: ModulePass({}, "EnforceArchaeopteryxABIPass"), layout(PackedLayout),
+	_bytesSaved(0)
 {
 
 }
@@ -43,10 +48,34 @@ EnforceArchaeopteryxABIPass::EnforceArchaeopteryxABIPass()
 typedef util::LargeMap<std::string, uint64_t> GlobalToAddressMap;
 typedef util::SmallMap<std::string, uint64_t>  LocalToAddressMap;
 
-static void layoutGlobals(ir::Module& module, GlobalToAddressMap& globals,
-	const abi::ApplicationBinaryInterface& abi);
-static void layoutLocals(ir::Function& function, LocalToAddressMap& globals,
-	const abi::ApplicationBinaryInterface& abi);
+typedef EnforceArchaeopteryxABIPass::LayoutStrategy LayoutStrategy;
+typedef EnforceArchaeopteryxABIPass::StringSet      StringSet;
+
+/*! \brief A variable that needs to be assigned an address */
+class LayoutEntry
+{
+public:
+	LayoutEntry(ir::Global* variable, unsigned int order, bool hot);
+
+public:
+	ir::Global*  variable;
+	uint64_t     bytes;
+	uint64_t     alignment;
+	unsigned int order;
+	bool         hot;
+
+public:
+	uint64_t     offset;
+};
+
+typedef std::vector<LayoutEntry> LayoutEntryVector;
+
+static uint64_t layoutGlobals(ir::Module& module, GlobalToAddressMap& globals,
+	const abi::ApplicationBinaryInterface& abi, LayoutStrategy layout,
+	const StringSet& hotGlobals, uint64_t& bytesSaved);
+static uint64_t layoutLocals(ir::Function& function, LocalToAddressMap& globals,
+	const abi::ApplicationBinaryInterface& abi, LayoutStrategy layout,
+	uint64_t base, uint64_t& bytesSaved);
 static void layoutArguments(ir::Function& function, LocalToAddressMap& globals,
 	const abi::ApplicationBinaryInterface& abi);
 static void lowerFunction(ir::Function& function,
@@ -63,7 +92,10 @@ void EnforceArchaeopteryxABIPass::runOnModule(Module& m)
 
 	GlobalToAddressMap globals;
 
-	layoutGlobals(m, globals, *abi);
+	_bytesSaved = 0;
+
+	uint64_t staticDataEnd = layoutGlobals(m, globals, *abi, layout,
+		hotGlobals, _bytesSaved);
 	
 	// barrier
 	report(" Lowering functions...");
@@ -73,52 +105,261 @@ void EnforceArchaeopteryxABIPass::runOnModule(Module& m)
 	{
 		LocalToAddressMap locals;
 	
-		layoutLocals(*function, locals, *abi);
+		staticDataEnd = layoutLocals(*function, locals, *abi, layout,
+			staticDataEnd, _bytesSaved);
 		layoutArguments(*function, locals, *abi);
 		
 		// barrier
 
 		lowerFunction(*function, *abi, globals, locals);
 	}
+
+	hydrazine::log("EnforceArchaeopteryxABIPass") << "Variable layout for "
+		<< m.name << " uses " << staticDataEnd << " bytes, saved "
+		<< _bytesSaved << " bytes of padding.\n";
+}
+
+void EnforceArchaeopteryxABIPass::configure(const StringVector& options)
+{
+	for(auto& option : options)
+	{
+		if(option == "layout=declaration")
+		{
+			layout = DeclarationOrderLayout;
+		}
+		else if(option == "layout=packed")
+		{
+			layout = PackedLayout;
+		}
+		else if(option.find("hot=") == 0)
+		{
+			hotGlobals.insert(option.substr(4));
+		}
+		else
+		{
+			throw std::runtime_error("Invalid option '" + option +
+				"' for EnforceArchaeopteryxABIPass.");
+		}
+	}
 }
 
 transforms::Pass* EnforceArchaeopteryxABIPass::clone() const
 {
-	return new EnforceArchaeopteryxABIPass;
+	auto pass = new EnforceArchaeopteryxABIPass;
+
+	pass->layout     = layout;
+	pass->hotGlobals = hotGlobals;
+
+	return pass;
+}
+
+uint64_t EnforceArchaeopteryxABIPass::bytesSaved() const
+{
+	return _bytesSaved;
 }
 
-static unsigned int align(unsigned int address, unsigned int alignment)
+static uint64_t align(uint64_t address, uint64_t alignment)
 {
-	unsigned int remainder = address % alignment;
-	unsigned int offset = remainder == 0 ? 0 : alignment - remainder;
+	uint64_t remainder = address % alignment;
+	uint64_t offset = remainder == 0 ? 0 : alignment - remainder;
 	
 	return address + offset;	
 }
 
-static void layoutGlobals(ir::Module& module, GlobalToAddressMap& globals,
-	const abi::ApplicationBinaryInterface& abi)
+LayoutEntry::LayoutEntry(ir::Global* v, unsigned int o, bool h)
+: variable(v), bytes(v->bytes()),
+	alignment(std::max((size_t)1, v->type().alignment())), order(o), hot(h),
+	offset(0)
 {
-	unsigned int offset = 0;
 
+}
+
+static uint64_t layoutInDeclarationOrder(LayoutEntryVector& entries,
+	uint64_t base)
+{
+	uint64_t offset = base;
+
+	for(auto& entry : entries)
+	{
+		entry.offset = align(offset, entry.alignment);
+		
+		offset = entry.offset + entry.bytes;
+	}
+	
+	return offset;
+}
+
+static bool isPackedBefore(const LayoutEntry& left, const LayoutEntry& right)
+{
+	if(left.hot       != right.hot)       return left.hot;
+	if(left.alignment != right.alignment) return left.alignment > right.alignment;
+	if(left.bytes     != right.bytes)     return left.bytes > right.bytes;
+	
+	return left.order < right.order;
+}
+
+/*! \brief Lay out hot variables first, then everything else in decreasing
+	alignment, first-fit packing small variables into padding holes */
+static uint64_t layoutPacked(LayoutEntryVector& entries, uint64_t base)
+{
+	typedef std::pair<uint64_t, uint64_t> Hole;
+	typedef std::list<Hole>               HoleList;
+
+	LayoutEntryVector sorted = entries;
+	
+	std::sort(sorted.begin(), sorted.end(), isPackedBefore);
+
+	HoleList holes;
+	uint64_t end = base;
+
+	for(auto& entry : sorted)
+	{
+		bool placed = false;
+		
+		for(auto hole = holes.begin(); hole != holes.end(); ++hole)
+		{
+			uint64_t start = align(hole->first, entry.alignment);
+			
+			if(start + entry.bytes > hole->second) continue;
+			
+			entry.offset = start;
+			
+			// split the hole around the variable
+			if(start + entry.bytes < hole->second)
+			{
+				holes.insert(std::next(hole),
+					Hole(start + entry.bytes, hole->second));
+			}
+			
+			if(start > hole->first)
+			{
+				hole->second = start;
+			}
+			else
+			{
+				holes.erase(hole);
+			}
+			
+			placed = true;
+			break;
+		}
+		
+		if(placed) continue;
+
+		entry.offset = align(end, entry.alignment);
+		
+		if(entry.offset > end)
+		{
+			holes.push_back(Hole(end, entry.offset));
+		}
+		
+		end = entry.offset + entry.bytes;
+	}
+	
+	// write back in declaration order
+	for(auto& entry : sorted)
+	{
+		entries[entry.order].offset = entry.offset;
+	}
+
+	return end;
+}
+
+static uint64_t layoutVariables(LayoutEntryVector& entries, uint64_t base,
+	LayoutStrategy layout, uint64_t& bytesSaved)
+{
+	LayoutEntryVector declarationOrder = entries;
+
+	uint64_t declarationEnd = layoutInDeclarationOrder(declarationOrder, base);
+
+	if(layout == EnforceArchaeopteryxABIPass::DeclarationOrderLayout)
+	{
+		entries = declarationOrder;
+		
+		return declarationEnd;
+	}
+	
+	uint64_t packedEnd = layoutPacked(entries, base);
+	
+	// Never do worse than declaration order
+	if(packedEnd > declarationEnd)
+	{
+		entries = declarationOrder;
+		
+		return declarationEnd;
+	}
+	
+	bytesSaved += declarationEnd - packedEnd;
+	
+	return packedEnd;
+}
+
+static uint64_t layoutGlobals(ir::Module& module, GlobalToAddressMap& globals,
+	const abi::ApplicationBinaryInterface& abi, LayoutStrategy layout,
+	const StringSet& hotGlobals, uint64_t& bytesSaved)
+{
 	report(" Lowering globals...");
 
+	LayoutEntryVector entries;
+
 	for(auto global = module.global_begin();
 		global != module.global_end(); ++global)
 	{
-		offset = align(offset, global->type().alignment());
-		
-		report("  Laying out '" << global->name() << "' at " << offset);
+		entries.push_back(LayoutEntry(&*global, entries.size(),
+			hotGlobals.count(global->name()) != 0));
+	}
+	
+	uint64_t end = layoutVariables(entries, 0, layout, bytesSaved);
+
+	for(auto& entry : entries)
+	{
+		report("  Laying out '" << entry.variable->name() << "' at "
+			<< entry.offset);
 		
-		globals.insert(std::make_pair(global->name(), offset));
+		entry.variable->setAddress(entry.offset);
 
-		offset += global->bytes();
+		globals.insert(std::make_pair(entry.variable->name(), entry.offset));
 	}
+	
+	return end;
 }
 
-static void layoutLocals(ir::Function& function, LocalToAddressMap& locals,
-	const abi::ApplicationBinaryInterface& abi)
+/*! \brief Locals are statically allocated in the data section
+	after the globals, one frame per function */
+static uint64_t layoutLocals(ir::Function& function, LocalToAddressMap& locals,
+	const abi::ApplicationBinaryInterface& abi, LayoutStrategy layout,
+	uint64_t base, uint64_t& bytesSaved)
 {
-	assertM(function.local_empty(), "Lowering locals not implemented.");
+	if(function.local_empty()) return base;
+
+	report(" Lowering locals...");
+
+	LayoutEntryVector entries;
+
+	uint64_t frameAlignment = 1;
+
+	for(auto local = function.local_begin();
+		local != function.local_end(); ++local)
+	{
+		entries.push_back(LayoutEntry(&*local, entries.size(), false));
+		
+		frameAlignment = std::max(frameAlignment, entries.back().alignment);
+	}
+
+	uint64_t end = layoutVariables(entries, align(base, frameAlignment),
+		layout, bytesSaved);
+
+	for(auto& entry : entries)
+	{
+		report("  Laying out '" << entry.variable->name() << "' at "
+			<< entry.offset);
+		
+		entry.variable->setAddress(entry.offset);
+
+		locals.insert(std::make_pair(entry.variable->name(), entry.offset));
+	}
+	
+	return end;
 }
 
 static void layoutArguments(ir::Function& function, LocalToAddressMap& locals,
@@ -134,7 +375,8 @@ static void layoutArguments(ir::Function& function, LocalToAddressMap& locals,
 	for(auto argument = function.argument_begin();
 		argument != function.argument_end(); ++argument)
 	{
-		offset = align(offset, argument->type().alignment());
+		offset = align(offset, std::max((size_t)1,
+			argument->type().alignment()));
 	
 		report("  Laying out '" << argument->name() << "' at " << offset);
 		
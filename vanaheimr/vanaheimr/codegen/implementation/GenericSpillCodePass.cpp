@@ -9,9 +9,35 @@
 
 #include <vanaheimr/codegen/interface/RegisterAllocator.h>
 
+#include <vanaheimr/abi/interface/ApplicationBinaryInterface.h>
+
+#include <vanaheimr/machine/interface/PhysicalRegisterOperand.h>
+#include <vanaheimr/machine/interface/PhysicalIndirectOperand.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Function.h>
+#include <vanaheimr/ir/interface/VirtualRegister.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+#include <vanaheimr/util/interface/LargeMap.h>
+#include <vanaheimr/util/interface/SmallMap.h>
+
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
+// Standard Library Includes
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// Preprocessor Macros
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 1
+
 namespace vanaheimr
 {
 
@@ -19,28 +45,333 @@ namespace codegen
 {
 
 GenericSpillCodePass::GenericSpillCodePass()
-: FunctionPass({}, "GenericSpillCodePass")
+: FunctionPass({}, "GenericSpillCodePass"), abiName("archaeopteryx")
 {
 
 }
 
+typedef RegisterAllocator::VirtualRegisterSet     VirtualRegisterSet;
+typedef RegisterAllocator::PhysicalRegisterVector PhysicalRegisterVector;
+
+typedef util::LargeMap<ir::VirtualRegister*, uint64_t> SpillSlotMap;
+typedef util::SmallMap<ir::VirtualRegister*,
+	const machine::PhysicalRegister*> ReloadMap;
+
+typedef abi::ApplicationBinaryInterface::FixedAddressRegion FixedAddressRegion;
+
+typedef GenericSpillCodePass::SpillFrame SpillFrame;
+
+static void layoutSpillSlots(SpillSlotMap& slots, SpillFrame& frame,
+	const VirtualRegisterSet& spilled, const ir::Function& function,
+	const abi::ApplicationBinaryInterface& abi);
+static void insertSpillCode(ir::BasicBlock& block, SpillFrame& frame,
+	const SpillSlotMap& slots, const PhysicalRegisterVector& temporaries);
+
 void GenericSpillCodePass::runOnFunction(Function& f)
 {
 	auto pass = static_cast<RegisterAllocator*>(getPass("register-allocator"));
 	assert(pass != nullptr);
-	
+
 	auto spilled = pass->getSpilledRegisters();
-	
-	assertM(spilled.empty(), "Spilling not implemented");	
+
+	auto abi = abi::ApplicationBinaryInterface::getABI(abiName);
+	assert(abi != nullptr);
+
+	SpillSlotMap slots;
+
+	_frame = SpillFrame();
+
+	layoutSpillSlots(slots, _frame, spilled, f, *abi);
+
+	if(slots.empty()) return;
+
+	report("Inserting spill code for " << slots.size()
+		<< " values in function '" << f.name() << "'");
+
+	auto temporaries = pass->getSpillTemporaries();
+
+	assertM(!temporaries.empty(), "Values were spilled without reserving "
+		"temporary registers to reload them.");
+
+	for(auto block = f.begin(); block != f.end(); ++block)
+	{
+		insertSpillCode(*block, _frame, slots, temporaries);
+	}
+}
+
+const GenericSpillCodePass::SpillFrame& GenericSpillCodePass::frame() const
+{
+	return _frame;
+}
+
+GenericSpillCodePass::SpillFrame::SpillFrame()
+: bytes(0), regionBytes(0), offset(0), alignment(1)
+{
+
+}
+
+void GenericSpillCodePass::SpillFrame::relocate(uint64_t newOffset)
+{
+	if(newOffset + bytes > regionBytes)
+	{
+		throw std::runtime_error("Spill frames do not fit in the ABI "
+			"spill region.");
+	}
+
+	for(auto address : addresses)
+	{
+		address->uint += newOffset - offset;
+	}
+
+	offset = newOffset;
 }
 
 transforms::Pass* GenericSpillCodePass::clone() const
 {
-	return new GenericSpillCodePass;
+	auto pass = new GenericSpillCodePass;
+
+	pass->abiName = abiName;
+
+	return pass;
+}
+
+static uint64_t align(uint64_t address, uint64_t alignment)
+{
+	uint64_t remainder = address % alignment;
+	uint64_t offset = remainder == 0 ? 0 : alignment - remainder;
+
+	return address + offset;
+}
+
+typedef std::vector<ir::VirtualRegister*> RegisterVector;
+
+static bool compareIds(const ir::VirtualRegister* left,
+	const ir::VirtualRegister* right)
+{
+	return left->id < right->id;
+}
+
+static void layoutSpillSlots(SpillSlotMap& slots, SpillFrame& frame,
+	const VirtualRegisterSet& spilled, const ir::Function& function,
+	const abi::ApplicationBinaryInterface& abi)
+{
+	// The allocator reports spills for every function it has seen,
+	//  assign slots in register order so the layout is deterministic
+	RegisterVector registers;
+
+	for(auto reg : spilled)
+	{
+		if(reg->function != &function) continue;
+		
+		registers.push_back(reg);
+	}
+	
+	std::sort(registers.begin(), registers.end(), compareIds);
+
+	uint64_t offset = 0;
+
+	const FixedAddressRegion* fixedRegion = nullptr;
+
+	for(auto reg : registers)
+	{
+		if(fixedRegion == nullptr)
+		{
+			auto region = abi.findRegion("spill");
+
+			if(region == nullptr || !region->isFixed())
+			{
+				throw std::runtime_error("The ABI does not provide a fixed "
+					"'spill' region, cannot spill registers.");
+			}
+
+			fixedRegion = static_cast<const FixedAddressRegion*>(region);
+		}
+
+		uint64_t bytes = reg->type->bytes();
+
+		offset = align(offset, bytes);
+
+		frame.alignment = std::max(frame.alignment, bytes);
+
+		if(offset + bytes > fixedRegion->bytes)
+		{
+			throw std::runtime_error("Spilled values in function '" +
+				function.name() + "' do not fit in the ABI spill region.");
+		}
+
+		report(" spilling vr" << reg->id << " to "
+			<< (fixedRegion->address + offset));
+
+		slots.insert(std::make_pair(reg, fixedRegion->address + offset));
+
+		offset += bytes;
+	}
+
+	frame.bytes = offset;
+
+	if(fixedRegion != nullptr) frame.regionBytes = fixedRegion->bytes;
+}
+
+static ir::VirtualRegister* getSpilledRegister(ir::Operand* operand,
+	const SpillSlotMap& slots)
+{
+	if(operand->mode() == ir::Operand::Predicate)
+	{
+		auto predicate = static_cast<ir::PredicateOperand*>(operand);
+
+		if(slots.count(predicate->virtualRegister()) != 0)
+		{
+			throw std::runtime_error("Spilling predicate registers is "
+				"not supported.");
+		}
+
+		return nullptr;
+	}
+
+	if(!operand->isRegister()) return nullptr;
+
+	auto reg = static_cast<ir::RegisterOperand*>(operand)->virtualRegister();
+
+	if(slots.count(reg) == 0) return nullptr;
+
+	return reg;
+}
+
+static int64_t getIndirectOffset(const ir::Operand* operand)
+{
+	// Allocated operands are not ir::IndirectOperands, the offset is
+	//  in a different place
+	auto physical =
+		dynamic_cast<const machine::PhysicalIndirectOperand*>(operand);
+
+	if(physical != nullptr) return physical->offset;
+
+	return static_cast<const ir::IndirectOperand*>(operand)->offset;
 }
 
+static void replaceWithTemporary(ir::Operand*& operand,
+	const machine::PhysicalRegister* temporary)
+{
+	auto registerOperand = static_cast<ir::RegisterOperand*>(operand);
+
+	ir::Operand* newOperand = nullptr;
+
+	if(operand->isIndirect())
+	{
+		newOperand = new machine::PhysicalIndirectOperand(temporary,
+			registerOperand->virtualRegister(), getIndirectOffset(operand),
+			registerOperand->instruction);
+	}
+	else
+	{
+		newOperand = new machine::PhysicalRegisterOperand(temporary,
+			registerOperand->virtualRegister(), registerOperand->instruction);
+	}
+
+	delete operand;
+
+	operand = newOperand;
 }
 
+static ir::Operand* getSpillAddress(uint64_t address, ir::Instruction* i,
+	SpillFrame& frame)
+{
+	auto type = compiler::Compiler::getSingleton()->getType("i64");
+
+	auto immediate = new ir::ImmediateOperand(address, i, type);
+
+	frame.addresses.push_back(immediate);
+
+	return immediate;
 }
 
+static void insertSpillCode(ir::BasicBlock& block, SpillFrame& frame,
+	const SpillSlotMap& slots, const PhysicalRegisterVector& temporaries)
+{
+	for(auto position = block.begin(); position != block.end(); ++position)
+	{
+		auto instruction = *position;
+
+		ReloadMap reloaded;
+
+		// Reload each spilled source into its own temporary
+		for(auto& read : instruction->reads)
+		{
+			auto reg = getSpilledRegister(read, slots);
+
+			if(reg == nullptr) continue;
+
+			auto temporary = reloaded.find(reg);
+
+			if(temporary == reloaded.end())
+			{
+				if(reloaded.size() == temporaries.size())
+				{
+					throw std::runtime_error("Not enough spill temporaries "
+						"to reload the sources of " + instruction->toString());
+				}
+
+				temporary = reloaded.insert(std::make_pair(reg,
+					temporaries[reloaded.size()])).first;
+
+				auto load = new ir::Ld(&block);
+
+				load->setGuard(new ir::PredicateOperand(
+					ir::PredicateOperand::PredicateTrue, load));
+				load->setD(new machine::PhysicalRegisterOperand(
+					temporary->second, reg, load));
+				load->setA(getSpillAddress(slots.find(reg)->second, load,
+					frame));
+
+				report("  " << load->toString());
+
+				block.insert(position, load);
+			}
+
+			replaceWithTemporary(read, temporary->second);
+		}
+
+		// Sources are dead by the time results are written, so all
+		//  spilled destinations can share the first temporary
+		auto next = position; ++next;
+
+		for(auto& write : instruction->writes)
+		{
+			auto reg = getSpilledRegister(write, slots);
+
+			if(reg == nullptr) continue;
+
+			assertM(instruction->writes.size() == 1, "Spilling instructions "
+				"with multiple destinations is not supported.");
+
+			replaceWithTemporary(write, temporaries.front());
+
+			auto store = new ir::St(&block);
+
+			// A predicated definition that does not execute leaves the
+			//  temporary stale, the slot must keep the old value
+			auto guard = static_cast<ir::PredicateOperand*>(
+				instruction->guard()->clone());
+
+			guard->instruction = store;
+
+			store->setGuard(guard);
+			store->setD(getSpillAddress(slots.find(reg)->second, store,
+				frame));
+			store->setA(new machine::PhysicalRegisterOperand(
+				temporaries.front(), reg, store));
+
+			report("  " << store->toString());
+
+			block.insert(next, store);
+		}
+
+		// skip over the stores
+		while(std::next(position) != next) ++position;
+	}
+}
+
+}
+
+}
 
@@ -13,11 +13,13 @@
 #include <vanaheimr/ir/interface/BasicBlock.h>
 
 #include <vanaheimr/util/interface/LargeSet.h>
+#include <vanaheimr/util/interface/LargeMap.h>
 
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
 // Standard Library Includes
+#include <vector>
 #include <cassert>
 
 // Preprocessor Macros
@@ -40,6 +42,9 @@ ListInstructionSchedulerPass::ListInstructionSchedulerPass()
 }
 
 typedef util::LargeSet<ir::Instruction*> InstructionSet;
+typedef std::vector<ir::Instruction*>    InstructionVector;
+typedef util::LargeSet<unsigned int>     PositionSet;
+typedef util::LargeMap<const ir::Instruction*, unsigned int> PositionMap;
 	
 static bool anyDependencies(ir::Instruction* instruction,
 	analysis::DependenceAnalysis& dep, const InstructionSet& remaining)
@@ -66,9 +71,20 @@ static void schedule(ir::BasicBlock& block, analysis::DependenceAnalysis& dep)
 	report(" Scheduling basic block '" << block.name() << "'");
 
 	// TODO sort by priority, sort in parallel
-	ir::BasicBlock::InstructionList newInstructions;
+	InstructionVector newInstructions;
 	
-	InstructionSet readyInstructions;
+	// Ready instructions are picked in their original order, never by
+	//  address, so the schedule does not depend on the allocator
+	InstructionVector originalInstructions(block.begin(), block.end());
+	
+	PositionMap positions;
+	
+	for(unsigned int i = 0; i < originalInstructions.size(); ++i)
+	{
+		positions.insert(std::make_pair(originalInstructions[i], i));
+	}
+	
+	PositionSet readyInstructions;
 	
 	InstructionSet remainingInstructions;
 	
@@ -82,14 +98,15 @@ static void schedule(ir::BasicBlock& block, analysis::DependenceAnalysis& dep)
 		{
 			report("   " << instruction->toString());
 		
-			readyInstructions.insert(instruction);
+			readyInstructions.insert(positions[instruction]);
 		}
 	}
 	
 	// Remove them from the set of remaining instructions
-	for(auto instruction : readyInstructions)
+	for(auto position : readyInstructions)
 	{
-		auto remaining = remainingInstructions.find(instruction);
+		auto remaining = remainingInstructions.find(
+			originalInstructions[position]);
 
 		assert(remaining != remainingInstructions.end());
 
@@ -100,7 +117,7 @@ static void schedule(ir::BasicBlock& block, analysis::DependenceAnalysis& dep)
 	
 	while(!readyInstructions.empty())
 	{
-		auto next = *readyInstructions.begin();
+		auto next = originalInstructions[*readyInstructions.begin()];
 		readyInstructions.erase(readyInstructions.begin());
 
 		report("   " << next->toString());
@@ -122,7 +139,7 @@ static void schedule(ir::BasicBlock& block, analysis::DependenceAnalysis& dep)
 				
 				report("    released '" << successor->toString() << "'");
 
-				readyInstructions.insert(successor);
+				readyInstructions.insert(positions[successor]);
 			}
 		}
 	}
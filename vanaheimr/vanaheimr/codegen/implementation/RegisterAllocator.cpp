@@ -7,6 +7,10 @@
 // Vanaheimr Includes
 #include <vanaheimr/codegen/interface/RegisterAllocator.h>
 
+// Standard Library Includes
+#include <stdexcept>
+#include <cstdlib>
+
 namespace vanaheimr
 {
 
@@ -15,7 +19,8 @@ namespace codegen
 
 RegisterAllocator::RegisterAllocator(const StringVector& analyses,
 	const std::string& n)
-: transforms::FunctionPass(analyses, n, {"register-allocator"})
+: transforms::FunctionPass(analyses, n, {"register-allocator"}),
+	_registerBudget(0), _usedRegisterCount(0)
 {
 	
 }
@@ -35,6 +40,35 @@ void RegisterAllocator::finalize()
 
 }
 
+void RegisterAllocator::configure(const StringVector& options)
+{
+	for(auto& option : options)
+	{
+		if(option.find("registers=") != 0)
+		{
+			throw std::runtime_error("Invalid register allocator option '" +
+				option + "'.");
+		}
+		
+		setRegisterBudget(std::atoi(option.substr(10).c_str()));
+	}
+}
+
+void RegisterAllocator::setRegisterBudget(unsigned int registers)
+{
+	_registerBudget = registers;
+}
+
+unsigned int RegisterAllocator::registerBudget() const
+{
+	return _registerBudget;
+}
+
+unsigned int RegisterAllocator::usedRegisterCount() const
+{
+	return _usedRegisterCount;
+}
+
 }
 
 }
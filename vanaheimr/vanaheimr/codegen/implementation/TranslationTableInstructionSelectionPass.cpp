@@ -21,6 +21,7 @@
 
 // Standard Library Includes
 #include <stdexcept>
+#include <vector>
 #include <cassert>
 
 namespace vanaheimr
@@ -49,7 +50,9 @@ transforms::Pass* TranslationTableInstructionSelectionPass::clone() const
 	return new TranslationTableInstructionSelectionPass;
 }
 
-static void lowerInstruction(ir::BasicBlock::InstructionList& instructions,
+typedef std::vector<ir::Instruction*> InstructionVector;
+
+static void lowerInstruction(InstructionVector& instructions,
 	ir::Instruction* instruction,
 	const machine::TranslationTable* translationTable);
 
@@ -60,7 +63,7 @@ void TranslationTableInstructionSelectionPass::_lowerBlock(BasicBlock& block)
 	
 	auto machineModel = compiler::Compiler::getSingleton()->getMachineModel();
 	
-	BasicBlock::InstructionList loweredInstructions;
+	InstructionVector loweredInstructions;
 
 	auto translationTable = machineModel->translationTable();
 	
@@ -73,10 +76,16 @@ void TranslationTableInstructionSelectionPass::_lowerBlock(BasicBlock& block)
 	// Swap out the block contents, deallocate it
 	block.clear();
 
+	// Translations copy operands out of the original instructions
+	for(auto instruction : loweredInstructions)
+	{
+		instruction->linkOperands();
+	}
+
 	block.assign(loweredInstructions.begin(), loweredInstructions.end());
 }
 
-static void lowerInstruction(ir::BasicBlock::InstructionList& instructions,
+static void lowerInstruction(InstructionVector& instructions,
 	ir::Instruction* instruction,
 	const machine::TranslationTable* translationTable)
 {
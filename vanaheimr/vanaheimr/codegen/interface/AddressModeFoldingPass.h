@@ -0,0 +1,53 @@
+/*! \file   AddressModeFoldingPass.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the AddressModeFoldingPass class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/transforms/interface/Pass.h>
+
+namespace vanaheimr
+{
+
+namespace codegen
+{
+
+/*! \brief Fold constant address arithmetic into indirect memory operands
+
+	Chains of the form 'add rX, rBase, imm' that feed the address of a
+	load or store are folded into the offset of the indirect operand,
+	and the arithmetic is deleted once it has no remaining uses.
+
+	The pass matches ir opcodes, it must run before instruction selection.
+ */
+class AddressModeFoldingPass : public transforms::FunctionPass
+{
+public:
+	AddressModeFoldingPass();
+
+public:
+	/*! \brief Run the pass on a specific function in the module */
+	virtual void runOnFunction(Function& f);
+
+public:
+	virtual Pass* clone() const;
+
+public:
+	/*! \brief The number of memory operands rewritten by the last run */
+	unsigned int foldedOperands() const;
+	/*! \brief The number of instructions deleted by the last run */
+	unsigned int deletedInstructions() const;
+
+private:
+	unsigned int _foldedOperands;
+	unsigned int _deletedInstructions;
+
+};
+
+}
+
+}
+
@@ -8,6 +8,15 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/codegen/interface/Target.h>
+#include <vanaheimr/codegen/interface/GenericSpillCodePass.h>
+
+// Standard Library Includes
+#include <string>
+#include <vector>
+#include <map>
+
+// Forward Declarations
+namespace vanaheimr { namespace ir { class Function; } }
 
 namespace vanaheimr
 {
@@ -18,6 +27,13 @@ namespace codegen
 /*! \brief A target for the Archaeopteryx Simulator */
 class ArchaeopteryxTarget : public Target
 {
+public:
+	typedef std::vector<std::string> StringVector;
+
+	/*! \brief The functions called by each function, an empty name
+		stands for an indirect call */
+	typedef std::map<std::string, StringVector> CallGraph;
+
 public:
 	ArchaeopteryxTarget();
 
@@ -30,11 +46,39 @@ public:
 public:
 	virtual Target* clone() const;
 
+public:
+	/*! \brief Get the per-thread register budget implied by the
+		requested occupancy, 0 if there is no limit */
+	unsigned int registerBudget() const;
+
 public:
 	std::string instructionSelectorName;
 	std::string registerAllocatorName;
 	std::string instructionSchedulerName;
 
+public:
+	/*! \brief Options for block placement, e.g. 'profile=<path>' */
+	StringVector blockPlacementOptions;
+
+public:
+	/*! \brief The number of threads that should be able to share a
+		register file, 0 does not constrain register allocation */
+	unsigned int requestedOccupancy;
+	/*! \brief The number of registers in a simulated register file */
+	unsigned int registerFileSize;
+	/*! \brief The number of threads used to lower functions in parallel,
+		0 uses the hardware concurrency, 1 lowers serially */
+	unsigned int threads;
+
+private:
+	typedef GenericSpillCodePass::SpillFrame SpillFrame;
+
+private:
+	void _lowerModule();
+	unsigned int _lowerFunctions(const CallGraph& calls,
+		uint64_t& localMemory);
+	unsigned int _lowerFunction(ir::Function& function, SpillFrame& frame);
+
 };
 
 }
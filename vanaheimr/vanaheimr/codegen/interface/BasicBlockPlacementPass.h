@@ -0,0 +1,83 @@
+/*! \file   BasicBlockPlacementPass.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the BasicBlockPlacementPass class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/transforms/interface/Pass.h>
+
+// Standard Library Includes
+#include <map>
+
+namespace vanaheimr
+{
+
+namespace codegen
+{
+
+/*! \brief Reorder the blocks in a function so that likely successors
+	are reached by falling through
+
+	Blocks are greedily merged into chains along the heaviest edges
+	(Pettis-Hansen), and chains are placed next to the chains that
+	branch to them most often.  Cold blocks (never executed in the
+	profile, unreachable, or calling a function marked 'cold' or
+	'noreturn') are moved to the end of the function.
+
+	Without a profile, edge weights are estimated from the loop
+	nesting depth and back edges are assumed to be taken.
+
+	This must run before instruction selection, while branches are
+	still visible to the control flow graph.
+ */
+class BasicBlockPlacementPass : public transforms::FunctionPass
+{
+public:
+	/*! \brief Execution counts of blocks, indexed by block name */
+	typedef std::map<std::string, uint64_t> BlockCountMap;
+	/*! \brief Block counts, indexed by function name */
+	typedef std::map<std::string, BlockCountMap> FunctionCountMap;
+
+public:
+	BasicBlockPlacementPass();
+
+public:
+	/*! \brief Run the pass on a specific function in the module */
+	virtual void runOnFunction(Function& f);
+
+public:
+	/*! \brief Accepts 'profile=<path>', a file with one
+		'<function> <block> <count>' entry per line */
+	virtual void configure(const StringVector& options);
+
+public:
+	virtual Pass* clone() const;
+
+public:
+	/*! \brief Load block counts from a profile file */
+	void loadProfile(const std::string& path);
+
+public:
+	/*! \brief The number of branches added by the last run */
+	unsigned int insertedBranches() const;
+	/*! \brief The number of branches removed by the last run */
+	unsigned int removedBranches() const;
+
+public:
+	/*! \brief Optional profile counts, functions without counts fall
+		back to static estimates, missing blocks never executed */
+	FunctionCountMap profile;
+
+private:
+	unsigned int _insertedBranches;
+	unsigned int _removedBranches;
+
+};
+
+}
+
+}
+
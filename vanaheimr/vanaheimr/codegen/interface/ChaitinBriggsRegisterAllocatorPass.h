@@ -40,12 +40,24 @@ public:
 	const machine::PhysicalRegister* getPhysicalRegister(
 		const ir::VirtualRegister&) const;
 
+	/*! \brief Get the registers reserved for reloading spilled values */
+	PhysicalRegisterVector getSpillTemporaries() const;
+
+public:
+	/*! \brief The number of registers reserved for spill code when
+		the register budget cannot be met */
+	static const unsigned int SpillTemporaryCount = 3;
+
 private:
 	typedef util::LargeMap<unsigned int, unsigned int> RegisterMap;
 
 private:
-	VirtualRegisterSet _spilled;
-	RegisterMap        _allocated;
+	void _spillToMeetBudget(Function& f, unsigned int colors);
+
+private:
+	VirtualRegisterSet     _spilled;
+	RegisterMap            _allocated;
+	PhysicalRegisterVector _spillTemporaries;
 
 private:
 	const machine::MachineModel* _machine;
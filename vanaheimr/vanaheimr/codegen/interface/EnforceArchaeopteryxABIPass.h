@@ -9,6 +9,9 @@
 // Vanaheimr Includes
 #include <vanaheimr/transforms/interface/Pass.h>
 
+// Standard Library Includes
+#include <set>
+
 namespace vanaheimr
 {
 
@@ -19,6 +22,16 @@ namespace codegen
 	calling convention */
 class EnforceArchaeopteryxABIPass : public transforms::ModulePass
 {
+public:
+	/*! \brief The strategy used to assign addresses to variables */
+	enum LayoutStrategy
+	{
+		DeclarationOrderLayout,
+		PackedLayout
+	};
+
+	typedef std::set<std::string> StringSet;
+
 public:
 	/*! \brief The constructor sets the type */
 	EnforceArchaeopteryxABIPass();
@@ -27,9 +40,29 @@ public:
 	/*! \brief Run the pass on a specific module */
 	virtual void runOnModule(Module& m);
 
+public:
+	/*! \brief Accepts 'layout=declaration', 'layout=packed',
+		and 'hot=<global-name>' */
+	virtual void configure(const StringVector& options);
+
 public:
 	virtual Pass* clone() const;
 
+public:
+	/*! \brief Bytes of padding removed relative to declaration order
+		by the last run */
+	uint64_t bytesSaved() const;
+
+public:
+	/*! \brief The layout strategy for globals and locals */
+	LayoutStrategy layout;
+	/*! \brief Globals that should be grouped together at the start
+		of the data section */
+	StringSet hotGlobals;
+
+private:
+	uint64_t _bytesSaved;
+
 };
 
 }
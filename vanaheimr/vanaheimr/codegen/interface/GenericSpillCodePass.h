@@ -9,12 +9,22 @@
 // Vanaheimr Includes
 #include <vanaheimr/transforms/interface/Pass.h>
 
+// Standard Library Includes
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Forward Declarations
+namespace vanaheimr { namespace ir { class ImmediateOperand; } }
+
 namespace vanaheimr
 {
 
 namespace codegen
 {
 
+/*! \brief Insert loads and stores around the uses and definitions of
+	values that the register allocator spilled to the ABI spill region */
 class GenericSpillCodePass : public transforms::FunctionPass
 {
 public:
@@ -26,6 +36,52 @@ public:
 
 public:
 	virtual Pass* clone() const;
+
+public:
+	/*! \brief The spill slots of one function
+
+		Slots are addressed from the start of the ABI spill region until
+		the frame is relocated.  Functions are lowered independently, so
+		placing frames so that callers and callees do not overlap is left
+		to whoever sees the whole module.
+	*/
+	class SpillFrame
+	{
+	public:
+		typedef std::vector<ir::ImmediateOperand*> ImmediateVector;
+
+	public:
+		SpillFrame();
+
+	public:
+		/*! \brief Move the frame 'offset' bytes into the spill region */
+		void relocate(uint64_t offset);
+
+	public:
+		/*! \brief The bytes used by the slots */
+		uint64_t bytes;
+		/*! \brief The bytes available in the spill region */
+		uint64_t regionBytes;
+		/*! \brief The offset of the frame in the spill region */
+		uint64_t offset;
+		/*! \brief The alignment of the largest slot */
+		uint64_t alignment;
+
+	public:
+		/*! \brief The slot address of every inserted load and store */
+		ImmediateVector addresses;
+	};
+
+public:
+	/*! \brief The frame of the last function the pass ran on */
+	const SpillFrame& frame() const;
+
+public:
+	/*! \brief The ABI that provides the spill region */
+	std::string abiName;
+
+private:
+	SpillFrame _frame;
 };
 
 }
@@ -11,6 +11,9 @@
 
 #include <vanaheimr/util/interface/LargeSet.h>
 
+// Standard Library Includes
+#include <vector>
+
 // Forward Declarations
 namespace vanaheimr { namespace ir      { class VirtualRegister;  } }
 namespace vanaheimr { namespace machine { class PhysicalRegister; } }
@@ -27,6 +30,8 @@ class RegisterAllocator : public transforms::FunctionPass
 
 public:
 	typedef util::LargeSet<ir::VirtualRegister*> VirtualRegisterSet;
+	typedef std::vector<const machine::PhysicalRegister*>
+		PhysicalRegisterVector;
 
 public:
 	/*! \brief The default constructor sets the type */
@@ -42,6 +47,10 @@ public:
 	/*! \brief Finalize the pass */
 	virtual void finalize();
 
+public:
+	/*! \brief Accepts 'registers=<n>' to set the per-thread register budget */
+	virtual void configure(const StringVector& options);
+
 public:
 	/*! \brief Get the set of values that were spilled during allocation */
 	virtual VirtualRegisterSet getSpilledRegisters() = 0;
@@ -50,6 +59,26 @@ public:
 	virtual const machine::PhysicalRegister* getPhysicalRegister(
 		const ir::VirtualRegister&) const = 0;
 
+	/*! \brief Get the registers held back from allocation to reload
+		spilled values, they are only valid within a single instruction */
+	virtual PhysicalRegisterVector getSpillTemporaries() const = 0;
+
+public:
+	/*! \brief Limit the number of registers available to each thread,
+		0 allows the allocator to use the entire machine register file */
+	void setRegisterBudget(unsigned int registers);
+
+	/*! \brief Get the per-thread register budget, 0 if there is none */
+	unsigned int registerBudget() const;
+
+	/*! \brief Get the largest number of registers used by any function
+		allocated since the pass was initialized */
+	unsigned int usedRegisterCount() const;
+
+protected:
+	unsigned int _registerBudget;
+	unsigned int _usedRegisterCount;
+
 };
 
 }
@@ -0,0 +1,717 @@
+/*! \file   test-archaeopteryx-lowering.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the test-archaeopteryx-lowering test.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/codegen/interface/ArchaeopteryxTarget.h>
+
+#include <vanaheimr/asm/interface/BinaryWriter.h>
+#include <vanaheimr/asm/interface/BinaryReader.h>
+
+#include <vanaheimr/machine/interface/Instruction.h>
+#include <vanaheimr/machine/interface/PhysicalIndirectOperand.h>
+#include <vanaheimr/machine/interface/Operation.h>
+#include <vanaheimr/machine/interface/MachineModel.h>
+#include <vanaheimr/machine/interface/MachineModelFactory.h>
+#include <vanaheimr/machine/interface/TranslationTable.h>
+#include <vanaheimr/machine/interface/OpcodeOnlyTranslationTableEntry.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Constant.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <map>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+namespace test
+{
+
+namespace ir      = vanaheimr::ir;
+namespace machine = vanaheimr::machine;
+
+/*! \brief The simulator machine with a one-to-one translation table */
+class TestMachineModel : public machine::MachineModel
+{
+public:
+	TestMachineModel()
+	: MachineModel("TestArchaeopteryxSimulator")
+	{
+		addRegisterFile("rf", 64);
+
+		_translationTable = new machine::TranslationTable;
+
+		for(auto opcode : {"add", "sub", "mul", "ld", "st", "ret"})
+		{
+			_translationTable->addTranslation(
+				new machine::OpcodeOnlyTranslationTableEntry(
+				opcode, opcode, ""));
+		}
+	}
+
+public:
+	virtual MachineModel* clone() const
+	{
+		return new TestMachineModel;
+	}
+
+};
+
+typedef std::vector<ir::VirtualRegister*> VirtualRegisterVector;
+
+template<typename InstructionType>
+static InstructionType* append(ir::BasicBlock& block)
+{
+	auto instruction = new InstructionType(&block);
+
+	instruction->setGuard(new ir::PredicateOperand(
+		ir::PredicateOperand::PredicateTrue, instruction));
+
+	block.push_back(instruction);
+
+	return instruction;
+}
+
+/*! \brief Load 'values' elements off of a base pointer, sum them, and
+	store the sum back, all of the loads are live at once */
+static void buildKernel(ir::Module& module, const std::string& name,
+	unsigned int values)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto i64 = compiler->getType("i64");
+
+	auto function = module.newFunction(name,
+		ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility);
+
+	function->addAttribute("kernel");
+
+	auto block = function->newBasicBlock(function->exit_block(), "body");
+
+	auto base = &*function->newVirtualRegister(i64);
+
+	auto initialize = append<ir::Add>(*block);
+
+	initialize->setD(new ir::RegisterOperand(base, initialize));
+	initialize->setA(new ir::ImmediateOperand((uint64_t)4096,
+		initialize, i64));
+	initialize->setB(new ir::ImmediateOperand((uint64_t)0, initialize, i64));
+
+	VirtualRegisterVector loaded;
+
+	for(unsigned int i = 0; i < values; ++i)
+	{
+		// saxpy style address arithmetic, 'base + 8 * i'
+		auto address = &*function->newVirtualRegister(i64);
+
+		auto add = append<ir::Add>(*block);
+
+		add->setD(new ir::RegisterOperand(address, add));
+		add->setA(new ir::RegisterOperand(base, add));
+		add->setB(new ir::ImmediateOperand((uint64_t)(8 * i), add, i64));
+
+		auto value = &*function->newVirtualRegister(i64);
+
+		auto load = append<ir::Ld>(*block);
+
+		load->setD(new ir::RegisterOperand(value, load));
+		load->setA(new ir::IndirectOperand(address, 0, load));
+
+		loaded.push_back(value);
+	}
+
+	auto sum = loaded.front();
+
+	for(unsigned int i = 1; i < values; ++i)
+	{
+		auto next = &*function->newVirtualRegister(i64);
+
+		auto add = append<ir::Add>(*block);
+
+		add->setD(new ir::RegisterOperand(next, add));
+		add->setA(new ir::RegisterOperand(sum, add));
+		add->setB(new ir::RegisterOperand(loaded[i], add));
+
+		sum = next;
+	}
+
+	auto store = append<ir::St>(*block);
+
+	store->setD(new ir::IndirectOperand(base, 0, store));
+	store->setA(new ir::RegisterOperand(sum, store));
+
+	append<ir::Ret>(*block);
+}
+
+static ir::Module* lowerKernel(unsigned int values, unsigned int occupancy)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto module = new ir::Module("test-archaeopteryx-lowering", compiler);
+
+	buildKernel(*module, "kernel", values);
+
+	vanaheimr::codegen::ArchaeopteryxTarget target;
+
+	target.requestedOccupancy = occupancy;
+
+	target.assignModule(module);
+	target.lower();
+
+	return module;
+}
+
+static uint64_t getIntegerGlobal(const ir::Module& module,
+	const std::string& name)
+{
+	auto global = module.getGlobal(name);
+
+	if(global == module.global_end() || !global->hasInitializer()) return 0;
+
+	auto constant = dynamic_cast<const ir::IntegerConstant*>(
+		global->initializer());
+
+	if(constant == nullptr)
+	{
+		throw std::runtime_error("Global '" + name +
+			"' is not an integer.");
+	}
+
+	return *constant;
+}
+
+static unsigned int getEmittedRegisterCount(const ir::Module& module)
+{
+	return getIntegerGlobal(module, "simulated-registers-per-thread");
+}
+
+static unsigned int getMaximumEncodedRegister(const ir::Operand* operand)
+{
+	if(operand == nullptr || !operand->isRegister()) return 0;
+
+	return vanaheimr::as::BinaryWriter::getEncodedRegister(
+		*static_cast<const ir::RegisterOperand*>(operand));
+}
+
+static unsigned int getMaximumEncodedRegister(const ir::Module& module)
+{
+	unsigned int maximum = 0;
+
+	for(auto function = module.begin(); function != module.end(); ++function)
+	{
+		for(auto& block : *function)
+		{
+			for(auto instruction : block)
+			{
+				for(auto read : instruction->reads)
+				{
+					maximum = std::max(maximum,
+						getMaximumEncodedRegister(read));
+				}
+
+				for(auto write : instruction->writes)
+				{
+					maximum = std::max(maximum,
+						getMaximumEncodedRegister(write));
+				}
+			}
+		}
+	}
+
+	return maximum;
+}
+
+/*! \brief Executes lowered code for a single thread, every value and
+	every memory word is 64 bits wide.  Like the simulator, accesses to the
+	published local memory window go to memory private to the thread. */
+class Interpreter
+{
+public:
+	typedef std::map<uint64_t, uint64_t>     Memory;
+	typedef std::map<unsigned int, uint64_t> RegisterFile;
+
+public:
+	Interpreter(uint64_t localAddress, uint64_t localBytes)
+	: _localAddress(localAddress), _localBytes(localBytes)
+	{
+
+	}
+
+public:
+	void run(const ir::Function& function)
+	{
+		for(auto& block : function)
+		{
+			for(auto instruction : block)
+			{
+				if(!instruction->guard()->isAlwaysTrue())
+				{
+					throw std::runtime_error("Predicated instruction '" +
+						instruction->toString() + "' is not supported.");
+				}
+
+				auto opcode = instruction->opcodeString();
+
+				if(opcode == "ret") return;
+
+				if(opcode == "add")
+				{
+					write(instruction->writes[0],
+						read(instruction->reads[1]) +
+						read(instruction->reads[2]));
+				}
+				else if(opcode == "ld")
+				{
+					auto location = address(instruction->reads[1]);
+
+					write(instruction->writes[0],
+						bank(location)[location]);
+				}
+				else if(opcode == "st")
+				{
+					auto location = address(instruction->reads[1]);
+
+					bank(location)[location] = read(instruction->reads[2]);
+				}
+				else
+				{
+					throw std::runtime_error("Instruction '" +
+						instruction->toString() + "' is not supported.");
+				}
+			}
+		}
+	}
+
+public:
+	Memory memory;
+	Memory local;
+
+private:
+	Memory& bank(uint64_t location)
+	{
+		if(location >= _localAddress &&
+			location - _localAddress < _localBytes)
+		{
+			return local;
+		}
+
+		return memory;
+	}
+
+private:
+	static unsigned int getRegister(const ir::Operand* operand)
+	{
+		return vanaheimr::as::BinaryWriter::getEncodedRegister(
+			*static_cast<const ir::RegisterOperand*>(operand));
+	}
+
+	static int64_t getOffset(const ir::Operand* operand)
+	{
+		auto physical =
+			dynamic_cast<const machine::PhysicalIndirectOperand*>(operand);
+
+		if(physical != nullptr) return physical->offset;
+
+		return static_cast<const ir::IndirectOperand*>(operand)->offset;
+	}
+
+	uint64_t read(const ir::Operand* operand)
+	{
+		if(operand->isImmediate())
+		{
+			return static_cast<const ir::ImmediateOperand*>(
+				operand)->uint;
+		}
+
+		return _registers[getRegister(operand)];
+	}
+
+	uint64_t address(const ir::Operand* operand)
+	{
+		if(!operand->isIndirect()) return read(operand);
+
+		return _registers[getRegister(operand)] + getOffset(operand);
+	}
+
+	void write(const ir::Operand* operand, uint64_t value)
+	{
+		_registers[getRegister(operand)] = value;
+	}
+
+private:
+	RegisterFile _registers;
+
+	uint64_t _localAddress;
+	uint64_t _localBytes;
+};
+
+/*! \brief Run the lowered kernel and check the sum that it stores */
+static bool runKernel(const ir::Module& module, unsigned int values)
+{
+	Interpreter interpreter(
+		getIntegerGlobal(module, "simulated-local-memory-address"),
+		getIntegerGlobal(module, "simulated-local-memory-per-thread"));
+
+	uint64_t expected = 0;
+
+	for(unsigned int i = 0; i < values; ++i)
+	{
+		interpreter.memory[4096 + 8 * i] = i + 1;
+
+		expected += i + 1;
+	}
+
+	auto kernel = module.getFunction("kernel");
+
+	interpreter.run(*kernel);
+
+	uint64_t sum = interpreter.memory[4096];
+
+	std::cout << " the kernel stored " << sum << ", expected "
+		<< expected << ", " << interpreter.local.size()
+		<< " thread local words used\n";
+
+	// Anything outside of the inputs would be shared by every thread
+	for(auto& word : interpreter.memory)
+	{
+		if(word.first < 4096 || word.first >= 4096 + 8 * values)
+		{
+			std::cout << "Address " << word.first << " is outside of the "
+				"thread local memory window.\n";
+			return false;
+		}
+	}
+
+	return sum == expected;
+}
+
+static bool testRegisterBudget(unsigned int values, unsigned int occupancy)
+{
+	vanaheimr::codegen::ArchaeopteryxTarget target;
+
+	target.requestedOccupancy = occupancy;
+
+	unsigned int budget = target.registerBudget();
+
+	auto module = lowerKernel(values, occupancy);
+
+	unsigned int emitted = getEmittedRegisterCount(*module);
+	unsigned int maximum = getMaximumEncodedRegister(*module);
+
+	bool correct = runKernel(*module, values);
+
+	delete module;
+
+	std::cout << " " << values << " live values under a budget of "
+		<< budget << " registers, " << emitted << " registers emitted, "
+		<< "highest encoded register " << maximum << "\n";
+
+	// The simulator sizes each thread's register file from the count
+	if(maximum >= emitted)
+	{
+		std::cout << "Encoded register " << maximum << " is outside of the "
+			<< emitted << " register file.\n";
+		return false;
+	}
+
+	if(budget != 0 && emitted > budget)
+	{
+		std::cout << "The register file exceeds the budget.\n";
+		return false;
+	}
+
+	if(!correct)
+	{
+		std::cout << "The spilled kernel computes the wrong sum.\n";
+		return false;
+	}
+
+	return true;
+}
+
+static unsigned int countOperations(const ir::Module& module,
+	const std::string& name)
+{
+	unsigned int count = 0;
+
+	for(auto function = module.begin(); function != module.end(); ++function)
+	{
+		for(auto& block : *function)
+		{
+			for(auto instruction : block)
+			{
+				if(!instruction->isMachineInstruction()) continue;
+
+				auto machineInstruction =
+					static_cast<const machine::Instruction*>(instruction);
+
+				if(machineInstruction->operation->name == name) ++count;
+			}
+		}
+	}
+
+	return count;
+}
+
+static bool testAddressFolding(unsigned int values)
+{
+	auto module = lowerKernel(values, 0);
+
+	unsigned int adds = countOperations(*module, "add");
+
+	bool correct = runKernel(*module, values);
+
+	delete module;
+
+	// The base and the sum chain remain, every 'base + 8 * i' is folded
+	unsigned int expected = values;
+
+	std::cout << " " << values << " loads off of one base, " << adds
+		<< " adds remain after lowering, expected " << expected << "\n";
+
+	if(adds != expected)
+	{
+		std::cout << "Address arithmetic was not folded into the loads.\n";
+		return false;
+	}
+
+	if(!correct)
+	{
+		std::cout << "The folded offsets were lost during lowering.\n";
+		return false;
+	}
+
+	return true;
+}
+
+/*! \brief Write a load through an allocated base and read it back, the
+	offset must survive encoding */
+static bool testIndirectOffsetEncoding()
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto i64 = compiler->getType("i64");
+
+	ir::Module module("test-indirect-offset-encoding", compiler);
+
+	auto type = *compiler->getOrInsertType(ir::FunctionType(compiler,
+		nullptr, ir::Type::TypeVector()));
+
+	auto function = module.newFunction("kernel",
+		ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility, type);
+
+	auto block = function->newBasicBlock(function->exit_block(), "body");
+
+	auto base  = &*function->newVirtualRegister(i64);
+	auto value = &*function->newVirtualRegister(i64);
+
+	auto physicalBase  = compiler->getMachineModel()->getPhysicalRegister(5);
+	auto physicalValue = compiler->getMachineModel()->getPhysicalRegister(6);
+
+	const int64_t offset = 40;
+
+	auto load = append<ir::Ld>(*block);
+
+	load->setD(new machine::PhysicalRegisterOperand(physicalValue, value,
+		load));
+	load->setA(new machine::PhysicalIndirectOperand(physicalBase, base,
+		offset, load));
+
+	append<ir::Ret>(*block);
+
+	std::stringstream binary;
+
+	vanaheimr::as::BinaryWriter writer;
+
+	writer.write(binary, module);
+
+	vanaheimr::as::BinaryReader reader;
+
+	std::unique_ptr<ir::Module> loaded(reader.read(binary,
+		"test-indirect-offset-encoding"));
+
+	auto loadedFunction = loaded->getFunction("kernel");
+
+	for(auto& loadedBlock : *loadedFunction)
+	{
+		for(auto instruction : loadedBlock)
+		{
+			if(instruction->opcode != ir::Instruction::Ld) continue;
+
+			auto address = static_cast<const ir::IndirectOperand*>(
+				static_cast<const ir::Ld*>(instruction)->a());
+
+			std::cout << " encoded " << load->a()->toString()
+				<< " as " << address->toString() << "\n";
+
+			if(address->offset != offset)
+			{
+				std::cout << "The folded offset was lost in the binary.\n";
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	std::cout << "The load was not written to the binary.\n";
+
+	return false;
+}
+
+/*! \brief Print every lowered instruction, in module order */
+static std::string toString(const ir::Module& module)
+{
+	std::stringstream stream;
+
+	for(auto function = module.begin(); function != module.end(); ++function)
+	{
+		for(auto& block : *function)
+		{
+			for(auto instruction : block)
+			{
+				stream << instruction->toString() << "\n";
+			}
+		}
+	}
+
+	return stream.str();
+}
+
+static std::string lowerKernels(unsigned int kernels, unsigned int values,
+	unsigned int threads, double& seconds)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	ir::Module module("test-archaeopteryx-parallel-lowering", compiler);
+
+	for(unsigned int kernel = 0; kernel < kernels; ++kernel)
+	{
+		std::stringstream name;
+
+		name << "kernel" << kernel;
+
+		buildKernel(module, name.str(), values);
+	}
+
+	vanaheimr::codegen::ArchaeopteryxTarget target;
+
+	target.threads = threads;
+
+	target.assignModule(&module);
+
+	auto begin = std::chrono::steady_clock::now();
+
+	target.lower();
+
+	auto end = std::chrono::steady_clock::now();
+
+	seconds = std::chrono::duration<double>(end - begin).count();
+
+	return toString(module);
+}
+
+static bool testParallelLowering(unsigned int kernels, unsigned int values,
+	unsigned int threads)
+{
+	double serialSeconds   = 0.0;
+	double parallelSeconds = 0.0;
+
+	auto serial   = lowerKernels(kernels, values, 1,       serialSeconds);
+	auto parallel = lowerKernels(kernels, values, threads, parallelSeconds);
+
+	std::cout << " lowering " << kernels << " kernels took "
+		<< serialSeconds << "s serially and " << parallelSeconds
+		<< "s with " << (threads == 0 ? std::string("all") :
+		std::to_string(threads)) << " threads, a "
+		<< (serialSeconds / parallelSeconds) << "x speedup\n";
+
+	if(serial != parallel)
+	{
+		std::cout << "Parallel lowering changed the generated code.\n";
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	unsigned int values    = 0;
+	unsigned int occupancy = 0;
+	unsigned int kernels   = 0;
+	unsigned int threads   = 0;
+
+	parser.description("This program lowers synthetic kernels with the "
+		"archaeopteryx target and checks the generated code.");
+
+	parser.parse("-n", "--values",    values,    16,
+		"The number of values loaded by the kernel.");
+	parser.parse("-o", "--occupancy", occupancy, 4096,
+		"The requested occupancy, it sets the register budget.");
+	parser.parse("-k", "--kernels",   kernels,   32,
+		"The number of kernels lowered in parallel.");
+	parser.parse("-t", "--threads",   threads,   0,
+		"The threads used for parallel lowering, 0 uses all cores.");
+	parser.parse();
+
+	test::TestMachineModel machineModel;
+
+	vanaheimr::machine::MachineModelFactory::registerMachineModel(
+		&machineModel);
+	vanaheimr::compiler::Compiler::getSingleton()->switchToNewMachineModel(
+		machineModel.name);
+
+	if(!test::testAddressFolding(values))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	if(!test::testIndirectOffsetEncoding())
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	if(!test::testRegisterBudget(values, occupancy))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	if(!test::testParallelLowering(kernels, values, threads))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	std::cout << "Test Passed\n";
+
+	return 0;
+}
+
@@ -40,17 +40,17 @@ static Compiler singleton;
 Compiler::Compiler()
 {
 	// TODO Add in common types
-	_types.push_back(new ir::IntegerType(this, 1) );
-	_types.push_back(new ir::IntegerType(this, 8) );
-	_types.push_back(new ir::IntegerType(this, 16));
-	_types.push_back(new ir::IntegerType(this, 32));
-	_types.push_back(new ir::IntegerType(this, 64));
+	_insertType(new ir::IntegerType(this, 1) );
+	_insertType(new ir::IntegerType(this, 8) );
+	_insertType(new ir::IntegerType(this, 16));
+	_insertType(new ir::IntegerType(this, 32));
+	_insertType(new ir::IntegerType(this, 64));
 
-	_types.push_back(new ir::FloatType(this));
-	_types.push_back(new ir::DoubleType(this));
+	_insertType(new ir::FloatType(this));
+	_insertType(new ir::DoubleType(this));
 
-	_types.push_back(new ir::BasicBlockType(this));
-	_types.push_back(new ir::VoidType(this));
+	_insertType(new ir::BasicBlockType(this));
+	_insertType(new ir::VoidType(this));
 
 	// Create the machine model
 	_machineModel = machine::MachineModelFactory::createDefaultMachine();
@@ -122,21 +122,26 @@ Compiler::module_iterator Compiler::newModule(const std::string& name)
 	
 Compiler::iterator Compiler::newType(const ir::Type& type)
 {
-	assert(getType(type.name) == nullptr);
+	std::lock_guard<std::mutex> lock(_typeMutex);
+
+	assert(_typesByName.count(type.name) == 0);
 
 	report("Added type: '" << type.name << "'");
 	
-	return _types.insert(_types.end(), type.clone());
+	return _insertType(type.clone());
 }
 
 Compiler::iterator Compiler::getOrInsertType(const ir::Type& type)
 {
-	for(iterator t = begin(); t != end(); ++t)
-	{
-		if(type.name == (*t)->name) return t;
-	}
+	std::lock_guard<std::mutex> lock(_typeMutex);
+
+	auto existingType = _typesByName.find(type.name);
+
+	if(existingType != _typesByName.end()) return existingType->second;
 
-	return newType(type);
+	report("Added type: '" << type.name << "'");
+	
+	return _insertType(type.clone());
 }
 
 Compiler::iterator Compiler::getOrInsertType(const std::string& signature)
@@ -178,26 +183,24 @@ Compiler::const_module_iterator Compiler::getModule(
 
 ir::Type* Compiler::getType(const std::string& name)
 {
-	iterator type = _types.begin();
+	std::lock_guard<std::mutex> lock(_typeMutex);
+
+	auto type = _typesByName.find(name);
 	
-	for( ; type != _types.end(); ++type)
-	{
-		if((*type)->name == name) return *type;
-	}
+	if(type == _typesByName.end()) return 0;
 	
-	return 0;
+	return *type->second;
 }
 
 const ir::Type* Compiler::getType(const std::string& typeName) const
 {
-	const_iterator type = _types.begin();
+	std::lock_guard<std::mutex> lock(_typeMutex);
+
+	auto type = _typesByName.find(typeName);
 	
-	for( ; type != _types.end(); ++type)
-	{
-		if((*type)->name == typeName) return *type;
-	}
+	if(type == _typesByName.end()) return 0;
 	
-	return 0;
+	return *type->second;
 }
 
 const ir::Type* Compiler::getBasicBlockType() const
@@ -229,6 +232,16 @@ Compiler* Compiler::getSingleton()
 	return &singleton;
 }
 
+Compiler::iterator Compiler::_insertType(ir::Type* type)
+{
+	auto position = _types.insert(_types.end(), type);
+
+	// The first type with a name wins, as with a linear search
+	_typesByName.insert(std::make_pair(type->name, position));
+
+	return position;
+}
+
 }
 
 }
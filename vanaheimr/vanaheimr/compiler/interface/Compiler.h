@@ -5,9 +5,15 @@
 	
 */
 
-// Standard Library Includes
+// Vanaheimr Includes
 #include <vanaheimr/ir/interface/Module.h>
 
+// Standard Library Includes
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 // Forward Declarations
 namespace vanaheimr { namespace ir      { class Type;         } }
 namespace vanaheimr { namespace machine { class MachineModel; } }
@@ -19,15 +25,20 @@ namespace vanaheimr
 namespace compiler
 {
 
-/*! \brief The global compiler state for vanaheimr. */
+/*! \brief The global compiler state for vanaheimr.
+
+	Types can be looked up and inserted by several threads at once, e.g.
+	by parsers working on different functions.  Types are never removed,
+	so iterators and pointers to them stay valid.
+*/
 class Compiler
 {
 public:
-	typedef std::vector<ir::Type*> TypeVector;
+	typedef std::list<ir::Type*>   TypeList;
 	typedef std::list<ir::Module>  ModuleList;
 	
-	typedef TypeVector::iterator       iterator;
-	typedef TypeVector::const_iterator const_iterator;
+	typedef TypeList::iterator       iterator;
+	typedef TypeList::const_iterator const_iterator;
 
 	typedef ModuleList::iterator       module_iterator;
 	typedef ModuleList::const_iterator const_module_iterator;
@@ -91,7 +102,15 @@ public:
 	static Compiler* getSingleton();
 
 private:
-	TypeVector             _types;
+	typedef std::unordered_map<std::string, iterator> TypeMap;
+
+private:
+	iterator _insertType(ir::Type* type);
+
+private:
+	TypeList               _types;
+	TypeMap                _typesByName;
+	mutable std::mutex     _typeMutex;
 	ModuleList             _modules;
 	machine::MachineModel* _machineModel;
 
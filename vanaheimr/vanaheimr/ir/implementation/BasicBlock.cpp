@@ -11,7 +11,7 @@
 #include <vanaheimr/compiler/interface/Compiler.h>
 
 // Standard Library Includes
-#include <algorithm>
+#include <cassert>
 
 namespace vanaheimr
 {
@@ -82,8 +82,13 @@ void BasicBlock::setTerminator(Instruction* i)
 {
 	if(terminator() != 0)
 	{
-		delete back();
-		back() = i->clone();
+		erase(back());
+
+		auto terminator = i->clone();
+
+		terminator->linkOperands();
+
+		push_back(terminator);
 	}
 	else
 	{
@@ -93,84 +98,71 @@ void BasicBlock::setTerminator(Instruction* i)
 
 BasicBlock::iterator BasicBlock::begin()
 {
-	return _instructions.begin();
+	return _instructions.pointer_begin();
 }
 
 BasicBlock::const_iterator BasicBlock::begin() const
 {
-	return _instructions.begin();
+	return _instructions.pointer_begin();
 }
 
 BasicBlock::iterator BasicBlock::end()
 {
-	return _instructions.end();
+	return _instructions.pointer_end();
 }
 
 BasicBlock::const_iterator BasicBlock::end() const
 {
-	return _instructions.end();
+	return _instructions.pointer_end();
 }
 
 BasicBlock::reverse_iterator BasicBlock::rbegin()
 {
-	return _instructions.rbegin();
+	return reverse_iterator(end());
 }
 
 BasicBlock::const_reverse_iterator BasicBlock::rbegin() const
 {
-	return _instructions.rbegin();
+	return const_reverse_iterator(end());
 }
 
 BasicBlock::reverse_iterator BasicBlock::rend()
 {
-	return _instructions.rend();
+	return reverse_iterator(begin());
 }
 
 BasicBlock::const_reverse_iterator BasicBlock::rend() const
 {
-	return _instructions.rend();
+	return const_reverse_iterator(begin());
 }
 
-Instruction*& BasicBlock::front()
+Instruction* BasicBlock::front() const
 {
-	return _instructions.front();
-}
+	assert(!empty());
 
-Instruction* const& BasicBlock::front() const
-{
-	return _instructions.front();
+	return *begin();
 }
 
-Instruction*& BasicBlock::back()
+Instruction* BasicBlock::back() const
 {
-	return _instructions.back();
-}
+	assert(!empty());
 
-Instruction* const& BasicBlock::back() const
-{
-	return _instructions.back();
+	return *rbegin();
 }
 
-
 BasicBlock::iterator BasicBlock::getIterator(const Instruction* instruction)
 {
-	for(auto i = begin(); i != end(); ++i)
-	{
-		if(*i == instruction) return i;
-	}
-	
-	return end();
+	if(instruction->block != this) return end();
+
+	return iterator(instruction);
 }
 
 BasicBlock::const_iterator BasicBlock::getIterator(
 	const Instruction* instruction) const
 {
-	for(auto i = begin(); i != end(); ++i)
-	{
-		if(*i == instruction) return i;
-	}
-	
-	return end();
+	if(instruction->block != this) return end();
+
+	return const_iterator(instruction);
 }
 
 bool BasicBlock::empty() const
@@ -209,46 +201,57 @@ void BasicBlock::push_front(Instruction* i)
 
 void BasicBlock::pop_back()
 {
-	_instructions.pop_back();
+	remove(back());
 }
 
 void BasicBlock::pop_front()
 {
-	_instructions.pop_front();
+	remove(front());
 }
 
 BasicBlock::iterator BasicBlock::insert(
 	const Instruction* pointer, Instruction* i)
 {
-	auto position = std::find(begin(), end(), pointer);
-	
-	return insert(position, i);
+	return insert(getIterator(pointer), i);
 }
 
 BasicBlock::iterator BasicBlock::insert(iterator position, Instruction* i)
 {
-	return _instructions.insert(position, i);
+	i->block = this;
+
+	_instructions.insert(position.node(), i);
+
+	return iterator(i);
 }
 
 BasicBlock::iterator BasicBlock::erase(iterator position)
 {
-	delete *position;
-	return _instructions.erase(position);
+	auto instruction = *position;
+
+	auto next = remove(instruction);
+
+	delete instruction;
+
+	return next;
 }
 
 BasicBlock::iterator BasicBlock::erase(const Instruction* pointer)
 {
-	auto position = std::find(begin(), end(), pointer);
-	
-	return erase(position);
+	return erase(getIterator(pointer));
+}
+
+BasicBlock::iterator BasicBlock::remove(Instruction* instruction)
+{
+	assert(instruction->block == this);
+
+	return iterator(_instructions.remove(instruction));
 }
-	
 
 void BasicBlock::clear()
 {
-	for(auto instruction : *this)
+	while(!empty())
 	{
-		delete instruction;
+		erase(begin());
 	}
 }
 
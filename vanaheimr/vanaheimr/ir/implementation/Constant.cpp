@@ -108,7 +108,8 @@ Constant* FloatingPointConstant::clone() const
 }
 
 IntegerConstant::IntegerConstant(uint64_t i, unsigned int bits)
-: Constant(compiler::Compiler::getSingleton()->getType("i" + toString(bits)))
+: Constant(compiler::Compiler::getSingleton()->getType("i" + toString(bits))),
+	_value(i)
 {
 
 }
@@ -224,6 +225,11 @@ uint64_t ArrayConstant::size() const
 	return bytes() / type()->bytes();
 }
 
+size_t ArrayConstant::bytes() const
+{
+	return _value.size();
+}
+
 bool ArrayConstant::isNullValue() const
 {
 	for(auto value : _value)
@@ -249,6 +255,60 @@ void* ArrayConstant::storage()
 	return _value.data();
 }
 
+const void* ArrayConstant::storage() const
+{
+	return _value.data();
+}
+
+uint64_t ArrayConstant::storageBytes() const
+{
+	return _value.size();
+}
+
+StreamedArrayConstant::Source::~Source()
+{
+
+}
+
+StreamedArrayConstant::StreamedArrayConstant(SourcePointer source,
+	uint64_t size, const Type* t)
+: Constant(t), _source(source), _size(size)
+{
+
+}
+
+void StreamedArrayConstant::read(uint64_t offset, void* data,
+	uint64_t bytes) const
+{
+	assert(offset + bytes <= _size);
+
+	_source->read(offset, data, bytes);
+}
+
+size_t StreamedArrayConstant::bytes() const
+{
+	return _size;
+}
+
+bool StreamedArrayConstant::isNullValue() const
+{
+	return false;
+}
+
+Constant::DataVector StreamedArrayConstant::data() const
+{
+	DataVector result(_size);
+
+	read(0, result.data(), _size);
+
+	return result;
+}
+
+Constant* StreamedArrayConstant::clone() const
+{
+	return new StreamedArrayConstant(*this);
+}
+
 }
 
 }
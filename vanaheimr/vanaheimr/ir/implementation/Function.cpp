@@ -37,6 +37,11 @@ Function::Function(const std::string& n, Module* m, Linkage l, Visibility v,
 	_exit  = newBasicBlock(end(), "__Exit");
 }
 
+Function::~Function()
+{
+	_clearBlocksAndRegisters();
+}
+
 Function::Function(const Function& f)
 : Variable(f), _nextBlockId(0), _nextRegisterId(0)
 {
@@ -65,8 +70,10 @@ Function& Function::operator=(const Function& f)
 		if(block == f.exit_block())  continue;
 		if(block == f.entry_block()) continue;
 	
-		auto newBlock = _blocks.insert(exit_block(), *block);
+		auto newBlock = new BasicBlock(*block);
 		newBlock->setFunction(this);
+
+		_blocks.insert(&*exit_block(), newBlock);
 		
 		assert(newBlock->id() < _nextBlockId);
 		
@@ -120,10 +127,10 @@ Function& Function::operator=(const Function& f)
 						static_cast<RegisterOperand*>(operand);
 				
 					VirtualRegisterMap::iterator mapping =
-						registerMapping.find(reg->virtualRegister->id);
+						registerMapping.find(reg->virtualRegister()->id);
 					assert(mapping != registerMapping.end());
 					
-					reg->virtualRegister = mapping->second;
+					reg->setVirtualRegister(mapping->second);
 				}
 
 				if(operand->isArgument())
@@ -162,10 +169,10 @@ Function& Function::operator=(const Function& f)
 						static_cast<RegisterOperand*>(operand);
 				
 					VirtualRegisterMap::iterator mapping =
-						registerMapping.find(reg->virtualRegister->id);
+						registerMapping.find(reg->virtualRegister()->id);
 					assert(mapping != registerMapping.end());
 					
-					reg->virtualRegister = mapping->second;
+					reg->setVirtualRegister(mapping->second);
 				}
 			}
 		}
@@ -219,6 +226,11 @@ size_t Function::size() const
 	return _blocks.size();
 }
 
+size_t Function::block_capacity() const
+{
+	return _nextBlockId;
+}
+
 bool Function::empty() const
 {
 	return _blocks.empty();
@@ -267,14 +279,19 @@ Function::StringList Function::attributes() const
 Function::iterator Function::newBasicBlock(iterator position,
 	const std::string& name)
 {
-	return _blocks.insert(position, BasicBlock(this, _nextBlockId++, name));
+	auto block = new BasicBlock(this, _nextBlockId++, name);
+
+	_blocks.insert(position.node(), block);
+
+	return iterator(block);
 }
 
 Function::register_iterator Function::newVirtualRegister(const Type* type,
 	const std::string& name)
 {
-	return _registers.insert(register_end(),
-		VirtualRegister(name, _nextRegisterId++, this, type));	
+	auto reg = new VirtualRegister(name, _nextRegisterId++, this, type);
+
+	return _registers.insert(reg->id, reg);
 }
 
 Function::argument_iterator Function::newArgument(const Type* type,
@@ -401,27 +418,30 @@ bool Function::register_empty() const
 	return _registers.empty();
 }
 
+size_t Function::register_capacity() const
+{
+	return _registers.capacity();
+}
+
+VirtualRegister* Function::getVirtualRegister(VirtualRegister::Id id) const
+{
+	return _registers.get(id);
+}
+
 Function::register_iterator Function::erase(const register_iterator& r)
 {
-	return _registers.erase(r);
+	return erase(&*r);
 }
 
 Function::register_iterator Function::erase(const VirtualRegister* r)
 {
-	register_iterator registerIterator = register_end();
-	
-	for(auto reg = register_begin(); reg != register_end(); ++reg)
-	{
-		if(&*reg == r)
-		{
-			registerIterator = reg;
-			break;
-		}
-	}
-	
-	assert(registerIterator != register_end());
-	
-	return erase(registerIterator);
+	assert(getVirtualRegister(r->id) == r);
+
+	auto id = r->id;
+
+	delete r;
+
+	return _registers.erase(id);
 }
 
 Function::register_iterator Function::findVirtualRegister(
@@ -453,7 +473,7 @@ Function::iterator  Function::findBasicBlock(const std::string& name)
 
 void Function::moveBasicBlock(iterator position, iterator block)
 {
-	_blocks.splice(position, _blocks, block);
+	_blocks.splice(position.node(), &*block);
 }
 
 Function::local_iterator Function::local_begin()
@@ -512,9 +532,8 @@ Function::Id Function::id() const
 
 void Function::clear()
 {
-	_blocks.clear();
+	_clearBlocksAndRegisters();
 	_arguments.clear();
-	_registers.clear();
 	
 	_nextBlockId    = 0;
 	_nextRegisterId = 0;
@@ -523,6 +542,25 @@ void Function::clear()
 	_exit  = newBasicBlock(end(), "__Exit" );
 }
 
+void Function::_clearBlocksAndRegisters()
+{
+	while(!_blocks.empty())
+	{
+		auto block = &_blocks.front();
+
+		_blocks.remove(block);
+
+		delete block;
+	}
+
+	for(auto reg = register_begin(); reg != register_end(); ++reg)
+	{
+		delete &*reg;
+	}
+
+	_registers.clear();
+}
+
 void Function::interpretType()
 {
 	Type::TypeVector argumentTypes;
@@ -18,7 +18,8 @@ namespace ir
 Global::Global(const std::string& n, Module* m,
 	const Type* t, Linkage l, Visibility v,
 	Constant* c, unsigned int le)
-: Variable(n, m, t, l, v), _initializer(c), _level(le)
+: Variable(n, m, t, l, v), _initializer(c), _level(le), _hasAddress(false),
+	_address(0)
 {
 
 }
@@ -29,7 +30,8 @@ Global::~Global()
 }
 
 Global::Global(const Global& g)
-: Variable(g), _initializer(0), _level(g.level())
+: Variable(g), _initializer(0), _level(g.level()),
+	_hasAddress(g._hasAddress), _address(g._address)
 {
 	if(g.hasInitializer())
 	{
@@ -49,6 +51,9 @@ Global& Global::operator=(const Global& g)
 		setLevel(g.level());
 	}
 	
+	_hasAddress = g._hasAddress;
+	_address    = g._address;
+	
 	return *this;
 }
 
@@ -82,6 +87,16 @@ size_t Global::bytes() const
 	return _initializer->bytes();
 }
 
+bool Global::hasAddress() const
+{
+	return _hasAddress;
+}
+
+uint64_t Global::address() const
+{
+	return _address;
+}
+
 void Global::setInitializer(Constant* c)
 {
 	delete _initializer;
@@ -94,6 +109,12 @@ void Global::setLevel(unsigned int l)
 	_level = l;
 }
 
+void Global::setAddress(uint64_t a)
+{
+	_hasAddress = true;
+	_address    = a;
+}
+
 }
 
 }
@@ -11,6 +11,8 @@
 #include <vanaheimr/ir/interface/MetaData.h>
 #include <vanaheimr/ir/interface/Type.h>
 
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
@@ -26,6 +28,21 @@ namespace vanaheimr
 namespace ir
 {
 
+/*! \brief Put an operand that is attached to an instruction on its
+	register's operand list, copies are not on it yet */
+static void linkOperand(Operand* operand)
+{
+	if(operand == nullptr) return;
+
+	// Predicates are register operands, but isRegister() excludes them
+	if(!operand->isRegister() && operand->mode() != Operand::Predicate)
+	{
+		return;
+	}
+
+	static_cast<RegisterOperand*>(operand)->link();
+}
+
 Instruction::Instruction(Opcode o, BasicBlock* b, Id id)
 : opcode(o), block(b), _id(id), _metadata(nullptr)
 {
@@ -37,6 +54,16 @@ Instruction::~Instruction()
 	clear();
 }
 
+void* Instruction::operator new(size_t bytes)
+{
+	return util::SlabAllocator::allocate(bytes);
+}
+
+void Instruction::operator delete(void* pointer, size_t bytes)
+{
+	util::SlabAllocator::deallocate(pointer, bytes);
+}
+
 Instruction::Instruction(const Instruction& i)
 : opcode(i.opcode), block(i.block), _id(i.id())
 {
@@ -116,6 +143,8 @@ void Instruction::setGuard(PredicateOperand* p)
 	delete guard();
 	
 	reads[0] = p;
+	
+	linkOperand(p);
 }
 
 Instruction::PredicateOperandPointer Instruction::guard()
@@ -160,6 +189,8 @@ void Instruction::appendWrite(Operand* newOperand)
 	newOperand->instruction = this;
 
 	writes.push_back(newOperand);
+
+	linkOperand(newOperand);
 }
 
 void Instruction::appendRead(Operand* newOperand)
@@ -167,6 +198,8 @@ void Instruction::appendRead(Operand* newOperand)
 	newOperand->instruction = this;
 
 	reads.push_back(newOperand);
+
+	linkOperand(newOperand);
 }
 
 void Instruction::replaceOperand(Operand* original, Operand* newOperand)
@@ -179,6 +212,7 @@ void Instruction::replaceOperand(Operand* original, Operand* newOperand)
 		{
 			delete *read;
 			*read = newOperand;
+			linkOperand(newOperand);
 			return;
 		}
 	}
@@ -189,6 +223,7 @@ void Instruction::replaceOperand(Operand* original, Operand* newOperand)
 		{
 			delete *write;
 			*write = newOperand;
+			linkOperand(newOperand);
 			return;
 		}
 	}
@@ -349,6 +384,12 @@ void Instruction::clear()
 	writes.clear();
 }	
 
+void Instruction::linkOperands()
+{
+	for(auto operand : reads)  linkOperand(operand);
+	for(auto operand : writes) linkOperand(operand);
+}
+
 void Instruction::addMetadata(MetaData* md)
 {
 	delete _metadata;
@@ -529,6 +570,8 @@ void UnaryInstruction::setD(Operand* o)
 	delete d();
 	
 	d() = o;
+	
+	linkOperand(o);
 }
 
 void UnaryInstruction::setA(Operand* o)
@@ -536,6 +579,8 @@ void UnaryInstruction::setA(Operand* o)
 	delete a();
 	
 	a() = o;
+	
+	linkOperand(o);
 }
 
 Instruction::OperandPointer& UnaryInstruction::d()
@@ -579,6 +624,8 @@ void BinaryInstruction::setD(Operand* o)
 	delete d();
 	
 	d() = o;
+	
+	linkOperand(o);
 }
 
 void BinaryInstruction::setA(Operand* o)
@@ -586,6 +633,8 @@ void BinaryInstruction::setA(Operand* o)
 	delete a();
 	
 	a() = o;
+	
+	linkOperand(o);
 }
 
 void BinaryInstruction::setB(Operand* o)
@@ -593,6 +642,8 @@ void BinaryInstruction::setB(Operand* o)
 	delete b();
 	
 	b() = o;
+	
+	linkOperand(o);
 }	
 
 Instruction::OperandPointer& BinaryInstruction::d()
@@ -761,6 +812,8 @@ void Bra::setTarget(Operand* o)
 	delete target();
 
 	target() = o;
+
+	linkOperand(o);
 }
 
 Instruction::OperandPointer& Bra::target()
@@ -829,17 +882,23 @@ void Call::setTarget(Operand* o)
 {
 	delete target();
 
-	target() = o;	
+	target() = o;
+
+	linkOperand(o);
 }
 
 void Call::addReturn(Operand* o)
 {
 	writes.push_back(o);
+
+	linkOperand(o);
 }
 
 void Call::addArgument(Operand* o)
 {
 	reads.push_back(o);
+
+	linkOperand(o);
 }
 
 Instruction::OperandPointer& Call::target()
@@ -858,7 +917,7 @@ const Instruction::OperandPointer& Call::target() const
 
 Call::OperandVector Call::returned()
 {
-	return writes;
+	return OperandVector(writes.begin(), writes.end());
 }
 
 Call::ConstOperandVector Call::returned() const
@@ -1201,6 +1260,8 @@ void St::setD(Operand* o)
 	delete d();
 	
 	d() = o;
+	
+	linkOperand(o);
 }
 
 void St::setA(Operand* o)
@@ -1208,6 +1269,8 @@ void St::setA(Operand* o)
 	delete a();
 	
 	a() = o;
+	
+	linkOperand(o);
 }
 
 St::OperandPointer& St::d()
@@ -1354,12 +1417,16 @@ void Phi::setD(RegisterOperand* o)
 	delete d();
 	
 	writes[0] = o;
+	
+	linkOperand(o);
 }
 
 void Phi::addSource(RegisterOperand* source, AddressOperand* predecessor)
 {
 	 reads.push_back(source);
 	 reads.push_back(predecessor);
+	
+	linkOperand(source);
 }
 
 void Phi::removeSource(BasicBlock* predecessor)
@@ -1527,12 +1594,17 @@ void Psi::setD(RegisterOperand* o)
 	delete d();
 	
 	writes[0] = o;
+	
+	linkOperand(o);
 }
 
 void Psi::addSource(PredicateOperand* predicate, RegisterOperand* source)
 {
 	reads.push_back(predicate);
 	reads.push_back(   source);
+	
+	linkOperand(predicate);
+	linkOperand(   source);
 }
 
 void Psi::removeSource(PredicateOperand* predicate)
@@ -1547,8 +1619,8 @@ void Psi::removeSource(PredicateOperand* predicate)
 		
 		assert(next != reads.end());
 		
-		reads.erase(readPosition);
-		reads.erase(next);
+		// erase the predicate and its source together
+		reads.erase(readPosition, ++next);
 
 		return;
 	}
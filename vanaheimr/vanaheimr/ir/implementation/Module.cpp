@@ -15,6 +15,18 @@
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
+// Standard Library Includes
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+// Preprocessor Macros
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
 namespace vanaheimr
 {
 
@@ -26,14 +38,129 @@ ModuleBase::~ModuleBase()
 
 }
 
+FunctionMaterializer::~FunctionMaterializer()
+{
+
+}
+
+/*! \brief The globals and functions of a module by name, built on the
+	first lookup */
+class VariableMap
+{
+public:
+	VariableMap(Module& m)
+	: _module(m), _built(false)
+	{
+
+	}
+
+public:
+	Variable* find(const std::string& name)
+	{
+		if(!_built) _build();
+
+		auto variable = _variables.find(name);
+
+		if(variable == _variables.end()) return nullptr;
+
+		return variable->second;
+	}
+
+private:
+	void _build()
+	{
+		for(auto global = _module.global_begin();
+			global != _module.global_end(); ++global)
+		{
+			_variables[global->name()] = &*global;
+		}
+
+		for(auto function = _module.begin();
+			function != _module.end(); ++function)
+		{
+			_variables[function->name()] = &*function;
+		}
+
+		_built = true;
+	}
+
+private:
+	typedef std::unordered_map<std::string, Variable*> NameToVariableMap;
+
+private:
+	Module&           _module;
+	NameToVariableMap _variables;
+	bool              _built;
+
+};
+
+/*! \brief Call 'visit' on every global or function address in a function */
+template<typename Visitor>
+static void visitReferences(Function& function, Visitor visit)
+{
+	for(auto& block : function)
+	{
+		for(auto instruction : block)
+		{
+			for(auto operands : {&instruction->reads, &instruction->writes})
+			{
+				for(auto operand : *operands)
+				{
+					if(operand == nullptr || !operand->isAddress()) continue;
+					if(operand->isBasicBlock()) continue;
+
+					visit(static_cast<AddressOperand*>(operand));
+				}
+			}
+		}
+	}
+}
+
+/*! \brief Point the references of a function at the variables of the
+	same name in another module */
+static void rebindReferences(Function& function, VariableMap& variables)
+{
+	visitReferences(function, [&](AddressOperand* address)
+	{
+		auto variable = variables.find(address->globalValue->name());
+
+		// Declarations that the module does not hold stay as they are
+		if(variable != nullptr) address->globalValue = variable;
+	});
+}
+
+static void retargetReferences(Function& function, const Variable* original,
+	Variable* copy)
+{
+	visitReferences(function, [&](AddressOperand* address)
+	{
+		if(address->globalValue == original) address->globalValue = copy;
+	});
+}
+
+SharedFunction::SharedFunction(const Function& f, Module* owner)
+: function(f), home(owner)
+{
+	function.setModule(owner);
+	
+	owners.push_back(owner);
+}
+
+RetiredVariables::~RetiredVariables()
+{
+	for(auto function : functions) delete function;
+}
+
 Module::Module(const std::string& n, compiler::Compiler* c)
-: name(n), _compiler(c)
+: name(n), _compiler(c), _materializer(nullptr),
+	_retired(std::make_shared<RetiredVariables>())
 {
 
 }
 
 Module::Module(const Module& m)
-: name(m.name), _compiler(m._compiler)
+: name(m.name), _compiler(m._compiler), _materializer(nullptr),
+	_retired(std::make_shared<RetiredVariables>())
 {
 	operator=(m);
 }
@@ -47,32 +174,151 @@ Module& Module::operator=(const Module& m)
 	name      = m.name;
 	_compiler = m._compiler;
 	
-	for(auto function : _functions)
+	// Copies never share the materializer, load everything up front
+	m.materializeAll();
+	
+	for(auto function : m._functions)
 	{
-		_functions.push_back(function);
-		_functions.back().setModule(this);
+		std::unique_lock<std::mutex> lock(function->mutex);
+		
+		_functions.push_back(new SharedFunction(function->function, this));
 	}
 	
-	for(auto global : _globals)
+	_copyGlobalsAndConstants(m);
+	
+	VariableMap variables(*this);
+	
+	for(auto function = begin(); function != end(); ++function)
 	{
-		_globals.push_back(global);
-		_globals.back().setModule(this);
+		rebindReferences(*function, variables);
 	}
 	
-	for(auto constant : _constants)
+	return *this;
+}
+
+Module::Module(const Module& m, CopyMode mode)
+: name(m.name), _compiler(m._compiler), _materializer(nullptr),
+	_retired(std::make_shared<RetiredVariables>())
+{
+	if(mode == DeepCopy)
 	{
-		_constants.push_back(constant->clone());
+		operator=(m);
+		return;
 	}
 	
-	return *this;
+	m.materializeAll();
+	
+	// Join the group, the shared functions refer to what it keeps alive
+	_retired = m._retired;
+	
+	for(auto function : m._functions)
+	{
+		std::unique_lock<std::mutex> lock(function->mutex);
+		
+		function->owners.push_back(this);
+		
+		_functions.push_back(function);
+	}
+	
+	_copyGlobalsAndConstants(m);
 }
 
 Module::~Module()
 {
-	for(constant_iterator constant = constant_begin();
-		constant != constant_end(); ++constant)
+	clear();
+}
+
+bool Module::isShared(const_iterator function) const
+{
+	auto shared = *function.base();
+	
+	std::unique_lock<std::mutex> lock(shared->mutex);
+	
+	return shared->owners.size() > 1 || shared->home != this;
+}
+
+Module::iterator Module::detach(iterator function)
+{
+	const Variable* shared = &*function;
+	
+	if(!_copyShared(function))
+	{
+		if(_adopt(function))
+		{
+			VariableMap variables(*this);
+		
+			rebindReferences(*function, variables);
+		}
+		
+		return function;
+	}
+	
+	VariableMap variables(*this);
+	
+	rebindReferences(*function, variables);
+	
+	// Functions that were already detached may call the shared version,
+	//  shared ones are only read
+	for(auto other = begin(); other != end(); ++other)
+	{
+		if(other == function || isShared(other)) continue;
+		
+		retargetReferences(*other, shared, &*function);
+	}
+	
+	return function;
+}
+
+void Module::detachAll()
+{
+	bool copied = false;
+	
+	for(auto function = begin(); function != end(); ++function)
 	{
-		delete *constant;
+		copied |= _copyShared(function);
+		copied |= _adopt(function);
+	}
+	
+	if(!copied) return;
+	
+	// Every function is private now, resolve all references at once
+	VariableMap variables(*this);
+	
+	for(auto function = begin(); function != end(); ++function)
+	{
+		rebindReferences(*function, variables);
+	}
+}
+
+void Module::setMaterializer(FunctionMaterializer* materializer)
+{
+	delete _materializer;
+	
+	_materializer = materializer;
+}
+
+bool Module::isMaterialized(const_iterator function) const
+{
+	if(_materializer == nullptr) return true;
+	
+	return _materializer->isMaterialized(*function);
+}
+
+void Module::materialize(const_iterator function) const
+{
+	if(_materializer == nullptr) return;
+	
+	// Loading a body is not a visible change to the module
+	_materializer->materialize((*function.base())->function);
+}
+
+void Module::materializeAll() const
+{
+	if(_materializer == nullptr) return;
+	
+	for(auto function = begin(); function != end(); ++function)
+	{
+		materialize(function);
 	}
 }
 
@@ -80,7 +326,12 @@ Module::iterator Module::getFunction(const std::string& name)
 {
 	for(iterator function = begin(); function != end(); ++function)
 	{
-		if(function->name() == name) return function;
+		if(function->name() == name)
+		{
+			materialize(function);
+			
+			return function;
+		}
 	}
 	
 	return end();
@@ -90,7 +341,12 @@ Module::const_iterator Module::getFunction(const std::string& name) const
 {
 	for(const_iterator function = begin(); function != end(); ++function)
 	{
-		if(function->name() == name) return function;
+		if(function->name() == name)
+		{
+			materialize(function);
+			
+			return function;
+		}
 	}
 	
 	return end();
@@ -98,7 +354,8 @@ Module::const_iterator Module::getFunction(const std::string& name) const
 
 Module::iterator Module::insertFunction(iterator position, const Function& f)
 {
-	return _functions.insert(position, f);
+	return iterator(_functions.insert(position.base(),
+		new SharedFunction(f, this)));
 }
 
 Module::iterator Module::newFunction(const std::string& name,
@@ -106,12 +363,16 @@ Module::iterator Module::newFunction(const std::string& name,
 {
 	assert(getFunction(name) == end());
 	
-	return _functions.insert(end(), Function(name, this, l, v, t));
+	return insertFunction(end(), Function(name, this, l, v, t));
 }
 
 Module::iterator Module::removeFunction(iterator f)
 {
-	return _functions.erase(f);
+	if(_materializer != nullptr) _materializer->discard(*f);
+	
+	_release(*f.base());
+	
+	return iterator(_functions.erase(f.base()));
 }
 
 Module::global_iterator Module::getGlobal(const std::string& name)
@@ -151,6 +412,18 @@ Module::global_iterator Module::newGlobal(const std::string& name,
 
 Module::global_iterator Module::removeGlobal(global_iterator g)
 {
+	// Functions shared within the group may still refer to it
+	if(_isInCopyOnWriteGroup())
+	{
+		auto next = std::next(g);
+		
+		std::unique_lock<std::mutex> lock(_retired->mutex);
+		
+		_retired->globals.splice(_retired->globals.end(), _globals, g);
+		
+		return next;
+	}
+	
 	return _globals.erase(g);
 }
 
@@ -170,22 +443,22 @@ void Module::writeAssembly(std::ostream& stream) const
 
 Module::iterator Module::begin()
 {
-	return _functions.begin();
+	return iterator(_functions.begin());
 }
 
 Module::const_iterator Module::begin() const
 {
-	return _functions.begin();
+	return const_iterator(_functions.begin());
 }
 
 Module::iterator Module::end()
 {
-	return _functions.end();
+	return iterator(_functions.end());
 }
 
 Module::const_iterator Module::end() const
 {
-	return _functions.end();
+	return const_iterator(_functions.end());
 }
 
 size_t Module::size() const
@@ -260,11 +533,131 @@ bool Module::constant_empty() const
 
 void Module::clear()
 {
+	// Bodies that were never loaded are simply dropped
+	delete _materializer;
+	
+	_materializer = nullptr;
+	
 	for(auto constant : _constants) delete constant;
+	for(auto function : _functions) _release(function);
+
+	// Functions shared within the group may still refer to the globals
+	if(_isInCopyOnWriteGroup())
+	{
+		std::unique_lock<std::mutex> lock(_retired->mutex);
+		
+		_retired->globals.splice(_retired->globals.end(), _globals);
+	}
 
 	_functions.clear();
 	_globals.clear();
 	_constants.clear();
+	
+	// Leave the group, a cleared module shares nothing
+	_retired = std::make_shared<RetiredVariables>();
+}
+
+void Module::_copyGlobalsAndConstants(const Module& m)
+{
+	for(auto& global : m._globals)
+	{
+		_globals.push_back(global);
+		_globals.back().setModule(this);
+	}
+	
+	for(auto constant : m._constants)
+	{
+		_constants.push_back(constant->clone());
+	}
+}
+
+void Module::_release(SharedFunction* function)
+{
+	{
+		std::unique_lock<std::mutex> lock(function->mutex);
+		
+		auto owner = std::find(function->owners.begin(),
+			function->owners.end(), this);
+		
+		assert(owner != function->owners.end());
+		
+		function->owners.erase(owner);
+		
+		// The other owners may be reading the function, so it keeps
+		//  referring to this module's variables, which the group retires,
+		//  until the last owner adopts it
+		if(function->home == this) function->home = nullptr;
+		
+		if(!function->owners.empty()) return;
+	}
+	
+	// Functions shared within the group may still call it
+	if(_isInCopyOnWriteGroup())
+	{
+		std::unique_lock<std::mutex> lock(_retired->mutex);
+		
+		_retired->functions.push_back(function);
+		
+		return;
+	}
+	
+	delete function;
+}
+
+bool Module::_copyShared(iterator function)
+{
+	auto shared = *function.base();
+	
+	SharedFunction* copy = nullptr;
+	
+	{
+		std::unique_lock<std::mutex> lock(shared->mutex);
+		
+		if(shared->owners.size() == 1) return false;
+	
+		report("Detaching function '" << shared->function.name()
+			<< "' from " << (shared->owners.size() - 1)
+			<< " other modules.");
+	
+		// Copy while holding the lock, the owner may change hands, the
+		//  copy does not write to the shared function
+		copy = new SharedFunction(shared->function, this);
+	}
+	
+	_release(shared);
+	
+	// Swap in place, iterators to the function stay valid
+	auto position = function.base();
+	
+	*position = copy;
+	
+	return true;
+}
+
+bool Module::_adopt(iterator function)
+{
+	auto shared = *function.base();
+	
+	{
+		std::unique_lock<std::mutex> lock(shared->mutex);
+		
+		if(shared->owners.size() > 1 || shared->home == this) return false;
+		
+		shared->home = this;
+	}
+	
+	report("Adopting function '" << shared->function.name()
+		<< "' from a module that let go of it.");
+	
+	// This is the only owner, the caller rebinds the references
+	shared->function.setModule(this);
+	
+	return true;
+}
+
+bool Module::_isInCopyOnWriteGroup() const
+{
+	return _retired.use_count() > 1;
 }
 
 }
@@ -6,14 +6,18 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/ir/interface/Operand.h>
+#include <vanaheimr/ir/interface/Instruction.h>
 #include <vanaheimr/ir/interface/VirtualRegister.h>
 #include <vanaheimr/ir/interface/Variable.h>
 #include <vanaheimr/ir/interface/Type.h>
 #include <vanaheimr/ir/interface/Argument.h>
 #include <vanaheimr/ir/interface/Constant.h>
 
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
 // Standard Library Includes
 #include <sstream>
+#include <algorithm>
 
 namespace vanaheimr
 {
@@ -32,6 +36,16 @@ Operand::~Operand()
 	
 }
 
+void* Operand::operator new(size_t bytes)
+{
+	return util::SlabAllocator::allocate(bytes);
+}
+
+void Operand::operator delete(void* pointer, size_t bytes)
+{
+	util::SlabAllocator::deallocate(pointer, bytes);
+}
+
 bool Operand::isRegister() const
 {
 	if(mode() == Register || mode() == Indirect) 
@@ -95,14 +109,76 @@ Constant* Operand::getConstantValue() const
 }
 
 RegisterOperand::RegisterOperand(VirtualRegister* reg, Instruction* i)
-: Operand(Register, i), virtualRegister(reg)
+: Operand(Register, i), _virtualRegister(reg)
 {
-	
+	_link();
+}
+
+RegisterOperand::~RegisterOperand()
+{
+	_unlink();
+}
+
+RegisterOperand::RegisterOperand(const RegisterOperand& o)
+: Operand(o), util::IntrusiveListNode<RegisterOperand>(o),
+	_virtualRegister(o._virtualRegister)
+{
+	// The owner of the copy links it, the original may be shared
+}
+
+RegisterOperand& RegisterOperand::operator=(const RegisterOperand& o)
+{
+	if(this == &o) return *this;
+
+	Operand::operator=(o);
+
+	setVirtualRegister(o._virtualRegister);
+
+	return *this;
+}
+
+void RegisterOperand::setVirtualRegister(VirtualRegister* reg)
+{
+	if(reg == _virtualRegister && isLinked()) return;
+
+	_unlink();
+
+	_virtualRegister = reg;
+
+	_link();
+}
+
+VirtualRegister* RegisterOperand::virtualRegister() const
+{
+	return _virtualRegister;
+}
+
+void RegisterOperand::link()
+{
+	if(isLinked()) return;
+
+	_link();
+}
+
+bool RegisterOperand::isDefinition() const
+{
+	if(instruction == nullptr) return false;
+
+	return std::find(instruction->writes.begin(), instruction->writes.end(),
+		this) != instruction->writes.end();
+}
+
+bool RegisterOperand::isUse() const
+{
+	if(instruction == nullptr) return false;
+
+	return std::find(instruction->reads.begin(), instruction->reads.end(),
+		this) != instruction->reads.end();
 }
 
 const Type* RegisterOperand::type() const
 {
-	return virtualRegister->type;
+	return _virtualRegister->type;
 }
 
 Operand* RegisterOperand::clone() const
@@ -112,14 +188,29 @@ Operand* RegisterOperand::clone() const
 
 std::string RegisterOperand::toString() const
 {
-	return virtualRegister->toString();
+	return _virtualRegister->toString();
 }
 
 RegisterOperand::RegisterOperand(VirtualRegister* reg, Instruction* i,
 	OperandMode m)
-: Operand(m, i), virtualRegister(reg)
+: Operand(m, i), _virtualRegister(reg)
+{
+	_link();
+}
+
+void RegisterOperand::_link()
+{
+	if(_virtualRegister == nullptr) return;
+
+	_virtualRegister->_operands.push_back(this);
+}
+
+void RegisterOperand::_unlink()
 {
+	// The register may already have been destroyed and unlinked us
+	if(!isLinked()) return;
 
+	_virtualRegister->_operands.remove(this);
 }
 
 ImmediateOperand::ImmediateOperand(uint64_t v, Instruction* i, const Type* t)
@@ -215,7 +306,7 @@ std::string PredicateOperand::toString() const
 	{
 		stream << "@";
 		
-		stream << virtualRegister->toString();
+		stream << virtualRegister()->toString();
 
 		break;
 	}
@@ -252,7 +343,7 @@ std::string IndirectOperand::toString() const
 		
 	stream << "[ ";
 	
-	stream << virtualRegister->toString();
+	stream << virtualRegister()->toString();
 
 	stream << " + " << std::hex << offset << std::dec << " ]";
 
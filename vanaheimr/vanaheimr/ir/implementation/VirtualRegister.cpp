@@ -6,10 +6,14 @@
 
 // Vanaheimr Includes
 #include <vanaheimr/ir/interface/VirtualRegister.h>
+#include <vanaheimr/ir/interface/Operand.h>
 #include <vanaheimr/ir/interface/Type.h>
 
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
 // Standard Library Includes
 #include <sstream>
+#include <cassert>
 
 namespace vanaheimr
 {
@@ -24,6 +28,97 @@ VirtualRegister::VirtualRegister(const std::string& n, Id i,
 
 }
 
+VirtualRegister::~VirtualRegister()
+{
+	// Operands that still refer to the register must not touch the
+	//  list when they are destroyed later
+	_operands.clear();
+}
+
+void* VirtualRegister::operator new(size_t bytes)
+{
+	return util::SlabAllocator::allocate(bytes);
+}
+
+void VirtualRegister::operator delete(void* pointer, size_t bytes)
+{
+	util::SlabAllocator::deallocate(pointer, bytes);
+}
+
+VirtualRegister::operand_iterator VirtualRegister::operand_begin() const
+{
+	return _operands.pointer_begin();
+}
+
+VirtualRegister::operand_iterator VirtualRegister::operand_end() const
+{
+	return _operands.pointer_end();
+}
+
+size_t VirtualRegister::operand_size() const
+{
+	return _operands.size();
+}
+
+VirtualRegister::RegisterOperandVector VirtualRegister::definitions() const
+{
+	RegisterOperandVector operands;
+
+	for(auto operand = operand_begin(); operand != operand_end(); ++operand)
+	{
+		if((*operand)->isDefinition()) operands.push_back(*operand);
+	}
+
+	return operands;
+}
+
+VirtualRegister::RegisterOperandVector VirtualRegister::uses() const
+{
+	RegisterOperandVector operands;
+
+	for(auto operand = operand_begin(); operand != operand_end(); ++operand)
+	{
+		if((*operand)->isUse()) operands.push_back(*operand);
+	}
+
+	return operands;
+}
+
+size_t VirtualRegister::definitionCount() const
+{
+	size_t count = 0;
+
+	for(auto operand = operand_begin(); operand != operand_end(); ++operand)
+	{
+		if((*operand)->isDefinition()) ++count;
+	}
+
+	return count;
+}
+
+size_t VirtualRegister::useCount() const
+{
+	size_t count = 0;
+
+	for(auto operand = operand_begin(); operand != operand_end(); ++operand)
+	{
+		if((*operand)->isUse()) ++count;
+	}
+
+	return count;
+}
+
+void VirtualRegister::replaceAllUsesWith(VirtualRegister* value)
+{
+	assert(value != this);
+
+	// Relinking the operands changes this list, so collect them first
+	for(auto use : uses())
+	{
+		use->setVirtualRegister(value);
+	}
+}
+
 std::string VirtualRegister::toString() const
 {
 	std::stringstream stream;
@@ -10,8 +10,7 @@
 #include <vanaheimr/ir/interface/Instruction.h>
 #include <vanaheimr/ir/interface/Variable.h>
 
-// Standard Library Includes
-#include <list>
+#include <vanaheimr/util/interface/IntrusiveList.h>
 
 // Forward Declarations
 namespace vanaheimr { namespace ir { class Function; } }
@@ -22,23 +21,31 @@ namespace vanaheimr
 namespace ir
 {
 
-/*! \brief A list of instructions ending with a terminator. */
-class BasicBlock : public Variable
+/*! \brief A list of instructions ending with a terminator.
+
+	The block owns its instructions, they are linked through the list
+	nodes embedded in each instruction.  Iterators dereference to
+	instruction pointers.
+*/
+class BasicBlock : public Variable,
+	public util::IntrusiveListNode<BasicBlock>
 {
 public:
-	typedef std::list<Instruction*> InstructionList;
+	typedef util::IntrusiveList<Instruction> InstructionList;
 
-	typedef InstructionList::iterator       iterator;
-	typedef InstructionList::const_iterator const_iterator;
+	typedef InstructionList::pointer_iterator iterator;
+	typedef InstructionList::pointer_iterator const_iterator;
 	
-	typedef InstructionList::reverse_iterator       reverse_iterator;
-	typedef InstructionList::const_reverse_iterator const_reverse_iterator;
+	typedef InstructionList::reverse_pointer_iterator reverse_iterator;
+	typedef InstructionList::reverse_pointer_iterator const_reverse_iterator;
 	
 	typedef unsigned int Id;
 
 public:
 	BasicBlock(Function* f, Id i, const std::string& name);
 	~BasicBlock();
+	/*! \brief The copied instructions are not linked, see
+		Instruction::clone() */
 	BasicBlock(const BasicBlock& b);
 	BasicBlock& operator=(const BasicBlock&);
 	
@@ -67,11 +74,8 @@ public:
 	const_reverse_iterator rend() const;
 
 public:
-	Instruction*&        front();
-	Instruction* const & front() const;
-
-	Instruction*&        back();
-	Instruction* const & back() const;
+	Instruction* front() const;
+	Instruction* back()  const;
 
 public:
 	/*! \brief Get an iterator to a function in the block */
@@ -94,10 +98,10 @@ public:
 	void push_front(Instruction* i);
 
 public:
-	/*! \brief Remove the first instruction in the block */
+	/*! \brief Remove the first instruction in the block, not deleting it */
 	void pop_front();
 	
-	/*! \brief Remove the last instruction in the block */
+	/*! \brief Remove the last instruction in the block, not deleting it */
 	void pop_back();
 
 public:
@@ -111,9 +115,15 @@ public:
 	iterator erase(iterator position);
 	/*! \brief Erase an instruction from the block, deleting it */
 	iterator erase(const Instruction* position);
+
+public:
+	/*! \brief Unlink an instruction from the block without deleting it */
+	iterator remove(Instruction* instruction);
 	
 public:
-	/*! \brief Assign instructions to the block */
+	/*! \brief Replace the instructions in the block with a sequence of
+		instructions that are not linked into any other block.  The old
+		instructions are unlinked, not deleted. */
 	template <typename Iterator>
 	void assign(Iterator begin, Iterator end);
 	
@@ -136,7 +146,12 @@ private:
 template <typename Iterator>
 void BasicBlock::assign(Iterator begin, Iterator end)
 {
-	_instructions.assign(begin, end);
+	_instructions.clear();
+
+	for(auto instruction = begin; instruction != end; ++instruction)
+	{
+		push_back(*instruction);
+	}
 }
 
 }
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <string>
+#include <memory>
 
 // Forward Declarations
 namespace vanaheimr { namespace ir { class BasicBlock; } }
@@ -181,7 +182,13 @@ public:
 	uint64_t size() const;
 
 public:
-	void* storage();
+	void*       storage();
+	const void* storage() const;
+	uint64_t    storageBytes() const;
+
+public:
+	/*! \brief The size of every element, not of the element type */
+	virtual size_t bytes() const;
 
 public:
 	virtual bool isNullValue() const;
@@ -194,6 +201,52 @@ private:
 	DataVector _value;
 };
 
+/*! \brief An array whose bytes are read from a source on demand
+
+	Large images, such as the allocations of a trace, are never held in
+	the module.  The binary writer copies them into the data section one
+	page at a time.  Copies of the constant share the source.
+*/
+class StreamedArrayConstant : public Constant
+{
+public:
+	/*! \brief Produces the bytes of the array, reads are serial */
+	class Source
+	{
+	public:
+		virtual ~Source();
+
+	public:
+		/*! \brief Copy 'bytes' bytes starting at 'offset' into 'data' */
+		virtual void read(uint64_t offset, void* data, uint64_t bytes) = 0;
+	};
+
+	typedef std::shared_ptr<Source> SourcePointer;
+
+public:
+	StreamedArrayConstant(SourcePointer source, uint64_t size, const Type* t);
+
+public:
+	/*! \brief Copy part of the array without reading the rest */
+	void read(uint64_t offset, void* data, uint64_t bytes) const;
+
+public:
+	virtual size_t bytes() const;
+
+public:
+	/*! \brief Conservatively false, the source is not read to check */
+	virtual bool isNullValue() const;
+	/*! \brief Read the whole array into memory */
+	virtual DataVector data() const;
+
+public:
+	virtual Constant* clone() const;
+
+private:
+	SourcePointer _source;
+	uint64_t      _size;
+};
+
 }
 
 }
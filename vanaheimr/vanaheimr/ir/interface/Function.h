@@ -12,6 +12,9 @@
 #include <vanaheimr/ir/interface/VirtualRegister.h>
 #include <vanaheimr/ir/interface/Local.h>
 
+#include <vanaheimr/util/interface/IntrusiveList.h>
+#include <vanaheimr/util/interface/IdIndexedVector.h>
+
 // Standard Library Includes
 #include <list>
 #include <set>
@@ -26,11 +29,11 @@ namespace ir
 class Function : public Variable
 {
 public:
-	typedef std::list<BasicBlock>      BasicBlockList;
-	typedef std::list<Argument>        ArgumentList;
-	typedef std::list<VirtualRegister> VirtualRegisterList;
-	typedef std::list<std::string>     StringList;
-	typedef std::list<Local>           LocalList;
+	typedef util::IntrusiveList<BasicBlock>      BasicBlockList;
+	typedef std::list<Argument>                  ArgumentList;
+	typedef util::IdIndexedVector<VirtualRegister> VirtualRegisterVector;
+	typedef std::list<std::string>               StringList;
+	typedef std::list<Local>                     LocalList;
 	
 	typedef BasicBlockList::iterator       iterator;
 	typedef BasicBlockList::const_iterator const_iterator;
@@ -38,8 +41,8 @@ public:
 	typedef ArgumentList::iterator       argument_iterator;
 	typedef ArgumentList::const_iterator const_argument_iterator;
 	
-	typedef VirtualRegisterList::iterator       register_iterator;
-	typedef VirtualRegisterList::const_iterator const_register_iterator;
+	typedef VirtualRegisterVector::iterator       register_iterator;
+	typedef VirtualRegisterVector::const_iterator const_register_iterator;
 
 	typedef LocalList::iterator       local_iterator;
 	typedef LocalList::const_iterator const_local_iterator;
@@ -50,6 +53,7 @@ public:
 	Function(const std::string& name = "", Module* m = 0,
 		Linkage l = InternalLinkage, Visibility v = HiddenVisibility,
 		const Type* type = 0);
+	~Function();
 	Function(const Function& f);
 	Function& operator=(const Function& f);
 	
@@ -70,6 +74,10 @@ public:
 	size_t size()  const;
 	bool   empty() const;
 
+public:
+	/*! \brief One past the largest block id, sizes id-indexed tables */
+	size_t block_capacity() const;
+
 public:
 	      BasicBlock& front();
 	const BasicBlock& front() const;
@@ -133,6 +141,12 @@ public:
 	size_t register_size()  const;
 	bool   register_empty() const;
 
+public:
+	/*! \brief One past the largest register id, sizes id-indexed tables */
+	size_t register_capacity() const;
+	/*! \brief Get a register by id, null if it was erased */
+	VirtualRegister* getVirtualRegister(VirtualRegister::Id id) const;
+
 public:
 	register_iterator erase(const register_iterator&);
 	register_iterator erase(const VirtualRegister*);
@@ -174,16 +188,19 @@ public:
 	/*! \brief Set the type of the function by examining the arguments. */
 	void interpretType();
 
+private:
+	void _clearBlocksAndRegisters();
+
 private:
 	typedef std::set<std::string> StringSet;
 
 private:
-	BasicBlockList      _blocks;
-	ArgumentList        _returnValues;
-	ArgumentList        _arguments;
-	VirtualRegisterList _registers;
-	StringSet           _attributes;
-	LocalList           _locals;
+	BasicBlockList        _blocks;
+	ArgumentList          _returnValues;
+	ArgumentList          _arguments;
+	VirtualRegisterVector _registers;
+	StringSet             _attributes;
+	LocalList             _locals;
 	
 	iterator _entry;
 	iterator _exit;
@@ -9,6 +9,9 @@
 // Vanaheimr Includes
 #include <vanaheimr/ir/interface/Variable.h>
 
+// Standard Library Includes
+#include <cstdint>
+
 // Forward  Declarations
 namespace vanaheimr { namespace ir { class Module;   } }
 namespace vanaheimr { namespace ir { class Constant; } }
@@ -54,13 +57,22 @@ public:
 	size_t       bytes() const;
 	unsigned int level() const;
 
+public:
+	/*! \brief Has the ABI assigned the global an offset in the data section? */
+	bool     hasAddress() const;
+	/*! \brief The data section offset assigned by the ABI */
+	uint64_t address()    const;
+
 public:
 	void setInitializer(Constant* c);
 	void setLevel(unsigned int level);
+	void setAddress(uint64_t address);
 
 protected:
 	Constant*    _initializer; // owned by the global
 	unsigned int _level;
+	bool         _hasAddress;
+	uint64_t     _address;
 };
 
 }
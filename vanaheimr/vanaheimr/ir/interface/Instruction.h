@@ -9,6 +9,9 @@
 // Vanaheimr Includes
 #include <vanaheimr/ir/interface/Operand.h>
 
+#include <vanaheimr/util/interface/IntrusiveList.h>
+#include <vanaheimr/util/interface/SmallVector.h>
+
 // Standard Library Includes 
 #include <vector>
 #include <string>
@@ -24,8 +27,12 @@ namespace vanaheimr
 namespace ir
 {
 
-/*! \brief A programmer efficient class for representing a single instruction */
-class Instruction
+/*! \brief A programmer efficient class for representing a single instruction
+
+	The links for the owning block's instruction list are embedded
+	in the instruction.
+*/
+class Instruction : public util::IntrusiveListNode<Instruction>
 {
 public:
 	/*! \brief The set of possible instructions */
@@ -81,7 +88,9 @@ public:
 	};
 
 	typedef Operand* OperandPointer;
-	typedef std::vector<OperandPointer> OperandVector;
+	/*! \brief Room for the guard and two sources, or a single
+		destination, without a separate heap buffer */
+	typedef util::SmallVector<OperandPointer, 3> OperandVector;
 	typedef PredicateOperand* PredicateOperandPointer;
 	
 	typedef unsigned int Id;
@@ -93,6 +102,11 @@ public:
 	Instruction(const Instruction&);
 	Instruction& operator=(const Instruction&);
 
+public:
+	/*! \brief Instructions are recycled through the IR slab allocator */
+	static void* operator new(size_t bytes);
+	static void  operator delete(void* pointer, size_t bytes);
+
 public:
 	/*! \brief Sets the predicate guard, the instruction now owns it */
 	void setGuard(PredicateOperand* g);
@@ -163,7 +177,12 @@ public:
 	const MetaData* metadata() const;	
 
 public:
+	/*! \brief Copy the instruction, the register operands of the copy are
+		not on their registers' operand lists until linkOperands() */
 	virtual Instruction* clone() const = 0;
+	/*! \brief Add the register operands of a copy to their registers'
+		operand lists */
+	void linkOperands();
 
 public:
 	static std::string toString(Opcode o);
@@ -11,8 +11,17 @@
 #include <vanaheimr/ir/interface/Global.h>
 #include <vanaheimr/ir/interface/Constant.h>
 
+// Standard Library Includes
+#include <list>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <iterator>
+#include <cstddef>
+
 // Forward Declarations
 namespace vanaheimr { namespace compiler { class Compiler; } }
+namespace vanaheimr { namespace ir       { class Module;   } }
 
 /*! \brief The wrapper namespace for Vanaheimr */
 namespace vanaheimr
@@ -36,16 +45,160 @@ public:
 	virtual void writeAssembly(std::ostream&) const = 0;
 };
 
+/*! \brief Loads the bodies of functions that a module declared before
+	reading them, e.g. from a memory mapped binary
+
+	Implementations must allow concurrent calls.
+*/
+class FunctionMaterializer
+{
+public:
+	virtual ~FunctionMaterializer();
+
+public:
+	/*! \brief Has the body of the function been loaded? */
+	virtual bool isMaterialized(const Function& function) const = 0;
+
+	/*! \brief Load the body of the function, a no-op if it is loaded */
+	virtual void materialize(Function& function) = 0;
+
+	/*! \brief Forget a function that is about to be deleted */
+	virtual void discard(const Function& function) = 0;
+};
+
+/*! \brief A function that may be shared by a module and its
+	copy-on-write clones
+
+	The function is never written while more than one module owns it.
+	It refers to the globals and functions of the module that created it,
+	its home, and keeps doing so after the home lets go of it.  Readers
+	only rely on the names and types of what it refers to, which every
+	owner has copies of.  Its module() must not be used once the home is
+	gone, the last owner rebinds it to itself before writing to it.
+*/
+class SharedFunction
+{
+public:
+	SharedFunction(const Function& function, Module* owner);
+
+public:
+	Function function;
+
+public:
+	/*! \brief Protects the owner list and the home */
+	std::mutex           mutex;
+	std::vector<Module*> owners;
+	/*! \brief The module its references point into, null once that
+		module lets go of it */
+	Module*              home;
+};
+
+/*! \brief Globals and functions that the modules of a copy-on-write group
+	let go of
+
+	Functions shared within the group may still refer to them, so they
+	live until every module of the group is gone.
+*/
+class RetiredVariables
+{
+public:
+	~RetiredVariables();
+
+public:
+	std::mutex                   mutex;
+	std::list<Global>            globals;
+	std::vector<SharedFunction*> functions;
+};
+
+/*! \brief An iterator over the functions of a module */
+template<typename ListIterator, typename Value>
+class ModuleFunctionIterator
+{
+public:
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Value                           value_type;
+	typedef Value&                          reference;
+	typedef Value*                          pointer;
+	typedef std::ptrdiff_t                  difference_type;
+
+public:
+	ModuleFunctionIterator() {}
+
+	explicit ModuleFunctionIterator(const ListIterator& i)
+	: _iterator(i) {}
+
+	/*! \brief Allow conversion from the mutable to the const iterator */
+	template<typename OtherIterator, typename OtherValue>
+	ModuleFunctionIterator(
+		const ModuleFunctionIterator<OtherIterator, OtherValue>& i)
+	: _iterator(i.base()) {}
+
+public:
+	reference operator*()  const { return  (*_iterator)->function; }
+	pointer   operator->() const { return &(*_iterator)->function; }
+
+public:
+	ModuleFunctionIterator& operator++()
+	{
+		++_iterator;
+		return *this;
+	}
+
+	ModuleFunctionIterator operator++(int)
+	{
+		ModuleFunctionIterator previous = *this;
+		++*this;
+		return previous;
+	}
+
+	ModuleFunctionIterator& operator--()
+	{
+		--_iterator;
+		return *this;
+	}
+
+	ModuleFunctionIterator operator--(int)
+	{
+		ModuleFunctionIterator previous = *this;
+		--*this;
+		return previous;
+	}
+
+public:
+	template<typename OtherIterator, typename OtherValue>
+	bool operator==(
+		const ModuleFunctionIterator<OtherIterator, OtherValue>& i) const
+	{
+		return _iterator == i.base();
+	}
+
+	template<typename OtherIterator, typename OtherValue>
+	bool operator!=(
+		const ModuleFunctionIterator<OtherIterator, OtherValue>& i) const
+	{
+		return _iterator != i.base();
+	}
+
+public:
+	const ListIterator& base() const { return _iterator; }
+
+private:
+	ListIterator _iterator;
+
+};
+
 /*! \brief Represents a single compilation unit. */
 class Module : public ModuleBase
 {
 public:
-	typedef std::list<Function>  FunctionList;
-	typedef std::list<Global>    GlobalList;
-	typedef std::list<Constant*>  ConstantList;
+	typedef std::list<SharedFunction*> FunctionList;
+	typedef std::list<Global>          GlobalList;
+	typedef std::list<Constant*>       ConstantList;
 
-	typedef FunctionList::iterator       iterator;
-	typedef FunctionList::const_iterator const_iterator;
+	typedef ModuleFunctionIterator<FunctionList::iterator,
+		Function>       iterator;
+	typedef ModuleFunctionIterator<FunctionList::const_iterator,
+		const Function> const_iterator;
 
 	typedef GlobalList::iterator         global_iterator;
 	typedef GlobalList::const_iterator   const_global_iterator;
@@ -58,16 +211,71 @@ public:
 	Module(const std::string& name, compiler::Compiler* compiler);
 	~Module();
 	
+public:
+	/*! \brief How the functions of a copied module are duplicated */
+	enum CopyMode
+	{
+		DeepCopy,
+		CopyOnWrite
+	};
+
 public:
 	/*! \brief Deep copy */
 	Module(const Module& r);
 	Module& operator=(const Module& r);
+
+	/*! \brief Copy a module, with CopyOnWrite the functions are shared
+		with the original until one of the modules detaches them */
+	Module(const Module& r, CopyMode mode);
+
+public:
+	/*! \brief Must the function be detached before writing to it?
+
+		It must while another module also owns it, or while it still
+		refers to a module that let go of it.
+	*/
+	bool isShared(const_iterator function) const;
+
+	/*! \brief Replace a shared function with a private copy before
+		writing to it
+
+		Iterators to the function refer to the copy afterwards, references
+		to the shared function still see the unchanged version.  The
+		copy refers to the globals and functions of this module, and
+		calls from the other private functions are pointed at it.
+
+		A function that is no longer shared, but was created by another
+		module, is rebound to this module in place.
+	*/
+	iterator detach(iterator function);
+
+	/*! \brief Detach every function */
+	void detachAll();
+
+public:
+	/*! \brief Load function bodies on demand, the module takes ownership */
+	void setMaterializer(FunctionMaterializer* materializer);
+
+	/*! \brief Has the body of the function been loaded? */
+	bool isMaterialized(const_iterator function) const;
+
+	/*! \brief Load the body of the function if it was deferred
+
+		getFunction() does this implicitly, code that walks the
+		function list must materialize what it reads.
+	*/
+	void materialize(const_iterator function) const;
+
+	/*! \brief Load every deferred function body */
+	void materializeAll() const;
 	
 public:
-	/*! \brief Get a named function in the module, return 0 if not found */
+	/*! \brief Get a named function in the module, return 0 if not found,
+		the function is materialized */
 	iterator getFunction(const std::string& name);
 
-	/*! \brief Get a named function in the module, return 0 if not found */
+	/*! \brief Get a named function in the module, return 0 if not found,
+		the function is materialized */
 	const_iterator getFunction(const std::string& name) const;
 	
 	/*! \brief Insert a function into the module, it takes ownership */
@@ -94,7 +302,8 @@ public:
 	global_iterator newGlobal(const std::string& name,
 		const Type* t, Variable::Linkage l, ir::Global::Level le);
 
-	/*! \brief Remove a global from the module, it is deleted */
+	/*! \brief Remove a global from the module, it is deleted once no
+		function shared with this module can refer to it */
 	global_iterator removeGlobal(global_iterator g);
 
 public:
@@ -155,7 +364,22 @@ private:
 	ConstantList _constants;
 	
 private:
-	compiler::Compiler* _compiler;
+	compiler::Compiler*   _compiler;
+	FunctionMaterializer* _materializer;
+
+private:
+	typedef std::shared_ptr<RetiredVariables> RetiredVariablesPointer;
+
+private:
+	/*! \brief Shared by every module of a copy-on-write group */
+	RetiredVariablesPointer _retired;
+
+private:
+	void _copyGlobalsAndConstants(const Module& m);
+	void _release(SharedFunction* function);
+	bool _copyShared(iterator function);
+	bool _adopt(iterator function);
+	bool _isInCopyOnWriteGroup() const;
 };
 
 }
@@ -6,8 +6,12 @@
 
 #pragma once
 
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntrusiveList.h>
+
 // Standard Library Includes
 #include <cstdint>
+#include <cstddef>
 #include <string>
 
 // Forward Declarations
@@ -24,7 +28,14 @@ namespace vanaheimr
 namespace ir
 {
 
-/*! \brief Represents a single instruction operand */
+/*! \brief Represents a single instruction operand
+
+	Operands are polymorphic objects that instructions hold by pointer.
+	Passes downcast them, machine operands derive from RegisterOperand,
+	and register operands sit on the operand lists of their registers,
+	so an operand's address must not change while it lives.  They are
+	recycled through the slab allocator, not stored inline as values.
+*/
 class Operand
 {
 public:
@@ -46,6 +57,11 @@ public:
 	Operand(OperandMode mode, Instruction* instruction);
 	virtual ~Operand();
 
+public:
+	/*! \brief Operands are recycled through the IR slab allocator */
+	static void* operator new(size_t bytes);
+	static void  operator delete(void* pointer, size_t bytes);
+
 public:
 	/*! \brief Is the operand a register */
 	bool isRegister() const;
@@ -96,24 +112,55 @@ private:
 
 typedef Operand::RegisterType RegisterType;
 
-/*! \brief A register operand */
-class RegisterOperand : public Operand
+/*! \brief A register operand
+
+	The operand is linked into the operand list of the register that it
+	refers to for as long as it lives.
+*/
+class RegisterOperand : public Operand,
+	public util::IntrusiveListNode<RegisterOperand>
 {
 public:
 	RegisterOperand(VirtualRegister* reg, Instruction* i);
+	virtual ~RegisterOperand();
+
+	/*! \brief The copy refers to the same register, but it is not on the
+		register's operand list until it is linked, so copying never
+		writes to the register of the original.  Attaching the copy to
+		an instruction links it. */
+	RegisterOperand(const RegisterOperand&);
+	RegisterOperand& operator=(const RegisterOperand&);
+
+public:
+	/*! \brief The register being accessed */
+	VirtualRegister* virtualRegister() const;
+	/*! \brief Refer to a different register, moving the operand to
+		the new register's operand list */
+	void setVirtualRegister(VirtualRegister* reg);
+	/*! \brief Add a copied operand to its register's operand list */
+	void link();
+
+public:
+	/*! \brief Is the operand one of the writes of its instruction */
+	bool isDefinition() const;
+	/*! \brief Is the operand one of the reads of its instruction */
+	bool isUse() const;
 
 public:
 	virtual const Type* type() const;
 	virtual Operand* clone() const;
 	virtual std::string toString() const;
 
-public:
-	/*! \brief The register being accessed */
-	VirtualRegister* virtualRegister;
-
 protected:
 	RegisterOperand(VirtualRegister* reg, Instruction* i, OperandMode m);
 
+private:
+	void _link();
+	void _unlink();
+
+private:
+	VirtualRegister* _virtualRegister;
+
 };
 
 /*! \brief An immediate operand */
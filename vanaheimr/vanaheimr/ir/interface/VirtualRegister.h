@@ -6,12 +6,18 @@
 
 #pragma once
 
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntrusiveList.h>
+
 // Standard Library Includes
 #include <string>
+#include <vector>
+#include <cstddef>
 
 // Forward Declarations
-namespace vanaheimr { namespace ir { class Function; } }
-namespace vanaheimr { namespace ir { class Type;     } }
+namespace vanaheimr { namespace ir { class Function;        } }
+namespace vanaheimr { namespace ir { class Type;            } }
+namespace vanaheimr { namespace ir { class RegisterOperand; } }
 
 namespace vanaheimr
 {
@@ -19,15 +25,55 @@ namespace vanaheimr
 namespace ir
 {
 
-/*! \brief A virtual register in the vanaheimr IR */
+/*! \brief A virtual register in the vanaheimr IR
+
+	Every register operand that refers to the register is threaded onto
+	the register's operand list, so the definitions and uses of a value
+	can be found without scanning the function.
+*/
 class VirtualRegister
 {
 public:
 	typedef unsigned int Id;
 
+	typedef util::IntrusiveList<RegisterOperand> OperandList;
+	typedef OperandList::pointer_iterator        operand_iterator;
+	typedef std::vector<RegisterOperand*>        RegisterOperandVector;
+
 public:
 	VirtualRegister(const std::string& name, Id id,
 		Function* function, const Type* t);
+	~VirtualRegister();
+
+public:
+	VirtualRegister(const VirtualRegister&) = delete;
+	VirtualRegister& operator=(const VirtualRegister&) = delete;
+
+public:
+	/*! \brief Registers are recycled through the IR slab allocator */
+	static void* operator new(size_t bytes);
+	static void  operator delete(void* pointer, size_t bytes);
+
+public:
+	/*! \brief Every operand referring to the register, in no order */
+	operand_iterator operand_begin() const;
+	operand_iterator operand_end()   const;
+
+	size_t operand_size() const;
+
+public:
+	/*! \brief The operands that write the register */
+	RegisterOperandVector definitions() const;
+	/*! \brief The operands that read the register */
+	RegisterOperandVector uses() const;
+
+public:
+	size_t definitionCount() const;
+	size_t useCount()        const;
+
+public:
+	/*! \brief Make every operand reading this register read another */
+	void replaceAllUsesWith(VirtualRegister* value);
 
 public:
 	std::string toString() const;
@@ -37,6 +83,12 @@ public:
 	Id          id;
 	Function*   function;
 	const Type* type;
+
+private:
+	OperandList _operands;
+
+private:
+	friend class RegisterOperand;
 };
 
 }
@@ -0,0 +1,205 @@
+/*! \file   benchmark-ir-allocation.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the IR allocation benchmark.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+
+namespace benchmark
+{
+
+namespace ir = vanaheimr::ir;
+
+typedef vanaheimr::util::SlabAllocator SlabAllocator;
+
+static double seconds(std::chrono::steady_clock::time_point begin,
+	std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+static void printStatistics(const std::string& stage)
+{
+	auto statistics = SlabAllocator::statistics();
+
+	std::cout << "  " << stage << ": " << statistics.liveBytes
+		<< " live bytes in " << statistics.slabBytes << " slab bytes, "
+		<< statistics.allocations << " allocations\n";
+}
+
+/*! \brief Fill a function with loads feeding a chain of adds, the same mix
+	of instructions, operands and registers that lowering produces */
+static void buildFunction(ir::Function& function, const ir::Type* type,
+	unsigned int blocks, unsigned int instructions)
+{
+	auto previous = &*function.newVirtualRegister(type);
+
+	for(unsigned int b = 0; b < blocks; ++b)
+	{
+		std::stringstream name;
+
+		name << "block" << b;
+
+		auto block = function.newBasicBlock(function.exit_block(),
+			name.str());
+
+		for(unsigned int i = 0; i < instructions; ++i)
+		{
+			auto loaded = &*function.newVirtualRegister(type);
+
+			auto load = new ir::Ld(&*block);
+
+			load->setGuard(new ir::PredicateOperand(
+				ir::PredicateOperand::PredicateTrue, load));
+			load->setD(new ir::RegisterOperand(loaded, load));
+			load->setA(new ir::IndirectOperand(previous, 8 * i, load));
+
+			block->push_back(load);
+
+			auto next = &*function.newVirtualRegister(type);
+
+			auto add = new ir::Add(&*block);
+
+			add->setGuard(new ir::PredicateOperand(
+				ir::PredicateOperand::PredicateTrue, add));
+			add->setD(new ir::RegisterOperand(next,     add));
+			add->setA(new ir::RegisterOperand(previous, add));
+			add->setB(new ir::RegisterOperand(loaded,   add));
+
+			block->push_back(add);
+
+			previous = next;
+		}
+	}
+}
+
+static ir::Module* buildModule(unsigned int functions, unsigned int blocks,
+	unsigned int instructions)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto type = compiler->getType("i64");
+
+	if(type == nullptr) throw std::runtime_error("No i64 type.");
+
+	auto module = new ir::Module("benchmark-ir-allocation", compiler);
+
+	for(unsigned int f = 0; f < functions; ++f)
+	{
+		std::stringstream name;
+
+		name << "function" << f;
+
+		auto function = module->newFunction(name.str(),
+			ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility,
+			type);
+
+		buildFunction(*function, type, blocks, instructions);
+	}
+
+	return module;
+}
+
+static void benchmarkAllocation(unsigned int functions, unsigned int blocks,
+	unsigned int instructions, unsigned int iterations)
+{
+	std::cout << functions << " functions, " << blocks << " blocks each, "
+		<< instructions << " loads and adds per block\n";
+
+	double buildTime   = 0.0;
+	double copyTime    = 0.0;
+	double destroyTime = 0.0;
+
+	for(unsigned int i = 0; i < iterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+
+		auto module = buildModule(functions, blocks, instructions);
+
+		auto built = std::chrono::steady_clock::now();
+
+		auto copy = new ir::Module(*module);
+
+		auto copied = std::chrono::steady_clock::now();
+
+		if(i == 0) printStatistics("with two modules");
+
+		delete copy;
+		delete module;
+
+		auto destroyed = std::chrono::steady_clock::now();
+
+		buildTime   += seconds(begin,  built);
+		copyTime    += seconds(built,  copied);
+		destroyTime += seconds(copied, destroyed);
+	}
+
+	printStatistics("after every module is destroyed");
+
+	if(iterations == 0) return;
+
+	std::cout << "  build:   " << (buildTime   * 1000.0 / iterations)
+		<< " ms per module\n";
+	std::cout << "  copy:    " << (copyTime    * 1000.0 / iterations)
+		<< " ms per module\n";
+	std::cout << "  destroy: " << (destroyTime * 1000.0 / iterations)
+		<< " ms per two modules\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	unsigned int functions    = 0;
+	unsigned int blocks       = 0;
+	unsigned int instructions = 0;
+	unsigned int iterations   = 0;
+
+	parser.description("This program repeatedly builds, copies and destroys "
+		"a synthetic module to measure IR allocation costs.");
+
+	parser.parse("-f", "--functions", functions, 64,
+		"The number of functions in the module.");
+	parser.parse("-b", "--blocks", blocks, 16,
+		"The number of basic blocks in each function.");
+	parser.parse("-i", "--instructions", instructions, 64,
+		"The number of load and add pairs in each block.");
+	parser.parse("-n", "--iterations", iterations, 10,
+		"The number of times to build, copy and destroy the module.");
+	parser.parse();
+
+	try
+	{
+		benchmark::benchmarkAllocation(functions, blocks, instructions,
+			iterations);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "benchmark-ir-allocation FAILED: " << e.what() << "\n";
+
+		return -1;
+	}
+
+	return 0;
+}
+
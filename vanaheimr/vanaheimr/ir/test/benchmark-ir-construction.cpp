@@ -0,0 +1,214 @@
+/*! \file   benchmark-ir-construction.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the IR construction benchmark.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+
+namespace benchmark
+{
+
+typedef vanaheimr::util::SlabAllocator SlabAllocator;
+
+static double seconds(std::chrono::steady_clock::time_point begin,
+	std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+/*! \brief Fill a function with a chain of three operand adds */
+static void buildFunction(vanaheimr::ir::Function& function,
+	const vanaheimr::ir::Type* type, unsigned int blocks,
+	unsigned int instructions)
+{
+	namespace ir = vanaheimr::ir;
+
+	auto previous = &*function.newVirtualRegister(type);
+
+	for(unsigned int b = 0; b < blocks; ++b)
+	{
+		std::stringstream name;
+
+		name << "block" << b;
+
+		auto block = function.newBasicBlock(function.exit_block(),
+			name.str());
+
+		for(unsigned int i = 0; i < instructions; ++i)
+		{
+			auto next = &*function.newVirtualRegister(type);
+
+			auto add = new ir::Add(&*block);
+
+			add->setGuard(new ir::PredicateOperand(
+				ir::PredicateOperand::PredicateTrue, add));
+			add->setD(new ir::RegisterOperand(next,     add));
+			add->setA(new ir::RegisterOperand(previous, add));
+			add->setB(new ir::ImmediateOperand((uint64_t)i, add, type));
+
+			block->push_back(add);
+
+			previous = next;
+		}
+	}
+}
+
+/*! \brief Visit every operand, the way most analyses do */
+static size_t traverseFunction(const vanaheimr::ir::Function& function)
+{
+	size_t registers = 0;
+
+	for(auto block = function.begin(); block != function.end(); ++block)
+	{
+		for(auto instruction : *block)
+		{
+			for(auto read : instruction->reads)
+			{
+				if(read != nullptr && read->isRegister()) ++registers;
+			}
+
+			for(auto write : instruction->writes)
+			{
+				if(write->isRegister()) ++registers;
+			}
+		}
+	}
+
+	return registers;
+}
+
+static void benchmarkConstruction(unsigned int functions,
+	unsigned int blocks, unsigned int instructions, unsigned int iterations)
+{
+	namespace ir = vanaheimr::ir;
+
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto type = compiler->getType("i32");
+
+	if(type == nullptr) throw std::runtime_error("No i32 type.");
+
+	double buildTime    = 0.0;
+	double traverseTime = 0.0;
+	double destroyTime  = 0.0;
+
+	size_t operands = 0;
+
+	for(unsigned int iteration = 0; iteration < iterations; ++iteration)
+	{
+		auto begin = std::chrono::steady_clock::now();
+
+		auto module = new ir::Module("benchmark", compiler);
+
+		for(unsigned int f = 0; f < functions; ++f)
+		{
+			std::stringstream name;
+
+			name << "function" << f;
+
+			auto function = module->newFunction(name.str(),
+				ir::Variable::ExternalLinkage, ir::Variable::HiddenVisibility);
+
+			buildFunction(*function, type, blocks, instructions);
+		}
+
+		auto built = std::chrono::steady_clock::now();
+
+		operands = 0;
+
+		for(auto function = module->begin();
+			function != module->end(); ++function)
+		{
+			operands += traverseFunction(*function);
+		}
+
+		auto traversed = std::chrono::steady_clock::now();
+
+		if(iteration == 0)
+		{
+			auto statistics = SlabAllocator::statistics();
+
+			std::cout << "  " << statistics.liveBytes << " live slab bytes, "
+				<< statistics.allocations << " slab allocations\n";
+		}
+
+		delete module;
+
+		auto destroyed = std::chrono::steady_clock::now();
+
+		buildTime    += seconds(begin,     built);
+		traverseTime += seconds(built,     traversed);
+		destroyTime  += seconds(traversed, destroyed);
+	}
+
+	double total = (double)functions * blocks * instructions;
+
+	if(iterations == 0 || total == 0.0) return;
+
+	std::cout << "  " << operands << " register operands per module\n";
+	std::cout << "  build:    " << (total * iterations / buildTime)
+		<< " instructions/s\n";
+	std::cout << "  traverse: " << (total * iterations / traverseTime)
+		<< " instructions/s\n";
+	std::cout << "  destroy:  " << (total * iterations / destroyTime)
+		<< " instructions/s\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	unsigned int functions    = 0;
+	unsigned int blocks       = 0;
+	unsigned int instructions = 0;
+	unsigned int iterations   = 0;
+
+	parser.description("This program builds, traverses and destroys "
+		"synthetic IR modules to measure instruction and operand "
+		"storage costs.");
+
+	parser.parse("-f", "--functions",    functions,    16,
+		"The number of functions in each module.");
+	parser.parse("-b", "--blocks",       blocks,       64,
+		"The number of basic blocks in each function.");
+	parser.parse("-n", "--instructions", instructions, 64,
+		"The number of instructions in each basic block.");
+	parser.parse("-i", "--iterations",   iterations,   10,
+		"The number of modules to build.");
+	parser.parse();
+
+	try
+	{
+		benchmark::benchmarkConstruction(functions, blocks, instructions,
+			iterations);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "benchmark-ir-construction FAILED: " << e.what() << "\n";
+
+		return -1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,275 @@
+/*! \file   test-copy-on-write-module.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the copy-on-write module test.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Type.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+
+// Standard Library Includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+namespace test
+{
+
+namespace ir = vanaheimr::ir;
+
+/*! \brief 'g' adds to the global 'x', 'f' adds the addresses of 'x'
+	and 'g' */
+static ir::Module* buildModule(unsigned int instructions)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	auto i64 = compiler->getType("i64");
+
+	auto module = new ir::Module("test-copy-on-write-module", compiler);
+
+	auto x = module->newGlobal("x", i64, ir::Variable::ExternalLinkage,
+		ir::Global::Shared);
+
+	auto g = module->newFunction("g", ir::Variable::ExternalLinkage,
+		ir::Variable::HiddenVisibility, i64);
+	auto f = module->newFunction("f", ir::Variable::ExternalLinkage,
+		ir::Variable::HiddenVisibility, i64);
+
+	for(auto function : {g, f})
+	{
+		auto block = function->newBasicBlock(function->exit_block(), "body");
+
+		for(unsigned int i = 0; i < instructions; ++i)
+		{
+			auto add = new ir::Add(&*block);
+
+			add->setGuard(new ir::PredicateOperand(
+				ir::PredicateOperand::PredicateTrue, add));
+			add->setD(new ir::RegisterOperand(
+				&*function->newVirtualRegister(i64), add));
+			add->setA(new ir::AddressOperand(&*x, add));
+
+			if(function == f)
+			{
+				add->setB(new ir::AddressOperand(&*g, add));
+			}
+			else
+			{
+				add->setB(new ir::ImmediateOperand((uint64_t)i, add, i64));
+			}
+
+			block->push_back(add);
+		}
+	}
+
+	return module;
+}
+
+static std::string toString(const ir::Module& module)
+{
+	std::stringstream stream;
+
+	for(auto& function : module)
+	{
+		stream << function.name() << "\n";
+
+		for(auto& block : function)
+		{
+			for(auto instruction : block)
+			{
+				stream << " " << instruction->toString() << "\n";
+			}
+		}
+	}
+
+	return stream.str();
+}
+
+/*! \brief Do the references of a function resolve to the module? */
+static bool refersTo(const ir::Module& module, const ir::Function& function)
+{
+	for(auto& block : function)
+	{
+		for(auto instruction : block)
+		{
+			for(auto operand : instruction->reads)
+			{
+				if(!operand->isAddress()) continue;
+
+				auto address = static_cast<const ir::AddressOperand*>(
+					operand);
+
+				auto name = address->globalValue->name();
+
+				auto global = module.getGlobal(name);
+
+				if(global != module.global_end())
+				{
+					if(address->globalValue != &*global) return false;
+
+					continue;
+				}
+
+				auto callee = module.getFunction(name);
+
+				if(callee == module.end()) return false;
+
+				if(address->globalValue != &*callee) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool testDestroyOriginal(unsigned int instructions)
+{
+	auto original = buildModule(instructions);
+
+	auto expected = toString(*original);
+
+	ir::Module clone(*original, ir::Module::CopyOnWrite);
+
+	delete original;
+
+	if(toString(clone) != expected)
+	{
+		std::cout << "The clone changed when the original was destroyed.\n";
+		return false;
+	}
+
+	// The last owner takes the functions over on the first write
+	for(auto function = clone.begin(); function != clone.end(); ++function)
+	{
+		clone.detach(function);
+
+		if(!refersTo(clone, *function))
+		{
+			std::cout << "Function '" << function->name() << "' still "
+				"refers to the destroyed module.\n";
+			return false;
+		}
+	}
+
+	if(toString(clone) != expected)
+	{
+		std::cout << "Taking the functions over changed them.\n";
+		return false;
+	}
+
+	std::cout << " the clone outlived the original\n";
+
+	return true;
+}
+
+/*! \brief Clones are read on other threads while the modules that share
+	their functions detach them and are destroyed */
+static bool testConcurrentRelease(unsigned int instructions,
+	unsigned int threads)
+{
+	auto original = buildModule(instructions);
+
+	auto expected = toString(*original);
+
+	typedef std::unique_ptr<ir::Module> ModulePointer;
+
+	std::vector<ModulePointer> readers;
+	std::vector<ModulePointer> writers;
+
+	for(unsigned int i = 0; i < threads; ++i)
+	{
+		readers.push_back(ModulePointer(
+			new ir::Module(*original, ir::Module::CopyOnWrite)));
+		writers.push_back(ModulePointer(
+			new ir::Module(*original, ir::Module::CopyOnWrite)));
+	}
+
+	std::atomic<unsigned int> mismatches(0);
+	std::atomic<bool>         started(false);
+
+	std::vector<std::thread> workers;
+
+	for(auto& reader : readers)
+	{
+		auto module = reader.get();
+
+		workers.push_back(std::thread([&, module]()
+		{
+			started = true;
+
+			for(unsigned int i = 0; i < 8; ++i)
+			{
+				if(toString(*module) != expected) ++mismatches;
+			}
+		}));
+	}
+
+	while(!started) std::this_thread::yield();
+
+	delete original;
+
+	for(auto& writer : writers)
+	{
+		writer->detachAll();
+		writer.reset();
+	}
+
+	for(auto& worker : workers) worker.join();
+
+	std::cout << " " << threads << " clones were read while "
+		<< threads << " others and the original let go, "
+		<< mismatches << " mismatches\n";
+
+	return mismatches == 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	unsigned int instructions = 0;
+	unsigned int threads      = 0;
+
+	parser.description("Test that copy-on-write clones of a module stay "
+		"valid while the modules sharing their functions change or go "
+		"away.");
+
+	parser.parse("-i", "--instructions", instructions, 64,
+		"The number of instructions in each function.");
+	parser.parse("-t", "--threads", threads, 4,
+		"The number of clones read concurrently.");
+	parser.parse();
+
+	if(!test::testDestroyOriginal(instructions))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	if(!test::testConcurrentRelease(instructions, threads))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	std::cout << "Test Passed\n";
+
+	return 0;
+}
+
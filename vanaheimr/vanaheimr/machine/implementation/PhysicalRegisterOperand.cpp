@@ -31,7 +31,7 @@ PhysicalRegisterOperand::Operand* PhysicalRegisterOperand::clone() const
 
 std::string PhysicalRegisterOperand::toString() const
 {
-	if(physicalRegister == nullptr) return virtualRegister->toString();
+	if(physicalRegister == nullptr) return virtualRegister()->toString();
 	
 	return physicalRegister->name();
 }
@@ -18,6 +18,9 @@
 
 // Standard Library Includes
 #include <stdexcept>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
 
 namespace vanaheimr
 {
@@ -48,6 +51,14 @@ static void addRules(Lexer* lexer)
 	lexer->addWhitespaceRules(" \t\r\n");
 
 	lexer->addTokens({"\"*\""});
+
+	// Array initializers
+	lexer->addTokens({"\\[", "\\]", ",", "[a-zA-Z_][a-zA-Z_0-9]*"});
+	lexer->addTokens({"-*[:digit:][:digit:]*",
+		"-*[:digit:][:digit:]*\\.[:digit:]*",
+		"-*[:digit:][:digit:]*\\.[:digit:]*e[-+][:digit:][:digit:]*",
+		"0x[0-9a-fA-F][0-9a-fA-F]*"});
+	lexer->addTokens({"\"[^\"]*\"", "c\"[^\"]*\""});
 }
 
 void ConstantValueParser::parse()
@@ -116,6 +127,15 @@ const ir::Constant* ConstantValueParser::parsedConstant() const
 	return _parsedConstant;
 }
 
+ir::Constant* ConstantValueParser::releaseParsedConstant()
+{
+	auto constant = _parsedConstant;
+
+	_parsedConstant = nullptr;
+
+	return constant;
+}
+
 static bool isNumeric(char c)
 {
 	return c == '0' || c == '2' || c == '3' || c == '4' || c == '5' ||
@@ -132,7 +152,7 @@ static bool isInteger(const std::string& integer)
 	return true;
 }
 
-static bool isString(const std::string& string)
+static bool isString(const Token& string)
 {
 	if(string.size() < 2) return false;
 	
@@ -203,26 +223,30 @@ static ir::Constant* createZeroInitializer(const ir::Type* type)
 	return nullptr;
 }
 
-static bool isZeroInitializer(const std::string& token)
+static bool isZeroInitializer(const Token& token)
 {
 	return token == "zeroinitializer";
 }
 
 ir::Constant* ConstantValueParser::_parseConstant(const ir::Type* type)
 {
-	auto nextToken = _lexer->peek();
+	auto nextToken = _lexer->peekToken();
 
 	ir::Constant* constant = nullptr;
 
 	if(isZeroInitializer(nextToken))
 	{
-		_lexer->nextToken();
+		_lexer->consumeToken();
 		constant = createZeroInitializer(type);
 	}
 	else if(isString(nextToken))
 	{
 		constant = _parseStringConstant(type);
 	}
+	else if(type->isArray() && nextToken == "[")
+	{
+		constant = _parseArrayConstant(type);
+	}
 	
 	if(constant == nullptr)
 	{
@@ -274,23 +298,230 @@ ir::Constant* ConstantValueParser::_parseFloatingPointConstant()
 	return new ir::FloatingPointConstant(parseFloat(_lexer->nextToken()));
 }
 
+static unsigned int hexDigit(char character)
+{
+	if(character >= '0' && character <= '9') return character - '0';
+	if(character >= 'a' && character <= 'f') return character - 'a' + 10;
+	if(character >= 'A' && character <= 'F') return character - 'A' + 10;
+
+	return 16;
+}
+
+/*! \brief Decode the escapes in the body of a string, \XX is a hex byte,
+	returns the decoded size, the output may be null to only count */
+static size_t decodeString(const char* begin, const char* end,
+	uint8_t* output)
+{
+	size_t size = 0;
+
+	for(const char* position = begin; position != end; ++size)
+	{
+		unsigned int value = (uint8_t)*position++;
+
+		if(value == '\\' && end - position >= 2 &&
+			hexDigit(position[0]) < 16 && hexDigit(position[1]) < 16)
+		{
+			value = hexDigit(position[0]) * 16 + hexDigit(position[1]);
+
+			position += 2;
+		}
+		else if(value == '\\' && position != end && *position == '\\')
+		{
+			++position;
+		}
+
+		if(output != nullptr) output[size] = value;
+	}
+
+	return size;
+}
+
 ir::Constant* ConstantValueParser::_parseStringConstant(const ir::Type* type)
 {
-	std::string token = _lexer->nextToken();
+	auto token = _lexer->consumeToken();
+
+	// Strip the c" or " prefix and the closing quote
+	const char* begin = token.begin() + (token.front() == 'c' ? 2 : 1);
+	const char* end   = token.end() - 1;
+
+	// Count first, then decode straight into the constant
+	size_t size = decodeString(begin, end, nullptr);
+
+	auto constant = new ir::ArrayConstant(size, type);
 
-	if(token.front() == 'c')
+	decodeString(begin, end, static_cast<uint8_t*>(constant->storage()));
+
+	hydrazine::log("ConstantValueParser::Parser") << " parsed string constant '"
+		<< token << "'\n";
+
+	return constant;
+}
+
+static bool parseIntegerToken(const Token& token, uint64_t& value)
+{
+	size_t position = token.startsWith('-') ? 1 : 0;
+
+	if(position == token.size()) return false;
+
+	value = 0;
+
+	for( ; position < token.size(); ++position)
 	{
-		token = token.substr(2, token.size() - 3);
+		unsigned int digit = token[position] - '0';
+
+		if(digit > 9) return false;
+
+		value = value * 10 + digit;
+	}
+
+	// Two's complement, truncated to the element size by the caller
+	if(token.startsWith('-')) value = -value;
+
+	return true;
+}
+
+static bool parseFloatingPointToken(const Token& token, bool isDouble,
+	uint64_t& bits)
+{
+	double value = 0.0;
+
+	if(token.startsWith("0x"))
+	{
+		// LLVM writes the bits of the double, even for floats
+		bits = 0;
+
+		if(token.size() == 2 || token.size() > 18) return false;
+
+		for(size_t position = 2; position < token.size(); ++position)
+		{
+			unsigned int digit = hexDigit(token[position]);
+
+			if(digit > 15) return false;
+
+			bits = (bits << 4) | digit;
+		}
+
+		if(isDouble) return true;
+
+		std::memcpy(&value, &bits, sizeof(double));
 	}
 	else
 	{
-		token = token.substr(1, token.size() - 1);
+		// Tokens are not null terminated
+		char buffer[64];
+
+		if(token.size() >= sizeof(buffer)) return false;
+
+		std::memcpy(buffer, token.data(), token.size());
+		buffer[token.size()] = '\0';
+
+		char* end = nullptr;
+
+		value = std::strtod(buffer, &end);
+
+		if(end != buffer + token.size()) return false;
 	}
-	
-	hydrazine::log("ConstantValueParser::Parser") << " parsed string constant '"
-		<< token << "'\n";
 
-	return new ir::ArrayConstant(token.c_str(), token.size(), type);
+	if(isDouble)
+	{
+		std::memcpy(&bits, &value, sizeof(double));
+	}
+	else
+	{
+		float single = value;
+
+		uint32_t singleBits = 0;
+
+		std::memcpy(&singleBits, &single, sizeof(float));
+
+		bits = singleBits;
+	}
+
+	return true;
+}
+
+static bool isElementTypeName(const Token& token, const ir::Type* type)
+{
+	if(token == type->name) return true;
+
+	if(type->isSinglePrecisionFloat()) return token == "float";
+	if(type->isDoublePrecisionFloat()) return token == "double";
+
+	return false;
+}
+
+ir::Constant* ConstantValueParser::_parseArrayConstant(const ir::Type* type)
+{
+	auto arrayType   = static_cast<const ir::ArrayType*>(type);
+	auto elementType = arrayType->getTypeAtIndex(0);
+
+	bool isInteger = elementType->isInteger();
+	bool isDouble  = elementType->isDoublePrecisionFloat();
+
+	if(!isInteger && !elementType->isFloatingPoint())
+	{
+		throw std::runtime_error("At " + _lexer->location() + ": array "
+			"initializers of '" + elementType->name + "' are not supported.");
+	}
+
+	_lexer->scanThrow("[");
+
+	// Elements are converted straight into the constant's storage
+	std::unique_ptr<ir::ArrayConstant> constant(
+		new ir::ArrayConstant(arrayType->bytes(), type));
+
+	auto storage = static_cast<uint8_t*>(constant->storage());
+
+	size_t elementBytes = elementType->bytes();
+	size_t elements     = arrayType->elementsInArray();
+
+	Token elementTypeName;
+
+	for(size_t element = 0; element < elements; ++element)
+	{
+		if(element > 0) _lexer->scanThrow(",");
+
+		// Every element is spelled with the type of the first one
+		auto typeName = _lexer->consumeToken();
+
+		if(element == 0 ? !isElementTypeName(typeName, elementType) :
+			typeName != elementTypeName)
+		{
+			throw std::runtime_error("At " + _lexer->location() +
+				": expecting an element of type '" + elementType->name +
+				"', found '" + typeName.str() + "'.");
+		}
+
+		elementTypeName = typeName;
+
+		auto valueToken = _lexer->consumeToken();
+
+		uint64_t value = 0;
+
+		bool parsed = isInteger ? parseIntegerToken(valueToken, value) :
+			parseFloatingPointToken(valueToken, isDouble, value);
+
+		if(!parsed)
+		{
+			throw std::runtime_error("At " + _lexer->location() +
+				": invalid array element '" + valueToken.str() + "'.");
+		}
+
+		// Little endian, like the rest of the data section
+		uint8_t* output = storage + element * elementBytes;
+
+		for(size_t byte = 0; byte < elementBytes; ++byte, value >>= 8)
+		{
+			output[byte] = value & 0xff;
+		}
+	}
+
+	_lexer->scanThrow("]");
+
+	hydrazine::log("ConstantValueParser::Parser") << " parsed " << elements
+		<< " element array constant\n";
+
+	return constant.release();
 }
 
 }
@@ -15,15 +15,24 @@
 #include <vanaheimr/compiler/interface/Compiler.h>
 
 #include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/Function.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Operand.h>
+#include <vanaheimr/ir/interface/Argument.h>
 #include <vanaheimr/ir/interface/Type.h>
 
+#include <vanaheimr/util/interface/ThreadPool.h>
+
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
 // Standard Library Includes
-#include <fstream>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <cstdlib>
 
 namespace vanaheimr
 {
@@ -31,8 +40,8 @@ namespace vanaheimr
 namespace parser
 {
 
-LLVMParser::LLVMParser(compiler::Compiler* compiler)
-: _compiler(compiler) 
+LLVMParser::LLVMParser(compiler::Compiler* compiler, unsigned int threads)
+: _compiler(compiler), _threads(threads)
 {
 
 }
@@ -47,14 +56,19 @@ typedef ir::Variable     Variable;
 typedef ir::Global       Global;
 typedef ir::FunctionType FunctionType;
 typedef ir::Constant     Constant;
+typedef ir::Operand      Operand;
+typedef ir::Instruction  Instruction;
+
+class LLVMFunctionBodyParser;
 
 class LLVMParserEngine
 {
 public:
-	LLVMParserEngine(compiler::Compiler* compiler, const std::string& filename);
+	LLVMParserEngine(compiler::Compiler* compiler, const std::string& filename,
+		unsigned int threads);
 
 public:
-	void parse(std::istream& stream);
+	void parse();
 
 public:
 	std::string moduleName;
@@ -62,14 +76,17 @@ public:
 private:
 	void _parseTypedefs();
 
-	void _parseTopLevelDeclaration(const std::string& declaration);
+	bool _isTopLevelDeclaration(const Token& token) const;
+	void _parseTopLevelDeclaration(const Token& declaration);
 	
-	void _parseGlobalVariable(const std::string& token);
-	void _parseTypedef(const std::string& token);
+	void _parseGlobalVariable(const Token& token);
+	void _parseTypedef(const Token& token);
 	void _parseFunction();
+	void _parseDeclaration();
 	void _parsePrototype(const std::string& linkage);
 	void _parseTarget();
 	void _parseMetadata();
+	void _parseAttributeGroup();
 
 private:
 	typedef std::set<ir::Type*> TypeSet;
@@ -83,51 +100,139 @@ private:
 	StringList _parseGlobalAttributes();
 	Constant* _parseInitializer(const Type*);
 	void _parseAlignment(ir::Global*);
+	void _parseConstructorList(const std::string& attribute);
+	void _addConstructorAttributes();
 
 	const Type* _parseType();
 	void _addTypeAlias(const std::string& alias, const Type*);
 	
 	void _parseFunctionAttributes();
 	void _parseFunctionAttribute();
-	void _parseFunctionBody();
-	void _parseFunctionBodyDeclaration();
-	void _parseLabel();
-	void _parseInstruction();
+	void _skipFunctionBody();
+	void _parseFunctionBodies();
 
 private:
 	void _resetParser();
 
+private:
+	/*! \brief A function whose body starts at a token index */
+	class FunctionBody
+	{
+	public:
+		FunctionBody(Function* function, size_t position);
+
+	public:
+		Function* function;
+		size_t    position;
+	};
+
 private:
 	typedef std::unordered_map<std::string, std::string> StringMap;
+	typedef std::unordered_set<unsigned int>             KeywordSet;
+	typedef std::vector<FunctionBody>                    FunctionBodyVector;
+	typedef std::pair<std::string, std::string>          StringPair;
+	typedef std::vector<StringPair>                      StringPairVector;
 
 private:
 	// Parser Working State
 	Compiler*   _compiler;
 	Module*     _module;
 	Function*   _function;
-	BasicBlock* _block;
 
 	TypeAliasSet _typedefs;
 	StringMap    _typedefStrings;
 
+	FunctionBodyVector _functionBodies;
+	unsigned int       _threads;
+
+	/*! \brief Functions named by llvm.global_ctors/dtors and the attribute
+		that they are given once every function is declared */
+	StringPairVector _constructors;
+
 private:
 	// Lexer Working State
 	Lexer _lexer;
+
+private:
+	// Interned Keywords
+	unsigned int _define;
+	unsigned int _declare;
+	unsigned int _target;
+	unsigned int _metadata;
+	unsigned int _attributes;
+	unsigned int _openBrace;
+	unsigned int _closeBrace;
+
+	unsigned int _call;
+	unsigned int _ret;
+	unsigned int _bitcast;
+	unsigned int _getelementptr;
+
+	KeywordSet _opcodes;
+
+private:
+	friend class LLVMFunctionBodyParser;
 };
 
-void LLVMParser::parse(const std::string& filename)
+/*! \brief Parses the body of one function
+
+	A body only adds blocks and instructions to its own function and only
+	reads the declarations, so bodies are parsed in parallel once every
+	declaration is known.  Each parser reads a copy of the engine's lexer.
+*/
+class LLVMFunctionBodyParser
 {
-	std::ifstream file(filename.c_str());
-	
-	if(!file.is_open())
-	{
-		throw std::runtime_error("LLVM Parser: Could not open file '" +
-			filename + "' for reading.");
-	}
+public:
+	LLVMFunctionBodyParser(const LLVMParserEngine& engine, Function* function,
+		size_t position);
 
-	LLVMParserEngine engine(_compiler, filename);
+public:
+	void parse();
+
+private:
+	void _parseFunctionBodyDeclaration();
+	void _parseLabel();
+	void _parseInstruction();
+
+	void _parseCall(const std::string& result);
+	void _parseReturn();
+	void _parseInstructionAttributes();
+
+private:
+	Operand* _parseTypedOperand(Instruction* instruction);
+	Operand* _parseOperand(const Type* type, Instruction* instruction);
+	Operand* _parseConstantExpression(Instruction* instruction);
+	const Type* _parseType();
+
+private:
+	void _newBlock(const std::string& name);
+	ir::VirtualRegister* _getValue(const std::string& name, const Type* type);
+	Variable* _getGlobalValue(const Token& token);
 
-	engine.parse(file);
+private:
+	bool _isOpcode(const Token& token) const;
+	bool _isInstruction(const Token& token) const;
+
+private:
+	typedef std::unordered_map<std::string, ir::VirtualRegister*> ValueMap;
+
+private:
+	const LLVMParserEngine& _engine;
+
+private:
+	Lexer       _lexer;
+	Function*   _function;
+	BasicBlock* _block;
+
+	/*! \brief Named SSA values, by name without the '%' */
+	ValueMap _values;
+};
+
+void LLVMParser::parse(const std::string& filename)
+{
+	LLVMParserEngine engine(_compiler, filename, _threads);
+
+	engine.parse();
 
 	_moduleName = engine.moduleName;
 }
@@ -138,8 +243,8 @@ std::string LLVMParser::getParsedModuleName() const
 }
 
 LLVMParserEngine::LLVMParserEngine(Compiler* compiler,
-	const std::string& filename)
-: moduleName(filename), _compiler(compiler)
+	const std::string& filename, unsigned int threads)
+: moduleName(filename), _compiler(compiler), _threads(threads)
 {
 	// Load up the lexer with token rules
 	
@@ -157,7 +262,8 @@ LLVMParserEngine::LLVMParserEngine(Compiler* compiler,
 		"uwtable"});
 	
 	/// types
-	_lexer.addTokens({"opaque", "void", "i8", "i32", "i16", "i64"}); 
+	_lexer.addTokens({"opaque", "void", "i1", "i8", "i32", "i16", "i64",
+		"float", "double"}); 
 	
 	/// LLVM ISA
 	_lexer.addTokens({"bitcast", "getelementptr", "call", "ret"});
@@ -169,55 +275,72 @@ LLVMParserEngine::LLVMParserEngine(Compiler* compiler,
 	_lexer.addTokens({"\"[^\n\"]*\""}); // strings 
 	_lexer.addTokens({"c\"[^\n\"]*\""}); // string constants 
 	_lexer.addTokens({"[:digit:]*"}); // decimal constants
-	_lexer.addTokens({";[^\n]*"}); // comments
+	_lexer.addTokens({"-[:digit:][:digit:]*"}); // negative constants
+	_lexer.addTokens({"-*[:digit:][:digit:]*\\.[:digit:]*"}); // floats
+	_lexer.addTokens({"-*[:digit:][:digit:]*\\.[:digit:]*e[-+][:digit:]*"});
+	_lexer.addTokens({"0x[0-9a-fA-F][0-9a-fA-F]*"}); // hex floats
 
 	// Whitespace	
 	_lexer.addWhitespaceRules(" \t\n\r");
+	_lexer.addWhitespaceRegex(";[^\n]*"); // comments
+
+	// Keywords are compared by id rather than by text
+	_define     = _lexer.keyword("define");
+	_declare    = _lexer.keyword("declare");
+	_target     = _lexer.keyword("target");
+	_metadata   = _lexer.keyword("!");
+	_attributes = _lexer.keyword("attributes");
+	_openBrace  = _lexer.keyword("{");
+	_closeBrace = _lexer.keyword("}");
+
+	_call          = _lexer.keyword("call");
+	_ret           = _lexer.keyword("ret");
+	_bitcast       = _lexer.keyword("bitcast");
+	_getelementptr = _lexer.keyword("getelementptr");
+
+	_opcodes = {_call, _ret};
+
+	_lexer.setThreads(threads);
 }
 
-static bool isTopLevelDeclaration(const std::string& token)
+bool LLVMParserEngine::_isTopLevelDeclaration(const Token& token) const
 {
-	if(token == "define" || token == "declare" ||
-		token == "!" || token == "target")
+	if(token.is(_define) || token.is(_declare) || token.is(_metadata) ||
+		token.is(_target) || token.is(_attributes))
 	{
 		return true;
 	}
 	
-	if(token.empty())
-	{
-		return false;
-	}
-	
-	if(token[0] == '%' || token[0] == '@')
-	{
-		return true;
-	}
-	
-	return false;
+	return token.startsWith('%') || token.startsWith('@');
 }
 
-void LLVMParserEngine::parse(std::istream& stream)
+void LLVMParserEngine::parse()
 {
 	_module = &*_compiler->newModule(moduleName);
 
-	_lexer.setStream(&stream);
+	// The file is mapped, tokens are views of the mapping
+	_lexer.setFile(moduleName);
 
 	_parseTypedefs();
 
-	auto token = _lexer.nextToken();
+	auto token = _lexer.consumeToken();
 
-	while(isTopLevelDeclaration(token))
+	while(_isTopLevelDeclaration(token))
 	{
 		_parseTopLevelDeclaration(token);
 	
-		token = _lexer.nextToken();
+		token = _lexer.consumeToken();
 	}
 
 	if(!_lexer.hitEndOfStream())
 	{
 		throw std::runtime_error("At " + _lexer.location() +
-			": hit invalid top level declaration '" + token + "'" );
+			": hit invalid top level declaration '" + token.str() + "'" );
 	}
+
+	_addConstructorAttributes();
+
+	_parseFunctionBodies();
 }
 
 void LLVMParserEngine::_parseTypedefs()
@@ -226,11 +349,11 @@ void LLVMParserEngine::_parseTypedefs()
 	
 	while(!_lexer.hitEndOfStream())
 	{
-		auto token = _lexer.nextToken();
+		auto token = _lexer.consumeToken();
 
 		if(token != "%") continue;
 		
-		auto name = _lexer.nextToken();
+		auto name = _lexer.consumeToken();
 
 		if(!_lexer.scan("=")) continue;
 
@@ -246,35 +369,50 @@ void LLVMParserEngine::_parseTypedefs()
 	_lexer.reset();
 }
 
-void LLVMParserEngine::_parseTopLevelDeclaration(const std::string& token)
+void LLVMParserEngine::_parseTopLevelDeclaration(const Token& token)
 {
-	if(token.find("@") == 0)
+	if(token.startsWith('@'))
 	{
 		_parseGlobalVariable(token);
 	}
-	else if(token.find("%") == 0)
+	else if(token.startsWith('%'))
 	{
 		_parseTypedef(token);
 	}
-	else if(token == "define")
+	else if(token.is(_define))
 	{
 		_parseFunction();
 	}
-	else if(token == "declare")
+	else if(token.is(_declare))
 	{
-		_parsePrototype("external");
+		_parseDeclaration();
 	}
-	else if(token == "target")
+	else if(token.is(_target))
 	{
 		_parseTarget();
 	}
+	else if(token.is(_attributes))
+	{
+		_parseAttributeGroup();
+	}
 	else
 	{
 		_parseMetadata();
 	}
 }
 
-static bool isLinkage(const std::string& token)
+/*! \brief Consume the next token only if it matches, scan() always
+	consumes it */
+static bool scanOptional(Lexer& lexer, const std::string& token)
+{
+	if(!lexer.scanPeek(token)) return false;
+
+	lexer.consumeToken();
+
+	return true;
+}
+
+static bool isLinkage(const Token& token)
 {
 	return token == "private" ||
 		token == "linker_private" ||
@@ -296,13 +434,17 @@ static bool isLinkage(const std::string& token)
 
 static Variable::Linkage translateLinkage(const std::string& token)
 {
-	if(token == "internal") return Variable::InternalLinkage;
-	if(token == "external") return Variable::ExternalLinkage;
-	if(token == "private")  return Variable::PrivateLinkage;
-
-	assertM(false, "Linkage " + token + " implemented.");
-
-	return Variable::ExternalLinkage;
+	// Symbols without a linkage are external
+	if(token.empty())           return Variable::ExternalLinkage;
+	if(token == "internal")     return Variable::InternalLinkage;
+	if(token == "external")     return Variable::ExternalLinkage;
+	if(token == "private")      return Variable::PrivateLinkage;
+	if(token == "linkonce")     return Variable::LinkOnceAnyLinkage;
+	if(token == "linkonce_odr") return Variable::LinkOnceODRLinkage;
+	if(token == "weak")         return Variable::WeakAnyLinkage;
+	if(token == "weak_odr")     return Variable::WeakAnyLinkage;
+
+	throw std::runtime_error("Linkage '" + token + "' is not supported.");
 }
 
 void LLVMParserEngine::_resolveTypeAliases()
@@ -386,9 +528,9 @@ void LLVMParserEngine::_resolveTypeAliasesInSubtypes(
 	}
 }
 
-void LLVMParserEngine::_parseGlobalVariable(const std::string& token)
+void LLVMParserEngine::_parseGlobalVariable(const Token& token)
 {
-	auto name = token.substr(1);
+	auto name = std::string(token.begin() + 1, token.end());
 
 	if(!_lexer.scan("="))
 	{
@@ -396,21 +538,33 @@ void LLVMParserEngine::_parseGlobalVariable(const std::string& token)
 			": expecting a '='.");
 	}
 	
-	auto linkage = _lexer.peek();
+	std::string linkage;
 
-	if(isLinkage(linkage))
+	if(isLinkage(_lexer.peekToken()))
 	{
-		_lexer.nextToken();
-	}
-	else
-	{
-		linkage = "";
+		linkage = _lexer.consumeToken().str();
 	}
 	
 	auto arributes = _parseGlobalAttributes();
 
 	auto type = _parseType();
 
+	// The static constructor lists become function attributes
+	if(name == "llvm.global_ctors" || name == "llvm.global_dtors")
+	{
+		_parseConstructorList(name == "llvm.global_ctors" ?
+			"constructor" : "destructor");
+		_parseAlignment(nullptr);
+
+		return;
+	}
+
+	if(name.compare(0, 5, "llvm.") == 0)
+	{
+		throw std::runtime_error("At " + _lexer.location() +
+			": intrinsic global '" + name + "' is not supported.");
+	}
+
 	auto global = _module->newGlobal(name, type, translateLinkage(linkage),
 		Global::Shared);
 
@@ -427,9 +581,9 @@ void LLVMParserEngine::_parseGlobalVariable(const std::string& token)
 	_parseAlignment(&*global);
 }
 
-void LLVMParserEngine::_parseTypedef(const std::string& token)
+void LLVMParserEngine::_parseTypedef(const Token& token)
 {
-	auto name = token.substr(1);
+	auto name = std::string(token.begin() + 1, token.end());
 	
 	if(!_lexer.scan("="))
 	{
@@ -450,58 +604,86 @@ void LLVMParserEngine::_parseTypedef(const std::string& token)
 
 void LLVMParserEngine::_parseFunction()
 {
-	auto linkage = _lexer.peek();
+	std::string linkage;
 
-	if(isLinkage(linkage))
+	if(isLinkage(_lexer.peekToken()))
 	{
-		_lexer.nextToken();
-	}
-	else
-	{
-		linkage = "";
+		linkage = _lexer.consumeToken().str();
 	}
 	
 	_parsePrototype(linkage);
 	_parseFunctionAttributes();
 
-	_lexer.scanThrow("{");
+	_lexer.scanThrow(_openBrace);
+
+	// Bodies are parsed once every declaration has been seen
+	_functionBodies.push_back(FunctionBody(_function, _lexer.position()));
 
-	_parseFunctionBody();
+	_skipFunctionBody();
 
-	_lexer.scanThrow("}");
+	_lexer.scanThrow(_closeBrace);
+}
+
+void LLVMParserEngine::_parseDeclaration()
+{
+	_parsePrototype("external");
+
+	// e.g. '#0', the attribute groups are not used yet
+	while(scanOptional(_lexer, "#"))
+	{
+		_lexer.consumeToken();
+	}
 }
 
 void LLVMParserEngine::_parsePrototype(const std::string& linkage)
 {
 	auto returnType = _parseType();
 	
-	auto name = _lexer.nextToken();
+	auto nameToken = _lexer.consumeToken();
 
-	if(name.find('@') != 0)
+	if(!nameToken.startsWith('@'))
 	{
 		throw std::runtime_error("At " + _lexer.location() +
 			": expecting '@'.");
 	}
 	
-	name = name.substr(1);
+	auto name = std::string(nameToken.begin() + 1, nameToken.end());
 
 	_lexer.scanThrow("(");
 
-	auto end = _lexer.peek();
+	auto end = _lexer.peekToken();
 
 	Type::TypeVector argumentTypes;
+	StringList       argumentNames;
+
+	unsigned int unnamedArguments = 0;
 
 	if(end != ")")
 	{
 		while(true)
 		{
+			// Variadic arguments are not passed as arguments
+			if(scanOptional(_lexer, "...")) break;
+
 			argumentTypes.push_back(_parseType());
-			
-			auto next = _lexer.peek();
 
-			if(next != ",") break;
-			
-			_lexer.scan(",");
+			// Unnamed arguments are numbered, as LLVM does
+			std::stringstream argumentName;
+
+			if(_lexer.peekToken().startsWith('%'))
+			{
+				auto token = _lexer.consumeToken();
+
+				argumentName << std::string(token.begin() + 1, token.end());
+			}
+			else
+			{
+				argumentName << unnamedArguments++;
+			}
+
+			argumentNames.push_back(argumentName.str());
+
+			if(!scanOptional(_lexer, ",")) break;
 		}
 	}
 
@@ -512,17 +694,29 @@ void LLVMParserEngine::_parsePrototype(const std::string& linkage)
 
 	_function = &*_module->newFunction(name, translateLinkage(linkage),
 		Variable::HiddenVisibility, *type);
+
+	if(!returnType->isVoid())
+	{
+		_function->newReturnValue(returnType, "returnedValue");
+	}
+
+	auto argumentName = argumentNames.begin();
+
+	for(auto argumentType : argumentTypes)
+	{
+		_function->newArgument(argumentType, *argumentName++);
+	}
 }
 
 void LLVMParserEngine::_parseTarget()
 {
 	hydrazine::log("LLVM::Parser") << "Parsing target\n";
 
-	auto name = _lexer.nextToken();
+	auto name = _lexer.consumeToken();
 
 	_lexer.scanThrow("=");
 
-	auto targetString = _lexer.nextToken();
+	auto targetString = _lexer.consumeToken();
 
 	hydrazine::log("LLVM::Parser") << " target:'" << name << " = "
 		<< targetString << "'\n";
@@ -537,7 +731,31 @@ void LLVMParserEngine::_parseMetadata()
 	assertM(false, "Not Implemented.");
 }
 
-static bool isGlobalAttribute(const std::string& token)
+void LLVMParserEngine::_parseAttributeGroup()
+{
+	hydrazine::log("LLVM::Parser") << "Parsing attribute group\n";
+
+	_lexer.scanThrow("#");
+	_lexer.consumeToken();
+	_lexer.scanThrow("=");
+	_lexer.scanThrow(_openBrace);
+
+	// TODO: save the attributes for the functions that name the group
+	while(!_lexer.scanPeek(_closeBrace))
+	{
+		if(_lexer.hitEndOfStream())
+		{
+			throw std::runtime_error("At " + _lexer.location() +
+				": hit the end of the file in an attribute group.");
+		}
+
+		_lexer.consumeToken();
+	}
+
+	_lexer.scanThrow(_closeBrace);
+}
+
+static bool isGlobalAttribute(const Token& token)
 {
 	if(token == "internal")     return true;
 	if(token == "external")     return true;
@@ -555,33 +773,29 @@ LLVMParserEngine::StringList LLVMParserEngine::_parseGlobalAttributes()
 
 	hydrazine::log("LLVM::Parser") << "Parsing global attributes...\n";
 	
-	auto next = _lexer.peek();
-
-	while(isGlobalAttribute(next))
+	while(isGlobalAttribute(_lexer.peekToken()))
 	{
-		attributes.push_back(_lexer.nextToken());
+		attributes.push_back(_lexer.consumeToken().str());
 
 		hydrazine::log("LLVM::Parser") << " parsed '"
 			<< attributes.back() << "'\n";
-
-		next = _lexer.peek();
 	}
 
 	return attributes;
 }
 
-static bool isConstant(const std::string& token)
+static bool isConstant(const Token& token)
 {
 	if(token == "zeroinitializer") return true;
-	if(token.find("c\"") == 0)     return true;
-	if(token.find("[") == 0)       return true;
+	if(token.startsWith("c\""))    return true;
+	if(token.startsWith('['))      return true;
 
 	return false;
 }
 
 Constant* LLVMParserEngine::_parseInitializer(const Type* type)
 {
-	auto next = _lexer.peek();
+	auto next = _lexer.peekToken();
 
 	if(!isConstant(next)) return nullptr;
 
@@ -589,23 +803,83 @@ Constant* LLVMParserEngine::_parseInitializer(const Type* type)
 
 	parser.parse(type);
 
-	return parser.parsedConstant()->clone();
+	// Large initializers are not copied
+	return parser.releaseParsedConstant();
 } 
 
-void LLVMParserEngine::_parseAlignment(ir::Global* global)
+void LLVMParserEngine::_parseConstructorList(const std::string& attribute)
+{
+	// e.g. [{ i32, void ()* } { i32 65535, void ()* @_GLOBAL__I_a }]
+	_lexer.scanThrow("[");
+
+	while(!_lexer.scanPeek("]"))
+	{
+		_parseType();
+
+		_lexer.scanThrow(_openBrace);
+
+		// TODO: order the constructors by priority
+		_parseType();
+		_lexer.consumeToken();
+
+		_lexer.scanThrow(",");
+
+		_parseType();
+
+		auto function = _lexer.consumeToken();
+
+		if(!function.startsWith('@'))
+		{
+			throw std::runtime_error("At " + _lexer.location() +
+				": expecting a function in the list of '" + attribute +
+				"' functions.");
+		}
+
+		_constructors.push_back(StringPair(
+			std::string(function.begin() + 1, function.end()), attribute));
+
+		// Newer versions add the data that the function initializes
+		while(scanOptional(_lexer, ","))
+		{
+			_parseType();
+			_lexer.consumeToken();
+		}
+
+		_lexer.scanThrow(_closeBrace);
+
+		if(!scanOptional(_lexer, ",")) break;
+	}
+
+	_lexer.scanThrow("]");
+}
+
+void LLVMParserEngine::_addConstructorAttributes()
 {
-	auto next = _lexer.peek();
+	for(auto& constructor : _constructors)
+	{
+		auto function = _module->getFunction(constructor.first);
 
-	while(next == ",")
+		if(function == _module->end())
+		{
+			throw std::runtime_error("The " + constructor.second +
+				" '" + constructor.first + "' is not a function in the "
+				"module.");
+		}
+
+		function->addAttribute(constructor.second);
+	}
+}
+
+void LLVMParserEngine::_parseAlignment(ir::Global* global)
+{
+	while(_lexer.peekToken() == ",")
 	{
-		_lexer.scan(",");
+		_lexer.consumeToken();
 
-		_lexer.nextToken();
-		_lexer.nextToken();
+		_lexer.consumeToken();
+		_lexer.consumeToken();
 		
 		// TODO: store the alignment
-
-		next = _lexer.peek();
 	}
 }
 
@@ -631,21 +905,25 @@ void LLVMParserEngine::_addTypeAlias(const std::string& alias, const Type* type)
 
 void LLVMParserEngine::_parseFunctionAttributes()
 {
-	while(_lexer.peek() != "{")
+	while(!_lexer.scanPeek(_openBrace))
 	{
 		_parseFunctionAttribute();
 	}
 }
 
-static bool isFunctionAttribute(const std::string& token)
+static bool isFunctionAttribute(const Token& token)
 {
 	return (token == "section"
-		|| token == "#");
+		|| token == "#"
+		|| token == "align"
+		|| token == "unnamed_addr"
+		|| token == "nounwind"
+		|| token == "uwtable");
 }
 
 void LLVMParserEngine::_parseFunctionAttribute()
 {
-	auto attribute = _lexer.nextToken();
+	auto attribute = _lexer.consumeToken();
 	
 	if(!isFunctionAttribute(attribute))
 	{
@@ -656,60 +934,117 @@ void LLVMParserEngine::_parseFunctionAttribute()
 	if(attribute == "section")
 	{
 		// TODO: save the section
-		_lexer.nextToken();
+		_lexer.consumeToken();
 	}
 	else if(attribute == "#")
 	{
 		// TODO: save the metadata node
-		_lexer.nextToken();
+		_lexer.consumeToken();
 	}
-	else
+	else if(attribute == "align")
 	{
-		assert(false);
+		// TODO: save the alignment
+		_lexer.consumeToken();
 	}
 }
 
-void LLVMParserEngine::_parseFunctionBody()
+void LLVMParserEngine::_skipFunctionBody()
+{
+	unsigned int depth = 0;
+
+	// Braces nest in aggregate constants
+	while(true)
+	{
+		if(_lexer.hitEndOfStream())
+		{
+			throw std::runtime_error("At " + _lexer.location() +
+				": hit the end of the file in a function body.");
+		}
+
+		auto token = _lexer.peekToken();
+
+		if(token.is(_closeBrace))
+		{
+			if(depth == 0) break;
+
+			--depth;
+		}
+		else if(token.is(_openBrace))
+		{
+			++depth;
+		}
+
+		_lexer.consumeToken();
+	}
+}
+
+void LLVMParserEngine::_parseFunctionBodies()
+{
+	util::ThreadPool pool(_functionBodies.size() > 1 ? _threads : 1);
+
+	hydrazine::log("LLVM::Parser") << "Parsing " << _functionBodies.size()
+		<< " function bodies with " << pool.size() << " threads.\n";
+
+	// The first error in file order is reported
+	pool.parallelFor(_functionBodies.size(), [&](size_t i)
+	{
+		auto& body = _functionBodies[i];
+
+		LLVMFunctionBodyParser parser(*this, body.function, body.position);
+
+		parser.parse();
+	});
+}
+
+LLVMParserEngine::FunctionBody::FunctionBody(Function* f, size_t p)
+: function(f), position(p)
+{
+
+}
+
+LLVMFunctionBodyParser::LLVMFunctionBodyParser(
+	const LLVMParserEngine& engine, Function* function, size_t position)
+: _engine(engine), _lexer(engine._lexer), _function(function), _block(nullptr)
+{
+	_lexer.seek(position);
+}
+
+void LLVMFunctionBodyParser::parse()
 {
-	while(_lexer.peek() != "}")
+	while(!_lexer.scanPeek(_engine._closeBrace))
 	{
 		_parseFunctionBodyDeclaration();
 	}
 }
 
-static bool isLabel(const std::string& token)
+static bool isLabel(const Token& token)
 {
 	if(token.empty()) return false;
 	
 	return token.back() == ':';
 }
 
-static std::set<std::string> opcodes = {"call", "ret"};
-
-static bool isOpcode(const std::string& token)
+bool LLVMFunctionBodyParser::_isOpcode(const Token& token) const
 {
-	return opcodes.count(token) != 0;
+	return _engine._opcodes.count(token.keyword()) != 0;
 }
 
-static bool isInstruction(const std::string& token)
+bool LLVMFunctionBodyParser::_isInstruction(const Token& token) const
 {
-	if(isOpcode(token)) return true;
-	
-	if(token.find("%") == 0)
-	{
-		return true;
-	}
+	if(_isOpcode(token)) return true;
 	
-	return false;
+	return token.startsWith('%');
 }
 
-void LLVMParserEngine::_parseFunctionBodyDeclaration()
+void LLVMFunctionBodyParser::_parseFunctionBodyDeclaration()
 {
-	if(isLabel(_lexer.peek()))
+	auto token = _lexer.peekToken();
+
+	if(isLabel(token))
 	{
 		_parseLabel();
 	}
-	else if(isInstruction(_lexer.peek()))
+	else if(_isInstruction(token))
 	{
 		_parseInstruction();
 	}
@@ -720,37 +1055,333 @@ void LLVMParserEngine::_parseFunctionBodyDeclaration()
 	}
 }
 
-void LLVMParserEngine::_parseLabel()
+void LLVMFunctionBodyParser::_parseLabel()
 {
-	auto label = _lexer.nextToken();
+	auto label = _lexer.consumeToken();
 
-	_block = &*_function->newBasicBlock(_function->end(),
-		label.substr(0, label.size() - 1));
+	_newBlock(std::string(label.begin(), label.end() - 1));
 }
 
-void LLVMParserEngine::_parseInstruction()
+void LLVMFunctionBodyParser::_parseInstruction()
 {
-	assert(_block != nullptr);
-	
-	ir::Operand* result = nullptr;
-	
-	std::string opcode;
-	
-	if(isOperand(_lexer.peek()))
+	// The entry block does not need a label
+	if(_block == nullptr) _newBlock("entry");
+
+	std::string result;
+
+	if(_lexer.peekToken().startsWith('%'))
 	{
-		result = _parseOperand();
+		auto token = _lexer.consumeToken();
+
+		result = std::string(token.begin() + 1, token.end());
+
+		_lexer.scanThrow("=");
 	}
 
-	opcode = _lexer.nextToken();
-	
-	ir::Instruction::OperandVector operands;
-	
-	while(isOperand(_lexer.peek()))
+	auto opcode = _lexer.consumeToken();
+
+	if(opcode.is(_engine._call))
 	{
-		operands.push_back(_parseOperand());
+		_parseCall(result);
+	}
+	else if(opcode.is(_engine._ret) && result.empty())
+	{
+		_parseReturn();
+	}
+	else
+	{
+		throw std::runtime_error("At " + _lexer.location() +
+			": instruction '" + opcode.str() + "' is not supported.");
 	}
-	
-	_block->push_back();
+}
+
+void LLVMFunctionBodyParser::_parseCall(const std::string& result)
+{
+	// The block owns the instruction even if the rest fails to parse
+	auto call = new ir::Call(_block);
+
+	_block->push_back(call);
+
+	call->setGuard(new ir::PredicateOperand(
+		ir::PredicateOperand::PredicateTrue, call));
+
+	auto type = _parseType();
+
+	call->setTarget(_parseOperand(type, call));
+
+	_lexer.scanThrow("(");
+
+	if(!scanOptional(_lexer, ")"))
+	{
+		do
+		{
+			call->addArgument(_parseTypedOperand(call));
+		}
+		while(scanOptional(_lexer, ","));
+
+		_lexer.scanThrow(")");
+	}
+
+	_parseInstructionAttributes();
+
+	if(result.empty()) return;
+
+	if(type->isVoid())
+	{
+		throw std::runtime_error("At " + _lexer.location() +
+			": a call that returns void can't name a result.");
+	}
+
+	// Direct calls return the type of the callee's returned value
+	if(call->target()->isAddress())
+	{
+		auto target = static_cast<ir::AddressOperand*>(call->target());
+
+		if(target->globalValue->type().isFunction())
+		{
+			auto callee = static_cast<Function*>(target->globalValue);
+
+			if(callee->returned_size() == 1)
+			{
+				type = &callee->returned_begin()->type();
+			}
+		}
+	}
+
+	call->addReturn(new ir::RegisterOperand(_getValue(result, type), call));
+}
+
+void LLVMFunctionBodyParser::_parseReturn()
+{
+	auto type = _parseType();
+
+	// The value is stored to the returned argument, as for PTX
+	if(!type->isVoid())
+	{
+		if(_function->returned_size() != 1)
+		{
+			throw std::runtime_error("At " + _lexer.location() +
+				": returning a value from a function without one.");
+		}
+
+		auto store = new ir::St(_block);
+
+		_block->push_back(store);
+
+		store->setGuard(new ir::PredicateOperand(
+			ir::PredicateOperand::PredicateTrue, store));
+		store->setD(new ir::ArgumentOperand(&*_function->returned_begin(),
+			store));
+		store->setA(_parseOperand(type, store));
+	}
+
+	auto ret = new ir::Ret(_block);
+
+	_block->push_back(ret);
+
+	ret->setGuard(new ir::PredicateOperand(
+		ir::PredicateOperand::PredicateTrue, ret));
+}
+
+void LLVMFunctionBodyParser::_parseInstructionAttributes()
+{
+	// e.g. '#1', the attribute groups are not used yet
+	while(scanOptional(_lexer, "#"))
+	{
+		_lexer.consumeToken();
+	}
+}
+
+Operand* LLVMFunctionBodyParser::_parseTypedOperand(Instruction* instruction)
+{
+	auto type = _parseType();
+
+	return _parseOperand(type, instruction);
+}
+
+static bool parseInteger(const Token& token, uint64_t& value)
+{
+	size_t position = token.startsWith('-') ? 1 : 0;
+
+	if(position == token.size()) return false;
+
+	value = 0;
+
+	for( ; position < token.size(); ++position)
+	{
+		unsigned int digit = token[position] - '0';
+
+		if(digit > 9) return false;
+
+		value = value * 10 + digit;
+	}
+
+	if(token.startsWith('-')) value = -value;
+
+	return true;
+}
+
+static bool parseFloatingPoint(const Token& token, double& value)
+{
+	// Tokens are not null terminated
+	std::string text = token.str();
+
+	char* end = nullptr;
+
+	value = std::strtod(text.c_str(), &end);
+
+	return !text.empty() && end == text.c_str() + text.size();
+}
+
+Operand* LLVMFunctionBodyParser::_parseOperand(const Type* type,
+	Instruction* instruction)
+{
+	auto token = _lexer.peekToken();
+
+	if(token.is(_engine._bitcast) || token.is(_engine._getelementptr))
+	{
+		return _parseConstantExpression(instruction);
+	}
+
+	_lexer.consumeToken();
+
+	if(token.startsWith('@'))
+	{
+		return new ir::AddressOperand(_getGlobalValue(token), instruction);
+	}
+
+	if(token.startsWith('%'))
+	{
+		auto value = _getValue(std::string(token.begin() + 1, token.end()),
+			type);
+
+		return new ir::RegisterOperand(value, instruction);
+	}
+
+	uint64_t integer  = 0;
+	double   floating = 0.0;
+
+	if(type->isInteger() && parseInteger(token, integer))
+	{
+		return new ir::ImmediateOperand(integer, instruction, type);
+	}
+
+	if(type->isFloatingPoint() && parseFloatingPoint(token, floating))
+	{
+		return new ir::ImmediateOperand(floating, instruction, type);
+	}
+
+	throw std::runtime_error("At " + _lexer.location() + ": expecting an "
+		"operand of type '" + type->name + "', found '" + token.str() + "'.");
+}
+
+Operand* LLVMFunctionBodyParser::_parseConstantExpression(
+	Instruction* instruction)
+{
+	auto opcode = _lexer.consumeToken();
+
+	if(opcode.is(_engine._bitcast))
+	{
+		_lexer.scanThrow("(");
+
+		std::unique_ptr<Operand> operand(_parseTypedOperand(instruction));
+
+		_lexer.scanThrow("to");
+		_parseType();
+		_lexer.scanThrow(")");
+
+		// Casting a constant does not change its bits
+		return operand.release();
+	}
+
+	scanOptional(_lexer, "inbounds");
+	_lexer.scanThrow("(");
+
+	std::unique_ptr<Operand> operand(_parseTypedOperand(instruction));
+
+	while(scanOptional(_lexer, ","))
+	{
+		_parseType();
+
+		auto index = _lexer.consumeToken();
+
+		if(index != "0")
+		{
+			throw std::runtime_error("At " + _lexer.location() +
+				": only getelementptr constants that address the start of a "
+				"global are supported, found index '" + index.str() + "'.");
+		}
+	}
+
+	_lexer.scanThrow(")");
+
+	return operand.release();
+}
+
+const Type* LLVMFunctionBodyParser::_parseType()
+{
+	TypeParser parser(_engine._compiler, &_engine._typedefs);
+
+	parser.parse(&_lexer);
+
+	return parser.parsedType();
+}
+
+void LLVMFunctionBodyParser::_newBlock(const std::string& name)
+{
+	bool isEntry = _block == nullptr;
+
+	_block = &*_function->newBasicBlock(_function->exit_block(), name);
+
+	if(!isEntry) return;
+
+	// Arguments are loaded into values at the top of the entry block
+	for(auto argument = _function->argument_begin();
+		argument != _function->argument_end(); ++argument)
+	{
+		auto load = new ir::Ld(_block);
+
+		_block->push_back(load);
+
+		load->setGuard(new ir::PredicateOperand(
+			ir::PredicateOperand::PredicateTrue, load));
+		load->setD(new ir::RegisterOperand(
+			_getValue(argument->name(), &argument->type()), load));
+		load->setA(new ir::ArgumentOperand(&*argument, load));
+	}
+}
+
+ir::VirtualRegister* LLVMFunctionBodyParser::_getValue(
+	const std::string& name, const Type* type)
+{
+	auto value = _values.find(name);
+
+	if(value != _values.end()) return value->second;
+
+	// Values may be used before the instruction that defines them
+	auto virtualRegister = &*_function->newVirtualRegister(type, name);
+
+	_values.insert(std::make_pair(name, virtualRegister));
+
+	return virtualRegister;
+}
+
+Variable* LLVMFunctionBodyParser::_getGlobalValue(const Token& token)
+{
+	auto name = std::string(token.begin() + 1, token.end());
+
+	auto module = _function->module();
+
+	auto function = module->getFunction(name);
+
+	if(function != module->end()) return &*function;
+
+	auto global = module->getGlobal(name);
+
+	if(global != module->global_end()) return &*global;
+
+	throw std::runtime_error("At " + _lexer.location() +
+		": use of undefined global '" + token.str() + "'.");
 }
 
 void LLVMParserEngine::_resetParser()
@@ -759,10 +1390,12 @@ void LLVMParserEngine::_resetParser()
 	
 	_module   = nullptr;
 	_function = nullptr;
-	_block    = nullptr;
 	
 	_typedefs.clear();
 	_typedefStrings.clear();
+
+	_functionBodies.clear();
+	_constructors.clear();
 }
 
 }
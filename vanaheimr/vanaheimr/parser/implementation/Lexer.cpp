@@ -7,17 +7,25 @@
 // Vanaheimr Includes
 #include <vanaheimr/parser/interface/Lexer.h>
 #include <vanaheimr/parser/interface/LexerRule.h>
+#include <vanaheimr/parser/interface/LexerStateMachine.h>
+
+#include <vanaheimr/util/interface/MappedFile.h>
+#include <vanaheimr/util/interface/ThreadPool.h>
 
 // Hydrazine Includes
 #include <hydrazine/interface/debug.h>
 
 // Standard Library Includes
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <sstream>
 #include <cassert>
 #include <stdexcept>
-#include <set>
+#include <iterator>
 #include <algorithm>
+#include <thread>
+#include <cstring>
 
 namespace vanaheimr
 {
@@ -28,17 +36,12 @@ namespace parser
 class LexerEngine
 {
 public:
-	// TODO: Consider a rule representation that uses a state machine
-	// rather than an explicit set of rules that could be matched
-	typedef std::set<LexerRule*> RuleSet;
-
 	class TokenDescriptor
 	{
 	public:
-		explicit TokenDescriptor(LexerEngine* engine);
-		TokenDescriptor(const TokenDescriptor& left,
-			const TokenDescriptor& right);
-	
+		TokenDescriptor(size_t begin, size_t end, size_t line, size_t column,
+			unsigned int keyword);
+
 	public:
 		size_t beginPosition;
 		size_t endPosition;
@@ -46,45 +49,58 @@ public:
 	public:
 		size_t line;
 		size_t column;
-		
+
 	public:
-		RuleSet possibleMatches;
+		unsigned int keyword;
+	};
 	
+	typedef std::vector<TokenDescriptor> TokenVector;
+	typedef size_t LexerContext;
+
+	typedef std::vector<LexerContext> LexerContextVector;
+
+	typedef std::vector<LexerRule> RuleVector;
+
+	typedef std::vector<std::string>                       StringVector;
+	typedef std::unordered_map<std::string, unsigned int> KeywordMap;
+	typedef std::vector<std::vector<unsigned int>>        KeywordVectors;
+
+	/*! \brief The tokens of a piece of the source, line and column
+		numbers are relative to the start of the piece */
+	class Chunk
+	{
 	public:
-		LexerEngine* engine;
-	
+		Chunk(size_t begin, size_t end);
+
 	public:
-		bool tokenIsMatched;
-	
+		size_t begin;
+		size_t end;
+
 	public:
-		bool   isEndMatched()   const;
-		bool   isBeginMatched() const;
-		size_t size()           const;
-	
-	public:	
-		bool   isMatched() const;
-		bool   isMatched();
-		bool   isMatched(const TokenDescriptor& next);
-	
+		TokenVector tokens;
+
 	public:
-		LexerRule* getMatchedRule();
-	
+		size_t endLine;
+		size_t endColumn;
+
 	public:
-		std::string getString() const;
+		/*! \brief Where lexing stopped, 'end' unless no rule matched */
+		size_t errorPosition;
 	};
-	
-	typedef std::vector<TokenDescriptor> TokenVector;
-	typedef TokenVector::iterator LexerContext;
 
-	typedef std::vector<LexerContext> LexerContextVector;
+	typedef std::vector<Chunk> ChunkVector;
 
-	typedef std::vector<LexerRule> RuleVector;
+public:
+	/*! \brief Sources are only split into pieces at least this large */
+	static const size_t MinimumChunkSize = 1 << 20;
+
+public:
+	LexerEngine();
 
 public:
 	std::istream* stream;
 
-	size_t line;
-	size_t column;
+	unsigned int threads;
 
 	LexerContextVector checkpoints;
 
@@ -93,52 +109,74 @@ public:
 	RuleVector whitespaceRules;
 
 public:
-	std::string nextToken();
-	std::string peek();
+	void addTokenRule(const std::string& regex);
+	void addWhitespaceRule(const std::string& regex);
+
+public:
+	Token nextToken();
+	Token peek() const;
 	bool hitEndOfStream() const;
 
 public:
-	void reset(std::istream* s);
+	unsigned int       keyword(const std::string& text) const;
+	const std::string& keywordText(unsigned int keyword) const;
+
+public:
+	size_t line()   const;
+	size_t column() const;
+
+public:
+	void setStream(std::istream* s);
+	void setFile(const std::string& path);
+	void rewind();
 
 	void checkpoint();
 	void restore();
 
+public:
+	size_t position() const;
+	void   seek(size_t position);
+
 private:
-	TokenVector           _tokens;
-	TokenVector::iterator _nextToken;
+	typedef std::shared_ptr<const TokenVector>      TokenVectorPointer;
+	typedef std::shared_ptr<const std::string>      StringPointer;
+	typedef std::shared_ptr<const util::MappedFile> MappedFilePointer;
 
 private:
-	void _createTokens();
-	void _mergeTokens();
-	void _removeWhitespace();
-	
-	char _snext();
+	// Copies of the engine share the source text and tokens
+	TokenVectorPointer _tokens;
+	size_t             _nextToken;
 
 private:
-	void _filterWithNeighbors(const LexerContext& token);
+	StringPointer     _buffer;
+	MappedFilePointer _file;
 
-	TokenDescriptor _mergeWithEnd(const LexerContext& token);
-	TokenDescriptor _mergeWithNext(const LexerContext& token,
-		const LexerContext& next);
-	
-	bool _isAMergePossible(const LexerContext& token,
-		const LexerContext& next);
-	bool _canMerge(const LexerContext& token,
-		const LexerContext& next);
-	
-	bool _isNewToken(const LexerContext& token);
-	bool _couldBeTokenEnd(const LexerContext& token);
-	bool _couldBeTokenBegin(const LexerContext& token);
-	bool _formsLargerMatchOfTheSameRule(const LexerContext& left,
-		const LexerContext& right);
-	bool _nextCantMatchOtherwise(const LexerContext& left,
-		const LexerContext& right);
-	
-	const LexerRule* _getRuleThatMatchesWithEnd(const LexerContext&) const;
-	const LexerRule* _getRuleThatMatchesWithBegin(const LexerContext&) const;
+	const char* _source;
+	size_t      _sourceSize;
+
+	size_t _endLine;
+	size_t _endColumn;
+
+private:
+	StringVector   _keywords;
+	KeywordMap     _keywordIds;
+	KeywordVectors _ruleKeywords;
 
-	bool _canMatch(const std::string& rule,
-		const std::string& text);
+private:
+	LexerStateMachine _machine;
+	bool              _machineIsCompiled;
+
+private:
+	void _lex();
+	void _readStream();
+	void _compileRules();
+	void _createTokens();
+
+private:
+	void _splitChunks(ChunkVector& chunks) const;
+	void _lexChunk(Chunk& chunk) const;
+	void _mergeChunks(ChunkVector& chunks, util::ThreadPool& pool,
+		TokenVector& tokens);
 	
 };
 
@@ -153,21 +191,37 @@ Lexer::~Lexer()
 	delete _engine;
 }
 
+Lexer::Lexer(const Lexer& lexer)
+: _engine(new LexerEngine(*lexer._engine))
+{
+
+}
+
 void Lexer::setStream(std::istream* stream)
 {
-	_engine->reset(stream);
+	_engine->setStream(stream);
 }	
 
+void Lexer::setFile(const std::string& path)
+{
+	_engine->setFile(path);
+}
+
+void Lexer::setThreads(unsigned int threads)
+{
+	_engine->threads = threads;
+}
+
 std::string Lexer::peek()
 {
-	return _engine->peek();
+	return _engine->peek().str();
 }
 
 std::string Lexer::location() const
 {
 	std::stringstream stream;
 	
-	stream << "(" << _engine->line << ":" << _engine->column << ")";
+	stream << "(" << line() << ":" << column() << ")";
 	
 	return stream.str();
 }
@@ -178,7 +232,7 @@ std::string Lexer::nextToken()
 
 	hydrazine::log("Lexer") << "scanned token '" << result << "'\n";
 
-	return result;
+	return result.str();
 }
 
 bool Lexer::hitEndOfStream() const
@@ -190,7 +244,7 @@ bool Lexer::scan(const std::string& token)
 {
 	hydrazine::log("Lexer") << "scanning for token '" << token << "'\n";
 	
-	return nextToken() == token;
+	return _engine->nextToken() == token;
 }
 
 void Lexer::scanThrow(const std::string& token)
@@ -205,12 +259,56 @@ bool Lexer::scanPeek(const std::string& token)
 {
 	hydrazine::log("Lexer") << "scanning/peek for token '" << token << "'\n";
 	
-	return peek() == token;
+	return _engine->peek() == token;
+}
+
+Token Lexer::peekToken() const
+{
+	return _engine->peek();
+}
+
+Token Lexer::consumeToken()
+{
+	return _engine->nextToken();
+}
+
+unsigned int Lexer::keyword(const std::string& text) const
+{
+	return _engine->keyword(text);
+}
+
+bool Lexer::scan(unsigned int keyword)
+{
+	return _engine->nextToken().is(keyword);
+}
+
+void Lexer::scanThrow(unsigned int keyword)
+{
+	if(!scan(keyword))
+	{
+		throw std::runtime_error(location() + ": expecting a '" +
+			_engine->keywordText(keyword) + "'");
+	}
+}
+
+bool Lexer::scanPeek(unsigned int keyword) const
+{
+	return _engine->peek().is(keyword);
+}
+
+size_t Lexer::line() const
+{
+	return _engine->line();
+}
+
+size_t Lexer::column() const
+{
+	return _engine->column();
 }
 
 void Lexer::reset()
 {
-	_engine->reset(_engine->stream);
+	_engine->rewind();
 }
 
 void Lexer::checkpoint()
@@ -230,20 +328,34 @@ void Lexer::discardCheckpoint()
 	_engine->checkpoints.pop_back();
 }
 
+size_t Lexer::position() const
+{
+	return _engine->position();
+}
+
+void Lexer::seek(size_t position)
+{
+	_engine->seek(position);
+}
+
 void Lexer::addTokenRegex(const std::string& regex)
 {
-	_engine->tokenRules.push_back(LexerRule(regex));
+	_engine->addTokenRule(regex);
 }
 
 void Lexer::addWhitespaceRules(const std::string& whitespaceCharacters)
 {
 	for(auto& character : whitespaceCharacters)
 	{
-		_engine->whitespaceRules.push_back(
-			LexerRule(std::string(1, character)));
+		_engine->addWhitespaceRule(std::string(1, character));
 	}
 }
 
+void Lexer::addWhitespaceRegex(const std::string& regex)
+{
+	_engine->addWhitespaceRule(regex);
+}
+
 void Lexer::addTokens(const StringList& regexes)
 {
 	for(auto& regex : regexes)
@@ -252,22 +364,106 @@ void Lexer::addTokens(const StringList& regexes)
 	}
 }
 
-void LexerEngine::reset(std::istream* s)
+LexerEngine::LexerEngine()
+: stream(nullptr), threads(0), _tokens(std::make_shared<TokenVector>()),
+	_nextToken(0), _source(nullptr), _sourceSize(0), _endLine(0),
+	_endColumn(0), _machineIsCompiled(false)
+{
+
+}
+
+static bool getLiteral(const LexerRule& rule, std::string& literal)
+{
+	auto elements = rule.elements();
+
+	literal.clear();
+
+	for(auto& element : elements)
+	{
+		if(element.isRepeated || element.characters.count() != 1) return false;
+
+		for(unsigned int character = 0; character < 256; ++character)
+		{
+			if(element.characters.test(character))
+			{
+				literal.push_back(character);
+				break;
+			}
+		}
+	}
+
+	return !literal.empty();
+}
+
+void LexerEngine::addTokenRule(const std::string& regex)
+{
+	tokenRules.push_back(LexerRule(regex));
+
+	// Rules that only ever match one string are interned as keywords
+	std::string literal;
+
+	if(getLiteral(tokenRules.back(), literal) &&
+		_keywordIds.count(literal) == 0)
+	{
+		_keywordIds.insert(std::make_pair(literal, _keywords.size()));
+		_keywords.push_back(literal);
+	}
+
+	_machineIsCompiled = false;
+}
+
+void LexerEngine::addWhitespaceRule(const std::string& regex)
+{
+	whitespaceRules.push_back(LexerRule(regex));
+
+	_machineIsCompiled = false;
+}
+
+void LexerEngine::setStream(std::istream* s)
 {
 	stream = s;
-	
-	stream->clear();
-	stream->seekg(0, std::ios::beg);
-	
-	line   = 0;
-	column = 0;
-	
+
+	_file.reset();
+
+	_readStream();
+	_lex();
+}
+
+void LexerEngine::setFile(const std::string& path)
+{
+	stream = nullptr;
+
+	_file = std::make_shared<util::MappedFile>(path);
+
+	_buffer.reset();
+
+	_source     = _file->data();
+	_sourceSize = _file->size();
+
+	_lex();
+}
+
+void LexerEngine::rewind()
+{
+	// Tokens only need to be recreated if the rules changed
+	if(!_machineIsCompiled)
+	{
+		_lex();
+		return;
+	}
+
+	checkpoints.clear();
+
+	_nextToken = 0;
+}
+
+void LexerEngine::_lex()
+{
 	checkpoints.clear();
 	
 	// Create the entire set of tokens
+	_compileRules();
 	_createTokens();
-	_mergeTokens();
-	_removeWhitespace();
 }
 
 void LexerEngine::checkpoint()
@@ -284,780 +480,340 @@ void LexerEngine::restore()
 	checkpoints.pop_back();
 }
 
-std::string LexerEngine::nextToken()
+size_t LexerEngine::position() const
+{
+	return _nextToken;
+}
+
+void LexerEngine::seek(size_t position)
+{
+	assert(position <= _tokens->size());
+
+	_nextToken = position;
+}
+
+Token LexerEngine::nextToken()
 {
 	auto result = peek();
 	
-	if(_nextToken != _tokens.end()) ++_nextToken;
+	if(!hitEndOfStream()) ++_nextToken;
 	
 	return result;
 }
 
-std::string LexerEngine::peek()
+Token LexerEngine::peek() const
 {
-	if(hitEndOfStream()) return "";
+	if(hitEndOfStream()) return Token();
 
-	std::string result(_nextToken->endPosition -
-		_nextToken->beginPosition, ' ');
+	auto& token = (*_tokens)[_nextToken];
 
-	stream->seekg(_nextToken->beginPosition);
-	
-	stream->read((char*)result.data(), result.size());
-	
-	return result;
+	return Token(_source + token.beginPosition,
+		token.endPosition - token.beginPosition, token.keyword);
 }
 
 bool LexerEngine::hitEndOfStream() const
 {
-	return _nextToken == _tokens.end();
+	return _nextToken >= _tokens->size();
 }
 
-void LexerEngine::_createTokens()
+unsigned int LexerEngine::keyword(const std::string& text) const
 {
-	_tokens.clear();
+	auto keyword = _keywordIds.find(text);
 
-	hydrazine::log("Lexer") << "Creating initial tokens...\n";
+	if(keyword == _keywordIds.end()) return Token::InvalidKeyword;
 
-	stream->seekg(0, std::ios::end);
-
-	size_t streamSize = stream->tellg();
+	return keyword->second;
+}
 
-	stream->seekg(0, std::ios::beg);
+const std::string& LexerEngine::keywordText(unsigned int keyword) const
+{
+	assert(keyword < _keywords.size());
 
-	for(size_t i = 0; i < streamSize; ++i)
-	{
-		_tokens.push_back(TokenDescriptor(this));
-			
-		_snext();
-	}
+	return _keywords[keyword];
 }
 
-void LexerEngine::_mergeTokens()
+size_t LexerEngine::line() const
 {
-	hydrazine::log("Lexer") << "Merging partial tokens together...\n";
+	if(hitEndOfStream()) return _endLine;
 
-	unsigned int counter = 0;
-	unsigned int unmatchedTokenCount = _tokens.size();
-	
-	while(true)
-	{
-		hydrazine::log("Lexer") << "============== Iteration "
-			<< counter++ << " ==============\n";
-
-		hydrazine::log("Lexer") << " Filtering out matched tokens:\n";
-		
-		// Filter out matched tokens
-		// Parallel for-all, start from previous unmatched count
-		unsigned int unmatchedCount = 0;
-		for(auto token = _tokens.begin(); token != _tokens.end(); ++token)
-		{
-			auto next = token; ++next;
-			
-			if(next != _tokens.end())
-			{
-				if(token->isMatched(*next)) continue;
-			}
-			else
-			{
-				if(token->isMatched()) continue;
-			}
-			
-			_filterWithNeighbors(token);
-			
-			bool isMatched = false;
-			
-			if(next != _tokens.end())
-			{
-				isMatched = token->isMatched(*next);
-			}
-			else
-			{
-				isMatched = token->isMatched();
-			}
-			
-			if(isMatched)
-			{
-				hydrazine::log("Lexer") << "  Token '" << token->getString()
-					<< "' after filtering matched rule '"
-					<< (*token->possibleMatches.begin())->toString()
-					<< "'\n";
-		
-				continue;
-			}
-			
-			++unmatchedCount;
-		}
+	return (*_tokens)[_nextToken].line;
+}
 
-		hydrazine::log("Lexer") << " unmatched token count "
-			<< unmatchedCount << "\n";
-		
-		if(unmatchedCount == 0) break;
-		
-		assertM(counter < 2 || unmatchedCount < unmatchedTokenCount,
-			"Lexing did not make enough progress during this iteration ("
-			<< unmatchedCount << " vs " << unmatchedTokenCount << ").");
-
-		unmatchedTokenCount = unmatchedCount;
-		
-		TokenVector newTokens;
-	
-		hydrazine::log("Lexer") << " Merging unmatched tokens with neighbors\n";
-		
-		// merge with neighbors
-		// Parallel for-all
-		for(auto token = _tokens.begin(); token != _tokens.end(); ++token)
-		{
-			auto next = token; ++next;
-			
-			if(next == _tokens.end())
-			{
-				if(token->isMatched())
-				{
-					newTokens.push_back(*token);
-					continue;
-				}
-			}
-			else
-			{
-				if(token->isMatched(*next))
-				{
-					newTokens.push_back(*token);
-					continue;
-				}
-			}
+size_t LexerEngine::column() const
+{
+	if(hitEndOfStream()) return _endColumn;
 
-			hydrazine::log("Lexer") << "  For unmatched token '"
-				<< token->getString() << "' "
-				<< (_isNewToken(token) ? " (starts new token)":"") << "\n";
-			
-			if(next == _tokens.end())
-			{
-				hydrazine::log("Lexer") << "   attempting to merge with "
-					"end of stream.\n";
-				newTokens.push_back(_mergeWithEnd(token));
-				
-				continue;
-			}
-			else
-			{
-				hydrazine::log("Lexer") << "   attempting to merge with '" <<
-					next->getString() << "'\n";
-				
-				if(_canMerge(token, next))
-				{
-					hydrazine::log("Lexer") << "    success: merging '"
-						<< token->getString() << "' with '"
-						<< next->getString() << "'\n";
-					
-					auto merged = _mergeWithNext(token, next);
-					
-					assertM(!merged.possibleMatches.empty(), 
-						"No possible matches for merged token '"
-						<< merged.getString() << "'");
-					
-					newTokens.push_back(merged);
-				}
-				else
-				{
-					hydrazine::log("Lexer") << "    failed\n";
-					newTokens.push_back(*token);
-					newTokens.push_back(*next );
-				}
-			}
-			
-			++token;
-		}
-		
-		// Update tokens
-		// Parallel stream compaction
-		_tokens = std::move(newTokens);
-	}
-	
-	_nextToken = _tokens.begin();
+	return (*_tokens)[_nextToken].column;
 }
 
-void LexerEngine::_removeWhitespace()
+void LexerEngine::_readStream()
 {
-	hydrazine::log("Lexer") << "Removing whitespace matches\n";
-				
-	RuleSet whitespaceRuleSet;
-	
-	for(auto& rule : whitespaceRules)
-	{
-		whitespaceRuleSet.insert(&rule);
-	}
-	
-	// Parallel remove + stream compact
-	TokenVector newTokens;
+	stream->clear();
+	stream->seekg(0, std::ios::beg);
 
-	for(auto& token : _tokens)
-	{
-		if(whitespaceRuleSet.count(token.getMatchedRule()) == 0)
-		{
-			hydrazine::log("Lexer") << " lexed '"
-				<< token.getString() << "'\n";
-			newTokens.push_back(token);
-		}
-		else
-		{
-			hydrazine::log("Lexer") << "  removed '"
-				<< token.getString() << "'\n";
-		}
-	}
-	
-	_tokens = std::move(newTokens);
+	_buffer = std::make_shared<std::string>(
+		std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>());
 
-	_nextToken = _tokens.begin();
+	_source     = _buffer->data();
+	_sourceSize = _buffer->size();
 }
 
-char LexerEngine::_snext()
+void LexerEngine::_compileRules()
 {
-	char c = stream->get();
+	if(_machineIsCompiled) return;
+
+	_machine.clear();
+
+	// Token rules win ties with whitespace
+	for(auto& rule : tokenRules)
+	{
+		_machine.addRule(rule);
+	}
 	
-	if(c == '\n')
+	for(auto& rule : whitespaceRules)
 	{
-		++line;
-		column = 0;
+		_machine.addRule(rule);
 	}
-	else
+
+	_machine.compile();
+
+	// A keyword is lexed by whichever rule wins its text, usually its own
+	_ruleKeywords.assign(_machine.rules(), std::vector<unsigned int>());
+
+	for(unsigned int keyword = 0; keyword < _keywords.size(); ++keyword)
 	{
-		++column;
+		auto& text = _keywords[keyword];
+
+		unsigned int rule = LexerStateMachine::InvalidRule;
+
+		size_t length = _machine.match(text.data(),
+			text.data() + text.size(), rule);
+
+		if(length != text.size()) continue;
+
+		_ruleKeywords[rule].push_back(keyword);
 	}
-	
-	return c;
+
+	_machineIsCompiled = true;
 }
 
-void LexerEngine::_filterWithNeighbors(const LexerContext& token)
+void LexerEngine::_createTokens()
 {
-	hydrazine::log("Lexer") << "  checking token possible matches for '" <<
-		token->getString() << "'\n";
-	
-	bool isNewToken = _isNewToken(token);
+	hydrazine::log("Lexer") << "Lexing " << _sourceSize
+		<< " characters...\n";
 
-	auto next = token; ++next;
-	
-	bool isTokenEnd = next == _tokens.end();
-	
-	if(!isTokenEnd)
-	{
-		isTokenEnd = !_isAMergePossible(token, next);
-	}
+	ChunkVector chunks;
 
-	hydrazine::log("Lexer") << "   possible matches for '" <<
-		token->getString() << "'"
-		<< (isNewToken ? " (starts new token)":"") 
-		<< (isTokenEnd ? " (ends current token)":"") << "\n";
+	_splitChunks(chunks);
 
-	LexerEngine::RuleSet remainingRules;
+	util::ThreadPool pool(chunks.size());
 
-	auto tokenString = token->getString();
+	hydrazine::log("Lexer") << " in " << chunks.size() << " pieces with "
+		<< pool.size() << " threads.\n";
 
-	for(auto rule : token->possibleMatches)
+	pool.parallelFor(chunks.size(), [&](size_t i)
 	{
-		if(isNewToken && !rule->canMatchWithBegin(tokenString))
-		{
-			hydrazine::log("Lexer") << "    filtered out rule '" <<
-				rule->toString() << "', can't match with begin.\n";;
+		_lexChunk(chunks[i]);
+	});
 
-			continue;
-		}
-		
-		if(isTokenEnd &&   !rule->canMatchWithEnd(tokenString))
-		{
-			hydrazine::log("Lexer") << "    filtered out rule '" <<
-				rule->toString() << "', can't match with end.\n";;
+	// Copies of the engine keep the tokens that they were made with
+	auto tokens = std::make_shared<TokenVector>();
 
-			continue;
-		}
-		
-		if(!rule->canMatch(tokenString))
-		{
-			hydrazine::log("Lexer") << "    filtered out rule '" <<
-				rule->toString() << "', can't at all.\n";;
+	_mergeChunks(chunks, pool, *tokens);
 
-			continue;
-		}
-		
-		hydrazine::log("Lexer") << "    '" << rule->toString() << "'\n";
-	
-		remainingRules.insert(rule);
-	}
-	
-	assertM(!remainingRules.empty(), "No possible matched for token '"
-		<< token->getString() << "'");
-	
-	token->possibleMatches = std::move(remainingRules);
-}
+	_tokens = tokens;
 
-LexerEngine::TokenDescriptor LexerEngine::_mergeWithEnd(
-	const LexerContext& token)
-{
-	auto string = token->getString();
-	
-	TokenDescriptor newToken(*token);
+	hydrazine::log("Lexer") << " lexed " << _tokens->size() << " tokens.\n";
 
-	hydrazine::log("Lexer") << "   possible matches:\n";
-	
-	for(auto rule : token->possibleMatches)
-	{
-		if(rule->canMatchWithEnd(string))
-		{
-			hydrazine::log("Lexer") << "    '" << rule->toString() << "'\n";
-			newToken.possibleMatches.insert(rule);
-		}
-	}
-	
-	if(newToken.isMatched())
-	{
-		hydrazine::log("Lexer") << "   Token '" << newToken.getString()
-			<< "' after merging with end matched rule '"
-			<< (*newToken.possibleMatches.begin())->toString()
-			<< "'\n";
-	}
-	
-	return newToken;
+	_nextToken = 0;
 }
 
-static LexerEngine::RuleSet intersection(const LexerEngine::RuleSet& left,
-	const LexerEngine::RuleSet& right)
+static size_t countPieces(size_t size, unsigned int threads)
 {
-	LexerEngine::RuleSet result;
-	
-	std::set_intersection(left.begin(), left.end(), right.begin(), right.end(),
-		std::inserter(result, result.end()));
-	
-	return result;
-}
+	if(threads == 0) threads = std::thread::hardware_concurrency();
+	if(threads == 0) threads = 1;
 
-LexerEngine::TokenDescriptor LexerEngine::_mergeWithNext(
-	const LexerContext& token,
-	const LexerContext& next)
-{
-	hydrazine::log("Lexer") << "   merging '" << token->getString()
-		<< "' with '" << next->getString() << "':\n";
-	
-	TokenDescriptor newToken(*token, *next);
-	
-	auto string = newToken.getString();
-	
-	// The set of possible matches is the intersection of the two tokens
-	auto possibleMatches = intersection(token->possibleMatches,
-		next->possibleMatches);
-	
-	// Only keep matches that handle the combined string
-	hydrazine::log("Lexer") << "    possible rule matches:\n";
-	for(auto rule : possibleMatches)
-	{
-		if(rule->canMatch(string))
-		{
-			hydrazine::log("Lexer") << "     '" << rule->toString() << "'\n";
-			newToken.possibleMatches.insert(rule);
-		}
-	}
-	
-	if(newToken.isMatched())
-	{
-		hydrazine::log("Lexer") << "   Token '" << newToken.getString()
-			<< "' after merging matched rule '"
-			<< (*newToken.possibleMatches.begin())->toString()
-			<< "'\n";
-	}
-	
-	return newToken;
-}
+	size_t pieces = size / LexerEngine::MinimumChunkSize;
 
-bool LexerEngine::_isAMergePossible(
-	const LexerContext& token,
-	const LexerContext& next)
-{
-	hydrazine::log("Lexer") << "   checking if '" << token->getString()
-		<< "' can merge with '" << next->getString() << "':\n";
-	
-	auto possibleMatches = intersection(token->possibleMatches,
-		next->possibleMatches);
-		
-	if(possibleMatches.empty())
-	{
-		hydrazine::log("Lexer") << "    can't merge, no shared rules.\n";
-		return false;
-	}
-	
-	hydrazine::log("Lexer") << "    merge is possible.\n";
-	return true;
-}
+	if(pieces > threads) pieces = threads;
 
-bool LexerEngine::_canMerge(
-	const LexerContext& token,
-	const LexerContext& next)
-{
-	// Can merge if the right token cannot start a new token
-	if(!_couldBeTokenBegin(next))
-	{
-		return true;
-	}
-	
-	// Can't merge if there is ambiguity about the left being a token end
-	if(_couldBeTokenEnd(token))
-	{
-		bool canStillMerge = false;
-
-		// allow 't' to join with 'arget', even though 't' matches the end
-		canStillMerge |= _formsLargerMatchOfTheSameRule(token, next);
-		
-		// allow '%' to join with '_identifier', if '%' is a rule
-		// TODO: add general purpose way of handling short rules that are subsets
-		//       of longer rules
-		canStillMerge |= _nextCantMatchOtherwise(token, next);
-	
-		if(!canStillMerge)
-		{
-			hydrazine::log("Lexer") << "     can't merge, "
-				"left could be a token end ("
-				<< _getRuleThatMatchesWithEnd(token)->toString() << ").\n";
-			return false;
-		}
-		
-	}
-	
-	// Or the right being a token begin
-	if(!_isNewToken(token) && !token->isBeginMatched())
-	{
-		if(_couldBeTokenBegin(next))
-		{
-			hydrazine::log("Lexer") << "     can't merge, "
-				"right could be a token begin ("
-				<< _getRuleThatMatchesWithBegin(next)->toString() << ").\n";
-			return false;
-		}
-	}
-	
-	return true;
+	return pieces == 0 ? 1 : pieces;
 }
 
-bool LexerEngine::_isNewToken(const LexerContext& token)
+void LexerEngine::_splitChunks(ChunkVector& chunks) const
 {
-	bool isNewToken = (token == _tokens.begin());
+	size_t pieces = countPieces(_sourceSize, threads);
+	size_t begin  = 0;
 
-	if(!isNewToken)
+	// Split after separators, tokens never span them
+	for(size_t piece = 1; piece < pieces; ++piece)
 	{
-		auto previous = token; --previous;
-		
-		if(previous->isEndMatched())
+		size_t split = std::max(begin, piece * _sourceSize / pieces);
+
+		while(split < _sourceSize && !_machine.isSeparator(_source[split]))
 		{
-			return true;
+			++split;
 		}
+
+		if(split >= _sourceSize) break;
+
+		chunks.push_back(Chunk(begin, split + 1));
+
+		begin = split + 1;
 	}
-	
-	return isNewToken;
-}	
 
-bool LexerEngine::_couldBeTokenEnd(const LexerContext& token)
-{
-	return _getRuleThatMatchesWithEnd(token) != nullptr;
+	chunks.push_back(Chunk(begin, _sourceSize));
 }
 
-bool LexerEngine::_couldBeTokenBegin(const LexerContext& token)
+void LexerEngine::_lexChunk(Chunk& chunk) const
 {
-	return _getRuleThatMatchesWithBegin(token) != nullptr;
-}
+	const char* begin = _source + chunk.begin;
+	const char* end   = _source + chunk.end;
 
-bool LexerEngine::_formsLargerMatchOfTheSameRule(
-	const LexerContext& left,
-	const LexerContext& right)
-{
-	auto string = left->getString();
+	size_t line   = 0;
+	size_t column = 0;
 
-	// find end matching rules
-	RuleSet endMatchingRules;
+	const char* position = begin;
 
-	for(auto rule : left->possibleMatches)
+	while(position != end)
 	{
-		if(rule->canMatchWithEnd(string))
-		{
-			endMatchingRules.insert(rule);
-		}
-	}
+		unsigned int rule = LexerStateMachine::InvalidRule;
 
-	auto combined = string + right->getString();
+		size_t length = _machine.match(position, end, rule);
 
-	if(_isNewToken(left))
-	{
-		// Does at least one of the rules still match the merged token
-		bool atLeastOneMatch = false;
+		if(length == 0) break;
 
-		for(auto rule : endMatchingRules)
+		if(rule < tokenRules.size())
 		{
-			hydrazine::log("Lexer") << "      checking rule '"
-				<< rule->toString() << "' against '" << combined << "'\n";
-			
-			if(rule->isExactMatch(string))
+			unsigned int keyword = Token::InvalidKeyword;
+
+			for(auto candidate : _ruleKeywords[rule])
 			{
-				if(rule->isExactMatch(combined))
+				auto& text = _keywords[candidate];
+
+				if(text.size() == length &&
+					std::memcmp(text.data(), position, length) == 0)
 				{
-					hydrazine::log("Lexer") << "      exact match\n";
-					atLeastOneMatch = true;
+					keyword = candidate;
 					break;
 				}
 			}
-		}
 
-		if(atLeastOneMatch) return true;
-
-		// find begin matching rules
-		RuleSet beginMatchingRules;
-
-		for(auto rule : left->possibleMatches)
-		{
-			if(rule->canMatchWithBegin(string) && !rule->isExactMatch(string))
-			{
-				beginMatchingRules.insert(rule);
-			}
-		}
-		
-		for(auto rule : beginMatchingRules)
-		{
-			if(rule->canMatchWithBegin(combined))
-			{
-				hydrazine::log("Lexer") << "      match with begin\n";
-				atLeastOneMatch = true;
-				break;
-			}
+			chunk.tokens.push_back(TokenDescriptor(position - _source,
+				position - _source + length, line, column, keyword));
 		}
 
-		return atLeastOneMatch;
-	}
-	else
-	{
-		// Do all of the rules still match the merged token?
-		for(auto rule : endMatchingRules)
+		for(const char* next = position + length; position != next; ++position)
 		{
-			hydrazine::log("Lexer") << "      checking rule "
-				<< rule->toString() << " against " << combined << "\n";
-			
-			if(!rule->canMatch(combined))
+			if(*position == '\n')
 			{
-				hydrazine::log("Lexer") << "      failed\n";
-				return false;
+				++line;
+				column = 0;
 			}
-
-			if(rule->isExactMatch(string) && !rule->isExactMatch(combined))
+			else
 			{
-				hydrazine::log("Lexer")
-					<< "      failed, not exact match with ("
-					<< rule->toString() << ")\n";
-				return false;
+				++column;
 			}
 		}
 	}
 
-	return true;
+	chunk.endLine       = line;
+	chunk.endColumn     = column;
+	chunk.errorPosition = position - _source;
 }
 
-bool LexerEngine::_nextCantMatchOtherwise(
-	const LexerContext& left,
-	const LexerContext& right)
+void LexerEngine::_mergeChunks(ChunkVector& chunks, util::ThreadPool& pool,
+	TokenVector& result)
 {
-	return false;
-}
+	typedef std::vector<size_t> SizeVector;
 
-const LexerRule* LexerEngine::_getRuleThatMatchesWithBegin(
-	const LexerContext& token) const
-{
-	auto string = token->getString();
-	
-	for(auto rule : token->possibleMatches)
-	{
-		if(rule->canMatchWithBegin(string)) return rule;
-	}
-	
-	return nullptr;
-}
-
-const LexerRule* LexerEngine::_getRuleThatMatchesWithEnd(
-	const LexerContext& token) const
-{
-	auto string = token->getString();
-	
-	for(auto rule : token->possibleMatches)
-	{
-		if(rule->canMatchWithEnd(string)) return rule;
-	}
-	
-	return nullptr;
-}
+	SizeVector tokenOffsets(chunks.size());
+	SizeVector lines(chunks.size());
+	SizeVector columns(chunks.size());
 
-LexerEngine::TokenDescriptor::TokenDescriptor(LexerEngine* e)
-: beginPosition(e->stream->tellg()),
-  endPosition((size_t)e->stream->tellg() + 1),
-  line(e->line), column(e->column), engine(e), tokenIsMatched(false)
-{
-	hydrazine::log("Lexer") << " created new token '"
-		<< getString() << "'\n";
+	size_t tokens = 0;
+	size_t line   = 0;
+	size_t column = 0;
 
-	for(auto& rule : engine->tokenRules)
+	// Chunk positions are relative to the end of the previous chunk
+	for(size_t i = 0; i < chunks.size(); ++i)
 	{
-		hydrazine::log("Lexer") << "  could match rule '"
-			<< rule.toString() << "'\n";
-		possibleMatches.insert(&rule);
-	}
-	
-	for(auto& rule : engine->whitespaceRules)
-	{
-		hydrazine::log("Lexer") << "  could match rule '"
-			<< rule.toString() << "'\n";
-		possibleMatches.insert(&rule);
-	}
-	
-	if(isMatched())
-	{
-		hydrazine::log("Lexer") << "  Token '" << getString()
-			<< "' during creation matched rule '" << getMatchedRule()->toString()
-			<< "'\n";
-	}
-}
+		auto& chunk = chunks[i];
 
-LexerEngine::TokenDescriptor::TokenDescriptor(const TokenDescriptor& left,
-	const TokenDescriptor& right)
-: beginPosition(left.beginPosition),
-  endPosition(right.endPosition),
-  line(left.line), column(right.column), engine(left.engine),
-  tokenIsMatched(false)
-{
-	assert(left.endPosition == right.beginPosition);
-}
+		tokenOffsets[i] = tokens;
+		lines[i]        = line;
+		columns[i]      = column;
 
-bool LexerEngine::TokenDescriptor::isBeginMatched() const
-{
-	assertM(!possibleMatches.empty(), "No possible matched for token '"
-		<< getString() << "'");
-	
-	if(possibleMatches.size() > 1) return false;
-
-	auto firstRule = (*possibleMatches.begin());
-
-	return firstRule->canOnlyMatchWithBegin(getString());
-}
-
-bool LexerEngine::TokenDescriptor::isEndMatched() const
-{
-	assertM(!possibleMatches.empty(), "No possible matched for token '"
-		<< getString() << "'");
-		
-	if(isMatched())
-	{
-		return true;
-	}
-
-	if(possibleMatches.size() > 1) return false;
-
-	auto firstRule = (*possibleMatches.begin());
-
-	if(firstRule->isEndRepeated()) return false;
-
-	return firstRule->canOnlyMatchWithEnd(getString());
-}
-
-size_t LexerEngine::TokenDescriptor::size() const
-{
-	return endPosition - beginPosition;
-}
+		if(chunk.endLine == 0)
+		{
+			column += chunk.endColumn;
+		}
+		else
+		{
+			column = chunk.endColumn;
+		}
 
-bool LexerEngine::TokenDescriptor::isMatched() const
-{
-	assertM(!possibleMatches.empty(), "No possible matched for token '"
-		<< getString() << "'");
-	
-	if(tokenIsMatched) return true;
-		
-	if(possibleMatches.size() > 1) return false;
+		line   += chunk.endLine;
+		tokens += chunk.tokens.size();
 
-	auto firstRule = (*possibleMatches.begin());
+		// The first failure is the one a sequential lexer would report
+		if(chunk.errorPosition != chunk.end)
+		{
+			std::stringstream message;
 
-	if(firstRule->isEndRepeated()) return false;
+			message << "(" << line << ":" << column
+				<< "): no lexer rule matches '"
+				<< _source[chunk.errorPosition] << "'";
 
-	bool match = firstRule->isExactMatch(getString());
+			throw std::runtime_error(message.str());
+		}
+	}
 
-	return match;
-}
+	_endLine   = line;
+	_endColumn = column;
 
-bool LexerEngine::TokenDescriptor::isMatched()
-{
-	if(const_cast<const TokenDescriptor*>(this)->isMatched())
+	if(chunks.size() == 1)
 	{
-		if(!tokenIsMatched)
-		{
-			tokenIsMatched = true;
-			hydrazine::log("Lexer") << "  Token '" << getString()
-				<< "' is matched exactly\n";
-		}
+		result.swap(chunks.front().tokens);
+		return;
 	}
 
-	return tokenIsMatched;
-}
+	result.resize(tokens, TokenDescriptor(0, 0, 0, 0, Token::InvalidKeyword));
 
-bool LexerEngine::TokenDescriptor::isMatched(const TokenDescriptor& next)
-{
-	if(tokenIsMatched) return true;
-	
-	if(possibleMatches.size() > 1) return false;
-	
-	auto firstRule = (*possibleMatches.begin());
-	
-	auto string = getString();
-
-	if(firstRule->isExactMatch(string))
+	pool.parallelFor(chunks.size(), [&](size_t i)
 	{
-		if(firstRule->isEndRepeated())
+		auto& chunk = chunks[i];
+
+		auto output = result.begin() + tokenOffsets[i];
+
+		for(auto& token : chunk.tokens)
 		{
-			auto combined = string + next.getString();
+			if(token.line == 0) token.column += columns[i];
 
-			if(firstRule->isExactMatch(combined))
-			{
-				return false;
-			}
-		}
-		
-		hydrazine::log("Lexer") << "  Token '" << getString()
-			<< "' is matched exactly when considering next token '"
-			<< next.getString() << "'\n";
-		
-		tokenIsMatched = true;
-		return true;
-	}
+			token.line += lines[i];
 
-	return false;
+			*output++ = token;
+		}
 
+		TokenVector().swap(chunk.tokens);
+	});
 }
 
-LexerRule* LexerEngine::TokenDescriptor::getMatchedRule()
+LexerEngine::Chunk::Chunk(size_t b, size_t e)
+: begin(b), end(e), tokens(), endLine(0), endColumn(0), errorPosition(e)
 {
-	assertM(!possibleMatches.empty(), "No possible matched for token '"
-		<< getString() << "'");
-		
-	if(possibleMatches.size() == 1) return *possibleMatches.begin();
 
-	return nullptr;
 }
 
-std::string LexerEngine::TokenDescriptor::getString() const
+LexerEngine::TokenDescriptor::TokenDescriptor(size_t b, size_t e,
+	size_t l, size_t c, unsigned int k)
+: beginPosition(b), endPosition(e), line(l), column(c), keyword(k)
 {
-	auto mutableEngine = const_cast<LexerEngine*>(engine);
-
-	std::string result(size(), ' ');
 
-	auto position = mutableEngine->stream->tellg();
-
-	mutableEngine->stream->seekg(beginPosition, std::ios::beg);
-	
-	mutableEngine->stream->read((char*)(result.data()), size());
-
-	mutableEngine->stream->seekg(position, std::ios::beg);
-	
-	return result;
 }
 
 }
 
 }
 
-
@@ -297,6 +297,9 @@ public:
 public:
 	virtual bool isRepeated() const;
 
+public:
+	const Character* subCharacter() const;
+
 public:
 	virtual Character* clone() const;
 
@@ -368,6 +371,11 @@ bool RepeatedCharacter::isRepeated() const
 	return true;
 }
 
+const LexerRule::Character* RepeatedCharacter::subCharacter() const
+{
+	return _subCharacter;
+}
+
 LexerRule::Character* RepeatedCharacter::clone() const
 {
 	return new RepeatedCharacter(*this);
@@ -745,6 +753,52 @@ void LexerRule::_formRegex(const_iterator& begin, const_iterator end)
 	}
 }
 
+static LexerRule::Element::CharacterSet getMatchingCharacters(
+	const LexerRule::Character* character)
+{
+	LexerRule::Element::CharacterSet characters;
+
+	for(unsigned int value = 0; value < characters.size(); ++value)
+	{
+		std::string text(1, (char)value);
+
+		std::string::const_iterator position = text.begin();
+
+		if(character->matches(position, text.end()))
+		{
+			characters.set(value);
+		}
+	}
+
+	return characters;
+}
+
+LexerRule::ElementVector LexerRule::elements() const
+{
+	ElementVector result;
+
+	for(const Character* character : _regex)
+	{
+		Element element;
+
+		element.isRepeated = false;
+
+		// A repeated repetition is the same as a single one
+		while(auto repeated = dynamic_cast<const RepeatedCharacter*>(character))
+		{
+			element.isRepeated = true;
+
+			character = repeated->subCharacter();
+		}
+
+		element.characters = getMatchingCharacters(character);
+
+		result.push_back(element);
+	}
+
+	return result;
+}
+
 bool LexerRule::_match(const_iterator& matchEnd,
 	const_regex_iterator& matchRuleEnd,
 	const_iterator begin, const_iterator end,
@@ -0,0 +1,370 @@
+/*! \file   LexerStateMachine.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the LexerStateMachine class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/parser/interface/LexerStateMachine.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <map>
+#include <algorithm>
+
+namespace vanaheimr
+{
+
+namespace parser
+{
+
+LexerStateMachine::LexerStateMachine()
+: _characterClasses(0), _startState(-1)
+{
+
+}
+
+void LexerStateMachine::addRule(const LexerRule& rule)
+{
+	_rules.push_back(rule.elements());
+}
+
+void LexerStateMachine::compile()
+{
+	hydrazine::log("Lexer") << "Compiling " << _rules.size()
+		<< " lexer rules into a DFA...\n";
+
+	_formCharacterClasses();
+	_formStates();
+	_minimize();
+	_formSeparators();
+
+	hydrazine::log("Lexer") << " " << _characterClasses
+		<< " character classes, " << states() << " states, "
+		<< _separators.count() << " separators.\n";
+}
+
+void LexerStateMachine::clear()
+{
+	_rules.clear();
+	_characterClass.clear();
+	_classRepresentative.clear();
+	_transitions.clear();
+	_acceptedRules.clear();
+
+	_separators.reset();
+
+	_characterClasses = 0;
+	_startState       = -1;
+}
+
+size_t LexerStateMachine::rules() const
+{
+	return _rules.size();
+}
+
+size_t LexerStateMachine::states() const
+{
+	return _acceptedRules.size();
+}
+
+LexerStateMachine::Item::Item(unsigned int r, unsigned int p)
+: rule(r), position(p)
+{
+
+}
+
+bool LexerStateMachine::Item::operator<(const Item& item) const
+{
+	if(rule != item.rule) return rule < item.rule;
+
+	return position < item.position;
+}
+
+bool LexerStateMachine::Item::operator==(const Item& item) const
+{
+	return rule == item.rule && position == item.position;
+}
+
+void LexerStateMachine::_formCharacterClasses()
+{
+	typedef std::vector<bool> Signature;
+	typedef std::map<Signature, uint8_t> SignatureMap;
+
+	SignatureMap classes;
+
+	_characterClass.assign(256, 0);
+	_classRepresentative.clear();
+
+	// Characters belong to the same class if every element treats them alike
+	for(unsigned int character = 0; character < 256; ++character)
+	{
+		Signature signature;
+
+		for(auto& rule : _rules)
+		{
+			for(auto& element : rule)
+			{
+				signature.push_back(element.characters.test(character));
+			}
+		}
+
+		auto characterClass = classes.find(signature);
+
+		if(characterClass == classes.end())
+		{
+			characterClass = classes.insert(std::make_pair(signature,
+				_classRepresentative.size())).first;
+
+			_classRepresentative.push_back(character);
+		}
+
+		_characterClass[character] = characterClass->second;
+	}
+
+	_characterClasses = _classRepresentative.size();
+}
+
+void LexerStateMachine::_formStates()
+{
+	typedef std::map<ItemVector, int32_t> StateMap;
+	typedef std::vector<ItemVector>       ItemSetVector;
+
+	StateMap      stateIds;
+	ItemSetVector itemSets;
+
+	_transitions.clear();
+	_acceptedRules.clear();
+
+	ItemVector start;
+
+	for(unsigned int rule = 0; rule < _rules.size(); ++rule)
+	{
+		start.push_back(Item(rule, 0));
+	}
+
+	_close(start);
+
+	stateIds.insert(std::make_pair(start, 0));
+	itemSets.push_back(start);
+
+	// Subset construction, every new set of items is a new state
+	for(size_t state = 0; state < itemSets.size(); ++state)
+	{
+		ItemVector items = itemSets[state];
+
+		for(unsigned int c = 0; c < _characterClasses; ++c)
+		{
+			ItemVector next = _move(items, c);
+
+			if(next.empty())
+			{
+				_transitions.push_back(-1);
+				continue;
+			}
+
+			auto nextState = stateIds.find(next);
+
+			if(nextState == stateIds.end())
+			{
+				nextState = stateIds.insert(std::make_pair(next,
+					(int32_t)itemSets.size())).first;
+
+				itemSets.push_back(next);
+			}
+
+			_transitions.push_back(nextState->second);
+		}
+
+		_acceptedRules.push_back(_getAcceptedRule(items));
+	}
+
+	_startState = 0;
+}
+
+void LexerStateMachine::_minimize()
+{
+	typedef std::vector<int64_t>                Signature;
+	typedef std::map<Signature, unsigned int>   SignatureMap;
+	typedef std::vector<unsigned int>           BlockVector;
+
+	size_t stateCount = states();
+
+	// Start with states that accept the same rule in the same block
+	BlockVector blocks(stateCount);
+
+	std::map<unsigned int, unsigned int> acceptedBlocks;
+
+	for(size_t state = 0; state < stateCount; ++state)
+	{
+		blocks[state] = acceptedBlocks.insert(std::make_pair(
+			_acceptedRules[state], acceptedBlocks.size())).first->second;
+	}
+
+	size_t blockCount = acceptedBlocks.size();
+
+	// Split blocks by where their transitions go until nothing changes
+	while(true)
+	{
+		SignatureMap signatures;
+		BlockVector  newBlocks(stateCount);
+
+		for(size_t state = 0; state < stateCount; ++state)
+		{
+			Signature signature(1, blocks[state]);
+
+			for(unsigned int c = 0; c < _characterClasses; ++c)
+			{
+				int32_t next = _transitions[state * _characterClasses + c];
+
+				signature.push_back(next < 0 ? -1 : blocks[next]);
+			}
+
+			newBlocks[state] = signatures.insert(std::make_pair(signature,
+				signatures.size())).first->second;
+		}
+
+		blocks = std::move(newBlocks);
+
+		if(signatures.size() == blockCount) break;
+
+		blockCount = signatures.size();
+	}
+
+	StateVector  transitions(blockCount * _characterClasses);
+	RuleIdVector acceptedRules(blockCount);
+
+	for(size_t state = 0; state < stateCount; ++state)
+	{
+		unsigned int block = blocks[state];
+
+		for(unsigned int c = 0; c < _characterClasses; ++c)
+		{
+			int32_t next = _transitions[state * _characterClasses + c];
+
+			transitions[block * _characterClasses + c] =
+				next < 0 ? -1 : blocks[next];
+		}
+
+		acceptedRules[block] = _acceptedRules[state];
+	}
+
+	_transitions   = std::move(transitions);
+	_acceptedRules = std::move(acceptedRules);
+	_startState    = blocks[_startState];
+}
+
+void LexerStateMachine::_formSeparators()
+{
+	_separators.reset();
+
+	// A token could restart in the middle of another one
+	for(auto next : _transitions)
+	{
+		if(next == _startState) return;
+	}
+
+	for(unsigned int c = 0; c < _characterClasses; ++c)
+	{
+		// Only the start state may consume a separator...
+		bool isSeparator = true;
+
+		for(size_t state = 0; state < states(); ++state)
+		{
+			if((int32_t)state == _startState) continue;
+
+			if(_transitions[state * _characterClasses + c] >= 0)
+			{
+				isSeparator = false;
+				break;
+			}
+		}
+
+		int32_t next = _transitions[_startState * _characterClasses + c];
+
+		if(!isSeparator || next < 0) continue;
+
+		// ...and the result must be a complete token that cannot grow
+		if(_acceptedRules[next] == InvalidRule) continue;
+
+		for(unsigned int d = 0; d < _characterClasses; ++d)
+		{
+			if(_transitions[next * _characterClasses + d] >= 0)
+			{
+				isSeparator = false;
+				break;
+			}
+		}
+
+		if(!isSeparator) continue;
+
+		for(unsigned int character = 0; character < 256; ++character)
+		{
+			if(_characterClass[character] == c) _separators.set(character);
+		}
+	}
+}
+
+void LexerStateMachine::_close(ItemVector& items) const
+{
+	size_t originalSize = items.size();
+
+	// Repeated elements may match nothing, so they can be skipped
+	for(size_t i = 0; i < originalSize; ++i)
+	{
+		auto& rule = _rules[items[i].rule];
+
+		for(unsigned int position = items[i].position;
+			position < rule.size() && rule[position].isRepeated; ++position)
+		{
+			items.push_back(Item(items[i].rule, position + 1));
+		}
+	}
+
+	std::sort(items.begin(), items.end());
+	items.erase(std::unique(items.begin(), items.end()), items.end());
+}
+
+LexerStateMachine::ItemVector LexerStateMachine::_move(
+	const ItemVector& items, unsigned int characterClass) const
+{
+	ItemVector next;
+
+	uint8_t character = _classRepresentative[characterClass];
+
+	for(auto& item : items)
+	{
+		auto& rule = _rules[item.rule];
+
+		if(item.position == rule.size()) continue;
+
+		auto& element = rule[item.position];
+
+		if(!element.characters.test(character)) continue;
+
+		next.push_back(Item(item.rule,
+			element.isRepeated ? item.position : item.position + 1));
+	}
+
+	_close(next);
+
+	return next;
+}
+
+unsigned int LexerStateMachine::_getAcceptedRule(const ItemVector& items) const
+{
+	// Items are sorted by rule, so the first complete one has priority
+	for(auto& item : items)
+	{
+		if(item.position == _rules[item.rule].size()) return item.rule;
+	}
+
+	return InvalidRule;
+}
+
+}
+
+}
+
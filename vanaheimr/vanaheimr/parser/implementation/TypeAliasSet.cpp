@@ -25,11 +25,50 @@ const ir::Type* TypeAliasSet::getType(const std::string& name) const
 void TypeAliasSet::addAlias(const std::string& name, const ir::Type* type)
 {
 	_types[name] = type;
+
+	std::lock_guard<std::mutex> lock(_parsedTypeMutex);
+
+	_parsedTypesWithAliases.clear();
 }
 
 void TypeAliasSet::clear()
 {
 	_types.clear();
+
+	std::lock_guard<std::mutex> lock(_parsedTypeMutex);
+
+	_parsedTypes.clear();
+	_parsedTypesWithAliases.clear();
+}
+
+ir::Type* TypeAliasSet::getParsedType(const std::string& spelling) const
+{
+	std::lock_guard<std::mutex> lock(_parsedTypeMutex);
+
+	auto type = _parsedTypes.find(spelling);
+
+	if(type != _parsedTypes.end()) return type->second;
+
+	type = _parsedTypesWithAliases.find(spelling);
+
+	if(type != _parsedTypesWithAliases.end()) return type->second;
+
+	return nullptr;
+}
+
+void TypeAliasSet::addParsedType(const std::string& spelling, ir::Type* type,
+	bool usesAliases) const
+{
+	std::lock_guard<std::mutex> lock(_parsedTypeMutex);
+
+	if(usesAliases)
+	{
+		_parsedTypesWithAliases[spelling] = type;
+	}
+	else
+	{
+		_parsedTypes[spelling] = type;
+	}
 }
 
 }
@@ -26,7 +26,8 @@ namespace parser
 {
 
 TypeParser::TypeParser(Compiler* c, const TypeAliasSet* a)
-: _compiler(c), _parsedType(nullptr), _typedefs(a), _lexer(nullptr)
+: _compiler(c), _parsedType(nullptr), _typedefs(a), _usesAliases(false),
+  _lexer(nullptr)
 {
 
 }
@@ -43,7 +44,7 @@ void TypeParser::parse(std::istream* stream)
 	_lexer = new Lexer();
 	_lexer->setStream(stream);
 	
-	_parsedType = _parseType();
+	_parsedType = _parseCachedType();
 
 	delete _lexer; _lexer = nullptr;
 }
@@ -54,7 +55,7 @@ void TypeParser::parse(Lexer* lexer)
 
 	_lexer = lexer;
 	
-	_parsedType = _parseType();
+	_parsedType = _parseCachedType();
 
 	_lexer = nullptr;
 }
@@ -66,6 +67,132 @@ const ir::Type* TypeParser::parsedType() const
 	return _parsedType;
 }
 
+static bool isOpenBracket(const Token& token)
+{
+	return token == "(" || token == "[" || token == "{";
+}
+
+static bool isCloseBracket(const Token& token)
+{
+	return token == ")" || token == "]" || token == "}";
+}
+
+static void appendToken(std::string& spelling, const Token& token)
+{
+	if(!spelling.empty()) spelling.push_back(' ');
+
+	spelling.append(token.data(), token.size());
+}
+
+static bool skipBrackets(Lexer* lexer, std::string& spelling)
+{
+	unsigned int depth = 0;
+
+	do
+	{
+		if(lexer->hitEndOfStream()) return false;
+
+		auto token = lexer->consumeToken();
+
+		appendToken(spelling, token);
+
+		if(isOpenBracket(token))
+		{
+			++depth;
+		}
+		else if(isCloseBracket(token))
+		{
+			if(depth == 0) return false;
+
+			--depth;
+		}
+	}
+	while(depth > 0);
+
+	return true;
+}
+
+ir::Type* TypeParser::_parseCachedType()
+{
+	if(_typedefs == nullptr) return _parseType();
+
+	size_t begin = _lexer->position();
+
+	std::string spelling;
+
+	bool isComplete = _getTypeSpelling(spelling);
+
+	if(isComplete)
+	{
+		auto type = _typedefs->getParsedType(spelling);
+
+		if(type != nullptr) return type;
+	}
+
+	size_t end = _lexer->position();
+
+	_lexer->seek(begin);
+
+	_usesAliases = false;
+
+	auto type = _parseType();
+
+	// Only cache the type if the parser read exactly the spelling
+	if(isComplete && _lexer->position() == end)
+	{
+		_typedefs->addParsedType(spelling, type, _usesAliases);
+	}
+
+	return type;
+}
+
+bool TypeParser::_getTypeSpelling(std::string& spelling)
+{
+	if(_lexer->hitEndOfStream()) return false;
+
+	auto token = _lexer->peekToken();
+
+	if(token == "(")
+	{
+		// (return type) (arguments)
+		if(!skipBrackets(_lexer, spelling)) return false;
+		if(!skipBrackets(_lexer, spelling)) return false;
+	}
+	else if(isOpenBracket(token))
+	{
+		if(!skipBrackets(_lexer, spelling)) return false;
+	}
+	else if(isCloseBracket(token))
+	{
+		return false;
+	}
+	else
+	{
+		appendToken(spelling, _lexer->consumeToken());
+
+		// '%' may be lexed apart from the alias name
+		if(token == "%")
+		{
+			if(_lexer->hitEndOfStream()) return false;
+
+			appendToken(spelling, _lexer->consumeToken());
+		}
+
+		// A function returning this type
+		if(!_lexer->hitEndOfStream() && _lexer->peekToken() == "(")
+		{
+			if(!skipBrackets(_lexer, spelling)) return false;
+		}
+	}
+
+	while(!_lexer->hitEndOfStream() && _lexer->peekToken() == "*")
+	{
+		appendToken(spelling, _lexer->consumeToken());
+	}
+
+	return true;
+}
+
 static bool isFunction(const std::string& token)
 {
 	return token.find("(") == 0;
@@ -278,7 +405,8 @@ ir::Type* TypeParser::_parseFunction(const ir::Type* returnType)
 			"type, expecting ')'.");
 	}
 
-	return new ir::FunctionType(_compiler, returnType, argumentTypes);
+	return *_compiler->getOrInsertType(ir::FunctionType(
+		_compiler, returnType, argumentTypes));
 }
 
 
@@ -399,18 +527,26 @@ ir::Type* TypeParser::_parsePrimitive()
 
 ir::Type* TypeParser::_parseTypeAlias()
 {
-	if(!_lexer->scan("%"))
+	std::string token = _lexer->nextToken();
+
+	if(token.find("%") != 0)
 	{
 		throw std::runtime_error("Failed to parse type alias, expecting '%'.");
 	}
-	
-	if(_lexer->hitEndOfStream())
+
+	// The name may be lexed as part of the same token
+	token = token.substr(1);
+
+	if(token.empty())
 	{
-		throw std::runtime_error("Hit end of stream while "
-			"searching for primitive type.");
-	}
+		if(_lexer->hitEndOfStream())
+		{
+			throw std::runtime_error("Hit end of stream while "
+				"searching for primitive type.");
+		}
 	
-	std::string token = _lexer->nextToken();
+		token = _lexer->nextToken();
+	}
 	
 	auto alias = _getTypeAlias(token);
 
@@ -427,6 +563,8 @@ ir::Type* TypeParser::_getTypeAlias(const std::string& token)
 {
 	if(_typedefs == nullptr) return nullptr;
 
+	_usesAliases = true;
+
 	auto type = _typedefs->getType(token);
 
  	if(type != nullptr) return *_compiler->getOrInsertType(*type);
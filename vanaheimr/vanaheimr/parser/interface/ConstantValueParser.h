@@ -40,6 +40,10 @@ public:
 public:
 	const ir::Constant* parsedConstant() const;
 
+	/*! \brief Hand the parsed constant to the caller, avoids copying
+		large initializers */
+	ir::Constant* releaseParsedConstant();
+
 private:
 	// Specialized Parsing
 	ir::Constant* _parseConstant();
@@ -48,6 +52,7 @@ private:
 	ir::Constant* _parseIntegerConstant();
 	ir::Constant* _parseFloatingPointConstant();
 	ir::Constant* _parseStringConstant(const ir::Type* type);
+	ir::Constant* _parseArrayConstant(const ir::Type* type);
 
 private:
 	ir::Constant* _parsedConstant;
@@ -25,7 +25,9 @@ public:
 	typedef compiler::Compiler Compiler;
 
 public:
-	LLVMParser(Compiler* compiler);
+	/*! \brief Function bodies are parsed by 'threads' threads, 0 uses
+		the hardware concurrency */
+	LLVMParser(Compiler* compiler, unsigned int threads = 0);
 
 public:
 	void parse(const std::string& filename);
@@ -36,6 +38,7 @@ public:
 private:
 	compiler::Compiler* _compiler;
 	std::string         _moduleName;
+	unsigned int        _threads;
 
 };
 
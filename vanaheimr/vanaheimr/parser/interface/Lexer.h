@@ -6,6 +6,9 @@
 
 #pragma once
 
+// Vanaheimr Includes
+#include <vanaheimr/parser/interface/Token.h>
+
 // Forward Declarations
 namespace vanaheimr { namespace parser { class LexerEngine; } }
 
@@ -30,6 +33,8 @@ public:
 	~Lexer();
 
 public:
+	/*! \brief A copy shares the lexed tokens but has its own position,
+		so copies can be read by different threads */
 	Lexer(const Lexer& );
 	Lexer& operator=(const Lexer&) = delete;
 
@@ -37,9 +42,23 @@ public:
 	/*! brief Set the stream being lexed */
 	void setStream(std::istream* stream);	
 
+	/*! \brief Lex a memory mapped file rather than a copy of a stream */
+	void setFile(const std::string& path);
+
+	/*! \brief Set the number of threads used to lex large sources
+
+		Sources over a megabyte are split after characters that are always
+		tokens of their own (e.g. newlines) and the pieces are lexed in
+		parallel.  0 (the default) uses the hardware concurrency.
+	*/
+	void setThreads(unsigned int threads);
+
 public:
 	/*! \brief Add a rule for lexing whitespace */
 	void addWhitespaceRules(const std::string& whitespaceCharacters);	
+	/*! \brief Add a rule for text that is skipped like whitespace,
+		e.g. comments */
+	void addWhitespaceRegex(const std::string& regex);
 	
 	/*! \brief Add a set of rules for lexing tokens */
 	void addTokens(const StringList& regexes);
@@ -57,16 +76,39 @@ public:
 	void scanThrow(const std::string& token);
 	bool scanPeek(const std::string& token);
 
+public:
+	/*! \brief Views of the source text, these never allocate */
+	Token peekToken() const;
+	Token consumeToken();
+
+public:
+	/*! \brief The id of a literal token rule, InvalidKeyword if there is
+		no rule that matches exactly this text */
+	unsigned int keyword(const std::string& text) const;
+
+	bool scan(unsigned int keyword);
+	void scanThrow(unsigned int keyword);
+	bool scanPeek(unsigned int keyword) const;
+
 public:
 	size_t   line() const;
 	size_t column() const;
 
 public:
+	/*! \brief Rewind to the first token, checkpoints are just token
+		indices, so none of these touch the source */
 	void reset();
 	void checkpoint();
 	void restoreCheckpoint();
 	void discardCheckpoint();
 
+public:
+	/*! \brief The index of the next token */
+	size_t position() const;
+
+	/*! \brief Move to a token index, e.g. one found by a copy */
+	void seek(size_t position);
+
 private:
 	LexerEngine* _engine;
 
@@ -9,6 +9,7 @@
 // Standard Library Includes
 #include <string>
 #include <vector>
+#include <bitset>
 
 namespace vanaheimr
 {
@@ -41,6 +42,25 @@ public:
 public:
 	bool isEndRepeated() const;
 
+public:
+	/*! \brief A set of characters that is matched once, or repeated zero
+		or more times */
+	class Element
+	{
+	public:
+		typedef std::bitset<256> CharacterSet;
+
+	public:
+		CharacterSet characters;
+		bool         isRepeated;
+	};
+
+	typedef std::vector<Element> ElementVector;
+
+	/*! \brief The rule as a sequence of character sets, indexed by the
+		unsigned value of each character */
+	ElementVector elements() const;
+
 public:
 	const std::string& toString() const;
 	
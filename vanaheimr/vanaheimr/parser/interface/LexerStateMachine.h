@@ -0,0 +1,152 @@
+/*! \file   LexerStateMachine.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the LexerStateMachine class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/parser/interface/LexerRule.h>
+
+// Standard Library Includes
+#include <vector>
+#include <bitset>
+#include <cstdint>
+#include <cstddef>
+
+namespace vanaheimr
+{
+
+namespace parser
+{
+
+/*! \brief A set of lexer rules compiled into one minimized DFA
+
+	Characters are first mapped to classes of characters that no rule
+	tells apart, so the transition table has one column per class rather
+	than one per character.  Matching follows the longest match, ties go
+	to the rule that was added first.  Empty matches are never reported.
+*/
+class LexerStateMachine
+{
+public:
+	static const unsigned int InvalidRule = 0xffffffff;
+
+public:
+	LexerStateMachine();
+
+public:
+	/*! \brief Add a rule, rules are numbered in the order of addition */
+	void addRule(const LexerRule& rule);
+
+	/*! \brief Build the DFA for all rules added so far */
+	void compile();
+
+	/*! \brief Remove all rules and states */
+	void clear();
+
+public:
+	/*! \brief Find the longest match of any rule that starts at 'begin'
+
+		\param rule Set to the number of the matched rule
+		\return The length of the match, zero if there is none
+	*/
+	size_t match(const char* begin, const char* end,
+		unsigned int& rule) const
+	{
+		if(_startState < 0) return 0;
+
+		int32_t state  = _startState;
+		size_t  length = 0;
+
+		for(const char* position = begin; position != end; ++position)
+		{
+			state = _transitions[state * _characterClasses +
+				_characterClass[(uint8_t)*position]];
+
+			if(state < 0) break;
+
+			if(_acceptedRules[state] != InvalidRule)
+			{
+				rule   = _acceptedRules[state];
+				length = position - begin + 1;
+			}
+		}
+
+		return length;
+	}
+
+	/*! \brief Is every occurrence of the character a token of its own?
+
+		No token can contain a separator and another character, so input
+		can be split right after one and the pieces lexed independently.
+	*/
+	bool isSeparator(char character) const
+	{
+		return _separators.test((uint8_t)character);
+	}
+
+public:
+	size_t rules()  const;
+	size_t states() const;
+
+private:
+	/*! \brief A position in a rule, the number of elements matched */
+	class Item
+	{
+	public:
+		Item(unsigned int rule, unsigned int position);
+
+	public:
+		bool operator<(const Item& ) const;
+		bool operator==(const Item& ) const;
+
+	public:
+		unsigned int rule;
+		unsigned int position;
+	};
+
+	typedef std::vector<Item> ItemVector;
+
+private:
+	void _formCharacterClasses();
+	void _formStates();
+	void _minimize();
+	void _formSeparators();
+
+	void       _close(ItemVector& items) const;
+	ItemVector _move(const ItemVector& items,
+		unsigned int characterClass) const;
+
+	unsigned int _getAcceptedRule(const ItemVector& items) const;
+
+private:
+	typedef std::vector<LexerRule::ElementVector> RuleVector;
+
+	typedef std::vector<int32_t>      StateVector;
+	typedef std::vector<unsigned int> RuleIdVector;
+	typedef std::vector<uint8_t>      CharacterVector;
+
+private:
+	RuleVector _rules;
+
+private:
+	CharacterVector _characterClass;
+	CharacterVector _classRepresentative;
+	unsigned int    _characterClasses;
+
+private:
+	StateVector  _transitions;
+	RuleIdVector _acceptedRules;
+	int32_t      _startState;
+
+private:
+	std::bitset<256> _separators;
+
+};
+
+}
+
+}
+
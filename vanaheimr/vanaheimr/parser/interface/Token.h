@@ -0,0 +1,125 @@
+/*! \file   Token.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the Token class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <ostream>
+
+namespace vanaheimr
+{
+
+namespace parser
+{
+
+/*! \brief A lexed token, a view of the text in the lexer's source buffer
+
+	Tokens never copy their text, they stay valid until the lexer that
+	produced them is given a new source.  A token that spells one of the
+	literal token rules (e.g. 'define' or '{') also carries that rule's
+	keyword id, so it can be compared with a single integer comparison.
+*/
+class Token
+{
+public:
+	static const unsigned int InvalidKeyword = 0xffffffff;
+
+public:
+	Token()
+	: _begin(""), _size(0), _keyword(InvalidKeyword) {}
+
+	Token(const char* begin, size_t size,
+		unsigned int keyword = InvalidKeyword)
+	: _begin(begin), _size(size), _keyword(keyword) {}
+
+public:
+	typedef const char* const_iterator;
+
+public:
+	const_iterator begin() const { return _begin;         }
+	const_iterator end()   const { return _begin + _size; }
+
+public:
+	const char* data()  const { return _begin;      }
+	size_t      size()  const { return _size;       }
+	bool        empty() const { return _size == 0;  }
+
+	char front() const { return _begin[0];         }
+	char back()  const { return _begin[_size - 1]; }
+
+	char operator[](size_t i) const { return _begin[i]; }
+
+public:
+	/*! \brief The keyword id, InvalidKeyword if this is not a keyword */
+	unsigned int keyword() const { return _keyword; }
+
+	bool is(unsigned int keyword) const
+	{
+		return keyword != InvalidKeyword && keyword == _keyword;
+	}
+
+public:
+	/*! \brief Copy the text out of the source buffer */
+	std::string str() const { return std::string(_begin, _size); }
+
+	bool startsWith(char character) const
+	{
+		return _size > 0 && _begin[0] == character;
+	}
+
+	bool startsWith(const char* prefix) const
+	{
+		size_t length = std::strlen(prefix);
+
+		return length <= _size && std::memcmp(_begin, prefix, length) == 0;
+	}
+
+public:
+	bool equals(const char* text, size_t size) const
+	{
+		return size == _size && std::memcmp(_begin, text, size) == 0;
+	}
+
+	bool operator==(const Token& token) const
+	{
+		return equals(token.data(), token.size());
+	}
+
+	bool operator==(const std::string& text) const
+	{
+		return equals(text.data(), text.size());
+	}
+
+	bool operator==(const char* text) const
+	{
+		return equals(text, std::strlen(text));
+	}
+
+	template<typename T>
+	bool operator!=(const T& text) const
+	{
+		return !(*this == text);
+	}
+
+private:
+	const char*  _begin;
+	size_t       _size;
+	unsigned int _keyword;
+
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Token& token)
+{
+	return stream.write(token.data(), token.size());
+}
+
+}
+
+}
+
@@ -4,9 +4,12 @@
 	\brief  The header file for the TypeAliasSet class.
 */
 
+#pragma once
+
 // Standard Library Includes
 #include <string>
 #include <unordered_map>
+#include <mutex>
 
 // Forward Declarations
 namespace vanaheimr { namespace ir { class Type; } }
@@ -17,6 +20,12 @@ namespace vanaheimr
 namespace parser
 {
 
+/*! \brief The named types of a module, and a cache of parsed type spellings
+
+	The cache maps the tokens of a type, e.g. '[ 16 x i8 ]', to the
+	canonical type owned by the compiler.  Spellings that name an alias are
+	dropped whenever an alias changes, so aliases may be defined after use.
+*/
 class TypeAliasSet
 {
 public:
@@ -26,12 +35,26 @@ public:
 
 	void clear();
 
+public:
+	/*! \brief Get a previously parsed type, null if it is not cached */
+	ir::Type* getParsedType(const std::string& spelling) const;
+
+	/*! \brief Remember a parsed type, safe to call from parallel parsers */
+	void addParsedType(const std::string& spelling, ir::Type* type,
+		bool usesAliases) const;
+
 private:
 	typedef std::unordered_map<std::string, const ir::Type*> TypeMap;
+	typedef std::unordered_map<std::string, ir::Type*> ParsedTypeMap;
 
 private:
 	TypeMap _types;
 
+private:
+	mutable ParsedTypeMap _parsedTypes;
+	mutable ParsedTypeMap _parsedTypesWithAliases;
+	mutable std::mutex    _parsedTypeMutex;
+
 };
 
 }
@@ -8,6 +8,7 @@
 
 // Standard Library Includes
 #include <istream>
+#include <string>
 
 // Forward Declarations
 namespace vanaheimr { namespace compiler { class Compiler;     } }
@@ -42,6 +43,11 @@ public:
 public:
 	const ir::Type* parsedType() const;
 
+private:
+	// Cached types
+	ir::Type* _parseCachedType();
+	bool      _getTypeSpelling(std::string& spelling);
+
 private:
 	// High Level Parser methods
 	ir::Type* _parseType();
@@ -61,6 +67,7 @@ private:
 	ir::Type*    _parsedType;
 	
 	const TypeAliasSet* _typedefs;
+	bool                _usesAliases;
 
 private:
 	Lexer* _lexer;
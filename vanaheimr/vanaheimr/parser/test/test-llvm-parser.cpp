@@ -0,0 +1,199 @@
+/*! \file   test-llvm-parser.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the LLVM parser test.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/parser/interface/LLVMParser.h>
+
+#include <vanaheimr/compiler/interface/Compiler.h>
+
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/BasicBlock.h>
+#include <vanaheimr/ir/interface/Instruction.h>
+#include <vanaheimr/ir/interface/Constant.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/ArgumentParser.h>
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace test
+{
+
+namespace ir = vanaheimr::ir;
+
+typedef std::vector<std::string> StringVector;
+
+static ir::Module* parse(const std::string& path, unsigned int threads)
+{
+	auto compiler = vanaheimr::compiler::Compiler::getSingleton();
+
+	vanaheimr::parser::LLVMParser parser(compiler, threads);
+
+	parser.parse(path);
+
+	return &*compiler->getModule(parser.getParsedModuleName());
+}
+
+static const ir::Instruction* findCall(const ir::Function& function)
+{
+	for(auto& block : function)
+	{
+		for(auto instruction : block)
+		{
+			if(instruction->isCall()) return instruction;
+		}
+	}
+
+	return nullptr;
+}
+
+/*! \brief Check the parts of hello.llvm that a code generator relies on */
+static bool checkHello(const ir::Module& module)
+{
+	if(module.size() != 7 || module.global_size() != 4)
+	{
+		std::cout << "  expecting 7 functions and 4 globals, found "
+			<< module.size() << " and " << module.global_size() << "\n";
+		return false;
+	}
+
+	auto string = module.getGlobal(".str");
+
+	std::string hello("Hello World\n", 13);
+
+	if(string == module.global_end() || !string->hasInitializer() ||
+		string->initializer()->data() !=
+		ir::Constant::DataVector(hello.begin(), hello.end()))
+	{
+		std::cout << "  '.str' is not initialized to 'Hello World\\n'\n";
+		return false;
+	}
+
+	auto main = module.getFunction("main");
+
+	if(main == module.end() || main->returned_size() != 1)
+	{
+		std::cout << "  'main' is missing or does not return a value\n";
+		return false;
+	}
+
+	// The stream and the string are passed to operator<<
+	auto call = static_cast<const ir::Call*>(findCall(*main));
+
+	if(call == nullptr || call->arguments().size() != 2 ||
+		call->returned().size() != 1)
+	{
+		std::cout << "  the call in 'main' did not parse\n";
+		return false;
+	}
+
+	auto constructor = module.getFunction("_GLOBAL__I_a");
+
+	if(constructor == module.end() ||
+		!constructor->hasAttribute("constructor"))
+	{
+		std::cout << "  '_GLOBAL__I_a' is not marked as a constructor\n";
+		return false;
+	}
+
+	return true;
+}
+
+static bool testExamples(const std::string& path, unsigned int threads)
+{
+	// Files that llvm-as accepts
+	StringVector modules = {"hello.llvm", "hello-simple.llvm",
+		"hello-simple2.llvm", "hello-simple3.llvm", "hello-simple4.llvm",
+		"hello-simple5.llvm", "hello-medium3.llvm"};
+
+	// Fragments of hello.llvm that use undefined names or are not modules
+	StringVector fragments = {"hello-medium.llvm", "hello-medium2.llvm",
+		"hello-medium4.llvm", "hello-simple6.llvm", "hello-simple7.llvm"};
+
+	for(auto& name : modules)
+	{
+		ir::Module* module = nullptr;
+
+		try
+		{
+			module = parse(path + "/" + name, threads);
+		}
+		catch(const std::exception& e)
+		{
+			std::cout << " failed to parse '" << name << "': "
+				<< e.what() << "\n";
+			return false;
+		}
+
+		std::cout << " parsed '" << name << "', " << module->size()
+			<< " functions, " << module->global_size() << " globals\n";
+
+		if(name == "hello.llvm" && !checkHello(*module)) return false;
+	}
+
+	for(auto& name : fragments)
+	{
+		try
+		{
+			parse(path + "/" + name, threads);
+		}
+		catch(const std::runtime_error& e)
+		{
+			std::cout << " rejected '" << name << "': " << e.what() << "\n";
+			continue;
+		}
+
+		std::cout << " accepted the fragment '" << name << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser(argc, argv);
+
+	std::string path;
+	unsigned int threads = 0;
+
+	bool verbose = false;
+
+	parser.description("This program parses the hello*.llvm examples end "
+		"to end and checks the module built from hello.llvm.");
+
+	parser.parse("-p", "--path", path, "examples/c++",
+		"The directory with the hello*.llvm examples.");
+	parser.parse("-t", "--threads", threads, 0,
+		"The number of threads that parse function bodies.");
+	parser.parse("-v", "--verbose", verbose, false,
+		"Print out log messages during execution");
+	parser.parse();
+
+	if(verbose)
+	{
+		hydrazine::enableAllLogs();
+	}
+
+	if(!test::testExamples(path, threads))
+	{
+		std::cout << "Test Failed\n";
+
+		return -1;
+	}
+
+	std::cout << "Test Passed\n";
+
+	return 0;
+}
+
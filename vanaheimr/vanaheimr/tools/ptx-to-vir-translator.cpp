@@ -12,14 +12,23 @@
 #include <vanaheimr/translation/interface/PTXToVIRTranslator.h>
 #include <vanaheimr/translation/interface/OcelotToVIRTraceTranslator.h>
 
+#include <vanaheimr/util/interface/FileCache.h>
+#include <vanaheimr/util/interface/MappedFile.h>
+
 // Ocelot Includes
 #include <ocelot/ir/interface/Module.h>
 
 // Hydrazine Includes
 #include <hydrazine/interface/ArgumentParser.h>
 
+// Generated Includes
+#include <configure.h>
+
 // Standard Library Includes
 #include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdio>
 
 namespace vanaheimr
 {
@@ -31,7 +40,8 @@ static bool isTraceFile(const std::string& path)
 	return extension == "trace";
 }
 
-static std::string translatePTX(const std::string& ptxFileName)
+static std::string translatePTX(const std::string& ptxFileName,
+	unsigned int threads)
 {
 	// Load the PTX module
 	::ir::Module ptxModule(ptxFileName);
@@ -39,7 +49,7 @@ static std::string translatePTX(const std::string& ptxFileName)
 	compiler::Compiler* virCompiler = compiler::Compiler::getSingleton();
 	
 	// Translate the PTX
-	translation::PTXToVIRTranslator translator(virCompiler);
+	translation::PTXToVIRTranslator translator(virCompiler, threads);
 	
 	try
 	{
@@ -56,12 +66,13 @@ static std::string translatePTX(const std::string& ptxFileName)
 	return ptxFileName;
 }
 
-static std::string translateTrace(const std::string& traceFileName)
+static std::string translateTrace(const std::string& traceFileName,
+	unsigned int threads)
 {
 	// Translate the trace
 	compiler::Compiler* virCompiler = compiler::Compiler::getSingleton();
 	
-	translation::OcelotToVIRTraceTranslator translator(virCompiler);
+	translation::OcelotToVIRTraceTranslator translator(virCompiler, threads);
 	
 	try
 	{
@@ -78,9 +89,10 @@ static std::string translateTrace(const std::string& traceFileName)
 	return translator.translatedModuleName();	
 }
 
-/*! \brief Load a PTX module, translate it to VIR, output the result */
-static void translate(const std::string& virFileName,
-	const std::string& ptxFileName, bool binary)
+/*! \brief Translate a PTX module or trace into VIR binary or assembly text */
+static bool translateToStream(std::ostream& stream,
+	const std::string& virFileName, const std::string& ptxFileName,
+	bool binary, unsigned int threads)
 {
 	// is this a ptx or trace file?
 	bool isTrace = isTraceFile(ptxFileName);
@@ -92,27 +104,66 @@ static void translate(const std::string& virFileName,
 	{
 		if(isTrace)
 		{
-			ptxModuleName = translateTrace(ptxFileName);
+			ptxModuleName = translateTrace(ptxFileName, threads);
 		}
 		else
 		{
-			ptxModuleName = translatePTX(ptxFileName);
+			ptxModuleName = translatePTX(ptxFileName, threads);
 		}
 	}
 	catch(const std::exception& e)
 	{
-		return;
+		return false;
 	}
 
 	compiler::Compiler* virCompiler = compiler::Compiler::getSingleton();
 	
-	// Output the VIR module
 	vanaheimr::compiler::Compiler::module_iterator virModule =
 		virCompiler->getModule(ptxModuleName);
 	assert(virModule != virCompiler->module_end());
 	
 	virModule->name = virFileName;
 
+	try
+	{
+		if(binary)
+		{
+			virModule->writeBinary(stream);
+		}
+		else
+		{
+			virModule->writeAssembly(stream);
+		}
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "Compilation Failed: binary writing failed.\n"; 
+		std::cerr << "  Message: " << e.what() << "\n"; 
+		
+		return false;
+	}
+
+	return true;
+}
+
+static bool translateToString(std::string& vir, const std::string& virFileName,
+	const std::string& ptxFileName, bool binary, unsigned int threads)
+{
+	std::stringstream stream;
+
+	if(!translateToStream(stream, virFileName, ptxFileName, binary, threads))
+	{
+		return false;
+	}
+
+	vir = stream.str();
+
+	return true;
+}
+
+static bool openOutput(std::ofstream& virFile, const std::string& virFileName,
+	bool binary)
+{
 	std::ios_base::openmode mode = std::ios_base::out;
 
 	if(binary)
@@ -120,32 +171,128 @@ static void translate(const std::string& virFileName,
 		mode |= std::ios_base::binary;
 	}
 	
-	std::ofstream virFile(virFileName.c_str(), mode);
+	virFile.open(virFileName.c_str(), mode);
 	
 	if(!virFile.is_open())
 	{
 		std::cerr << "Compilation Failed: could not open VIR file '"
 			<< virFileName << "' for writing.\n"; 
-		return;
+		return false;
 	}
+
+	return true;
+}
+
+static bool writeOutput(const std::string& virFileName, const std::string& vir,
+	bool binary)
+{
+	std::ofstream virFile;
 	
+	if(!openOutput(virFile, virFileName, binary)) return false;
+
+	virFile.write(vir.data(), vir.size());
+
+	return true;
+}
+
+/*! \brief Load a PTX module, translate it to VIR, output the result
+
+	The output is written as it is produced, streamed trace images never
+	have to fit in memory.
+*/
+static void translate(const std::string& virFileName,
+	const std::string& ptxFileName, bool binary, unsigned int threads)
+{
+	std::ofstream virFile;
+
+	if(!openOutput(virFile, virFileName, binary)) return;
+
+	if(!translateToStream(virFile, virFileName, ptxFileName, binary, threads))
+	{
+		virFile.close();
+
+		// Leave no partial output behind
+		std::remove(virFileName.c_str());
+	}
+}
+
+/*! \brief Everything other than the input bytes that shapes the output */
+static std::string cacheContext(const std::string& ptxFileName, bool binary)
+{
+	std::stringstream context;
+
+	context << "ptx-to-vir-translator " << PACKAGE_VERSION << "\n";
+	context << "trace " << isTraceFile(ptxFileName) << "\n";
+	context << "binary " << binary << "\n";
+
+	return context.str();
+}
+
+/*! \brief Translate through the cache, warm runs never parse the input */
+static void translateCached(const std::string& virFileName,
+	const std::string& ptxFileName, bool binary, unsigned int threads,
+	const std::string& cacheDirectory, uint64_t cacheBytes,
+	bool printStatistics)
+{
+	// Set once the cache has been consulted, past that point a failure
+	//  must not run the translation a second time
+	bool handled = false;
+
 	try
 	{
-		if(binary)
+		util::FileCache cache(cacheDirectory, cacheBytes);
+
+		std::string key;
+
 		{
-			virModule->writeBinary(virFile);
+			util::MappedFile input(ptxFileName);
+
+			key = util::FileCache::makeKey(input.data(), input.size(),
+				cacheContext(ptxFileName, binary));
 		}
-		else
+
+		std::string vir;
+
+		bool hit = cache.lookup(key, vir);
+
+		handled = true;
+
+		if(hit)
 		{
-			virModule->writeAssembly(virFile);
+			writeOutput(virFileName, vir, binary);
+		}
+		else if(translateToString(vir, virFileName, ptxFileName, binary,
+			threads))
+		{
+			if(writeOutput(virFileName, vir, binary))
+			{
+				cache.insert(key, vir);
+			}
+		}
+
+		if(printStatistics)
+		{
+			auto statistics = cache.statistics();
+
+			std::cout << "Cache '" << cache.directory() << "': "
+				<< statistics.hits << " hits, "
+				<< statistics.misses << " misses, "
+				<< statistics.insertions << " insertions, "
+				<< statistics.evictions << " evictions, "
+				<< cache.bytes() << " / " << cache.maximumBytes()
+				<< " bytes\n";
 		}
 	}
 	catch(const std::exception& e)
 	{
-		std::cerr << "Compilation Failed: binary writing failed.\n"; 
-		std::cerr << "  Message: " << e.what() << "\n"; 
-		
-		std::remove(virFileName.c_str());
+		std::cerr << "Compilation Warning: cache access failed.\n";
+		std::cerr << "  Message: " << e.what() << "\n";
+
+		// An unusable cache must not cost the user the output
+		if(!handled)
+		{
+			translate(virFileName, ptxFileName, binary, threads);
+		}
 	}
 }
 
@@ -157,7 +304,12 @@ int main(int argc, char** argv)
 
 	std::string ptxFileName;
 	std::string virFileName;
+	std::string cacheDirectory;
 	bool writeBinary;
+	bool cacheStatistics;
+
+	unsigned int threads = 0;
+	unsigned int cacheMegabytes = 1024;
 
 	parser.description("This program compiles a PTX file into a VIR binary.");
 
@@ -167,9 +319,27 @@ int main(int argc, char** argv)
 	parser.parse("-b", "--use-binary-format", writeBinary,
 		false, "Output a VIR binary "
 		"bytecode file rather than an assembly file.");
+	parser.parse("-t", "--threads", threads, 0,
+		"Threads used to translate kernel bodies (0 for all cores).");
+	parser.parse("", "--cache", cacheDirectory, "",
+		"Reuse translations stored in this directory, keyed by the "
+		"input contents and options.");
+	parser.parse("", "--cache-size", cacheMegabytes, 1024,
+		"The size limit of the cache in megabytes.");
+	parser.parse("", "--cache-statistics", cacheStatistics, false,
+		"Print the hit and miss counts of the cache.");
 	parser.parse();
 	
-	vanaheimr::translate(virFileName, ptxFileName, writeBinary);
+	if(cacheDirectory.empty())
+	{
+		vanaheimr::translate(virFileName, ptxFileName, writeBinary, threads);
+	}
+	else
+	{
+		vanaheimr::translateCached(virFileName, ptxFileName, writeBinary,
+			threads, cacheDirectory, cacheMegabytes * (1ULL << 20),
+			cacheStatistics);
+	}
 
 	return 0;
 }
@@ -8,44 +8,52 @@
 #include <vanaheimr/ir/interface/Module.h>
 
 #include <vanaheimr/asm/interface/BinaryReader.h>
+#include <vanaheimr/asm/interface/AssemblyWriter.h>
 
 // Hydrazine Includes
 #include <hydrazine/interface/ArgumentParser.h>
 
 // Standard Library Includes
-#include <fstream>
+#include <iostream>
+#include <stdexcept>
 
 namespace vanaheimr
 {
 
-static void dump(const std::string& name)
+static void dump(const std::string& name, const std::string& functionName)
 {	
-	std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary;
-	
-	std::ifstream virFile(name.c_str(), mode);
-	
-	if(!virFile.is_open())
-	{
-		std::cerr << "ObjDump Failed: could not open VIR file '"
-			<< name << "' for reading.\n"; 
-		return;
-	}
-	
 	ir::Module* module = 0;
 
 	try
 	{
 		as::BinaryReader reader;
 
-		module = reader.read(virFile, name);
+		// Only the functions that are printed are ever decoded
+		module = reader.map(name, name);
 	
-		module->writeAssembly(std::cout);
+		if(functionName.empty())
+		{
+			module->writeAssembly(std::cout);
+		}
+		else
+		{
+			auto function = module->getFunction(functionName);
+
+			if(function == module->end())
+			{
+				throw std::runtime_error("There is no function named '" +
+					functionName + "'");
+			}
+
+			as::AssemblyWriter writer;
+
+			writer.write(std::cout, *function);
+		}
 	}
 	catch(const std::exception& e)
 	{
 		std::cerr << "ObjDump Failed: binary reading failed.\n"; 
 		std::cerr << "  Message: " << e.what() << "\n"; 
-		return;
 	}
 	
 	delete module;
@@ -58,14 +66,18 @@ int main(int argc, char** argv)
 	hydrazine::ArgumentParser parser(argc, argv);
 
 	std::string virFileName;
+	std::string functionName;
 
 	parser.description("This program prints out an assembly "
 		"representation of a VIR binary.");
 
-	parser.parse("-i", "--input",  virFileName, "", "The input VIR file path.");
+	parser.parse("-i", "--input",    virFileName,  "",
+		"The input VIR file path.");
+	parser.parse("-f", "--function", functionName, "",
+		"Only print the function with this name.");
 	parser.parse();
 	
-	vanaheimr::dump(virFileName);
+	vanaheimr::dump(virFileName, functionName);
 
 	return 0;
 }
@@ -11,16 +11,25 @@
 #include <vanaheimr/parser/interface/LLVMParser.h>
 
 #include <vanaheimr/asm/interface/BinaryReader.h>
+#include <vanaheimr/asm/interface/BinaryWriter.h>
 
 #include <vanaheimr/compiler/interface/Compiler.h>
 
 #include <vanaheimr/ir/interface/Module.h>
 
+#include <vanaheimr/util/interface/FileCache.h>
+#include <vanaheimr/util/interface/MappedFile.h>
+
 // Hydrazine Includes
 #include <hydrazine/interface/ArgumentParser.h>
 
+// Generated Includes
+#include <configure.h>
+
 // Standard Library Includes
 #include <fstream>
+#include <sstream>
+#include <iostream>
 #include <stdexcept>
 
 namespace vanaheimr
@@ -50,21 +59,12 @@ static void optimizeModule(ir::Module* module, const std::string& optimizations)
 
 static ir::Module* loadBinaryModule(const std::string& inputFileName)
 {
-	std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary;
-	
-	std::ifstream virFile(inputFileName.c_str(), mode);
-	
-	if(!virFile.is_open())
-	{
-		std::cerr << "VIR Optimizer Failed: could not open VIR bytecode file '"
-			<< inputFileName << "' for reading.\n"; 
-	}
-	
 	try
 	{
 		as::BinaryReader reader;
 
-		return reader.read(virFile, inputFileName);
+		// Function bodies are decoded as the passes reach them
+		return reader.map(inputFileName, inputFileName);
 	}
 	catch(const std::exception& e)
 	{
@@ -75,11 +75,13 @@ static ir::Module* loadBinaryModule(const std::string& inputFileName)
 	return nullptr;
 }
 
-static ir::Module* loadAssemblyModule(const std::string& inputFileName)
+static ir::Module* loadAssemblyModule(const std::string& inputFileName,
+	unsigned int threads)
 {
 	try
 	{
-		parser::LLVMParser parser(compiler::Compiler::getSingleton());
+		parser::LLVMParser parser(compiler::Compiler::getSingleton(),
+			threads);
 
 		parser.parse(inputFileName);
 	
@@ -108,25 +110,68 @@ static bool isAssembly(const std::string& inputFileName)
 	return getExt(inputFileName) == "llvm";
 }
 
-static ir::Module* loadModule(const std::string& inputFileName)
+static ir::Module* loadModule(const std::string& inputFileName,
+	unsigned int threads)
 {
 	if(isAssembly(inputFileName))
 	{
-		return loadAssemblyModule(inputFileName);
+		return loadAssemblyModule(inputFileName, threads);
 	}
 
 	return loadBinaryModule(inputFileName);
 
 }
 
-static void optimize(const std::string& inputFileName,
-	const std::string& outputFileName,
-	const std::string& optimizations)
-{	
+/*! \brief Everything other than the input bytes that shapes the output */
+static std::string cacheContext(const std::string& inputFileName,
+	const std::string& optimizations, bool compress)
+{
+	std::stringstream context;
+
+	context << "vir-optimizer " << PACKAGE_VERSION << "\n";
+	context << "assembly " << isAssembly(inputFileName) << "\n";
+	context << "optimizations " << optimizations << "\n";
+	context << "compress " << compress << "\n";
+
+	return context.str();
+}
+
+static std::string cacheKey(const std::string& inputFileName,
+	const std::string& optimizations, bool compress)
+{
+	util::MappedFile input(inputFileName);
+
+	return util::FileCache::makeKey(input.data(), input.size(),
+		cacheContext(inputFileName, optimizations, compress));
+}
+
+static bool writeOutput(const std::string& outputFileName,
+	const std::string& binary)
+{
+	std::ios_base::openmode oMode = std::ios_base::out | std::ios_base::binary;	
+	
+	std::ofstream outputVirFile(outputFileName.c_str(), oMode);
 	
-	ir::Module* module = loadModule(inputFileName);
+	if(!outputVirFile.is_open())
+	{
+		std::cerr << "VIR Optimizer Failed: could not open VIR file '"
+			<< outputFileName << "' for writing.\n"; 
+		
+		return false;
+	}
+
+	outputVirFile.write(binary.data(), binary.size());
+
+	return true;
+}
+
+static bool optimizeToBinary(const std::string& inputFileName,
+	std::string& binary,
+	const std::string& optimizations, bool compress, unsigned int threads)
+{
+	ir::Module* module = loadModule(inputFileName, threads);
 
-	if(module == nullptr) return;
+	if(module == nullptr) return false;
 	
 	try
 	{
@@ -137,32 +182,107 @@ static void optimize(const std::string& inputFileName,
 		std::cerr << "VIR Optimizer Failed: optimization failed.\n"; 
 		std::cerr << "  Message: " << e.what() << "\n"; 
 
-		return;
+		return false;
 	}
 	
-	std::ios_base::openmode oMode = std::ios_base::out | std::ios_base::binary;	
-	
-	std::ofstream outputVirFile(outputFileName.c_str(), oMode);
-	
-	if(!outputVirFile.is_open())
+	try
 	{
-		std::cerr << "ObjDump Failed: could not open VIR file '"
-			<< outputFileName << "' for writing.\n"; 
+		as::BinaryWriter writer(compress ? as::BinaryHeader::PageCompression :
+			as::BinaryHeader::NoCompression, threads);
 		
-		return;
+		std::stringstream stream;
+
+		writer.write(stream, *module);
+
+		binary = stream.str();
 	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "VIR Optimizer Failed: binary writing failed.\n"; 
+		std::cerr << "  Message: " << e.what() << "\n"; 
+		return false;
+	}
+
+	return true;
+}
+
+static void optimize(const std::string& inputFileName,
+	const std::string& outputFileName,
+	const std::string& optimizations, bool compress, unsigned int threads)
+{	
+	std::string binary;
 	
+	if(!optimizeToBinary(inputFileName, binary, optimizations,
+		compress, threads))
+	{
+		return;
+	}
+
+	writeOutput(outputFileName, binary);
+}
+
+/*! \brief Optimize through the cache, warm runs never parse the input */
+static void optimizeCached(const std::string& inputFileName,
+	const std::string& outputFileName,
+	const std::string& optimizations, bool compress, unsigned int threads,
+	const std::string& cacheDirectory, uint64_t cacheBytes,
+	bool printStatistics)
+{
+	std::string key;
+	std::string binary;
+
+	// Set once the cache has been consulted, past that point a failure
+	//  must not run the optimization a second time
+	bool handled = false;
+
 	try
 	{
-		module->writeBinary(outputVirFile);
+		util::FileCache cache(cacheDirectory, cacheBytes);
+
+		key = cacheKey(inputFileName, optimizations, compress);
+
+		bool hit = cache.lookup(key, binary);
+
+		handled = true;
+
+		if(hit)
+		{
+			writeOutput(outputFileName, binary);
+		}
+		else if(optimizeToBinary(inputFileName, binary, optimizations,
+			compress, threads))
+		{
+			if(writeOutput(outputFileName, binary))
+			{
+				cache.insert(key, binary);
+			}
+		}
+
+		if(printStatistics)
+		{
+			auto statistics = cache.statistics();
+
+			std::cout << "Cache '" << cache.directory() << "': "
+				<< statistics.hits << " hits, "
+				<< statistics.misses << " misses, "
+				<< statistics.insertions << " insertions, "
+				<< statistics.evictions << " evictions, "
+				<< cache.bytes() << " / " << cache.maximumBytes()
+				<< " bytes\n";
+		}
 	}
 	catch(const std::exception& e)
 	{
-		std::cerr << "ObjDump Failed: binary writing failed.\n"; 
-		std::cerr << "  Message: " << e.what() << "\n"; 
-		return;
+		std::cerr << "VIR Optimizer Warning: cache access failed.\n";
+		std::cerr << "  Message: " << e.what() << "\n";
+
+		// An unusable cache must not cost the user the output
+		if(!handled)
+		{
+			optimize(inputFileName, outputFileName, optimizations,
+				compress, threads);
+		}
 	}
-	
 }
 
 }
@@ -175,7 +295,14 @@ int main(int argc, char** argv)
 	std::string outputFileName;
 	std::string optimizations;
 
-	bool verbose = false;
+	std::string cacheDirectory;
+
+	bool verbose  = false;
+	bool compress = false;
+	bool cacheStatistics = false;
+
+	unsigned int threads = 1;
+	unsigned int cacheMegabytes = 1024;
 
 	parser.description("This program reads in a VIR binary, optimizes it, "
 		"and writes it out again a new binary.");
@@ -188,6 +315,18 @@ int main(int argc, char** argv)
 		"Print out log messages during execution");
 	parser.parse("", "--optimizations",  optimizations,
 		"", "Comma separated list of optimizations (ConvertToSSA).");
+	parser.parse("-c", "--compress", compress, false,
+		"Compress the code and data pages of the output binary.");
+	parser.parse("-t", "--threads", threads, 1,
+		"Threads used to parse the input and write the output binary "
+		"(0 for all cores).");
+	parser.parse("", "--cache", cacheDirectory, "",
+		"Reuse optimized binaries stored in this directory, keyed by the "
+		"input contents and options.");
+	parser.parse("", "--cache-size", cacheMegabytes, 1024,
+		"The size limit of the cache in megabytes.");
+	parser.parse("", "--cache-statistics", cacheStatistics, false,
+		"Print the hit and miss counts of the cache.");
 	parser.parse();
 
 	if(verbose)
@@ -195,7 +334,17 @@ int main(int argc, char** argv)
 		hydrazine::enableAllLogs();
 	}
 	
-	vanaheimr::optimize(virFileName, outputFileName, optimizations);
+	if(cacheDirectory.empty())
+	{
+		vanaheimr::optimize(virFileName, outputFileName, optimizations,
+			compress, threads);
+	}
+	else
+	{
+		vanaheimr::optimizeCached(virFileName, outputFileName, optimizations,
+			compress, threads, cacheDirectory, cacheMegabytes * (1ULL << 20),
+			cacheStatistics);
+	}
 
 	return 0;
 }
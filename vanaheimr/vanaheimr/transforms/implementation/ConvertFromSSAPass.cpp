@@ -150,7 +150,7 @@ static void removeFirstPhi(ir::BasicBlock& block,
 	
 	copy->setGuard(new ir::PredicateOperand(
 		ir::PredicateOperand::PredicateTrue, copy));
-	copy->setD(new ir::RegisterOperand(phi->d()->virtualRegister, copy));
+	copy->setD(new ir::RegisterOperand(phi->d()->virtualRegister(), copy));
 	copy->setA(new ir::RegisterOperand(sourceRegister, copy));
 
 	// Insert the copy before the non-phi first instruction
@@ -168,14 +168,14 @@ static void removeFirstPhi(ir::BasicBlock& block,
 		++source, ++predecessor)
 	{
 		auto insertPosition = determineInsertionPosition(*predecessor,
-			(*source)->virtualRegister, dfg);
+			(*source)->virtualRegister(), dfg);
 	
 		auto copy = new ir::Bitcast;
 	
 		copy->setGuard(new ir::PredicateOperand(
 			ir::PredicateOperand::PredicateTrue, copy));
 		copy->setD(new ir::RegisterOperand(sourceRegister, copy));
-		copy->setA(new ir::RegisterOperand((*source)->virtualRegister, copy));
+		copy->setA(new ir::RegisterOperand((*source)->virtualRegister(), copy));
 
 		(*predecessor)->insert(insertPosition, copy);
 	}
@@ -156,13 +156,13 @@ void ConvertToSSAPass::_insertPsis(Function& function)
 				psi->setGuard(new ir::PredicateOperand(
 					ir::PredicateOperand::PredicateTrue, psi));
 				psi->setD(new ir::RegisterOperand(
-					registerWrite->virtualRegister, psi));
+					registerWrite->virtualRegister(), psi));
 				
 				block->insert(next, psi);
 				
 				// Do this with a local update, and then a final gather
 				_registersNeedingRenaming.insert(
-					registerWrite->virtualRegister);
+					registerWrite->virtualRegister());
 			}
 		}
 	}
@@ -205,8 +205,8 @@ void ConvertToSSAPass::_rename(Function& f)
 	
 	BasicBlockSet worklist;
 	
-	 _renamedLiveIns.resize(f.size());
-	_renamedLiveOuts.resize(f.size());
+	 _renamedLiveIns.resize(f.block_capacity());
+	_renamedLiveOuts.resize(f.block_capacity());
 	
 	//
 	// Rename the def immediately in parallel, there can be no conflicts
@@ -259,12 +259,32 @@ public:
 	}
 };
 
-static InstructionVector sort(
-	const vanaheimr::analysis::DataflowAnalysis::InstructionSet& instructions)
+static InstructionVector getDefiningInstructions(
+	const vanaheimr::ir::VirtualRegister& value)
 {
-	InstructionVector sortedInstructions(instructions.begin(),
+	InstructionVector instructions;
+	
+	for(auto definition : value.definitions())
+	{
+		// skip instructions that are not in a block
+		if(!definition->instruction->isLinked()) continue;
+		
+		instructions.push_back(definition->instruction);
+	}
+	
+	// an instruction may write the value more than once
+	std::sort(instructions.begin(), instructions.end());
+	
+	instructions.erase(std::unique(instructions.begin(), instructions.end()),
 		instructions.end());
 	
+	return instructions;
+}
+
+static InstructionVector sort(const InstructionVector& instructions)
+{
+	InstructionVector sortedInstructions(instructions);
+	
 	std::sort(sortedInstructions.begin(), sortedInstructions.end(),
 		InstructionComparator());
 	
@@ -276,14 +296,13 @@ void ConvertToSSAPass::_renameAllDefs(VirtualRegister& value,
 {
 	report("   renaming r" << value.id);
 		
-	auto dfg = static_cast<DataflowAnalysis*>(getAnalysis("DataflowAnalysis"));
 	auto dominatorAnalysis = static_cast<DominatorAnalysis*>(
 		getAnalysis("DominatorAnalysis"));
 	
-	assert(dfg != nullptr);
 	assert(dominatorAnalysis != nullptr);
 	
-	auto definitions = dfg->getReachingDefinitions(value);
+	// the def chain also covers PSIs and PHIs inserted by this pass
+	auto definitions = getDefiningInstructions(value);
 	
 	// sort the definitions in program order
 	auto orderedDefinitions = sort(definitions);
@@ -340,10 +359,10 @@ void ConvertToSSAPass::_updateDefinition(Instruction& definingInstruction,
 		
 		auto writeOperand = static_cast<ir::RegisterOperand*>(write);
 		
-		if(writeOperand->virtualRegister != &value) continue;
+		if(writeOperand->virtualRegister() != &value) continue;
 		
 		// rename the register
-		writeOperand->virtualRegister = &newValue;
+		writeOperand->setVirtualRegister(&newValue);
 	}
 }
 
@@ -374,13 +393,13 @@ bool ConvertToSSAPass::_updateUsesInThisBlock(Instruction& definingInstruction,
 			auto readOperand = static_cast<ir::RegisterOperand*>(read);
 			
 			// skip reads from different registers
-			if(readOperand->virtualRegister != &value) continue;
+			if(readOperand->virtualRegister() != &value) continue;
 			
 			report("      replacing use by '"
 				<< (*instruction)->toString() << "'");
 			
 			// update the value
-			readOperand->virtualRegister = &newValue;
+			readOperand->setVirtualRegister(&newValue);
 		}
 		
 		// stop on the first def
@@ -391,7 +410,7 @@ bool ConvertToSSAPass::_updateUsesInThisBlock(Instruction& definingInstruction,
 			auto writeOperand = static_cast<ir::RegisterOperand*>(write);
 		
 			// another value will be live out, not this one
-			if(writeOperand->virtualRegister == &value) return true;
+			if(writeOperand->virtualRegister() == &value) return true;
 		}
 	}
 	
@@ -434,18 +453,18 @@ void ConvertToSSAPass::_renameValuesInBlock(
 			auto readOperand = static_cast<ir::RegisterOperand*>(read);
 			
 			auto renamedValue = renamedLiveIns.find(
-				readOperand->virtualRegister);
+				readOperand->virtualRegister());
 			
 			// skip values that were not renamed
 			if(renamedValue == renamedLiveIns.end()) continue;
 		
 			// update the value
-			report("    renaming r" << readOperand->virtualRegister->id
+			report("    renaming r" << readOperand->virtualRegister()->id
 				<< " to r"
 				<< renamedValue->second->id << " in '"
 				<< instruction->toString() << "'");
 	
-			readOperand->virtualRegister = renamedValue->second;
+			readOperand->setVirtualRegister(renamedValue->second);
 		}
 			
 		// kill the update on writes
@@ -456,7 +475,7 @@ void ConvertToSSAPass::_renameValuesInBlock(
 			auto writeOperand = static_cast<ir::RegisterOperand*>(write);
 			
 			auto renamedValue = renamedLiveIns.find(
-				writeOperand->virtualRegister);
+				writeOperand->virtualRegister());
 			
 			// skip values that were not renamed
 			if(renamedValue == renamedLiveIns.end()) continue;
@@ -579,14 +598,14 @@ void ConvertToSSAPass::_renamePhiInputs(BasicBlock* block,
 						continue;
 					}
 					
-					if(source->virtualRegister != value.first) continue;
+					if(source->virtualRegister() != value.first) continue;
 					
 					report("       replacing use by '"
 						<< instruction->toString() << "' from predecessor "
 						<< block->name());
 					
 					foundPhi = true;
-					source->virtualRegister = value.second;
+					source->setVirtualRegister(value.second);
 					break;
 				}
 				
@@ -599,10 +618,7 @@ void ConvertToSSAPass::_renamePhiInputs(BasicBlock* block,
 ConvertToSSAPass::SmallBlockSet ConvertToSSAPass::_getBlocksThatDefineThisValue(
 	const ir::VirtualRegister& value)
 {
-	auto dfg = static_cast<DataflowAnalysis*>(getAnalysis("DataflowAnalysis"));
-	assert(dfg != nullptr);
-	
-	auto instructions = dfg->getReachingDefinitions(value);
+	auto instructions = getDefiningInstructions(value);
 
 	SmallBlockSet blocks;
 
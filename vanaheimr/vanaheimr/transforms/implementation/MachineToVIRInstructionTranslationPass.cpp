@@ -124,6 +124,11 @@ void MachineToVIRInstructionTranslationPass::runOnBlock(BasicBlock& block)
 			instructions.end());
 	}
 	
+	for(auto instruction : newInstructions)
+	{
+		instruction->linkOperands();
+	}
+	
 	block.assign(newInstructions.begin(), newInstructions.end());
 }
 
@@ -12,6 +12,8 @@
 #include <vanaheimr/transforms/interface/ConvertFromSSAPass.h>
 
 #include <vanaheimr/codegen/interface/EnforceArchaeopteryxABIPass.h>
+#include <vanaheimr/codegen/interface/AddressModeFoldingPass.h>
+#include <vanaheimr/codegen/interface/BasicBlockPlacementPass.h>
 #include <vanaheimr/codegen/interface/ListInstructionSchedulerPass.h>
 #include <vanaheimr/codegen/interface/ChaitinBriggsRegisterAllocatorPass.h>
 #include <vanaheimr/codegen/interface/GenericSpillCodePass.h>
@@ -68,6 +70,16 @@ Pass* PassFactory::createPass(const std::string& name,
 		pass = new codegen::EnforceArchaeopteryxABIPass();
 	}
 	
+	if(name == "address-mode-folding" || name == "AddressModeFoldingPass")
+	{
+		pass = new codegen::AddressModeFoldingPass();
+	}
+	
+	if(name == "block-placement" || name == "BasicBlockPlacementPass")
+	{
+		pass = new codegen::BasicBlockPlacementPass();
+	}
+	
 	if(name == "ListInstructionSchedulerPass" || name == "list")
 	{
 		pass = new codegen::ListInstructionSchedulerPass();
@@ -238,6 +238,42 @@ static void allocateNewDataStructures(PassUseCountMap& uses,
 	}
 }
 
+static bool writesFunctions(const PassManager::PassVector& wave)
+{
+	for(auto pass : wave)
+	{
+		if(pass->type == Pass::FunctionPass)   return true;
+		if(pass->type == Pass::BasicBlockPass) return true;
+	}
+	
+	return false;
+}
+
+static bool writesModule(const PassManager::PassVector& wave)
+{
+	for(auto pass : wave)
+	{
+		if(pass->type == Pass::ModulePass) return true;
+	}
+	
+	return false;
+}
+
+static ir::Module::iterator detachFunction(Module* module,
+	ir::Module::iterator function, AnalysisMap& analyses)
+{
+	if(!module->isShared(function)) return function;
+	
+	report("  Detaching shared function '" << function->name() << "'");
+	
+	// The analyses describe the shared copy, they are rebuilt on demand
+	for(auto analysis : analyses) delete analysis.second;
+	
+	analyses.clear();
+	
+	return module->detach(function);
+}
+
 static void runFunctionPass(Function* function, Pass* pass)
 {
 	report("  Running pass '" << pass->toString() << "' on function '"
@@ -480,12 +516,34 @@ void PassManager::runOnFunction(const std::string& name)
 	runOnFunction(*function);
 }
 
-void PassManager::runOnFunction(Function& function)
+void PassManager::runOnFunction(Function& f)
 {
-	report("Running pass manager on function " << function.name());
+	report("Running pass manager on function " << f.name());
 
 	PassWaveList passes = _schedulePasses();
 	
+	bool writes = false;
+	
+	for(auto& wave : passes)
+	{
+		writes |= writesFunctions(wave);
+	}
+	
+	// Functions shared with a cloned module are copied before the first
+	//  write, the passes run on the module's private copy
+	Function* target = &f;
+	
+	auto position = _module->getFunction(f.name());
+	
+	if(writes && position != _module->end() && &*position == &f)
+	{
+		AnalysisMap noAnalyses;
+		
+		target = &*detachFunction(_module, position, noAnalyses);
+	}
+	
+	Function& function = *target;
+	
 	PassUseCountMap passesUseCounts = getPassUseCounts(passes);
 	
 	for(auto wave = passes.begin(); wave != passes.end(); ++wave)
@@ -528,6 +586,9 @@ void PassManager::runOnModule()
 {
 	report("Running pass manager on module " << _module->name);
 
+	// Passes walk the function list directly, load deferred bodies first
+	_module->materializeAll();
+
 	typedef std::map<std::string, AnalysisMap> AnalysisMapMap;
 	
 	AnalysisMapMap functionAnalyses;
@@ -539,6 +600,21 @@ void PassManager::runOnModule()
 	// Run waves in order
 	for(auto wave = passes.begin(); wave != passes.end(); ++wave)
 	{
+		// Module passes may write any function
+		if(writesModule(*wave))
+		{
+			for(auto function = _module->begin();
+				function != _module->end(); ++function)
+			{
+				auto analyses = functionAnalyses.insert(std::make_pair(
+					function->name(), AnalysisMap())).first;
+				
+				detachFunction(_module, function, analyses->second);
+			}
+		}
+		
+		bool writesAnyFunction = writesFunctions(*wave);
+		
 		// Run all module passes first
 		for(auto pass = wave->begin(); pass != wave->end(); ++pass)
 		{
@@ -571,7 +647,13 @@ void PassManager::runOnModule()
 		
 			auto analyses = functionAnalyses.insert(std::make_pair(
 					function->name(), AnalysisMap())).first;
-				
+			
+			if(writesAnyFunction)
+			{
+				detachFunction(_module, function,
+					analyses->second);
+			}
+			
 			_analyses = &analyses->second;
 			_function = &*function;
 		
@@ -7,6 +7,7 @@
 // Vanaheimr Includes
 #include <vanaheimr/translation/interface/OcelotToVIRTraceTranslator.h>
 #include <vanaheimr/translation/interface/PTXToVIRTranslator.h>
+#include <vanaheimr/translation/interface/OcelotTraceReader.h>
 
 #include <vanaheimr/abi/interface/ApplicationBinaryInterface.h>
 
@@ -15,18 +16,24 @@
 #include <vanaheimr/compiler/interface/Compiler.h>
 
 #include <vanaheimr/ir/interface/Type.h>
+#include <vanaheimr/ir/interface/Module.h>
+#include <vanaheimr/ir/interface/Constant.h>
 
 #include <configure.h>
 
 // Ocelot Includes
 #if HAVE_OCELOT
-#include <ocelot/util/interface/ExtractedDeviceState.h>
-
 #include <ocelot/ir/interface/Module.h>
 
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
 // Standard Library Includes
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
+#include <map>
 
 namespace vanaheimr
 {
@@ -34,24 +41,71 @@ namespace vanaheimr
 namespace translation
 {
 
-typedef ::util::ExtractedDeviceState ExtractedDeviceState;
+typedef OcelotTraceReader::KernelLaunch KernelLaunch;
+typedef OcelotTraceReader::ByteVector   ByteVector;
+
+/*! \brief Where an allocation image is in the trace */
+class TracedAllocation
+{
+public:
+	OcelotTraceReader::AllocationKind kind;
+
+	std::string device;
+	uint64_t    bytes;
+	uint64_t    offset;
+};
 
-OcelotToVIRTraceTranslator::OcelotToVIRTraceTranslator(compiler::Compiler* c)
-: _compiler(c)
+/*! \brief Keeps everything in a trace except for the allocation images,
+	which are only located */
+class TraceHeader : public OcelotTraceReader::Visitor
+{
+public:
+	typedef std::map<std::string, OcelotTraceReader::Module> ModuleMap;
+	typedef std::vector<TracedAllocation> AllocationVector;
+
+public:
+	virtual void* visitAllocation(OcelotTraceReader::AllocationKind kind,
+		const std::string& device, uint64_t bytes, uint64_t offset);
+
+	virtual void visitKernelLaunch(const KernelLaunch& launch);
+	virtual void visitModule(const OcelotTraceReader::Module& module);
+
+public:
+	KernelLaunch     launch;
+	ModuleMap        modules;
+	AllocationVector allocations;
+};
+
+/*! \brief Decodes an allocation image when the binary writer reads it */
+class TraceImageSource : public ir::StreamedArrayConstant::Source
+{
+public:
+	TraceImageSource(const std::string& traceFileName,
+		const TracedAllocation& allocation);
+
+public:
+	virtual void read(uint64_t offset, void* data, uint64_t bytes);
+
+private:
+	OcelotTraceReader::ImageReader _reader;
+};
+
+OcelotToVIRTraceTranslator::OcelotToVIRTraceTranslator(compiler::Compiler* c,
+	unsigned int threads)
+: _compiler(c), _threads(threads)
 {
 
 }
 
 static void translatePTX(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state);
+	const TraceHeader& header, unsigned int threads);
 static void addVariablesForTraceData(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state);
-static void archaeopteryxCodeGen(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state);
+	const TraceHeader& header, const std::string& traceFileName);
+static void archaeopteryxCodeGen(compiler::Compiler* compiler);
 
 void OcelotToVIRTraceTranslator::translate(const std::string& traceFileName)
 {
-	std::ifstream stream(traceFileName.c_str());
+	std::ifstream stream(traceFileName.c_str(), std::ios::binary);
 	
 	if(!stream.is_open())
 	{
@@ -59,16 +113,20 @@ void OcelotToVIRTraceTranslator::translate(const std::string& traceFileName)
 			traceFileName + "' for reading.\n");
 	}
 	
-	ExtractedDeviceState state;
+	// Images are only located here, they are decoded when the binary
+	//  writer copies them into the data section
+	TraceHeader header;
 	
-	state.deserialize(stream);
+	OcelotTraceReader reader;
 	
-	translatePTX(_compiler, state);
-	archaeopteryxCodeGen(_compiler, state);
+	reader.read(stream, header);
 	
-	addVariablesForTraceData(_compiler, state);
+	translatePTX(_compiler, header, _threads);
+	archaeopteryxCodeGen(_compiler);
+	
+	addVariablesForTraceData(_compiler, header, traceFileName);
 
-	_translatedModuleName = state.launch.moduleName;
+	_translatedModuleName = header.launch.moduleName;
 }
 
 std::string OcelotToVIRTraceTranslator::translatedModuleName() const
@@ -76,38 +134,67 @@ std::string OcelotToVIRTraceTranslator::translatedModuleName() const
 	return _translatedModuleName;
 }
 
-static void translatePTX(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+void* TraceHeader::visitAllocation(OcelotTraceReader::AllocationKind kind,
+	const std::string& device, uint64_t bytes, uint64_t offset)
 {
-	PTXToVIRTranslator ptxTranslator(compiler);
-	
-	auto module = state.modules.find(state.launch.moduleName);
-	
-	if(module == state.modules.end())
+	if(kind == OcelotTraceReader::GlobalAllocation ||
+		kind == OcelotTraceReader::PostLaunchGlobalAllocation)
 	{
-		throw std::runtime_error("Malformed trace, no module names '" +
-			state.launch.moduleName + "'.");
+		throw std::runtime_error("No support for global variables yet.");
 	}
 	
-	std::stringstream ptxStream(module->second->ptx);
+	TracedAllocation allocation;
 	
-	::ir::Module ptxModule(ptxStream, state.launch.moduleName);
+	allocation.kind   = kind;
+	allocation.device = device;
+	allocation.bytes  = bytes;
+	allocation.offset = offset;
 	
-	ptxTranslator.translate(ptxModule);
+	allocations.push_back(allocation);
+	
+	return nullptr;
 }
 
-static void addTextures(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+void TraceHeader::visitKernelLaunch(const KernelLaunch& l)
+{
+	launch = l;
+}
+
+void TraceHeader::visitModule(const OcelotTraceReader::Module& module)
 {
-	auto module = state.modules.find(state.launch.moduleName);
+	modules[module.name] = module;
+}
+
+static const OcelotTraceReader::Module& getTracedModule(
+	const TraceHeader& header)
+{
+	auto module = header.modules.find(header.launch.moduleName);
 	
-	if(module == state.modules.end())
+	if(module == header.modules.end())
 	{
 		throw std::runtime_error("Malformed trace, no module names '" +
-			state.launch.moduleName + "'.");
+			header.launch.moduleName + "'.");
 	}
 	
-	assertM(module->second->textures.empty(),
+	return module->second;
+}
+
+static void translatePTX(compiler::Compiler* compiler,
+	const TraceHeader& header, unsigned int threads)
+{
+	PTXToVIRTranslator ptxTranslator(compiler, threads);
+	
+	std::stringstream ptxStream(getTracedModule(header).ptx);
+	
+	::ir::Module ptxModule(ptxStream, header.launch.moduleName);
+	
+	ptxTranslator.translate(ptxModule);
+}
+
+static void addTextures(compiler::Compiler* compiler,
+	const TraceHeader& header)
+{
+	assertM(getTracedModule(header).textures == 0,
 		"Traces with textures not supported.");
 }
 
@@ -120,14 +207,20 @@ static const ir::Type* getStringType(compiler::Compiler* compiler,
 	return *compiler->getOrInsertType(arrayType);
 }
 
-static void addGlobal(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state,
-	const std::string& globalName, const std::string& globalValue)
+static ir::Module& getModule(compiler::Compiler* compiler,
+	const std::string& moduleName)
 {
-	auto module = compiler->getModule(state.launch.moduleName);
+	auto module = compiler->getModule(moduleName);
 	assert(module != compiler->module_end());
 	
-	auto global = module->newGlobal(globalName,
+	return *module;
+}
+
+static void addGlobal(compiler::Compiler* compiler,
+	const std::string& moduleName,
+	const std::string& globalName, const std::string& globalValue)
+{
+	auto global = getModule(compiler, moduleName).newGlobal(globalName,
 		getStringType(compiler, globalValue),
 		ir::Global::ExternalLinkage,  ir::Global::Shared);
 
@@ -137,34 +230,37 @@ static void addGlobal(compiler::Compiler* compiler,
 	global->setInitializer(constant);
 }
 
-static void addGlobal(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state,
-	const std::string& globalName, const ::util::ByteVector& globalValue)
+static ir::Global* addImageGlobal(compiler::Compiler* compiler,
+	const std::string& moduleName,
+	const std::string& globalName, uint64_t bytes)
 {
-	auto module = compiler->getModule(state.launch.moduleName);
-	assert(module != compiler->module_end());
-	
-	auto global = module->newGlobal(globalName,
+	return &*getModule(compiler, moduleName).newGlobal(globalName,
 		*compiler->getOrInsertType(ir::ArrayType(compiler,
-			compiler->getType("i8"), globalValue.size())),
+			compiler->getType("i8"), bytes)),
 		ir::Global::ExternalLinkage, ir::Global::Shared);
+}
 
-	auto constant = new ir::ArrayConstant(globalValue.data(),
-		globalValue.size(), compiler->getType("i8"));
+static void addGlobal(compiler::Compiler* compiler,
+	const std::string& moduleName,
+	const std::string& globalName, const ByteVector& globalValue)
+{
+	auto global = addImageGlobal(compiler, moduleName, globalName,
+		globalValue.size());
 	
-	global->setInitializer(constant);
+	global->setInitializer(new ir::ArrayConstant(globalValue.data(),
+		globalValue.size(), compiler->getType("i8")));
 }
 
 template <typename T>
 static void addGlobal(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state,
+	const std::string& moduleName,
 	const std::string& globalName, const T& globalValue)
 {
 	std::stringstream stream;
 	
 	stream << globalValue;
 	
-	addGlobal(compiler, state, globalName, stream.str());
+	addGlobal(compiler, moduleName, globalName, stream.str());
 }
 
 static size_t getParameterMemoryAddress()
@@ -182,89 +278,92 @@ static size_t getParameterMemoryAddress()
 	return fixedRegion->address;
 }
 
-static void addLaunch(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+static void addLaunch(compiler::Compiler* compiler, const KernelLaunch& launch)
 {
-	if(state.launch.gridDim.y > 1 || state.launch.gridDim.z > 1)
+	if(launch.gridDim.y > 1 || launch.gridDim.z > 1)
 	{
 		throw std::runtime_error("Malformed trace, only support"
 			" kernels with ctas in the x dimension.");
 	}
 	
-	if(state.launch.blockDim.y > 1 || state.launch.blockDim.z > 1)
+	if(launch.blockDim.y > 1 || launch.blockDim.z > 1)
 	{
 		throw std::runtime_error("Malformed trace, only support"
 			" kernels with threads in the x dimension.");
 	}
 
-	addGlobal(compiler, state, "simulated-parameter-memory-size",
-		state.launch.parameterMemory.size());
-	addGlobal(compiler, state, "simulated-parameter-memory-address",
+	auto& name = launch.moduleName;
+
+	addGlobal(compiler, name, "simulated-parameter-memory-size",
+		launch.parameterMemory.size());
+	addGlobal(compiler, name, "simulated-parameter-memory-address",
 		getParameterMemoryAddress());
-	addGlobal(compiler, state, "simulated-parameter-memory",
-		state.launch.parameterMemory);
-	
-	addGlobal(compiler, state, "simulated-ctas",
-		state.launch.gridDim.x);
-	addGlobal(compiler, state, "simulated-threads-per-cta",
-		state.launch.blockDim.x);
-	addGlobal(compiler, state, "simulated-shared-memory-per-cta",
-		state.launch.sharedMemorySize);
-	
-	addGlobal(compiler, state, "simulated-kernel-name",
-		state.launch.kernelName);
+	addGlobal(compiler, name, "simulated-parameter-memory",
+		launch.parameterMemory);
+	
+	addGlobal(compiler, name, "simulated-ctas",
+		launch.gridDim.x);
+	addGlobal(compiler, name, "simulated-threads-per-cta",
+		launch.blockDim.x);
+	addGlobal(compiler, name, "simulated-shared-memory-per-cta",
+		launch.sharedMemorySize);
+	
+	addGlobal(compiler, name, "simulated-kernel-name",
+		launch.kernelName);
 }
 
-static void addAllocations(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+TraceImageSource::TraceImageSource(const std::string& traceFileName,
+	const TracedAllocation& allocation)
+: _reader(traceFileName, allocation.offset, allocation.bytes)
 {
-	if(!state.globalVariables.empty())
-	{
-		throw std::runtime_error("No support for global variables yet.");
-	}
-	
-	for(auto allocation = state.globalAllocations.begin();
-		allocation != state.globalAllocations.end(); ++allocation)
-	{
-		std::stringstream name;
-		
-		name << "simulated-allocation-" << allocation->second->devicePointer;
-	
-		addGlobal(compiler, state, name.str(), allocation->second->data);
-	}
+
 }
 
-static void addAllocationChecks(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+void TraceImageSource::read(uint64_t offset, void* data, uint64_t bytes)
 {
-	if(!state.postLaunchGlobalVariables.empty())
+	_reader.read(offset, data, bytes);
+}
+
+static void addAllocation(compiler::Compiler* compiler,
+	const std::string& moduleName, const std::string& traceFileName,
+	const TracedAllocation& allocation)
+{
+	std::stringstream name;
+	
+	if(allocation.kind == OcelotTraceReader::Allocation)
 	{
-		throw std::runtime_error("No support for global variables yet.");
+		name << "simulated-allocation-" << allocation.device;
 	}
-
-	for(auto allocation = state.postLaunchGlobalAllocations.begin();
-		allocation != state.postLaunchGlobalAllocations.end(); ++allocation)
+	else
 	{
-		std::stringstream name;
-		
-		name << "simulated-verify-allocation-"
-			<< allocation->second->devicePointer;
-	
-		addGlobal(compiler, state, name.str(), allocation->second->data);
+		name << "simulated-verify-allocation-" << allocation.device;
 	}
+	
+	auto global = addImageGlobal(compiler, moduleName, name.str(),
+		allocation.bytes);
+	
+	ir::StreamedArrayConstant::SourcePointer source(
+		new TraceImageSource(traceFileName, allocation));
+	
+	global->setInitializer(new ir::StreamedArrayConstant(source,
+		allocation.bytes, compiler->getType("i8")));
 }
 
 static void addVariablesForTraceData(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+	const TraceHeader& header, const std::string& traceFileName)
 {
-	addTextures(compiler, state);
-	addLaunch(compiler, state);
-	addAllocations(compiler, state);
-	addAllocationChecks(compiler, state);
+	addTextures(compiler, header);
+	addLaunch(compiler, header.launch);
+	
+	// The images stay in the trace until the binary is written
+	for(auto& allocation : header.allocations)
+	{
+		addAllocation(compiler, header.launch.moduleName, traceFileName,
+			allocation);
+	}
 }
 
-static void archaeopteryxCodeGen(compiler::Compiler* compiler,
-	const ExtractedDeviceState& state)
+static void archaeopteryxCodeGen(compiler::Compiler* compiler)
 {
 	codegen::ArchaeopteryxTarget target;
 
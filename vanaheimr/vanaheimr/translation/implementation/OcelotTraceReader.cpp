@@ -0,0 +1,823 @@
+/*!	\file   OcelotTraceReader.cpp
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The source file for the OcelotTraceReader class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/translation/interface/OcelotTraceReader.h>
+
+// Hydrazine Includes
+#include <hydrazine/interface/debug.h>
+
+// Standard Library Includes
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+
+namespace vanaheimr
+{
+
+namespace translation
+{
+
+typedef OcelotTraceReader::AllocationKind AllocationKind;
+typedef OcelotTraceReader::ByteVector     ByteVector;
+
+class TraceParser
+{
+public:
+	TraceParser(std::istream& stream, OcelotTraceReader::Visitor& visitor);
+
+public:
+	void parse();
+
+public:
+	/*! \brief Continue reading at an offset in the stream */
+	void seek(uint64_t offset);
+
+	/*! \brief Decode an image a piece at a time */
+	void     beginImage();
+	uint64_t decodeImage(uint8_t* storage, uint64_t bytes);
+	void     endImage(uint64_t bytes);
+
+private:
+	void _parseAllocations(AllocationKind kind);
+	void _parseAllocation(AllocationKind kind);
+	void _parseKernelLaunch();
+	void _parseModules();
+	void _parseModule();
+
+private:
+	void _parseDimensions(OcelotTraceReader::Dimensions& dimensions);
+	void _parseParameterMemory(ByteVector& memory);
+	void _parseImage(uint8_t* storage, uint64_t bytes);
+	void _skipImage();
+
+private:
+	bool        _nextMember(std::string& key, bool& isFirst);
+	bool        _nextElement(bool& isFirst);
+	std::string _parseString();
+	uint64_t    _parseUnsigned();
+	uint32_t    _parseWord();
+	void        _skipValue();
+
+private:
+	int  _peek();
+	int  _get();
+	bool _scan(char character);
+	void _expect(char character);
+	void _skipWhitespace();
+	bool _fill();
+
+	std::string _location() const;
+
+private:
+	static const size_t BufferSize = 1 << 16;
+
+private:
+	std::istream&               _stream;
+	OcelotTraceReader::Visitor& _visitor;
+
+	std::vector<char> _buffer;
+	size_t            _position;
+	size_t            _end;
+	uint64_t          _offset;
+
+private:
+	bool     _isFirstWord;
+	bool     _isImageDone;
+	uint32_t _word;
+	unsigned _wordBytes;
+
+};
+
+class OcelotTraceReader::ImageReader::Decoder
+{
+public:
+	Decoder(const std::string& traceFileName, uint64_t offset);
+
+public:
+	std::ifstream              stream;
+	OcelotTraceReader::Visitor visitor;
+	TraceParser                parser;
+};
+
+OcelotTraceReader::Dimensions::Dimensions()
+: x(1), y(1), z(1)
+{
+
+}
+
+OcelotTraceReader::KernelLaunch::KernelLaunch()
+: sharedMemorySize(0)
+{
+
+}
+
+OcelotTraceReader::Module::Module()
+: textures(0)
+{
+
+}
+
+OcelotTraceReader::Visitor::~Visitor()
+{
+
+}
+
+void* OcelotTraceReader::Visitor::visitAllocation(AllocationKind kind,
+	const std::string& device, uint64_t bytes, uint64_t offset)
+{
+	return nullptr;
+}
+
+void OcelotTraceReader::Visitor::visitKernelLaunch(const KernelLaunch& launch)
+{
+
+}
+
+void OcelotTraceReader::Visitor::visitModule(const Module& module)
+{
+
+}
+
+OcelotTraceReader::ImageReader::ImageReader(const std::string& traceFileName,
+	uint64_t offset, uint64_t bytes)
+: _traceFileName(traceFileName), _offset(offset), _bytes(bytes),
+  _position(0)
+{
+
+}
+
+OcelotTraceReader::ImageReader::~ImageReader()
+{
+
+}
+
+void OcelotTraceReader::ImageReader::read(uint64_t offset, void* data,
+	uint64_t bytes)
+{
+	assert(offset + bytes <= _bytes);
+
+	if(_decoder && offset < _position) _decoder.reset();
+
+	if(!_decoder)
+	{
+		_decoder.reset(new Decoder(_traceFileName, _offset));
+
+		_position = 0;
+	}
+
+	uint8_t skipped[4096];
+
+	while(_position < offset)
+	{
+		uint64_t decoded = _decoder->parser.decodeImage(skipped,
+			std::min<uint64_t>(sizeof(skipped), offset - _position));
+
+		if(decoded == 0) break;
+
+		_position += decoded;
+	}
+
+	uint64_t decoded = 0;
+
+	if(_position == offset)
+	{
+		decoded = _decoder->parser.decodeImage((uint8_t*)data, bytes);
+	}
+
+	std::fill((uint8_t*)data + decoded, (uint8_t*)data + bytes, 0);
+
+	_position = offset + bytes;
+
+	// Let go of the trace once the image has been read through
+	if(_position == _bytes)
+	{
+		_decoder->parser.endImage(_bytes);
+
+		_decoder.reset();
+	}
+}
+
+OcelotTraceReader::ImageReader::Decoder::Decoder(
+	const std::string& traceFileName, uint64_t offset)
+: stream(traceFileName.c_str(), std::ios::binary), parser(stream, visitor)
+{
+	if(!stream.is_open())
+	{
+		throw std::runtime_error("Failed to open Ocelot trace file '" +
+			traceFileName + "' for reading.");
+	}
+
+	parser.seek(offset);
+	parser.beginImage();
+}
+
+void OcelotTraceReader::read(std::istream& stream, Visitor& visitor)
+{
+	TraceParser parser(stream, visitor);
+
+	parser.parse();
+}
+
+TraceParser::TraceParser(std::istream& stream,
+	OcelotTraceReader::Visitor& visitor)
+: _stream(stream), _visitor(visitor), _buffer(BufferSize), _position(0),
+  _end(0), _offset(0), _isFirstWord(true), _isImageDone(true), _word(0),
+  _wordBytes(0)
+{
+
+}
+
+void TraceParser::parse()
+{
+	_skipWhitespace();
+	_expect('{');
+
+	std::string key;
+	bool isFirst = true;
+
+	while(_nextMember(key, isFirst))
+	{
+		hydrazine::log("OcelotTraceReader") << "Reading trace section '"
+			<< key << "'\n";
+
+		if(key == "allocations")
+		{
+			_parseAllocations(OcelotTraceReader::Allocation);
+		}
+		else if(key == "global_allocations")
+		{
+			_parseAllocations(OcelotTraceReader::GlobalAllocation);
+		}
+		else if(key == "post_launch_allocations")
+		{
+			_parseAllocations(OcelotTraceReader::PostLaunchAllocation);
+		}
+		else if(key == "post_launch_global_allocations")
+		{
+			_parseAllocations(OcelotTraceReader::PostLaunchGlobalAllocation);
+		}
+		else if(key == "kernelLaunch")
+		{
+			_parseKernelLaunch();
+		}
+		else if(key == "modules")
+		{
+			_parseModules();
+		}
+		else
+		{
+			_skipValue();
+		}
+	}
+}
+
+void TraceParser::_parseAllocations(AllocationKind kind)
+{
+	_expect('[');
+
+	bool isFirst = true;
+
+	while(_nextElement(isFirst))
+	{
+		_parseAllocation(kind);
+	}
+}
+
+void TraceParser::_parseAllocation(AllocationKind kind)
+{
+	_expect('{');
+
+	std::string device;
+	std::string key;
+	bool isFirst = true;
+
+	while(_nextMember(key, isFirst))
+	{
+		if(key == "device")
+		{
+			device = _parseString();
+		}
+		else if(key == "data")
+		{
+			_expect('{');
+
+			uint64_t bytes = 0;
+			bool isFirstData = true;
+
+			while(_nextMember(key, isFirstData))
+			{
+				if(key == "bytes")
+				{
+					bytes = _parseUnsigned();
+				}
+				else if(key == "image")
+				{
+					// Ocelot writes the size ahead of the image
+					auto storage = _visitor.visitAllocation(kind, device,
+						bytes, _offset + _position);
+
+					if(storage == nullptr)
+					{
+						_skipImage();
+					}
+					else
+					{
+						_parseImage((uint8_t*)storage, bytes);
+					}
+				}
+				else
+				{
+					_skipValue();
+				}
+			}
+		}
+		else
+		{
+			_skipValue();
+		}
+	}
+}
+
+void TraceParser::_parseKernelLaunch()
+{
+	_expect('{');
+
+	OcelotTraceReader::KernelLaunch launch;
+
+	std::string key;
+	bool isFirst = true;
+
+	while(_nextMember(key, isFirst))
+	{
+		if(key == "module")
+		{
+			launch.moduleName = _parseString();
+		}
+		else if(key == "kernel")
+		{
+			launch.kernelName = _parseString();
+		}
+		else if(key == "gridDim")
+		{
+			_parseDimensions(launch.gridDim);
+		}
+		else if(key == "blockDim")
+		{
+			_parseDimensions(launch.blockDim);
+		}
+		else if(key == "sharedMemorySize")
+		{
+			launch.sharedMemorySize = _parseUnsigned();
+		}
+		else if(key == "parameterMemory")
+		{
+			_parseParameterMemory(launch.parameterMemory);
+		}
+		else
+		{
+			_skipValue();
+		}
+	}
+
+	_visitor.visitKernelLaunch(launch);
+}
+
+void TraceParser::_parseModules()
+{
+	_expect('[');
+
+	bool isFirst = true;
+
+	while(_nextElement(isFirst))
+	{
+		_parseModule();
+	}
+}
+
+void TraceParser::_parseModule()
+{
+	_expect('{');
+
+	OcelotTraceReader::Module module;
+
+	std::string key;
+	bool isFirst = true;
+
+	while(_nextMember(key, isFirst))
+	{
+		if(key == "name")
+		{
+			module.name = _parseString();
+		}
+		else if(key == "ptx")
+		{
+			module.ptx = _parseString();
+		}
+		else if(key == "textures")
+		{
+			_expect('[');
+
+			bool isFirstTexture = true;
+
+			while(_nextElement(isFirstTexture))
+			{
+				_skipValue();
+
+				++module.textures;
+			}
+		}
+		else
+		{
+			_skipValue();
+		}
+	}
+
+	_visitor.visitModule(module);
+}
+
+void TraceParser::_parseDimensions(OcelotTraceReader::Dimensions& dimensions)
+{
+	_expect('[');
+
+	unsigned int* values[] = {&dimensions.x, &dimensions.y, &dimensions.z};
+
+	unsigned int index = 0;
+	bool isFirst = true;
+
+	while(_nextElement(isFirst))
+	{
+		if(index == 3)
+		{
+			throw std::runtime_error("Malformed trace at " + _location() +
+				", dimensions have more than three values.");
+		}
+
+		*values[index++] = _parseUnsigned();
+	}
+}
+
+void TraceParser::_parseParameterMemory(ByteVector& memory)
+{
+	_expect('{');
+
+	std::string key;
+	bool isFirst = true;
+
+	while(_nextMember(key, isFirst))
+	{
+		if(key == "bytes")
+		{
+			memory.resize(_parseUnsigned());
+		}
+		else if(key == "image")
+		{
+			_parseImage(memory.data(), memory.size());
+		}
+		else
+		{
+			_skipValue();
+		}
+	}
+}
+
+void TraceParser::seek(uint64_t offset)
+{
+	_stream.clear();
+	_stream.seekg(offset);
+
+	_offset   = offset;
+	_position = 0;
+	_end      = 0;
+}
+
+void TraceParser::beginImage()
+{
+	_expect('[');
+
+	_isFirstWord = true;
+	_isImageDone = false;
+	_wordBytes   = 0;
+}
+
+uint64_t TraceParser::decodeImage(uint8_t* storage, uint64_t bytes)
+{
+	uint64_t position = 0;
+
+	// Images are little-endian 32-bit words
+	while(position < bytes)
+	{
+		if(_wordBytes == 0)
+		{
+			if(_isImageDone) break;
+
+			if(!_nextElement(_isFirstWord))
+			{
+				_isImageDone = true;
+				break;
+			}
+
+			_word      = _parseWord();
+			_wordBytes = 4;
+		}
+
+		storage[position++] = (uint8_t)_word;
+
+		_word >>= 8;
+		--_wordBytes;
+	}
+
+	return position;
+}
+
+void TraceParser::endImage(uint64_t bytes)
+{
+	if(_isImageDone) return;
+
+	// The bytes of the last word past the end of the image are dropped
+	if(_nextElement(_isFirstWord))
+	{
+		std::stringstream message;
+
+		message << "Malformed trace at " << _location()
+			<< ", image is larger than " << bytes << " bytes.";
+
+		throw std::runtime_error(message.str());
+	}
+
+	_isImageDone = true;
+}
+
+void TraceParser::_parseImage(uint8_t* storage, uint64_t bytes)
+{
+	beginImage();
+
+	// A partial last word may be left out, the storage keeps whatever it
+	//  held for those bytes
+	decodeImage(storage, bytes);
+
+	endImage(bytes);
+}
+
+void TraceParser::_skipImage()
+{
+	_expect('[');
+
+	// Images hold nothing but numbers, so the first ']' closes them
+	while(true)
+	{
+		if(_position == _end && !_fill())
+		{
+			throw std::runtime_error("Malformed trace, hit the end of the "
+				"file in an image.");
+		}
+
+		auto begin = &_buffer[_position];
+		auto close = (const char*)std::memchr(begin, ']', _end - _position);
+
+		if(close != nullptr)
+		{
+			_position += close - begin + 1;
+			return;
+		}
+
+		_position = _end;
+	}
+}
+
+bool TraceParser::_nextMember(std::string& key, bool& isFirst)
+{
+	_skipWhitespace();
+
+	if(_scan('}')) return false;
+
+	if(!isFirst)
+	{
+		_expect(',');
+		_skipWhitespace();
+	}
+
+	isFirst = false;
+
+	key = _parseString();
+
+	_skipWhitespace();
+	_expect(':');
+	_skipWhitespace();
+
+	return true;
+}
+
+bool TraceParser::_nextElement(bool& isFirst)
+{
+	_skipWhitespace();
+
+	if(_scan(']')) return false;
+
+	if(!isFirst)
+	{
+		_expect(',');
+		_skipWhitespace();
+	}
+
+	isFirst = false;
+
+	return true;
+}
+
+std::string TraceParser::_parseString()
+{
+	_expect('"');
+
+	std::string result;
+
+	// PTX is written with raw newlines, only quotes and escapes end a run
+	while(true)
+	{
+		if(_position == _end && !_fill())
+		{
+			throw std::runtime_error("Malformed trace, hit the end of the "
+				"file in a string.");
+		}
+
+		size_t run = _position;
+
+		while(run < _end && _buffer[run] != '"' && _buffer[run] != '\\')
+		{
+			++run;
+		}
+
+		result.append(&_buffer[_position], run - _position);
+
+		_position = run;
+
+		if(_position == _end) continue;
+
+		if(_get() == '"') break;
+
+		int escaped = _get();
+
+		switch(escaped)
+		{
+		case 'n': result.push_back('\n'); break;
+		case 't': result.push_back('\t'); break;
+		case 'r': result.push_back('\r'); break;
+		case EOF:
+		{
+			throw std::runtime_error("Malformed trace, hit the end of the "
+				"file in a string.");
+		}
+		default: result.push_back((char)escaped); break;
+		}
+	}
+
+	return result;
+}
+
+uint64_t TraceParser::_parseUnsigned()
+{
+	uint64_t value  = 0;
+	unsigned int digits = 0;
+
+	for(int c = _peek(); c >= '0' && c <= '9'; c = _peek())
+	{
+		value = value * 10 + (c - '0');
+
+		++_position;
+		++digits;
+	}
+
+	if(digits == 0)
+	{
+		throw std::runtime_error("Malformed trace at " + _location() +
+			", expecting a number.");
+	}
+
+	return value;
+}
+
+uint32_t TraceParser::_parseWord()
+{
+	bool isNegative = _scan('-');
+
+	uint64_t value = _parseUnsigned();
+
+	if(value > (isNegative ? 0x80000000ULL : 0xffffffffULL))
+	{
+		throw std::runtime_error("Malformed trace at " + _location() +
+			", image word does not fit in 32 bits.");
+	}
+
+	return isNegative ? (uint32_t)(0 - value) : (uint32_t)value;
+}
+
+void TraceParser::_skipValue()
+{
+	int c = _peek();
+
+	if(c == '{')
+	{
+		_get();
+
+		std::string key;
+		bool isFirst = true;
+
+		while(_nextMember(key, isFirst)) _skipValue();
+	}
+	else if(c == '[')
+	{
+		_get();
+
+		bool isFirst = true;
+
+		while(_nextElement(isFirst)) _skipValue();
+	}
+	else if(c == '"')
+	{
+		_parseString();
+	}
+	else
+	{
+		// numbers, true, false and null
+		for(c = _peek(); c != EOF && c != ',' && c != '}' && c != ']' &&
+			!std::isspace(c); c = _peek())
+		{
+			++_position;
+		}
+	}
+}
+
+int TraceParser::_peek()
+{
+	if(_position == _end && !_fill()) return EOF;
+
+	return (uint8_t)_buffer[_position];
+}
+
+int TraceParser::_get()
+{
+	int c = _peek();
+
+	if(c != EOF) ++_position;
+
+	return c;
+}
+
+bool TraceParser::_scan(char character)
+{
+	if(_peek() != (uint8_t)character) return false;
+
+	++_position;
+
+	return true;
+}
+
+void TraceParser::_expect(char character)
+{
+	if(!_scan(character))
+	{
+		throw std::runtime_error("Malformed trace at " + _location() +
+			", expecting '" + std::string(1, character) + "'.");
+	}
+}
+
+void TraceParser::_skipWhitespace()
+{
+	for(int c = _peek(); c != EOF && std::isspace(c); c = _peek())
+	{
+		++_position;
+	}
+}
+
+bool TraceParser::_fill()
+{
+	_offset += _end;
+
+	_stream.read(_buffer.data(), _buffer.size());
+
+	_position = 0;
+	_end      = _stream.gcount();
+
+	return _end > 0;
+}
+
+std::string TraceParser::_location() const
+{
+	std::stringstream stream;
+
+	stream << "byte " << (_offset + _position);
+
+	return stream.str();
+}
+
+}
+
+}
+
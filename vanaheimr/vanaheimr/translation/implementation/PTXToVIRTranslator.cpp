@@ -11,6 +11,8 @@
 
 #include <vanaheimr/compiler/interface/Compiler.h>
 
+#include <vanaheimr/util/interface/ThreadPool.h>
+
 #include <configure.h>
 
 // Ocelot Includes
@@ -41,8 +43,9 @@ namespace vanaheimr
 namespace translation
 {
 
-PTXToVIRTranslator::PTXToVIRTranslator(compiler::Compiler* compiler)
-: _compiler(compiler)
+PTXToVIRTranslator::PTXToVIRTranslator(compiler::Compiler* compiler,
+	unsigned int threads)
+: _compiler(compiler), _threads(threads)
 {
 
 }
@@ -61,12 +64,31 @@ void PTXToVIRTranslator::translate(const PTXModule& m)
 		_translateGlobal(global->second);
 	}
 	
-	// Translate kernel functions
+	// Translate kernel and function prototypes
+	KernelBodyVector bodies;
+	
 	for(PTXModule::KernelMap::const_iterator kernel = m.kernels().begin();
 		kernel != m.kernels().end(); ++kernel)
 	{
-		_translateKernel(*kernel->second);
+		bodies.push_back(_translateKernelPrototype(*kernel->second));
 	}
+	
+	// Translate kernel and function bodies
+	_translateKernelBodies(bodies);
+}
+
+PTXToVIRTranslator::PendingTarget::PendingTarget(Call* c,
+	const std::string& n, bool s)
+: call(c), name(n), isSpecial(s)
+{
+
+}
+
+PTXToVIRTranslator::KernelBody::KernelBody(const PTXKernel* k,
+	ir::Function* f)
+: kernel(k), function(f)
+{
+
 }
 
 void PTXToVIRTranslator::_translateParameter(const PTXParameter& parameter)
@@ -117,7 +139,8 @@ static ::ir::ControlFlowGraph::BlockPointerVector
 	return pass.blocks;
 }
 
-void PTXToVIRTranslator::_translateKernel(const PTXKernel& kernel)
+PTXToVIRTranslator::KernelBody PTXToVIRTranslator::_translateKernelPrototype(
+	const PTXKernel& kernel)
 {
 	report(" Translating PTX kernel '" << kernel.getPrototype().toString());
 
@@ -153,8 +176,57 @@ void PTXToVIRTranslator::_translateKernel(const PTXKernel& kernel)
 	
 	_function->interpretType();
 
+	KernelBody body(&kernel, _function);
+
+	// The layout pass goes through the shared PTX module, run it up front
+	::ir::ControlFlowGraph::BlockPointerVector sequence =
+		getBlockSequence(kernel);
+
+	for(::ir::ControlFlowGraph::BlockPointerVector::iterator
+		block = sequence.begin(); block != sequence.end(); ++block)
+	{
+		if(*block == kernel.cfg()->get_entry_block()) continue;
+		if(*block == kernel.cfg()->get_exit_block())  continue;
+
+		body.blocks.push_back(&**block);
+	}
+	
+	_function = nullptr;
+	
+	return body;
+}
+
+void PTXToVIRTranslator::_translateKernelBodies(KernelBodyVector& bodies)
+{
+	util::ThreadPool pool(bodies.size() > 1 ? _threads : 1);
+	
+	report(" Translating " << bodies.size() << " PTX kernel bodies with "
+		<< pool.size() << " threads.");
+	
+	// Bodies only read the module, each one has its own translator state
+	pool.parallelFor(bodies.size(), [&](size_t i)
+	{
+		PTXToVIRTranslator translator(*this);
+		
+		translator._translateKernelBody(bodies[i]);
+	});
+	
+	// Add intrinsic prototypes in the order of a sequential translation
+	for(auto& body : bodies)
+	{
+		_resolvePendingTargets(body);
+	}
+}
+
+void PTXToVIRTranslator::_translateKernelBody(KernelBody& body)
+{
+	report(" Translating PTX kernel body '" << body.kernel->name << "'");
+
+	_function = body.function;
+	
 	// Translate Values
-	PTXKernel::RegisterVector registers = kernel.getReferencedRegisters();
+	PTXKernel::RegisterVector registers =
+		body.kernel->getReferencedRegisters();
 	
 	for(PTXKernel::RegisterVector::iterator reg = registers.begin();
 		reg != registers.end(); ++reg)
@@ -163,38 +235,57 @@ void PTXToVIRTranslator::_translateKernel(const PTXKernel& kernel)
 	}
 	
 	// Translate locals
-	for(auto local = kernel.locals.begin();
-		local != kernel.locals.end(); ++local)
+	for(auto local = body.kernel->locals.begin();
+		local != body.kernel->locals.end(); ++local)
 	{
 		_translateLocal(local->second);
 	}
 	
-	::ir::ControlFlowGraph::BlockPointerVector sequence =
-		getBlockSequence(kernel);
-
 	// Keep a record of blocks
-	for(::ir::ControlFlowGraph::BlockPointerVector::iterator
-		block = sequence.begin(); block != sequence.end(); ++block)
+	for(auto block : body.blocks)
 	{
-		if(*block == kernel.cfg()->get_entry_block()) continue;
-		if(*block == kernel.cfg()->get_exit_block())  continue;
-		_recordBasicBlock(**block);
+		_recordBasicBlock(*block);
 	}
 	
 	// Translate blocks
-	for(::ir::ControlFlowGraph::BlockPointerVector::iterator
-		block = sequence.begin(); block != sequence.end(); ++block)
+	for(auto block : body.blocks)
 	{
-		if(*block == kernel.cfg()->get_entry_block()) continue;
-		if(*block == kernel.cfg()->get_exit_block())  continue;
-
-		_translateBasicBlock(**block);
+		_translateBasicBlock(*block);
 	}
 	
+	body.targets = std::move(_pendingTargets);
+	
+	_pendingTargets.clear();
 	_registers.clear();
 	_blocks.clear();
 }
 
+void PTXToVIRTranslator::_resolvePendingTargets(KernelBody& body)
+{
+	_function = body.function;
+
+	for(auto& target : body.targets)
+	{
+		if(target.isSpecial)
+		{
+			_addSpecialPrototype(target.name);
+		}
+		else
+		{
+			_addPrototype(target.name, *target.call);
+		}
+		
+		target.call->setTarget(new ir::AddressOperand(
+			_getGlobal(target.name), target.call));
+		
+		report("  Resolved call " << target.call->toString());
+	}
+	
+	body.targets.clear();
+	
+	_function = nullptr;
+}
+
 void PTXToVIRTranslator::_translateLocal(const PTXLocal& local)
 {
 	report("  Translating PTX local " << local.toString());
@@ -1074,14 +1165,9 @@ void PTXToVIRTranslator::_translateSimpleIntrinsic(const PTXInstruction& ptx)
 		stream << "_" << translateTypeName(ptx.type);
 	}
 	
-	_addPrototype(stream.str(), *call);
-	
-	call->setTarget(new ir::AddressOperand(_getGlobal(stream.str()),
-		_instruction));
+	_addPendingTarget(call, stream.str(), false);
 
 	_block->push_back(call);
-	
-	report("    to " << call->toString());
 }
 
 void PTXToVIRTranslator::_translateCall(const PTXInstruction& ptx)
@@ -1094,13 +1180,7 @@ void PTXToVIRTranslator::_translateCall(const PTXInstruction& ptx)
 	if(ptx.a.addressMode == PTXOperand::FunctionName)
 	{
 		// direct call
-		_addPrototype(ptx.a.identifier, *call);
-		
-		auto function = _getGlobal(ptx.a.identifier);
-			
-		assert(function != nullptr);
-		
-		call->setTarget(new ir::AddressOperand(function, _instruction));
+		_addPendingTarget(call, ptx.a.identifier, false);
 	}
 	else
 	{
@@ -1126,7 +1206,9 @@ void PTXToVIRTranslator::_translateCall(const PTXInstruction& ptx)
 	
 	_block->push_back(call);
 	
-	report("    to " << call->toString());
+	// Direct calls are reported once their target is resolved
+	reportE(ptx.a.addressMode != PTXOperand::FunctionName,
+		"    to " << call->toString());
 }
 
 ir::Operand* PTXToVIRTranslator::_newTranslatedOperand(const PTXOperand& ptx)
@@ -1272,8 +1354,6 @@ ir::VirtualRegister* PTXToVIRTranslator::_getSpecialVirtualRegister(
 			PTXOperand::toString((PTXOperand::VectorIndex)vectorIndex);
 	}
 	
-	_addSpecialPrototype(stream.str());
-
 	ir::Call* call = new ir::Call(_block);
 	
 	call->setGuard(_translatePredicateOperand(PTXOperand::PT));
@@ -1283,14 +1363,11 @@ ir::VirtualRegister* PTXToVIRTranslator::_getSpecialVirtualRegister(
 
 	call->addReturn(specialValue);
 	
-	call->setTarget(new ir::AddressOperand(
-		_getGlobal(stream.str()), _instruction));
+	_addPendingTarget(call, stream.str(), true);
 
 	_block->push_back(call);
 	
-	report("    to " << call->toString());
-	
-	return specialValue->virtualRegister;
+	return specialValue->virtualRegister();
 }
 
 ir::VirtualRegister* PTXToVIRTranslator::_getRegister(PTXRegisterId id)
@@ -1593,6 +1670,13 @@ void PTXToVIRTranslator::_addPrototype(const std::string& name,
 	function->interpretType();
 }
 
+void PTXToVIRTranslator::_addPendingTarget(Call* call,
+	const std::string& name, bool isSpecial)
+{
+	// Prototypes change the module, they wait until every body is done
+	_pendingTargets.push_back(PendingTarget(call, name, isSpecial));
+}
+
 }
 
 }
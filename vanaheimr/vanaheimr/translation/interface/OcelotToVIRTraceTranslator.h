@@ -18,10 +18,19 @@ namespace vanaheimr
 namespace translation
 {
 
+/*! \brief Translates an Ocelot device state trace into a VIR module
+
+	Each allocation image becomes a global whose initializer is streamed
+	from the trace.  The module never holds an image, the binary writer
+	decodes it a page at a time into the data section, so the trace must
+	stay in place until the module is written.
+*/
 class OcelotToVIRTraceTranslator
 {
 public:
-	OcelotToVIRTraceTranslator(compiler::Compiler* compiler);
+	/*! \brief 0 threads uses the hardware concurrency */
+	OcelotToVIRTraceTranslator(compiler::Compiler* compiler,
+		unsigned int threads = 0);
 
 public:
 	void translate(const std::string& traceFileName);
@@ -31,6 +40,7 @@ public:
 
 private:
 	compiler::Compiler* _compiler;
+	unsigned int        _threads;
 	
 	std::string _translatedModuleName;
 };
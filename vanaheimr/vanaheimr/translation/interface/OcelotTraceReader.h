@@ -0,0 +1,147 @@
+/*!	\file   OcelotTraceReader.h
+	\author agent <agent@local>
+	\date   Sunday October 18, 2026
+	\brief  The header file for the OcelotTraceReader class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <string>
+#include <vector>
+#include <istream>
+#include <memory>
+#include <cstdint>
+
+namespace vanaheimr
+{
+
+namespace translation
+{
+
+/*! \brief Streams an Ocelot device state trace without building a JSON tree
+
+	The trace is read through a fixed size buffer and reported to a visitor
+	one section at a time.  Allocation images, which make up nearly all of
+	a trace, are decoded straight into storage supplied by the visitor, or
+	skipped without being decoded.  A skipped image can be decoded later,
+	a piece at a time, by an ImageReader.  The reader itself keeps no JSON
+	tree and no copy of an image.
+*/
+class OcelotTraceReader
+{
+public:
+	typedef std::vector<uint8_t> ByteVector;
+
+	class Dimensions
+	{
+	public:
+		Dimensions();
+
+	public:
+		unsigned int x;
+		unsigned int y;
+		unsigned int z;
+	};
+
+	class KernelLaunch
+	{
+	public:
+		KernelLaunch();
+
+	public:
+		std::string moduleName;
+		std::string kernelName;
+
+		Dimensions gridDim;
+		Dimensions blockDim;
+
+		uint64_t   sharedMemorySize;
+		ByteVector parameterMemory;
+	};
+
+	class Module
+	{
+	public:
+		Module();
+
+	public:
+		std::string name;
+		std::string ptx;
+
+		unsigned int textures;
+	};
+
+	/*! \brief The trace sections that hold memory images */
+	enum AllocationKind
+	{
+		Allocation,
+		GlobalAllocation,
+		PostLaunchAllocation,
+		PostLaunchGlobalAllocation
+	};
+
+	class Visitor
+	{
+	public:
+		virtual ~Visitor();
+
+	public:
+		/*! \brief Return storage for the image of an allocation
+
+			\param device The device pointer, as spelled in the trace
+			\param bytes  The size of the image, the storage must hold it
+			\param offset Where the image starts in the trace, for an
+				ImageReader
+			\return The storage, or 0 to skip the image without decoding it
+		*/
+		virtual void* visitAllocation(AllocationKind kind,
+			const std::string& device, uint64_t bytes, uint64_t offset);
+
+		virtual void visitKernelLaunch(const KernelLaunch& launch);
+		virtual void visitModule(const Module& module);
+	};
+
+	/*! \brief Decodes one image of a trace on demand
+
+		Only a fixed buffer is held however large the image is.  The trace
+		is opened by the first read and closed once the end of the image
+		has been read.
+	*/
+	class ImageReader
+	{
+	public:
+		/*! \brief The offset is the one the visitor was given */
+		ImageReader(const std::string& traceFileName, uint64_t offset,
+			uint64_t bytes);
+		~ImageReader();
+
+	public:
+		/*! \brief Copy bytes of the image, words left out at the end read
+			as zero.  Reading front to back is fastest, reading behind
+			the previous read starts over from the beginning. */
+		void read(uint64_t offset, void* data, uint64_t bytes);
+
+	private:
+		class Decoder;
+
+		typedef std::unique_ptr<Decoder> DecoderPointer;
+
+	private:
+		std::string    _traceFileName;
+		uint64_t       _offset;
+		uint64_t       _bytes;
+		uint64_t       _position;
+		DecoderPointer _decoder;
+	};
+
+public:
+	/*! \brief Read a trace, reporting each section to the visitor */
+	void read(std::istream& stream, Visitor& visitor);
+
+};
+
+}
+
+}
+
@@ -13,6 +13,7 @@
 // Standard Library Includes
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 // Forward Declarations
                       namespace ir       { class Module;           }
@@ -36,13 +37,23 @@ namespace vanaheimr
 namespace translation
 {
 
+/*! \brief Translates a PTX module into a new Vanaheimr module
+
+	Globals and the prototypes of every kernel and function are translated
+	first, in module order.  Bodies are then translated concurrently, each
+	into its own ir::Function.  Intrinsic prototypes needed by the bodies
+	are added afterwards in the order a sequential translation would add
+	them, so the result does not depend on the number of threads.
+*/
 class PTXToVIRTranslator
 {
 public:
 	typedef ::ir::Module PTXModule;
 
 public:
-	PTXToVIRTranslator(compiler::Compiler* compiler);
+	/*! \brief 0 threads uses the hardware concurrency */
+	PTXToVIRTranslator(compiler::Compiler* compiler,
+		unsigned int threads = 0);
 	
 public:
 	/*! \brief Translate the specified PTX module, adding it to the
@@ -66,9 +77,41 @@ private:
 	typedef unsigned int PTXAttribute;
 	typedef unsigned int PTXLinkingDirective;
 
+	/*! \brief A call whose target is added once all bodies are done */
+	class PendingTarget
+	{
+	public:
+		PendingTarget(Call* call, const std::string& name, bool isSpecial);
+
+	public:
+		Call*       call;
+		std::string name;
+		bool        isSpecial;
+	};
+
+	typedef std::vector<PendingTarget>        PendingTargetVector;
+	typedef std::vector<const PTXBasicBlock*> PTXBasicBlockVector;
+
+	class KernelBody
+	{
+	public:
+		KernelBody(const PTXKernel* kernel, ir::Function* function);
+
+	public:
+		const PTXKernel*    kernel;
+		ir::Function*       function;
+		PTXBasicBlockVector blocks;
+		PendingTargetVector targets;
+	};
+
+	typedef std::vector<KernelBody> KernelBodyVector;
+
 private:
 	void _translateGlobal(const PTXGlobal&);
-	void _translateKernel(const PTXKernel&);
+	KernelBody _translateKernelPrototype(const PTXKernel&);
+	void _translateKernelBodies(KernelBodyVector& bodies);
+	void _translateKernelBody(KernelBody& body);
+	void _resolvePendingTargets(KernelBody& body);
 	void _translateLocal(const PTXLocal&);
 	void _translateParameter(const PTXParameter& argument);
 	void _translateRegisterValue(PTXRegisterId, PTXDataType);
@@ -126,9 +169,13 @@ private:
 	void                  _addSpecialPrototype(const std::string& name);
 	void                  _addPrototype(const std::string& name,
 	                                    const Call& call);
+	void                  _addPendingTarget(Call* call,
+	                                        const std::string& name,
+	                                        bool isSpecial);
 	
 private:
 	compiler::Compiler* _compiler;
+	unsigned int        _threads;
 	ir::Module*         _module;
 	ir::Function*       _function;
 	ir::BasicBlock*     _block;
@@ -137,8 +184,9 @@ private:
 	const PTXModule*      _ptx;
 	const PTXInstruction* _ptxInstruction;
 	
-	RegisterMap   _registers;
-	BasicBlockMap _blocks;
+	RegisterMap         _registers;
+	BasicBlockMap       _blocks;
+	PendingTargetVector _pendingTargets;
 	
 };
 
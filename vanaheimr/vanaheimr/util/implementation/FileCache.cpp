@@ -0,0 +1,482 @@
+/*! \file   FileCache.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the FileCache class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/FileCache.h>
+#include <vanaheimr/util/interface/MappedFile.h>
+
+// Standard Library Includes
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+
+// System Includes
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+static const char* entryExtension = ".vir";
+
+static std::string errorMessage(const std::string& action,
+	const std::string& path)
+{
+	return "Failed to " + action + " '" + path + "': " + std::strerror(errno);
+}
+
+static uint64_t rotate(uint64_t value, unsigned int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t finalize(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+
+	return value;
+}
+
+/*! \brief Two independent 64-bit multiply-rotate lanes over 8 byte words */
+class Digest
+{
+public:
+	Digest()
+	: _low(0x9e3779b97f4a7c15ULL), _high(0xc2b2ae3d27d4eb4fULL)
+	{
+
+	}
+
+public:
+	void add(const char* data, size_t size)
+	{
+		const char* end = data + size;
+
+		for(; end - data >= 8; data += 8)
+		{
+			uint64_t word = 0;
+
+			std::memcpy(&word, data, 8);
+
+			_addWord(word);
+		}
+
+		// The tail is padded with its length so that "a" and "a\0" differ
+		uint64_t word = static_cast<uint64_t>(end - data) << 56;
+
+		std::memcpy(&word, data, end - data);
+
+		_addWord(word);
+		_addWord(size);
+	}
+
+	std::string hex() const
+	{
+		uint64_t low  = finalize(_low ^ rotate(_high, 17));
+		uint64_t high = finalize(_high + low);
+
+		char buffer[33];
+
+		std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+			static_cast<unsigned long long>(high),
+			static_cast<unsigned long long>(low));
+
+		return buffer;
+	}
+
+private:
+	void _addWord(uint64_t word)
+	{
+		_low  = rotate(_low  ^ (word * 0x87c37b91114253d5ULL), 31)
+			* 0x4cf5ad432745937fULL;
+		_high = rotate(_high ^ (word * 0x4cf5ad432745937fULL), 27)
+			* 0x87c37b91114253d5ULL + _low;
+	}
+
+private:
+	uint64_t _low;
+	uint64_t _high;
+
+};
+
+/*! \brief Holds an exclusive lock on a file for as long as it lives */
+class FileLock
+{
+public:
+	FileLock(const std::string& path)
+	: _descriptor(open(path.c_str(), O_RDWR | O_CREAT, 0644))
+	{
+		if(_descriptor < 0)
+		{
+			throw std::runtime_error(errorMessage("open", path));
+		}
+
+		while(flock(_descriptor, LOCK_EX) != 0)
+		{
+			if(errno == EINTR) continue;
+
+			std::string message = errorMessage("lock", path);
+
+			close(_descriptor);
+
+			throw std::runtime_error(message);
+		}
+	}
+
+	~FileLock()
+	{
+		// Closing the descriptor releases the lock
+		close(_descriptor);
+	}
+
+private:
+	FileLock(const FileLock&);
+	FileLock& operator=(const FileLock&);
+
+private:
+	int _descriptor;
+
+};
+
+FileCache::Statistics::Statistics()
+: hits(0), misses(0), insertions(0), evictions(0)
+{
+
+}
+
+FileCache::FileCache(const std::string& directory, uint64_t maximumBytes)
+: _directory(directory), _maximumBytes(maximumBytes)
+{
+	if(mkdir(_directory.c_str(), 0755) != 0 && errno != EEXIST)
+	{
+		throw std::runtime_error(errorMessage("create cache directory",
+			_directory));
+	}
+}
+
+std::string FileCache::makeKey(const char* data, size_t size,
+	const std::string& context)
+{
+	Digest digest;
+
+	digest.add(context.data(), context.size());
+	digest.add(data, size);
+
+	return digest.hex();
+}
+
+bool FileCache::lookup(const std::string& key, std::string& data)
+{
+	std::string path = _entryPath(key);
+
+	bool hit = false;
+
+	struct stat status;
+
+	if(stat(path.c_str(), &status) == 0)
+	{
+		// The entry may be evicted by another process before it is mapped
+		try
+		{
+			MappedFile file(path);
+
+			data.assign(file.data(), file.size());
+
+			hit = true;
+		}
+		catch(const std::runtime_error&)
+		{
+
+		}
+	}
+
+	if(hit)
+	{
+		// Mark the entry as recently used
+		utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+	}
+
+	Statistics delta;
+
+	if(hit)
+	{
+		delta.hits = 1;
+	}
+	else
+	{
+		delta.misses = 1;
+	}
+
+	_record(delta);
+
+	return hit;
+}
+
+void FileCache::insert(const std::string& key, const std::string& data)
+{
+	Statistics delta;
+
+	// An entry that can never fit would only evict everything else
+	if(data.size() <= _maximumBytes)
+	{
+		_writeAtomically(_entryPath(key), data);
+
+		delta.insertions = 1;
+	}
+
+	// Still evict, the budget may have shrunk since the last insertion
+	delta.evictions = _evict();
+
+	_record(delta);
+}
+
+FileCache::Statistics FileCache::statistics() const
+{
+	Statistics statistics;
+
+	std::ifstream file(_statisticsPath().c_str());
+
+	std::string name;
+	uint64_t    value = 0;
+
+	while(file >> name >> value)
+	{
+		if(name == "hits")            statistics.hits       = value;
+		else if(name == "misses")     statistics.misses     = value;
+		else if(name == "insertions") statistics.insertions = value;
+		else if(name == "evictions")  statistics.evictions  = value;
+	}
+
+	return statistics;
+}
+
+class Entry
+{
+public:
+	std::string path;
+	uint64_t    bytes;
+	timespec    lastUse;
+};
+
+typedef std::vector<Entry> EntryVector;
+
+static bool endsWith(const std::string& name, const std::string& suffix)
+{
+	return name.size() > suffix.size() &&
+		name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static EntryVector listEntries(const std::string& directory)
+{
+	EntryVector entries;
+
+	DIR* handle = opendir(directory.c_str());
+
+	if(handle == nullptr)
+	{
+		throw std::runtime_error(errorMessage("list cache directory",
+			directory));
+	}
+
+	while(dirent* element = readdir(handle))
+	{
+		std::string name = element->d_name;
+
+		if(!endsWith(name, entryExtension)) continue;
+
+		Entry entry;
+
+		entry.path = directory + "/" + name;
+
+		struct stat status;
+
+		// Another process may have evicted it already
+		if(stat(entry.path.c_str(), &status) != 0) continue;
+
+		entry.bytes   = status.st_size;
+		entry.lastUse = status.st_mtim;
+
+		entries.push_back(entry);
+	}
+
+	closedir(handle);
+
+	return entries;
+}
+
+uint64_t FileCache::bytes() const
+{
+	uint64_t total = 0;
+
+	for(auto& entry : listEntries(_directory))
+	{
+		total += entry.bytes;
+	}
+
+	return total;
+}
+
+const std::string& FileCache::directory() const
+{
+	return _directory;
+}
+
+uint64_t FileCache::maximumBytes() const
+{
+	return _maximumBytes;
+}
+
+std::string FileCache::_entryPath(const std::string& key) const
+{
+	return _directory + "/" + key + entryExtension;
+}
+
+std::string FileCache::_statisticsPath() const
+{
+	return _directory + "/statistics";
+}
+
+std::string FileCache::_statisticsLockPath() const
+{
+	return _directory + "/statistics.lock";
+}
+
+void FileCache::_writeAtomically(const std::string& path,
+	const std::string& data) const
+{
+	std::stringstream temporaryPath;
+
+	temporaryPath << path << "." << getpid() << ".tmp";
+
+	std::string temporary = temporaryPath.str();
+
+	int descriptor = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+		0644);
+
+	if(descriptor < 0)
+	{
+		throw std::runtime_error(errorMessage("create", temporary));
+	}
+
+	const char* position = data.data();
+	size_t      remaining = data.size();
+
+	while(remaining > 0)
+	{
+		ssize_t written = write(descriptor, position, remaining);
+
+		if(written < 0)
+		{
+			if(errno == EINTR) continue;
+
+			std::string message = errorMessage("write", temporary);
+
+			close(descriptor);
+			unlink(temporary.c_str());
+
+			throw std::runtime_error(message);
+		}
+
+		position  += written;
+		remaining -= written;
+	}
+
+	close(descriptor);
+
+	if(rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		std::string message = errorMessage("rename", temporary);
+
+		unlink(temporary.c_str());
+
+		throw std::runtime_error(message);
+	}
+}
+
+static bool isOlder(const Entry& left, const Entry& right)
+{
+	if(left.lastUse.tv_sec != right.lastUse.tv_sec)
+	{
+		return left.lastUse.tv_sec < right.lastUse.tv_sec;
+	}
+
+	return left.lastUse.tv_nsec < right.lastUse.tv_nsec;
+}
+
+unsigned int FileCache::_evict()
+{
+	EntryVector entries = listEntries(_directory);
+
+	uint64_t total = 0;
+
+	for(auto& entry : entries)
+	{
+		total += entry.bytes;
+	}
+
+	if(total <= _maximumBytes) return 0;
+
+	std::sort(entries.begin(), entries.end(), isOlder);
+
+	unsigned int evicted = 0;
+
+	for(auto& entry : entries)
+	{
+		if(total <= _maximumBytes) break;
+
+		// Losing a race with another evicting process is harmless
+		if(unlink(entry.path.c_str()) == 0)
+		{
+			++evicted;
+		}
+
+		total -= entry.bytes;
+	}
+
+	return evicted;
+}
+
+void FileCache::_record(const Statistics& delta)
+{
+	// Other processes update the counters between the read and the rename
+	FileLock lock(_statisticsLockPath());
+
+	Statistics totals = statistics();
+
+	totals.hits       += delta.hits;
+	totals.misses     += delta.misses;
+	totals.insertions += delta.insertions;
+	totals.evictions  += delta.evictions;
+
+	std::stringstream stream;
+
+	stream << "hits "       << totals.hits       << "\n";
+	stream << "misses "     << totals.misses     << "\n";
+	stream << "insertions " << totals.insertions << "\n";
+	stream << "evictions "  << totals.evictions  << "\n";
+
+	_writeAtomically(_statisticsPath(), stream.str());
+}
+
+}
+
+}
+
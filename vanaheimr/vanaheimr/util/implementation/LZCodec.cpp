@@ -0,0 +1,175 @@
+/*! \file   LZCodec.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the LZCodec class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/LZCodec.h>
+
+// Standard Library Includes
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+static const unsigned int HashBits = 12;
+
+static uint32_t read32(const uint8_t* data)
+{
+	uint32_t value;
+
+	std::memcpy(&value, data, sizeof(uint32_t));
+
+	return value;
+}
+
+static uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+/*! \brief Appends to the output buffer, remembering if it overflowed */
+class BlockWriter
+{
+public:
+	BlockWriter(uint8_t* begin, size_t capacity)
+	: begin(begin), position(begin), end(begin + capacity) {}
+
+public:
+	void byte(unsigned int value)
+	{
+		if(position == end)
+		{
+			position = nullptr;
+			end      = nullptr;
+		}
+
+		if(position == nullptr) return;
+
+		*position++ = value;
+	}
+
+	void length(size_t value)
+	{
+		if(value < 15) return;
+
+		for(value -= 15; value >= 255; value -= 255) byte(255);
+
+		byte(value);
+	}
+
+	void bytes(const uint8_t* data, size_t size)
+	{
+		if(position == nullptr || (size_t)(end - position) < size)
+		{
+			position = nullptr;
+			end      = nullptr;
+
+			return;
+		}
+
+		std::memcpy(position, data, size);
+
+		position += size;
+	}
+
+	void sequence(const uint8_t* literals, size_t literalCount,
+		size_t distance, size_t matchLength)
+	{
+		size_t matchCode = matchLength - LZCodec::MinimumMatch;
+
+		byte((std::min<size_t>(literalCount, 15) << 4) |
+			std::min<size_t>(matchCode, 15));
+
+		length(literalCount);
+		bytes(literals, literalCount);
+
+		byte(distance & 0xff);
+		byte(distance >> 8);
+
+		length(matchCode);
+	}
+
+	/*! \brief The compressed size, or 0 on overflow */
+	size_t size() const
+	{
+		if(position == nullptr) return 0;
+
+		return position - begin;
+	}
+
+public:
+	uint8_t* begin;
+	uint8_t* position;
+	uint8_t* end;
+};
+
+size_t LZCodec::compress(const void* input, size_t inputSize,
+	void* output, size_t outputCapacity)
+{
+	const uint8_t* in = static_cast<const uint8_t*>(input);
+
+	BlockWriter writer(static_cast<uint8_t*>(output), outputCapacity);
+
+	// Positions are stored plus one, zero is an empty slot
+	std::vector<uint32_t> table(1 << HashBits, 0);
+
+	size_t anchor   = 0;
+	size_t position = 0;
+
+	while(position + MinimumMatch <= inputSize)
+	{
+		uint32_t sequence = read32(in + position);
+		uint32_t slot     = hash(sequence);
+
+		size_t candidate = table[slot];
+
+		table[slot] = position + 1;
+
+		if(candidate == 0 || position + 1 - candidate > MaximumDistance ||
+			read32(in + candidate - 1) != sequence)
+		{
+			++position;
+			continue;
+		}
+
+		--candidate;
+
+		size_t length = MinimumMatch;
+
+		while(position + length < inputSize &&
+			in[candidate + length] == in[position + length])
+		{
+			++length;
+		}
+
+		writer.sequence(in + anchor, position - anchor,
+			position - candidate, length);
+
+		if(writer.size() == 0) return 0;
+
+		position += length;
+		anchor    = position;
+	}
+
+	if(anchor < inputSize || inputSize == 0)
+	{
+		// Literals only, ends the block
+		writer.byte(std::min<size_t>(inputSize - anchor, 15) << 4);
+		writer.length(inputSize - anchor);
+		writer.bytes(in + anchor, inputSize - anchor);
+	}
+
+	return writer.size();
+}
+
+}
+
+}
+
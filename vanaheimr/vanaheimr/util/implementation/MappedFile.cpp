@@ -0,0 +1,101 @@
+/*! \file   MappedFile.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the MappedFile class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/MappedFile.h>
+
+// Standard Library Includes
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+// System Includes
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+static std::string errorMessage(const std::string& action,
+	const std::string& path)
+{
+	return "Failed to " + action + " '" + path + "': " + std::strerror(errno);
+}
+
+MappedFile::MappedFile(const std::string& path)
+: _path(path), _data(nullptr), _size(0)
+{
+	int descriptor = open(path.c_str(), O_RDONLY);
+
+	if(descriptor < 0)
+	{
+		throw std::runtime_error(errorMessage("open", path));
+	}
+
+	struct stat status;
+
+	if(fstat(descriptor, &status) != 0)
+	{
+		std::string message = errorMessage("stat", path);
+
+		close(descriptor);
+
+		throw std::runtime_error(message);
+	}
+
+	_size = status.st_size;
+
+	// mmap rejects empty mappings, an empty file is an empty view
+	if(_size > 0)
+	{
+		void* mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE,
+			descriptor, 0);
+
+		if(mapping == MAP_FAILED)
+		{
+			std::string message = errorMessage("map", path);
+
+			close(descriptor);
+
+			throw std::runtime_error(message);
+		}
+
+		_data = static_cast<const char*>(mapping);
+	}
+
+	// The mapping keeps the file alive
+	close(descriptor);
+}
+
+MappedFile::~MappedFile()
+{
+	if(_data != nullptr) munmap(const_cast<char*>(_data), _size);
+}
+
+const char* MappedFile::data() const
+{
+	return _data;
+}
+
+size_t MappedFile::size() const
+{
+	return _size;
+}
+
+const std::string& MappedFile::path() const
+{
+	return _path;
+}
+
+}
+
+}
+
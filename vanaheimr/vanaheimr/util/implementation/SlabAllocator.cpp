@@ -0,0 +1,324 @@
+/*! \file   SlabAllocator.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the SlabAllocator class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/SlabAllocator.h>
+
+// Standard Library Includes
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+static const size_t SizeClasses =
+	SlabAllocator::MaximumObjectSize / SlabAllocator::Alignment;
+
+/*! \brief A released object, linked through its own storage */
+class FreeObject
+{
+public:
+	FreeObject* next;
+};
+
+class ThreadCache;
+
+typedef std::vector<ThreadCache*> ThreadCacheVector;
+
+/*! \brief Objects handed back by threads that have exited */
+class SharedPool
+{
+public:
+	SharedPool()
+	: slabBytes(0), liveBytes(0), allocations(0)
+	{
+		for(size_t i = 0; i < SizeClasses; ++i) freeLists[i] = nullptr;
+	}
+
+public:
+	std::mutex  mutex;
+	FreeObject* freeLists[SizeClasses];
+
+public:
+	/*! \brief The live caches, their counters are summed on demand */
+	ThreadCacheVector caches;
+
+public:
+	/*! \brief Totals from exited threads, protected by the mutex */
+	size_t slabBytes;
+	size_t liveBytes;
+	size_t allocations;
+};
+
+static SharedPool& getSharedPool()
+{
+	// Never destroyed, objects may outlive static destructors
+	static SharedPool* pool = new SharedPool;
+
+	return *pool;
+}
+
+/*! \brief Add to a counter that only one thread writes, without a locked
+	read-modify-write */
+static void add(std::atomic<size_t>& counter, size_t value)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + value,
+		std::memory_order_relaxed);
+}
+
+class ThreadCache
+{
+public:
+	ThreadCache()
+	: slabBytes(0), liveBytes(0), allocations(0),
+		slab(nullptr), slabRemaining(0)
+	{
+		for(size_t i = 0; i < SizeClasses; ++i) freeLists[i] = nullptr;
+
+		auto& pool = getSharedPool();
+
+		std::unique_lock<std::mutex> lock(pool.mutex);
+
+		pool.caches.push_back(this);
+	}
+
+	/*! \brief Hand all free objects and counts back to the shared pool */
+	void release()
+	{
+		auto& pool = getSharedPool();
+
+		std::unique_lock<std::mutex> lock(pool.mutex);
+
+		pool.caches.erase(std::find(pool.caches.begin(),
+			pool.caches.end(), this));
+
+		pool.slabBytes   += slabBytes;
+		pool.liveBytes   += liveBytes;
+		pool.allocations += allocations;
+
+		for(size_t i = 0; i < SizeClasses; ++i)
+		{
+			while(freeLists[i] != nullptr)
+			{
+				auto object = freeLists[i];
+				freeLists[i] = object->next;
+
+				object->next = pool.freeLists[i];
+				pool.freeLists[i] = object;
+			}
+		}
+	}
+
+public:
+	void* allocate(size_t sizeClass)
+	{
+		if(freeLists[sizeClass] == nullptr) _refill(sizeClass);
+
+		auto object = freeLists[sizeClass];
+
+		freeLists[sizeClass] = object->next;
+
+		return object;
+	}
+
+	void deallocate(void* pointer, size_t sizeClass)
+	{
+		auto object = static_cast<FreeObject*>(pointer);
+
+		object->next = freeLists[sizeClass];
+		freeLists[sizeClass] = object;
+	}
+
+private:
+	void _refill(size_t sizeClass)
+	{
+		auto& pool = getSharedPool();
+
+		{
+			std::unique_lock<std::mutex> lock(pool.mutex);
+
+			if(pool.freeLists[sizeClass] != nullptr)
+			{
+				freeLists[sizeClass]      = pool.freeLists[sizeClass];
+				pool.freeLists[sizeClass] = nullptr;
+
+				return;
+			}
+		}
+
+		size_t bytes = (sizeClass + 1) * SlabAllocator::Alignment;
+
+		if(slabRemaining < bytes)
+		{
+			// The tail of the old slab is too small for this class, drop it
+			slab = static_cast<char*>(::operator new(SlabAllocator::SlabSize));
+			slabRemaining = SlabAllocator::SlabSize;
+
+			add(slabBytes, SlabAllocator::SlabSize);
+		}
+
+		deallocate(slab, sizeClass);
+
+		slab          += bytes;
+		slabRemaining -= bytes;
+	}
+
+public:
+	/*! \brief Written by the owning thread, read by statistics(), live
+		bytes wrap around when objects are freed by another thread */
+	std::atomic<size_t> slabBytes;
+	std::atomic<size_t> liveBytes;
+	std::atomic<size_t> allocations;
+
+private:
+	FreeObject* freeLists[SizeClasses];
+
+private:
+	char*  slab;
+	size_t slabRemaining;
+
+};
+
+// Plain thread locals stay valid after the thread's destructors have run
+static thread_local ThreadCache* threadCache          = nullptr;
+static thread_local bool         threadCacheDestroyed = false;
+
+class ThreadCacheOwner
+{
+public:
+	~ThreadCacheOwner()
+	{
+		threadCache->release();
+
+		delete threadCache;
+
+		threadCache          = nullptr;
+		threadCacheDestroyed = true;
+	}
+};
+
+/*! \brief Get the cache for this thread, or null once the thread is
+	shutting down (e.g. static destructors releasing IR) */
+static ThreadCache* getThreadCache()
+{
+	if(threadCache != nullptr)  return threadCache;
+	if(threadCacheDestroyed)    return nullptr;
+
+	static thread_local ThreadCacheOwner owner;
+
+	(void)owner;
+
+	threadCache = new ThreadCache;
+
+	return threadCache;
+}
+
+static size_t getSizeClass(size_t bytes)
+{
+	if(bytes == 0) bytes = 1;
+
+	return (bytes - 1) / SlabAllocator::Alignment;
+}
+
+void* SlabAllocator::allocate(size_t bytes)
+{
+	if(bytes > MaximumObjectSize) return ::operator new(bytes);
+
+	size_t sizeClass = getSizeClass(bytes);
+
+	auto cache = getThreadCache();
+
+	if(cache == nullptr)
+	{
+		auto& pool = getSharedPool();
+
+		{
+			std::unique_lock<std::mutex> lock(pool.mutex);
+
+			pool.liveBytes   += bytes;
+			pool.allocations += 1;
+		}
+
+		// Round up, the object may be recycled through a free list later
+		return ::operator new((sizeClass + 1) * Alignment);
+	}
+
+	add(cache->liveBytes,   bytes);
+	add(cache->allocations, 1);
+
+	return cache->allocate(sizeClass);
+}
+
+void SlabAllocator::deallocate(void* pointer, size_t bytes)
+{
+	if(pointer == nullptr) return;
+
+	if(bytes > MaximumObjectSize)
+	{
+		::operator delete(pointer);
+		return;
+	}
+
+	auto cache = getThreadCache();
+
+	if(cache == nullptr)
+	{
+		auto& pool = getSharedPool();
+
+		// Too late to cache it, keep the object for other threads
+		std::unique_lock<std::mutex> lock(pool.mutex);
+
+		pool.liveBytes -= bytes;
+
+		auto object  = static_cast<FreeObject*>(pointer);
+		auto& head   = pool.freeLists[getSizeClass(bytes)];
+
+		object->next = head;
+		head         = object;
+
+		return;
+	}
+
+	// Unsigned wrap around, the sum over all threads is still exact
+	add(cache->liveBytes, -bytes);
+
+	cache->deallocate(pointer, getSizeClass(bytes));
+}
+
+SlabAllocator::Statistics SlabAllocator::statistics()
+{
+	auto& pool = getSharedPool();
+
+	std::unique_lock<std::mutex> lock(pool.mutex);
+
+	Statistics statistics;
+
+	statistics.slabBytes   = pool.slabBytes;
+	statistics.liveBytes   = pool.liveBytes;
+	statistics.allocations = pool.allocations;
+
+	for(auto cache : pool.caches)
+	{
+		statistics.slabBytes   +=
+			cache->slabBytes.load(std::memory_order_relaxed);
+		statistics.liveBytes   +=
+			cache->liveBytes.load(std::memory_order_relaxed);
+		statistics.allocations +=
+			cache->allocations.load(std::memory_order_relaxed);
+	}
+
+	return statistics;
+}
+
+}
+
+}
+
@@ -0,0 +1,133 @@
+/*! \file   ThreadPool.cpp
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The source file for the ThreadPool class.
+*/
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/ThreadPool.h>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+ThreadPool::ThreadPool(unsigned int threads)
+: _task(nullptr), _count(0), _next(0), _busyWorkers(0), _generation(0),
+	_shutdown(false)
+{
+	if(threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+
+	// The calling thread is the first member of the pool
+	for(unsigned int i = 1; i < threads; ++i)
+	{
+		_workers.push_back(std::thread(&ThreadPool::_work, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_shutdown = true;
+	}
+
+	_start.notify_all();
+
+	for(auto& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::parallelFor(size_t count, const Task& task)
+{
+	if(count == 0) return;
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_task        = &task;
+		_count       = count;
+		_next        = 0;
+		_busyWorkers = _workers.size();
+
+		_exceptions.assign(count, std::exception_ptr());
+
+		++_generation;
+	}
+
+	_start.notify_all();
+
+	_runTasks();
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		_finish.wait(lock, [this] { return _busyWorkers == 0; });
+
+		_task = nullptr;
+	}
+
+	for(auto& exception : _exceptions)
+	{
+		if(exception) std::rethrow_exception(exception);
+	}
+}
+
+unsigned int ThreadPool::size() const
+{
+	return _workers.size() + 1;
+}
+
+void ThreadPool::_work()
+{
+	unsigned int generation = 0;
+
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			_start.wait(lock, [&] {
+				return _shutdown || _generation != generation; });
+
+			if(_shutdown) return;
+
+			generation = _generation;
+		}
+
+		_runTasks();
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			if(--_busyWorkers == 0) _finish.notify_all();
+		}
+	}
+}
+
+void ThreadPool::_runTasks()
+{
+	for(size_t index = _next++; index < _count; index = _next++)
+	{
+		try
+		{
+			(*_task)(index);
+		}
+		catch(...)
+		{
+			_exceptions[index] = std::current_exception();
+		}
+	}
+}
+
+}
+
+}
+
@@ -0,0 +1,72 @@
+/*! \file   ArrayView.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the ArrayView class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <cstddef>
+#include <cassert>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A typed, read-only window onto memory owned by someone else
+
+	The view never copies or frees the elements, whoever owns the
+	memory must keep it alive for as long as the view is used.
+*/
+template<typename T>
+class ArrayView
+{
+public:
+	typedef T        value_type;
+	typedef const T& const_reference;
+	typedef const T* const_iterator;
+	typedef const T* iterator;
+
+public:
+	ArrayView()
+	: _begin(nullptr), _size(0) {}
+
+	ArrayView(const T* begin, size_t size)
+	: _begin(begin), _size(size) {}
+
+	/*! \brief View raw bytes as an array of T */
+	static ArrayView fromBytes(const void* bytes, size_t byteCount)
+	{
+		return ArrayView(static_cast<const T*>(bytes), byteCount / sizeof(T));
+	}
+
+public:
+	const_iterator begin() const { return _begin;         }
+	const_iterator end()   const { return _begin + _size; }
+
+public:
+	size_t size()  const { return _size;      }
+	bool   empty() const { return _size == 0; }
+
+	const T* data() const { return _begin; }
+
+public:
+	const_reference operator[](size_t i) const
+	{
+		assert(i < _size);
+		return _begin[i];
+	}
+
+private:
+	const T* _begin;
+	size_t   _size;
+
+};
+
+}
+
+}
+
@@ -0,0 +1,102 @@
+/*! \file   FileCache.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the FileCache class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A size bounded, content addressed cache of files in a directory
+
+	Entries are written to a temporary file and renamed into place, so a
+	reader never observes a partial entry, even with several processes
+	sharing the directory.  Hits refresh the modification time of an entry
+	and insertions evict the least recently used entries until the cache
+	fits its budget.
+*/
+class FileCache
+{
+public:
+	class Statistics
+	{
+	public:
+		Statistics();
+
+	public:
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t insertions;
+		uint64_t evictions;
+	};
+
+public:
+	/*! \brief Open (creating if needed) the cache held in a directory
+
+		\param directory    The directory holding the entries
+		\param maximumBytes The budget for the total size of all entries
+	*/
+	FileCache(const std::string& directory, uint64_t maximumBytes);
+
+public:
+	/*! \brief Build a key from the bytes of an input and the context that
+			determines how it is processed (tool, version, options).
+
+		The digest is 128 bits wide but not cryptographic, the cache trusts
+		the users of its directory.
+	*/
+	static std::string makeKey(const char* data, size_t size,
+		const std::string& context);
+
+public:
+	/*! \brief Read the entry for a key, returns false on a miss */
+	bool lookup(const std::string& key, std::string& data);
+	/*! \brief Atomically add or replace the entry for a key, entries
+			larger than the whole budget are not stored */
+	void insert(const std::string& key, const std::string& data);
+
+public:
+	/*! \brief The totals recorded by every user of the directory
+
+		Counters are updated with a read-modify-rename under an exclusive
+		flock, so concurrent processes never lose each other's increments.
+		Readers see either the old or the new totals.
+	*/
+	Statistics statistics() const;
+	/*! \brief The total size of the entries currently held */
+	uint64_t bytes() const;
+
+public:
+	const std::string& directory() const;
+	uint64_t maximumBytes() const;
+
+private:
+	std::string _entryPath(const std::string& key) const;
+	std::string _statisticsPath() const;
+	std::string _statisticsLockPath() const;
+
+	void _writeAtomically(const std::string& path,
+		const std::string& data) const;
+	unsigned int _evict();
+	void _record(const Statistics& delta);
+
+private:
+	std::string _directory;
+	uint64_t    _maximumBytes;
+
+};
+
+}
+
+}
+
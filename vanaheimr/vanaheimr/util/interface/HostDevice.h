@@ -0,0 +1,18 @@
+/*! \file   HostDevice.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for qualifiers of code shared with the
+	        archaeopteryx simulator.
+*/
+
+#pragma once
+
+// Preprocessor Macros
+
+/*! \brief Marks inline functions that are also compiled for the device */
+#ifdef __CUDACC__
+#define VANAHEIMR_HOST_DEVICE __host__ __device__
+#else
+#define VANAHEIMR_HOST_DEVICE
+#endif
+
@@ -0,0 +1,210 @@
+/*! \file   IdIndexedVector.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the IdIndexedVector class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <vector>
+#include <iterator>
+#include <cstddef>
+#include <cassert>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief An iterator over the occupied slots of an IdIndexedVector */
+template<typename T, typename Value>
+class IdIndexedVectorIterator
+{
+public:
+	typedef std::vector<T*> PointerVector;
+
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef Value                           value_type;
+	typedef Value&                          reference;
+	typedef Value*                          pointer;
+	typedef std::ptrdiff_t                  difference_type;
+
+public:
+	IdIndexedVectorIterator()
+	: _slots(nullptr), _index(0) {}
+
+	IdIndexedVectorIterator(const PointerVector* slots, size_t index)
+	: _slots(slots), _index(index)
+	{
+		_skipForward();
+	}
+
+	/*! \brief Allow conversion from the mutable to the const iterator */
+	template<typename OtherValue>
+	IdIndexedVectorIterator(const IdIndexedVectorIterator<T, OtherValue>& i)
+	: _slots(i.slots()), _index(i.index()) {}
+
+public:
+	reference operator*()  const { return *(*_slots)[_index]; }
+	pointer   operator->() const { return  (*_slots)[_index]; }
+
+public:
+	IdIndexedVectorIterator& operator++()
+	{
+		++_index;
+		_skipForward();
+		return *this;
+	}
+
+	IdIndexedVectorIterator operator++(int)
+	{
+		IdIndexedVectorIterator previous = *this;
+		++*this;
+		return previous;
+	}
+
+	IdIndexedVectorIterator& operator--()
+	{
+		do
+		{
+			assert(_index > 0);
+			--_index;
+		}
+		while((*_slots)[_index] == nullptr);
+
+		return *this;
+	}
+
+	IdIndexedVectorIterator operator--(int)
+	{
+		IdIndexedVectorIterator previous = *this;
+		--*this;
+		return previous;
+	}
+
+public:
+	template<typename OtherValue>
+	bool operator==(const IdIndexedVectorIterator<T, OtherValue>& i) const
+	{
+		return _index == i.index();
+	}
+
+	template<typename OtherValue>
+	bool operator!=(const IdIndexedVectorIterator<T, OtherValue>& i) const
+	{
+		return _index != i.index();
+	}
+
+public:
+	const PointerVector* slots() const { return _slots; }
+	size_t               index() const { return _index; }
+
+private:
+	void _skipForward()
+	{
+		while(_index < _slots->size() && (*_slots)[_index] == nullptr)
+		{
+			++_index;
+		}
+	}
+
+private:
+	const PointerVector* _slots;
+	size_t               _index;
+
+};
+
+/*! \brief Objects stored at the index of their id
+
+	Erased ids leave holes that iteration skips over, so the ids of the
+	remaining objects stay stable and can index side tables directly.
+	The vector does not own the objects.
+*/
+template<typename T>
+class IdIndexedVector
+{
+public:
+	typedef IdIndexedVectorIterator<T, T>       iterator;
+	typedef IdIndexedVectorIterator<T, const T> const_iterator;
+
+public:
+	IdIndexedVector()
+	: _size(0) {}
+
+public:
+	iterator       begin()       { return iterator(&_slots, 0);       }
+	const_iterator begin() const { return const_iterator(&_slots, 0); }
+
+	iterator       end()       { return iterator(&_slots, _slots.size());  }
+	const_iterator end() const
+	{
+		return const_iterator(&_slots, _slots.size());
+	}
+
+public:
+	/*! \brief The number of objects stored */
+	size_t size()  const { return _size;      }
+	bool   empty() const { return _size == 0; }
+
+	/*! \brief One past the largest id that has ever been stored */
+	size_t capacity() const { return _slots.size(); }
+
+public:
+	/*! \brief Get the object with an id, null if it has been erased */
+	T* get(size_t id) const
+	{
+		if(id >= _slots.size()) return nullptr;
+
+		return _slots[id];
+	}
+
+	iterator find(size_t id)
+	{
+		if(get(id) == nullptr) return end();
+
+		return iterator(&_slots, id);
+	}
+
+public:
+	/*! \brief Store an object at the slot for its id */
+	iterator insert(size_t id, T* object)
+	{
+		if(id >= _slots.size()) _slots.resize(id + 1, nullptr);
+
+		assert(_slots[id] == nullptr);
+
+		_slots[id] = object;
+		++_size;
+
+		return iterator(&_slots, id);
+	}
+
+	/*! \brief Empty the slot for an id, return the next object */
+	iterator erase(size_t id)
+	{
+		assert(get(id) != nullptr);
+
+		_slots[id] = nullptr;
+		--_size;
+
+		return iterator(&_slots, id + 1);
+	}
+
+	void clear()
+	{
+		_slots.clear();
+		_size = 0;
+	}
+
+private:
+	std::vector<T*> _slots;
+	size_t          _size;
+
+};
+
+}
+
+}
+
@@ -0,0 +1,333 @@
+/*! \file   IntrusiveList.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the IntrusiveList class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <cstddef>
+#include <iterator>
+#include <cassert>
+
+// Forward Declarations
+namespace vanaheimr { namespace util {
+	template<typename T> class IntrusiveList; } }
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief The links embedded in each element of an IntrusiveList
+
+	Copying an element does not copy its links, the copy starts out
+	unlinked.
+*/
+template<typename T>
+class IntrusiveListNode
+{
+public:
+	IntrusiveListNode()
+	: _previous(this), _next(this), _self(nullptr) {}
+
+	IntrusiveListNode(const IntrusiveListNode&)
+	: _previous(this), _next(this), _self(nullptr) {}
+
+	IntrusiveListNode& operator=(const IntrusiveListNode&)
+	{
+		return *this;
+	}
+
+public:
+	/*! \brief Is the element currently in a list? */
+	bool isLinked() const
+	{
+		return _next != this;
+	}
+
+public:
+	IntrusiveListNode* previousNode() const { return _previous; }
+	IntrusiveListNode* nextNode()     const { return _next;     }
+
+	/*! \brief The element, null for the list sentinel */
+	T* const& element() const { return _self; }
+
+private:
+	IntrusiveListNode* _previous;
+	IntrusiveListNode* _next;
+	T*                 _self;
+
+private:
+	friend class IntrusiveList<T>;
+};
+
+/*! \brief An iterator over the nodes of an IntrusiveList
+
+	Access determines what dereferencing yields, the element itself
+	or a stable pointer to it.
+*/
+template<typename T, typename Access>
+class IntrusiveListIterator
+{
+public:
+	typedef IntrusiveListNode<T> Node;
+
+	typedef std::bidirectional_iterator_tag    iterator_category;
+	typedef typename Access::value_type        value_type;
+	typedef typename Access::reference         reference;
+	typedef typename Access::pointer           pointer;
+	typedef std::ptrdiff_t                     difference_type;
+
+public:
+	IntrusiveListIterator()
+	: _node(nullptr) {}
+
+	explicit IntrusiveListIterator(const Node* node)
+	: _node(const_cast<Node*>(node)) {}
+
+	/*! \brief Allow conversion from the mutable to the const iterator */
+	template<typename OtherAccess>
+	IntrusiveListIterator(const IntrusiveListIterator<T, OtherAccess>& i)
+	: _node(i.node()) {}
+
+public:
+	reference operator*()  const { return Access::get(_node); }
+	pointer   operator->() const { return &Access::get(_node); }
+
+public:
+	IntrusiveListIterator& operator++()
+	{
+		_node = _node->nextNode();
+		return *this;
+	}
+
+	IntrusiveListIterator operator++(int)
+	{
+		IntrusiveListIterator previous = *this;
+		++*this;
+		return previous;
+	}
+
+	IntrusiveListIterator& operator--()
+	{
+		_node = _node->previousNode();
+		return *this;
+	}
+
+	IntrusiveListIterator operator--(int)
+	{
+		IntrusiveListIterator previous = *this;
+		--*this;
+		return previous;
+	}
+
+public:
+	template<typename OtherAccess>
+	bool operator==(const IntrusiveListIterator<T, OtherAccess>& i) const
+	{
+		return _node == i.node();
+	}
+
+	template<typename OtherAccess>
+	bool operator!=(const IntrusiveListIterator<T, OtherAccess>& i) const
+	{
+		return _node != i.node();
+	}
+
+public:
+	Node* node() const { return _node; }
+
+private:
+	Node* _node;
+
+};
+
+/*! \brief Dereference to the element */
+template<typename T, typename Value>
+class IntrusiveListElementAccess
+{
+public:
+	typedef Value  value_type;
+	typedef Value& reference;
+	typedef Value* pointer;
+
+public:
+	static reference get(const IntrusiveListNode<T>* node)
+	{
+		return *node->element();
+	}
+};
+
+/*! \brief Dereference to a pointer to the element, like a list of pointers */
+template<typename T>
+class IntrusiveListPointerAccess
+{
+public:
+	typedef T* const  value_type;
+	typedef T* const& reference;
+	typedef T* const* pointer;
+
+public:
+	static reference get(const IntrusiveListNode<T>* node)
+	{
+		return node->element();
+	}
+};
+
+/*! \brief A doubly linked list threaded through its elements
+
+	The list does not own its elements and never allocates.  An element
+	may be in at most one list at a time.  Iterators stay valid until
+	the element they refer to is removed, as for std::list.
+*/
+template<typename T>
+class IntrusiveList
+{
+public:
+	typedef IntrusiveListNode<T> Node;
+
+	typedef IntrusiveListIterator<T,
+		IntrusiveListElementAccess<T, T>>             iterator;
+	typedef IntrusiveListIterator<T,
+		IntrusiveListElementAccess<T, const T>>       const_iterator;
+	typedef IntrusiveListIterator<T,
+		IntrusiveListPointerAccess<T>>                pointer_iterator;
+
+	typedef std::reverse_iterator<iterator>         reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+	typedef std::reverse_iterator<pointer_iterator> reverse_pointer_iterator;
+
+public:
+	IntrusiveList()
+	: _size(0) {}
+
+	~IntrusiveList()
+	{
+		clear();
+	}
+
+public:
+	IntrusiveList(const IntrusiveList&) = delete;
+	IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+public:
+	iterator begin()
+	{
+		return iterator(_sentinel.nextNode());
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(_sentinel.nextNode());
+	}
+
+	iterator end()
+	{
+		return iterator(&_sentinel);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(&_sentinel);
+	}
+
+public:
+	pointer_iterator pointer_begin() const
+	{
+		return pointer_iterator(_sentinel.nextNode());
+	}
+
+	pointer_iterator pointer_end() const
+	{
+		return pointer_iterator(&_sentinel);
+	}
+
+public:
+	bool   empty() const { return _size == 0; }
+	size_t size()  const { return _size;      }
+
+public:
+	T& front() const
+	{
+		assert(!empty());
+		return *_sentinel.nextNode()->element();
+	}
+
+	T& back() const
+	{
+		assert(!empty());
+		return *_sentinel.previousNode()->element();
+	}
+
+public:
+	/*! \brief Link an element in front of the node at position */
+	void insert(const Node* position, T* element)
+	{
+		Node* node = element;
+		Node* next = const_cast<Node*>(position);
+
+		assert(!node->isLinked());
+
+		node->_self     = element;
+		node->_next     = next;
+		node->_previous = next->_previous;
+
+		next->_previous->_next = node;
+		next->_previous        = node;
+
+		++_size;
+	}
+
+	/*! \brief Unlink an element, returning the node that followed it */
+	Node* remove(T* element)
+	{
+		Node* node = element;
+		Node* next = node->_next;
+
+		assert(node->isLinked());
+
+		node->_previous->_next = next;
+		next->_previous        = node->_previous;
+
+		node->_previous = node;
+		node->_next     = node;
+
+		--_size;
+
+		return next;
+	}
+
+	/*! \brief Move an element of this list in front of position */
+	void splice(const Node* position, T* element)
+	{
+		if(position == element) return;
+
+		remove(element);
+		insert(position, element);
+	}
+
+	void push_back(T* element)  { insert(&_sentinel, element);           }
+	void push_front(T* element) { insert(_sentinel.nextNode(), element); }
+
+	/*! \brief Unlink every element without destroying them */
+	void clear()
+	{
+		while(!empty()) remove(_sentinel.nextNode()->element());
+	}
+
+public:
+	const Node* sentinel() const { return &_sentinel; }
+
+private:
+	Node   _sentinel;
+	size_t _size;
+
+};
+
+}
+
+}
+
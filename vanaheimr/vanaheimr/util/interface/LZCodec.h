@@ -0,0 +1,122 @@
+/*! \file   LZCodec.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the LZCodec class.
+*/
+
+#pragma once
+
+// Vanaheimr Includes
+#include <vanaheimr/util/interface/IntTypes.h>
+#include <vanaheimr/util/interface/HostDevice.h>
+
+// Standard Library Includes
+#include <cstddef>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A small, fast LZ77 codec for independently compressed blocks
+
+	A block is a series of sequences.  Each starts with a token byte
+	holding the literal count in its high nibble and the match length
+	minus MinimumMatch in its low nibble, a nibble of 15 is extended by
+	following bytes that are added until one is not 255.  The literals
+	come next, then a two byte little endian distance back into the
+	output and the match length extension.  The final sequence of a
+	block stops after its literals.
+
+	Decompression is also compiled for the device so that the simulator
+	can expand binary pages itself.
+*/
+class LZCodec
+{
+public:
+	static const unsigned int MinimumMatch    = 4;
+	static const unsigned int MaximumDistance = 0xffff;
+
+public:
+	/*! \brief Compress a block, returns the compressed size, or 0 if the
+		result does not fit in the output buffer */
+	static size_t compress(const void* input, size_t inputSize,
+		void* output, size_t outputCapacity);
+
+	/*! \brief Decompress a block that expands to exactly outputSize bytes,
+		returns false if the block is malformed */
+	VANAHEIMR_HOST_DEVICE static bool decompress(const void* input,
+		size_t inputSize, void* output, size_t outputSize)
+	{
+		const uint8_t* in     = static_cast<const uint8_t*>(input);
+		const uint8_t* inEnd  = in + inputSize;
+		uint8_t*       out    = static_cast<uint8_t*>(output);
+		uint8_t*       outEnd = out + outputSize;
+
+		while(in < inEnd)
+		{
+			unsigned int token = *in++;
+
+			size_t literals = token >> 4;
+
+			if(!_readLength(in, inEnd, literals)) return false;
+
+			if(literals > (size_t)(inEnd - in))   return false;
+			if(literals > (size_t)(outEnd - out)) return false;
+
+			for(size_t i = 0; i < literals; ++i) *out++ = *in++;
+
+			if(in == inEnd) break;
+
+			if(inEnd - in < 2) return false;
+
+			size_t distance = in[0] | (in[1] << 8);
+
+			in += 2;
+
+			size_t length = token & 0xf;
+
+			if(!_readLength(in, inEnd, length)) return false;
+
+			length += MinimumMatch;
+
+			const uint8_t* begin = static_cast<const uint8_t*>(output);
+
+			if(distance == 0 || distance > (size_t)(out - begin)) return false;
+			if(length > (size_t)(outEnd - out)) return false;
+
+			// Byte at a time, the match may overlap what it produces
+			const uint8_t* match = out - distance;
+
+			for(size_t i = 0; i < length; ++i) *out++ = *match++;
+		}
+
+		return out == outEnd;
+	}
+
+private:
+	VANAHEIMR_HOST_DEVICE static bool _readLength(const uint8_t*& in,
+		const uint8_t* inEnd, size_t& length)
+	{
+		if(length != 15) return true;
+
+		unsigned int byte = 255;
+
+		while(byte == 255)
+		{
+			if(in == inEnd) return false;
+
+			byte    = *in++;
+			length += byte;
+		}
+
+		return true;
+	}
+
+};
+
+}
+
+}
+
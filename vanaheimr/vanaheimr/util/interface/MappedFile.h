@@ -0,0 +1,52 @@
+/*! \file   MappedFile.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the MappedFile class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <string>
+#include <cstddef>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A read-only memory mapping of a whole file
+
+	Pages are brought in by the operating system on first touch, so
+	opening a large file costs the same as opening a small one.
+*/
+class MappedFile
+{
+public:
+	/*! \brief Map the file at path, throws std::runtime_error on failure */
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+public:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+	const char* data() const;
+	size_t      size() const;
+
+public:
+	const std::string& path() const;
+
+private:
+	std::string _path;
+	const char* _data;
+	size_t      _size;
+
+};
+
+}
+
+}
+
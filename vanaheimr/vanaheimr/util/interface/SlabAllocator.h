@@ -0,0 +1,115 @@
+/*! \file   SlabAllocator.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the SlabAllocator class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <cstddef>
+#include <new>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A process wide allocator for small, short lived IR objects
+
+	Objects are carved out of large slabs and recycled through per-thread
+	free lists segregated by size, so allocation and release are a few
+	instructions without touching malloc.  Slabs are never returned to
+	the system, memory released by one module is reused by the next.
+
+	Objects may be released by a different thread than the one that
+	allocated them.
+
+	This is not an arena.  Functions and Modules do not own the memory of
+	their instructions and operands, each object is still deleted on its
+	own and nothing is released in bulk when a Function or Module dies.
+*/
+class SlabAllocator
+{
+public:
+	/*! \brief Requests larger than this go to the system allocator */
+	static const size_t MaximumObjectSize = 256;
+	/*! \brief The granularity of the size classes */
+	static const size_t Alignment         = 16;
+	/*! \brief The size of each slab requested from the system */
+	static const size_t SlabSize          = 64 * 1024;
+
+public:
+	static void* allocate(size_t bytes);
+	static void  deallocate(void* pointer, size_t bytes);
+
+public:
+	/*! \brief Statistics for the whole process */
+	class Statistics
+	{
+	public:
+		/*! \brief Bytes reserved from the system in slabs */
+		size_t slabBytes;
+		/*! \brief Bytes currently handed out to live objects */
+		size_t liveBytes;
+		/*! \brief The number of allocations served from slabs */
+		size_t allocations;
+	};
+
+public:
+	/*! \brief Sum the counters of every thread, the allocation paths only
+		update counters owned by the calling thread */
+	static Statistics statistics();
+
+};
+
+/*! \brief An STL allocator that draws nodes from the SlabAllocator */
+template<typename T>
+class PoolAllocator
+{
+public:
+	typedef T value_type;
+
+public:
+	PoolAllocator() {}
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>&) {}
+
+public:
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(SlabAllocator::allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* pointer, size_t n)
+	{
+		SlabAllocator::deallocate(pointer, n * sizeof(T));
+	}
+
+public:
+	template<typename U>
+	struct rebind
+	{
+		typedef PoolAllocator<U> other;
+	};
+
+};
+
+template<typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+	return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+	return false;
+}
+
+}
+
+}
+
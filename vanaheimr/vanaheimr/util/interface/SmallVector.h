@@ -0,0 +1,317 @@
+/*! \file   SmallVector.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the SmallVector class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A vector that keeps its first few elements inline
+
+	Vectors that never grow past InlineCapacity elements never touch
+	the heap.  The interface is the subset of std::vector that the IR
+	uses, iterators are plain pointers and are invalidated by any
+	insertion or erasure, as for std::vector.
+
+	Elements are moved around bitwise, so only trivial types such as
+	pointers may be stored.
+*/
+template<typename T, size_t InlineCapacity>
+class SmallVector
+{
+public:
+	static_assert(std::is_trivial<T>::value,
+		"SmallVector only holds trivial types.");
+	static_assert(InlineCapacity > 0,
+		"SmallVector needs room for at least one inline element.");
+
+public:
+	typedef T        value_type;
+	typedef T&       reference;
+	typedef const T& const_reference;
+	typedef T*       pointer;
+	typedef const T* const_pointer;
+	typedef size_t   size_type;
+
+	typedef T*       iterator;
+	typedef const T* const_iterator;
+
+	typedef std::reverse_iterator<iterator>       reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+public:
+	SmallVector()
+	: _begin(_inline), _size(0), _capacity(InlineCapacity) {}
+
+	template<typename Iterator>
+	SmallVector(Iterator first, Iterator last)
+	: _begin(_inline), _size(0), _capacity(InlineCapacity)
+	{
+		insert(end(), first, last);
+	}
+
+	SmallVector(const SmallVector& v)
+	: _begin(_inline), _size(0), _capacity(InlineCapacity)
+	{
+		insert(end(), v.begin(), v.end());
+	}
+
+	SmallVector(SmallVector&& v)
+	: _begin(_inline), _size(0), _capacity(InlineCapacity)
+	{
+		_take(v);
+	}
+
+	~SmallVector()
+	{
+		_free();
+	}
+
+public:
+	SmallVector& operator=(const SmallVector& v)
+	{
+		if(this == &v) return *this;
+
+		clear();
+		insert(end(), v.begin(), v.end());
+
+		return *this;
+	}
+
+	SmallVector& operator=(SmallVector&& v)
+	{
+		if(this == &v) return *this;
+
+		_free();
+
+		_begin    = _inline;
+		_size     = 0;
+		_capacity = InlineCapacity;
+
+		_take(v);
+
+		return *this;
+	}
+
+public:
+	iterator       begin()       { return _begin;         }
+	const_iterator begin() const { return _begin;         }
+	iterator       end()         { return _begin + _size; }
+	const_iterator end()   const { return _begin + _size; }
+
+	reverse_iterator rbegin() { return reverse_iterator(end());   }
+	reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+	const_reverse_iterator rbegin() const
+	{
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return const_reverse_iterator(begin());
+	}
+
+public:
+	size_t size()     const { return _size;      }
+	bool   empty()    const { return _size == 0; }
+	size_t capacity() const { return _capacity;  }
+
+	/*! \brief Are the elements still stored inline? */
+	bool isInline() const { return _begin == _inline; }
+
+public:
+	reference operator[](size_t i)
+	{
+		assert(i < _size);
+		return _begin[i];
+	}
+
+	const_reference operator[](size_t i) const
+	{
+		assert(i < _size);
+		return _begin[i];
+	}
+
+	reference       front()       { assert(!empty()); return _begin[0]; }
+	const_reference front() const { assert(!empty()); return _begin[0]; }
+
+	reference back()
+	{
+		assert(!empty());
+		return _begin[_size - 1];
+	}
+
+	const_reference back() const
+	{
+		assert(!empty());
+		return _begin[_size - 1];
+	}
+
+	T*       data()       { return _begin; }
+	const T* data() const { return _begin; }
+
+public:
+	void push_back(const T& value)
+	{
+		if(_size == _capacity)
+		{
+			// The value may live in this vector
+			T copy = value;
+
+			reserve(_capacity * 2);
+
+			_begin[_size++] = copy;
+			return;
+		}
+
+		_begin[_size++] = value;
+	}
+
+	void pop_back()
+	{
+		assert(!empty());
+		--_size;
+	}
+
+	iterator insert(const_iterator position, const T& value)
+	{
+		size_t index = position - _begin;
+		T      copy  = value;
+
+		assert(index <= _size);
+
+		if(_size == _capacity) reserve(_capacity * 2);
+
+		std::copy_backward(_begin + index, _begin + _size,
+			_begin + _size + 1);
+
+		_begin[index] = copy;
+		++_size;
+
+		return _begin + index;
+	}
+
+	/*! \brief Insert a range, which must not come from this vector */
+	template<typename Iterator>
+	iterator insert(const_iterator position, Iterator first, Iterator last)
+	{
+		size_t index = position - _begin;
+		size_t count = std::distance(first, last);
+
+		assert(index <= _size);
+
+		if(_size + count > _capacity)
+		{
+			reserve(std::max(_size + count, (size_t)_capacity * 2));
+		}
+
+		std::copy_backward(_begin + index, _begin + _size,
+			_begin + _size + count);
+		std::copy(first, last, _begin + index);
+
+		_size += count;
+
+		return _begin + index;
+	}
+
+	iterator erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		iterator begin = _begin + (first - _begin);
+		iterator end   = _begin + (last  - _begin);
+
+		assert(begin <= end && end <= this->end());
+
+		std::copy(end, this->end(), begin);
+
+		_size -= end - begin;
+
+		return begin;
+	}
+
+	/*! \brief Remove every element, any heap storage is kept */
+	void clear()
+	{
+		_size = 0;
+	}
+
+	void resize(size_t size, const T& value = T())
+	{
+		if(size > _capacity) reserve(size);
+
+		if(size > _size) std::fill(_begin + _size, _begin + size, value);
+
+		_size = size;
+	}
+
+	void reserve(size_t capacity)
+	{
+		if(capacity <= _capacity) return;
+
+		T* storage = new T[capacity];
+
+		std::copy(begin(), end(), storage);
+
+		_free();
+
+		_begin    = storage;
+		_capacity = capacity;
+	}
+
+private:
+	void _free()
+	{
+		if(!isInline()) delete[] _begin;
+	}
+
+	/*! \brief Take the contents of another vector, leaving it empty */
+	void _take(SmallVector& v)
+	{
+		if(v.isInline())
+		{
+			insert(end(), v.begin(), v.end());
+		}
+		else
+		{
+			_begin    = v._begin;
+			_size     = v._size;
+			_capacity = v._capacity;
+
+			v._begin    = v._inline;
+			v._capacity = InlineCapacity;
+		}
+
+		v._size = 0;
+	}
+
+private:
+	T*       _begin;
+	uint32_t _size;
+	uint32_t _capacity;
+	T        _inline[InlineCapacity];
+
+};
+
+}
+
+}
+
@@ -0,0 +1,83 @@
+/*! \file   ThreadPool.h
+	\date   Sunday October 18, 2026
+	\author agent <agent@local>
+	\brief  The header file for the ThreadPool class.
+*/
+
+#pragma once
+
+// Standard Library Includes
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace vanaheimr
+{
+
+namespace util
+{
+
+/*! \brief A fixed set of worker threads that execute data-parallel loops
+
+	The calling thread participates in each loop.  Loops are not reentrant,
+	a task must not start another loop on the same pool.
+*/
+class ThreadPool
+{
+public:
+	typedef std::function<void(size_t)> Task;
+
+public:
+	/*! \brief Create a pool, 0 threads uses the hardware concurrency */
+	explicit ThreadPool(unsigned int threads = 0);
+	~ThreadPool();
+
+public:
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+	/*! \brief Run task(i) for every i in [0, count), return when all finish
+
+		If any task throws, the exception from the lowest index is rethrown
+		after all tasks have completed.
+	*/
+	void parallelFor(size_t count, const Task& task);
+
+public:
+	/*! \brief The number of threads that execute tasks, including the caller */
+	unsigned int size() const;
+
+private:
+	void _work();
+	void _runTasks();
+
+private:
+	typedef std::vector<std::thread>        ThreadVector;
+	typedef std::vector<std::exception_ptr> ExceptionVector;
+
+private:
+	ThreadVector            _workers;
+	std::mutex              _mutex;
+	std::condition_variable _start;
+	std::condition_variable _finish;
+
+private:
+	const Task*         _task;
+	size_t              _count;
+	std::atomic<size_t> _next;
+	unsigned int        _busyWorkers;
+	unsigned int        _generation;
+	bool                _shutdown;
+	ExceptionVector     _exceptions;
+
+};
+
+}
+
+}
+